@@ -0,0 +1,202 @@
+/*
+  Asynchronous TCP library for Espressif MCUs
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+  This file is part of the esp8266 core for Arduino environment.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "Arduino.h"
+#include "AsyncRingBuffer.h"
+#include "ESPAsyncTCP.h"
+
+AsyncRingBuffer::AsyncRingBuffer(size_t size, size_t maxSize)
+  : _buf(NULL)
+  , _size(0)
+  , _minSize(size)
+  , _maxSize(maxSize)
+  , _tail(0)
+  , _used(0)
+  , _sent(0)
+  , _peak(0)
+  , _retired(NULL)
+  , _retiredLen(0)
+  , _highWater(0)
+  , _lowWater(0)
+  , _high(false)
+  , _watermark_cb(0)
+  , _watermark_cb_arg(0)
+{
+  if(_maxSize && _maxSize < _minSize)
+    _maxSize = _minSize;
+  _resize(_minSize);
+}
+
+AsyncRingBuffer::~AsyncRingBuffer(){
+  if(_retired != NULL)
+    free(_retired);
+  if(_buf != NULL)
+    free(_buf);
+}
+
+bool AsyncRingBuffer::_resize(size_t size){
+  if(size < _used || size == _size)
+    return false;
+  //in flight bytes point into the current storage, only one old storage can be kept around
+  if(_sent && _retired != NULL)
+    return false;
+  char *buf = (char*)malloc(size);
+  if(buf == NULL)
+    return false;
+  if(_used){
+    size_t first = _size - _tail;
+    if(first > _used)
+      first = _used;
+    memcpy(buf, _buf + _tail, first);
+    memcpy(buf + first, _buf, _used - first);
+  }
+  if(_sent){
+    _retired = _buf;
+    _retiredLen = _sent;
+  } else if(_buf != NULL) {
+    free(_buf);
+  }
+  _buf = buf;
+  _size = size;
+  _tail = 0;
+  if(_size > _peak)
+    _peak = _size;
+  return true;
+}
+
+void AsyncRingBuffer::_checkWatermark(){
+  if(!_highWater)
+    return;
+  if(!_high && _used >= _highWater){
+    _high = true;
+    if(_watermark_cb)
+      _watermark_cb(_watermark_cb_arg, this, true);
+  } else if(_high && _used <= _lowWater){
+    _high = false;
+    if(_watermark_cb)
+      _watermark_cb(_watermark_cb_arg, this, false);
+  }
+}
+
+size_t AsyncRingBuffer::room(){
+  return _size - _used;
+}
+
+size_t AsyncRingBuffer::write(const uint8_t *data, size_t len){
+  if(data == NULL || len == 0)
+    return 0;
+  if(room() < len && (!_maxSize || _size < _maxSize)){
+    size_t size = _size ? _size : _minSize;
+    while((size - _used) < len && (!_maxSize || size < _maxSize))
+      size <<= 1;
+    if(_maxSize && size > _maxSize)
+      size = _maxSize;
+    _resize(size);
+  }
+  size_t toWrite = room();
+  if(toWrite > len)
+    toWrite = len;
+  if(toWrite == 0)
+    return 0;
+  size_t head = (_tail + _used) % _size;
+  size_t first = _size - head;
+  if(first > toWrite)
+    first = toWrite;
+  memcpy(_buf + head, data, first);
+  memcpy(_buf, data + first, toWrite - first);
+  _used += toWrite;
+  _checkWatermark();
+  return toWrite;
+}
+
+size_t AsyncRingBuffer::send(AsyncClient *client){
+  if(client == NULL)
+    return 0;
+  size_t added = 0;
+  while(pending()){
+    size_t start = (_tail + _sent) % _size;
+    size_t segment = _size - start;
+    if(segment > pending())
+      segment = pending();
+    size_t a = client->add(_buf + start, segment);
+    _sent += a;
+    added += a;
+    if(a < segment)
+      break;
+  }
+  if(added)
+    client->send();
+  return added;
+}
+
+size_t AsyncRingBuffer::ack(size_t len){
+  if(len > _sent)
+    len = _sent;
+  if(len == 0)
+    return 0;
+  _tail = (_tail + len) % _size;
+  _used -= len;
+  _sent -= len;
+  if(_retired != NULL){
+    if(len >= _retiredLen){
+      free(_retired);
+      _retired = NULL;
+      _retiredLen = 0;
+    } else {
+      _retiredLen -= len;
+    }
+  }
+  if(_used == 0){
+    _tail = 0;
+    if(_size > _minSize)
+      _resize(_minSize);
+  }
+  _checkWatermark();
+  return len;
+}
+
+void AsyncRingBuffer::clear(){
+  if(_retired != NULL){
+    free(_retired);
+    _retired = NULL;
+    _retiredLen = 0;
+  }
+  _tail = 0;
+  _used = 0;
+  _sent = 0;
+  if(_size > _minSize)
+    _resize(_minSize);
+  _checkWatermark();
+}
+
+void AsyncRingBuffer::setWatermarks(size_t high, size_t low){
+  if(low > high)
+    low = high;
+  _highWater = high;
+  _lowWater = low;
+  _high = false;
+  _checkWatermark();
+}
+
+void AsyncRingBuffer::onWatermark(ArbWatermarkHandler cb, void* arg){
+  _watermark_cb = cb;
+  _watermark_cb_arg = arg;
+}
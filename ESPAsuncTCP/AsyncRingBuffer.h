@@ -0,0 +1,89 @@
+/*
+  Asynchronous TCP library for Espressif MCUs
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+  This file is part of the esp8266 core for Arduino environment.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef ASYNCRINGBUFFER_H_
+#define ASYNCRINGBUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+
+class AsyncClient;
+class AsyncRingBuffer;
+
+#ifndef ASYNC_RING_BUFFER_SIZE
+#define ASYNC_RING_BUFFER_SIZE 1460
+#endif
+
+typedef std::function<void(void*, AsyncRingBuffer*, bool high)> ArbWatermarkHandler;
+
+/*
+  Growable TX ring buffer. Data is handed to AsyncClient::add() straight out of the
+  ring and stays there until lwIP acks it (tcp_write is called without copy), so the
+  stored bytes are split into [in flight][pending][free].
+  The ring doubles when it runs out of room, up to maxSize (0 = only limited by heap).
+  If bytes are still in flight the old storage is kept until they are acked, a second
+  resize has to wait for that.
+*/
+class AsyncRingBuffer {
+  private:
+    char *_buf;
+    size_t _size;
+    size_t _minSize;
+    size_t _maxSize;
+    size_t _tail;//first byte not yet acked
+    size_t _used;//bytes in flight + pending
+    size_t _sent;//bytes in flight
+    size_t _peak;
+    char *_retired;//previous storage still referenced by lwIP
+    size_t _retiredLen;
+    size_t _highWater;
+    size_t _lowWater;
+    bool _high;
+    ArbWatermarkHandler _watermark_cb;
+    void *_watermark_cb_arg;
+
+    bool _resize(size_t size);
+    void _checkWatermark();
+
+  public:
+    AsyncRingBuffer(size_t size = ASYNC_RING_BUFFER_SIZE, size_t maxSize = 0);
+    ~AsyncRingBuffer();
+
+    size_t write(const uint8_t *data, size_t len);//copies as much as fits, grows if allowed
+    size_t send(AsyncClient *client);//add() pending segments and send them
+    size_t ack(size_t len);//release acked bytes
+    void clear();//drop everything, only when the data is no longer referenced by lwIP
+
+    size_t length(){ return _used; }
+    size_t pending(){ return _used - _sent; }
+    size_t inFlight(){ return _sent; }
+    size_t capacity(){ return _size; }
+    size_t peak(){ return _peak; }//largest capacity used so far
+    size_t room();//bytes that can be written without waiting for acks
+    bool empty(){ return _used == 0; }
+
+    //handler gets high=true when length() reaches the high mark and high=false once it drained to the low mark
+    void setWatermarks(size_t high, size_t low);
+    void onWatermark(ArbWatermarkHandler cb, void* arg = 0);
+};
+
+#endif /* ASYNCRINGBUFFER_H_ */
@@ -0,0 +1,142 @@
+/*
+  Asynchronous TCP library for Espressif MCUs
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+  This file is part of the esp8266 core for Arduino environment.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "AsyncTimerWheel.h"
+
+AsyncTimer::AsyncTimer(AsyncTimerHandler cb, void* arg)
+  : _prev(NULL)
+  , _next(NULL)
+  , _list(NULL)
+  , _wheel(NULL)
+  , _deadline(0)
+  , _cb(cb)
+  , _cb_arg(arg)
+{}
+
+AsyncTimer::~AsyncTimer(){
+  if(_wheel != NULL)
+    _wheel->stop(this);
+}
+
+AsyncTimerWheel::AsyncTimerWheel(uint32_t tick)
+  : _expired(NULL)
+  , _tick(tick ? tick : 1)
+  , _nextTime(0)
+  , _cursor(0)
+  , _count(0)
+  , _fired(0)
+  , _visited(0)
+{
+  for(size_t i = 0; i < ASYNC_TIMER_SLOTS; i++)
+    _slots[i] = NULL;
+}
+
+void AsyncTimerWheel::begin(uint32_t now){
+  if(_count)
+    return;
+  _nextTime = now + _tick;
+}
+
+void AsyncTimerWheel::_link(AsyncTimer** list, AsyncTimer* timer){
+  timer->_list = list;
+  timer->_wheel = this;
+  timer->_prev = NULL;
+  timer->_next = *list;
+  if(*list)
+    (*list)->_prev = timer;
+  *list = timer;
+}
+
+void AsyncTimerWheel::_unlink(AsyncTimer* timer){
+  if(timer->_prev)
+    timer->_prev->_next = timer->_next;
+  else
+    *(timer->_list) = timer->_next;
+  if(timer->_next)
+    timer->_next->_prev = timer->_prev;
+  timer->_prev = NULL;
+  timer->_next = NULL;
+  timer->_list = NULL;
+  timer->_wheel = NULL;
+}
+
+void AsyncTimerWheel::start(AsyncTimer* timer, uint32_t now, uint32_t delay){
+  startAt(timer, now + delay);
+}
+
+void AsyncTimerWheel::startAt(AsyncTimer* timer, uint32_t deadline){
+  if(timer == NULL)
+    return;
+  stop(timer);
+  timer->_deadline = deadline;
+  //deadlines in the past go into the next slot
+  size_t ahead = 0;
+  int32_t delta = (int32_t)(deadline - _nextTime);
+  if(delta > 0)
+    ahead = ((uint32_t)delta + _tick - 1) / _tick;
+  _link(&_slots[(_cursor + ahead) % ASYNC_TIMER_SLOTS], timer);
+  _count++;
+}
+
+void AsyncTimerWheel::stop(AsyncTimer* timer){
+  if(timer == NULL || timer->_wheel != this)
+    return;
+  _unlink(timer);
+  _count--;
+}
+
+size_t AsyncTimerWheel::run(uint32_t now){
+  size_t fired = 0;
+  size_t slots = 0;
+  while((int32_t)(now - _nextTime) >= 0 && slots < ASYNC_TIMER_SLOTS){
+    AsyncTimer** slot = &_slots[_cursor];
+    _cursor = (_cursor + 1) % ASYNC_TIMER_SLOTS;
+    _nextTime += _tick;
+    slots++;
+    //move what is due to the expired list first, handlers may start and stop timers
+    AsyncTimer* t = *slot;
+    while(t != NULL){
+      AsyncTimer* n = t->_next;
+      _visited++;
+      if((int32_t)(t->_deadline - now) <= 0){
+        _unlink(t);
+        _link(&_expired, t);
+      }
+      t = n;
+    }
+    while(_expired != NULL){
+      t = _expired;
+      _unlink(t);
+      _count--;
+      _fired++;
+      fired++;
+      if(t->_cb)
+        t->_cb(t->_cb_arg, t);
+    }
+  }
+  //fell behind by more than a lap, every slot was visited once, skip ahead keeping the slot mapping
+  if((int32_t)(now - _nextTime) >= 0){
+    uint32_t skip = (now - _nextTime) / _tick + 1;
+    _cursor = (_cursor + skip) % ASYNC_TIMER_SLOTS;
+    _nextTime += skip * _tick;
+  }
+  return fired;
+}
@@ -0,0 +1,100 @@
+/*
+  Asynchronous TCP library for Espressif MCUs
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+  This file is part of the esp8266 core for Arduino environment.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef ASYNCTIMERWHEEL_H_
+#define ASYNCTIMERWHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef ASYNC_TIMER_TICK
+#define ASYNC_TIMER_TICK 125 //ms per wheel slot
+#endif
+
+#ifndef ASYNC_TIMER_SLOTS
+#define ASYNC_TIMER_SLOTS 64 //one lap of the wheel is ASYNC_TIMER_TICK * ASYNC_TIMER_SLOTS ms
+#endif
+
+class AsyncTimer;
+class AsyncTimerWheel;
+
+typedef void (*AsyncTimerHandler)(void* arg, AsyncTimer* timer);
+
+/*
+  Intrusive timer node, owned by the object it belongs to (one per deadline kind).
+  Destroying an armed timer stops it.
+*/
+class AsyncTimer {
+  private:
+    friend class AsyncTimerWheel;
+    AsyncTimer* _prev;
+    AsyncTimer* _next;
+    AsyncTimer** _list;
+    AsyncTimerWheel* _wheel;
+    uint32_t _deadline;
+    AsyncTimerHandler _cb;
+    void* _cb_arg;
+
+  public:
+    AsyncTimer(AsyncTimerHandler cb = 0, void* arg = 0);
+    ~AsyncTimer();
+
+    bool armed(){ return _list != NULL; }
+    uint32_t deadline(){ return _deadline; }
+};
+
+/*
+  Hashed timer wheel, a timer lives in the first slot whose tick is at or after its deadline.
+  run() only walks the slots whose tick has passed, so its cost depends on the
+  timers that are due (plus the few waiting for a later lap), not on how many
+  timers exist. Time is passed in by the caller, which keeps it usable with a
+  simulated clock.
+*/
+class AsyncTimerWheel {
+  private:
+    AsyncTimer* _slots[ASYNC_TIMER_SLOTS];
+    AsyncTimer* _expired;
+    uint32_t _tick;
+    uint32_t _nextTime;//time the slot at _cursor becomes due
+    size_t _cursor;
+    size_t _count;
+    uint32_t _fired;
+    uint32_t _visited;
+
+    void _link(AsyncTimer** list, AsyncTimer* timer);
+    void _unlink(AsyncTimer* timer);
+
+  public:
+    AsyncTimerWheel(uint32_t tick = ASYNC_TIMER_TICK);
+
+    void begin(uint32_t now);//align the wheel to now, only while it is empty
+    void start(AsyncTimer* timer, uint32_t now, uint32_t delay);
+    void startAt(AsyncTimer* timer, uint32_t deadline);
+    void stop(AsyncTimer* timer);
+    size_t run(uint32_t now);//fire everything due at now, returns the number of fired timers
+
+    size_t count(){ return _count; }
+    uint32_t tick(){ return _tick; }
+    uint32_t fired(){ return _fired; }//timers fired so far
+    uint32_t visited(){ return _visited; }//timers looked at by run() so far
+};
+
+#endif /* ASYNCTIMERWHEEL_H_ */
@@ -22,12 +22,66 @@
 #include "Arduino.h"
 
 #include "ESPAsyncTCP.h"
+#if ASYNC_TCP_POSIX
+#include "ESPAsyncTCPposix.h"
+#else
 extern "C"{
   #include "lwip/opt.h"
   #include "lwip/tcp.h"
   #include "lwip/inet.h"
   #include "lwip/dns.h"
+  #include "osapi.h"
 }
+#endif
+
+/*
+  Shared timer wheel for the RX, ACK and poll deadlines of all clients.
+  One os_timer drives it and only runs while timers are armed, instead of
+  an lwIP poll callback per connection. On the host asyncTcpLoop() runs it.
+*/
+
+static AsyncTimerWheel _async_timers;
+
+#if ASYNC_TCP_POSIX
+
+static void _async_timer_start(AsyncTimer *timer, uint32_t delay){
+  uint32_t now = millis();
+  _async_timers.begin(now);
+  _async_timers.start(timer, now, delay);
+}
+
+void asyncTcpLoop(uint32_t timeout){
+  if(_async_timers.count() && timeout > _async_timers.tick())
+    timeout = _async_timers.tick();
+  tcp_posix_poll(timeout);
+  _async_timers.run(millis());
+}
+
+#else
+
+static os_timer_t _async_tick;
+static bool _async_tick_armed = false;
+
+static void _async_tick_cb(void *arg){
+  _async_timers.run(millis());
+  if(!_async_timers.count()){
+    os_timer_disarm(&_async_tick);
+    _async_tick_armed = false;
+  }
+}
+
+static void _async_timer_start(AsyncTimer *timer, uint32_t delay){
+  uint32_t now = millis();
+  _async_timers.begin(now);
+  _async_timers.start(timer, now, delay);
+  if(!_async_tick_armed){
+    os_timer_setfn(&_async_tick, &_async_tick_cb, NULL);
+    os_timer_arm(&_async_tick, _async_timers.tick(), true);
+    _async_tick_armed = true;
+  }
+}
+
+#endif
 
 /*
   Async TCP Client
@@ -44,16 +98,22 @@ AsyncClient::AsyncClient(tcp_pcb* pcb):
   , _error_cb_arg(0)
   , _recv_cb(0)
   , _recv_cb_arg(0)
+  , _pb_cb(0)
+  , _pb_cb_arg(0)
   , _timeout_cb(0)
   , _timeout_cb_arg(0)
   , _pcb_busy(false)
   , _pcb_sent_at(0)
   , _close_pcb(false)
   , _ack_pcb(true)
+  , _rx_ack_len(0)
   , _rx_last_packet(0)
   , _rx_since_timeout(0)
   , _ack_timeout(ASYNC_MAX_ACK_TIME)
   , _connect_port(0)
+  , _rx_timer(&_s_rx_timer, this)
+  , _ack_timer(&_s_ack_timer, this)
+  , _poll_timer(&_s_poll_timer, this)
   , prev(NULL)
   , next(NULL)
 {
@@ -64,13 +124,14 @@ AsyncClient::AsyncClient(tcp_pcb* pcb):
     tcp_recv(_pcb, &_s_recv);
     tcp_sent(_pcb, &_s_sent);
     tcp_err(_pcb, &_s_error);
-    tcp_poll(_pcb, &_s_poll, 1);
+    _startTimers();
   }
 }
 
 AsyncClient::~AsyncClient(){
   if(_pcb)
     _close();
+  _stopTimers();
 }
 
 bool AsyncClient::connect(IPAddress ip, uint16_t port){
@@ -117,7 +178,7 @@ AsyncClient& AsyncClient::operator=(const AsyncClient& other){
     tcp_recv(_pcb, &_s_recv);
     tcp_sent(_pcb, &_s_sent);
     tcp_err(_pcb, &_s_error);
-    tcp_poll(_pcb, &_s_poll, 1);
+    _startTimers();
   }
   return *this;
 }
@@ -138,8 +199,11 @@ void AsyncClient::close(bool now){
   tcp_recved(_pcb, _rx_ack_len);
   if(now)
     _close();
-  else
+  else {
+    //closed from the poll timer, outside of the current callback
     _close_pcb = true;
+    _async_timer_start(&_poll_timer, 0);
+  }
 }
 
 void AsyncClient::stop() {
@@ -175,6 +239,8 @@ size_t AsyncClient::write(const char* data, size_t size) {
     return 0;
   _pcb_sent_at = millis();
   _pcb_busy = true;
+  if(_ack_timeout && !_ack_timer.armed())
+    _async_timer_start(&_ack_timer, _ack_timeout);
   if(will_send < size){
     size_t left = size - will_send;
     return will_send + write(data+will_send, left);
@@ -196,11 +262,14 @@ size_t AsyncClient::add(const char* data, size_t size) {
 }
 
 bool AsyncClient::send(){
-  if(!canSend())
+  //add() may have used up all of snd_buf, the queued data still has to go out
+  if(_pcb == NULL || _pcb->state != 4)
     return false;
   if(tcp_output(_pcb) == ERR_OK){
     _pcb_busy = true;
     _pcb_sent_at = millis();
+    if(_ack_timeout && !_ack_timer.armed())
+      _async_timer_start(&_ack_timer, _ack_timeout);
     return true;
   }
   return false;
@@ -215,6 +284,14 @@ size_t AsyncClient::ack(size_t len){
   return len;
 }
 
+void AsyncClient::ackPacket(struct pbuf *pb){
+  if(pb == NULL)
+    return;
+  if(_pcb)
+    tcp_recved(_pcb, pb->tot_len);
+  pbuf_free(pb);
+}
+
 // Private Callbacks
 
 int8_t AsyncClient::_close(){
@@ -230,6 +307,7 @@ int8_t AsyncClient::_close(){
       err = abort();
     }
     _pcb = NULL;
+    _stopTimers();
     if(_discard_cb)
       _discard_cb(_discard_cb_arg, this);
   }
@@ -242,8 +320,8 @@ int8_t AsyncClient::_connected(void* pcb, int8_t err){
     tcp_setprio(_pcb, TCP_PRIO_MIN);
     tcp_recv(_pcb, &_s_recv);
     tcp_sent(_pcb, &_s_sent);
-    tcp_poll(_pcb, &_s_poll, 1);
     _pcb_busy = false;
+    _startTimers();
   }
   if(_connect_cb)
     _connect_cb(_connect_cb_arg, this);
@@ -259,6 +337,7 @@ void AsyncClient::_error(int8_t err) {
     tcp_poll(_pcb, NULL, 0);
     _pcb = NULL;
   }
+  _stopTimers();
   if(_error_cb)
     _error_cb(_error_cb_arg, this, err);
   if(_discard_cb)
@@ -279,6 +358,11 @@ int8_t AsyncClient::_recv(tcp_pcb* pcb, pbuf* pb, int8_t err) {
   }
 
   _rx_last_packet = millis();
+  //hand the whole chain over (onPacket defined)
+  if(_pb_cb){
+    _pb_cb(_pb_cb_arg, this, pb);
+    return ERR_OK;
+  }
   //use callback (onData defined)
   while(pb != NULL){
     //we should not ack before we assimilate the data
@@ -298,30 +382,59 @@ int8_t AsyncClient::_recv(tcp_pcb* pcb, pbuf* pb, int8_t err) {
   return ERR_OK;
 }
 
-int8_t AsyncClient::_poll(tcp_pcb* pcb){
-  // Close requested
-  if(_close_pcb){
-    _close_pcb = false;
+void AsyncClient::_startTimers(){
+  _rx_last_packet = millis();
+  if(_rx_since_timeout)
+    _async_timer_start(&_rx_timer, _rx_since_timeout * 1000);
+  if(_poll_cb)
+    _async_timer_start(&_poll_timer, ASYNC_POLL_TIME);
+}
+
+void AsyncClient::_stopTimers(){
+  _async_timers.stop(&_rx_timer);
+  _async_timers.stop(&_ack_timer);
+  _async_timers.stop(&_poll_timer);
+}
+
+// Deadlines are not moved on every packet, an early timer rearms itself for the rest
+
+void AsyncClient::_onRxTimer(){
+  if(!_pcb || !_rx_since_timeout)
+    return;
+  uint32_t now = millis();
+  uint32_t timeout = _rx_since_timeout * 1000;
+  if(now - _rx_last_packet >= timeout){
     _close();
-    return ERR_OK;
+    return;
   }
+  _async_timer_start(&_rx_timer, timeout - (now - _rx_last_packet));
+}
+
+void AsyncClient::_onAckTimer(){
+  if(!_pcb || !_pcb_busy || !_ack_timeout)
+    return;
   uint32_t now = millis();
-  // ACK Timeout
-  if(_pcb_busy && _ack_timeout && (now - _pcb_sent_at) >= _ack_timeout){
+  if((now - _pcb_sent_at) >= _ack_timeout){
     _pcb_busy = false;
     if(_timeout_cb)
       _timeout_cb(_timeout_cb_arg, this, (now - _pcb_sent_at));
-    return ERR_OK;
+    return;
   }
-  // RX Timeout
-  if(_rx_since_timeout && now - _rx_last_packet >= _rx_since_timeout * 1000){
+  _async_timer_start(&_ack_timer, _ack_timeout - (now - _pcb_sent_at));
+}
+
+void AsyncClient::_onPollTimer(){
+  // Close requested
+  if(_close_pcb){
+    _close_pcb = false;
     _close();
-    return ERR_OK;
+    return;
   }
-  // Everything is fine
-  if(_poll_cb)
-    _poll_cb(_poll_cb_arg, this);
-  return ERR_OK;
+  if(!_pcb || !_poll_cb)
+    return;
+  //rearm first, the handler may delete the client
+  _async_timer_start(&_poll_timer, ASYNC_POLL_TIME);
+  _poll_cb(_poll_cb_arg, this);
 }
 
 void AsyncClient::_dns_found(ip_addr_t *ipaddr){
@@ -341,8 +454,16 @@ void AsyncClient::_s_dns_found(const char *name, ip_addr_t *ipaddr, void *arg){
   reinterpret_cast<AsyncClient*>(arg)->_dns_found(ipaddr);
 }
 
-int8_t AsyncClient::_s_poll(void *arg, struct tcp_pcb *tpcb) {
-  return reinterpret_cast<AsyncClient*>(arg)->_poll(tpcb);
+void AsyncClient::_s_rx_timer(void *arg, AsyncTimer *timer) {
+  reinterpret_cast<AsyncClient*>(arg)->_onRxTimer();
+}
+
+void AsyncClient::_s_ack_timer(void *arg, AsyncTimer *timer) {
+  reinterpret_cast<AsyncClient*>(arg)->_onAckTimer();
+}
+
+void AsyncClient::_s_poll_timer(void *arg, AsyncTimer *timer) {
+  reinterpret_cast<AsyncClient*>(arg)->_onPollTimer();
 }
 
 int8_t AsyncClient::_s_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *pb, int8_t err) {
@@ -378,6 +499,10 @@ AsyncClient & AsyncClient::operator+=(const AsyncClient &other) {
 
 void AsyncClient::setRxTimeout(uint32_t timeout){
   _rx_since_timeout = timeout;
+  if(!timeout)
+    _async_timers.stop(&_rx_timer);
+  else if(_pcb)
+    _async_timer_start(&_rx_timer, 0);//checked on the next tick, rearms itself
 }
 
 uint32_t AsyncClient::getRxTimeout(){
@@ -390,6 +515,10 @@ uint32_t AsyncClient::getAckTimeout(){
 
 void AsyncClient::setAckTimeout(uint32_t timeout){
   _ack_timeout = timeout;
+  if(!timeout)
+    _async_timers.stop(&_ack_timer);
+  else if(_pcb_busy)
+    _async_timer_start(&_ack_timer, 0);
 }
 
 void AsyncClient::setNoDelay(bool nodelay){
@@ -515,6 +644,11 @@ void AsyncClient::onData(AcDataHandler cb, void* arg){
   _recv_cb_arg = arg;
 }
 
+void AsyncClient::onPacket(AcPacketHandler cb, void* arg){
+  _pb_cb = cb;
+  _pb_cb_arg = arg;
+}
+
 void AsyncClient::onTimeout(AcTimeoutHandler cb, void* arg){
   _timeout_cb = cb;
   _timeout_cb_arg = arg;
@@ -523,6 +657,8 @@ void AsyncClient::onTimeout(AcTimeoutHandler cb, void* arg){
 void AsyncClient::onPoll(AcConnectHandler cb, void* arg){
   _poll_cb = cb;
   _poll_cb_arg = arg;
+  if(_pcb && _poll_cb && !_poll_timer.armed())
+    _async_timer_start(&_poll_timer, ASYNC_POLL_TIME);
 }
 
 
@@ -572,6 +708,87 @@ const char * AsyncClient::stateToString(){
   }
 }
 
+/*
+  pbuf chain view
+*/
+
+AsyncPbufView::AsyncPbufView(pbuf* pb, size_t offset)
+  : _pb(pb)
+  , _offset(offset)
+{}
+
+size_t AsyncPbufView::length(){
+  if(_pb == NULL || _offset >= _pb->tot_len)
+    return 0;
+  return _pb->tot_len - _offset;
+}
+
+size_t AsyncPbufView::segments(){
+  size_t count = 0;
+  size_t skip = _offset;
+  for(pbuf* p = _pb; p != NULL; p = p->next){
+    if(skip >= p->len){
+      skip -= p->len;
+      continue;
+    }
+    skip = 0;
+    count++;
+  }
+  return count;
+}
+
+const uint8_t* AsyncPbufView::segment(size_t index, size_t* len){
+  size_t skip = _offset;
+  for(pbuf* p = _pb; p != NULL; p = p->next){
+    if(skip >= p->len){
+      skip -= p->len;
+      continue;
+    }
+    if(index == 0){
+      *len = p->len - skip;
+      return (const uint8_t*)p->payload + skip;
+    }
+    skip = 0;
+    index--;
+  }
+  *len = 0;
+  return NULL;
+}
+
+int AsyncPbufView::at(size_t index){
+  index += _offset;
+  for(pbuf* p = _pb; p != NULL; p = p->next){
+    if(index < p->len)
+      return ((const uint8_t*)p->payload)[index];
+    index -= p->len;
+  }
+  return -1;
+}
+
+int AsyncPbufView::indexOf(uint8_t c, size_t from){
+  size_t skip = _offset + from;
+  size_t base = 0;
+  for(pbuf* p = _pb; p != NULL; p = p->next){
+    if(skip < p->len){
+      const uint8_t* data = (const uint8_t*)p->payload;
+      const uint8_t* found = (const uint8_t*)memchr(data + skip, c, p->len - skip);
+      if(found != NULL)
+        return base + (found - data) - _offset;
+      skip = 0;
+    } else {
+      skip -= p->len;
+    }
+    base += p->len;
+  }
+  return -1;
+}
+
+size_t AsyncPbufView::copy(void* dst, size_t len, size_t index){
+  if(_pb == NULL)
+    return 0;
+  return pbuf_copy_partial(_pb, dst, len, _offset + index);
+}
+
 /*
   Async TCP Server
 */
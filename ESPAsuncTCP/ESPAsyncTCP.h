@@ -25,8 +25,18 @@
 
 
 #include "IPAddress.h"
+#include "AsyncTimerWheel.h"
 #include <functional>
 
+//build against non-blocking sockets and epoll instead of lwIP, see ESPAsyncTCPposix.h
+#ifndef ASYNC_TCP_POSIX
+#if !defined(ESP8266) && defined(__linux__)
+#define ASYNC_TCP_POSIX 1
+#else
+#define ASYNC_TCP_POSIX 0
+#endif
+#endif
+
 #define USE_ASYNC_BUFFER 0
 #define SERVER_KEEP_CLIENTS 0
 #define CLIENT_SYNC_API 0
@@ -34,17 +44,41 @@
 class AsyncClient;
 
 #define ASYNC_MAX_ACK_TIME 5000
+#define ASYNC_POLL_TIME 125
 
 typedef std::function<void(void*, AsyncClient*)> AcConnectHandler;
 typedef std::function<void(void*, AsyncClient*, size_t len, uint32_t time)> AcAckHandler;
 typedef std::function<void(void*, AsyncClient*, int8_t error)> AcErrorHandler;
 typedef std::function<void(void*, AsyncClient*, void *data, size_t len)> AcDataHandler;
 typedef std::function<void(void*, AsyncClient*, uint32_t time)> AcTimeoutHandler;
+typedef std::function<void(void*, AsyncClient*, struct pbuf *pb)> AcPacketHandler;
 
 struct tcp_pcb;
 struct pbuf;
 struct ip_addr;
 
+/*
+  Read-only scatter/gather view over a received pbuf chain, lets packet handlers
+  parse the data in place without copying it into a contiguous buffer
+*/
+class AsyncPbufView {
+  protected:
+    pbuf* _pb;
+    size_t _offset;
+
+  public:
+    AsyncPbufView(pbuf* pb = NULL, size_t offset = 0);
+
+    pbuf* chain(){ return _pb; }
+    size_t length();//bytes in the chain after the offset
+    size_t segments();
+    const uint8_t* segment(size_t index, size_t* len);//contiguous data of one segment
+    int at(size_t index);//byte at index or -1
+    int indexOf(uint8_t c, size_t from = 0);
+    size_t copy(void* dst, size_t len, size_t index = 0);
+    void consume(size_t len){ _offset += len; }
+};
+
 class AsyncClient {
   protected:
     friend class AsyncTCPbuffer;
@@ -59,6 +93,8 @@ class AsyncClient {
     void* _error_cb_arg;
     AcDataHandler _recv_cb;
     void* _recv_cb_arg;
+    AcPacketHandler _pb_cb;
+    void* _pb_cb_arg;
     AcTimeoutHandler _timeout_cb;
     void* _timeout_cb_arg;
     AcConnectHandler _poll_cb;
@@ -72,15 +108,24 @@ class AsyncClient {
     uint32_t _rx_since_timeout;
     uint32_t _ack_timeout;
     uint16_t _connect_port;
+    AsyncTimer _rx_timer;
+    AsyncTimer _ack_timer;
+    AsyncTimer _poll_timer;
 
     int8_t _close();
     int8_t _connected(void* pcb, int8_t err);
     void _error(int8_t err);
-    int8_t _poll(tcp_pcb* pcb);
+    void _startTimers();
+    void _stopTimers();
+    void _onRxTimer();
+    void _onAckTimer();
+    void _onPollTimer();
     int8_t _sent(tcp_pcb* pcb, uint16_t len);
     int8_t _recv(tcp_pcb* pcb, pbuf* pb, int8_t err);
     void _dns_found(struct ip_addr *ipaddr);
-    static int8_t _s_poll(void *arg, struct tcp_pcb *tpcb);
+    static void _s_rx_timer(void *arg, AsyncTimer *timer);
+    static void _s_ack_timer(void *arg, AsyncTimer *timer);
+    static void _s_poll_timer(void *arg, AsyncTimer *timer);
     static int8_t _s_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *pb, int8_t err);
     static void _s_error(void *arg, int8_t err);
     static int8_t _s_sent(void *arg, struct tcp_pcb *tpcb, uint16_t len);
@@ -116,6 +161,7 @@ class AsyncClient {
     bool send();//send all data added with the method above
     size_t ack(size_t len); //ack data that you have not acked using the method below
     void ackLater(){ _ack_pcb = false; } //will not ack the current packet. Call from onData
+    void ackPacket(struct pbuf *pb); //ack and free a chain received through onPacket
 
 
     size_t write(const char* data);
@@ -149,6 +195,7 @@ class AsyncClient {
     void onAck(AcAckHandler cb, void* arg = 0);             //ack received
     void onError(AcErrorHandler cb, void* arg = 0);         //unsuccessful connect or error
     void onData(AcDataHandler cb, void* arg = 0);           //data received
+    void onPacket(AcPacketHandler cb, void* arg = 0);       //data received, handler owns the pbuf chain until ackPacket()
     void onTimeout(AcTimeoutHandler cb, void* arg = 0);     //ack timeout
     void onPoll(AcConnectHandler cb, void* arg = 0);        //every 125ms when connected
 
@@ -181,5 +228,9 @@ class AsyncServer {
     static int8_t _s_accept(void *arg, tcp_pcb* newpcb, int8_t err);
 };
 
+#if ASYNC_TCP_POSIX
+//run socket events and client timers, call this from the main loop of the host program
+void asyncTcpLoop(uint32_t timeout = ASYNC_TIMER_TICK);
+#endif
 
 #endif /* ASYNCTCP_H_ */
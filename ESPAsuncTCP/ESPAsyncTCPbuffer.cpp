@@ -36,8 +36,7 @@ AsyncTCPbuffer::AsyncTCPbuffer(AsyncClient* client) {
     }
 
     _client = client;
-    _TXbufferWrite = new cbuf(1460);
-    _TXbufferRead = _TXbufferWrite;
+    _TXbuffer = new AsyncRingBuffer(1460);
     _RXbuffer = new cbuf(100);
     _RXmode = ATB_RX_MODE_FREE;
     _rxSize = 0;
@@ -45,6 +44,7 @@ AsyncTCPbuffer::AsyncTCPbuffer(AsyncClient* client) {
     _rxReadBytesPtr = NULL;
     _rxReadStringPtr = NULL;
     _cbDisconnect = NULL;
+    _cbWatermark = NULL;
 
     _cbRX = NULL;
     _cbDone = NULL;
@@ -61,20 +61,9 @@ AsyncTCPbuffer::~AsyncTCPbuffer() {
         _RXbuffer = NULL;
     }
 
-    if(_TXbufferWrite) {
-        // will be deleted in _TXbufferRead chain
-        _TXbufferWrite = NULL;
-    }
-
-    if(_TXbufferRead) {
-        cbuf * next = _TXbufferRead->next;
-        delete _TXbufferRead;
-        while(next != NULL) {
-            _TXbufferRead = next;
-            next = _TXbufferRead->next;
-            delete _TXbufferRead;
-        }
-        _TXbufferRead = NULL;
+    if(_TXbuffer) {
+        delete _TXbuffer;
+        _TXbuffer = NULL;
     }
 }
 
@@ -101,44 +90,25 @@ size_t AsyncTCPbuffer::write(const char *data, size_t len) {
  * @return
  */
 size_t AsyncTCPbuffer::write(const uint8_t *data, size_t len) {
-    if(_TXbufferWrite == NULL || _client == NULL || !_client->connected() || data == NULL || len == 0) {
+    if(_TXbuffer == NULL || _client == NULL || !_client->connected() || data == NULL || len == 0) {
         return 0;
     }
 
-    size_t bytesLeft = len;
-    while(bytesLeft) {
-        size_t w = _TXbufferWrite->write((const char*) data, bytesLeft);
-        bytesLeft -= w;
-        data += w;
-        _sendBuffer();
-
-        // add new buffer since we have more data
-        if(_TXbufferWrite->full() && bytesLeft > 0) {
-
-            // to less ram!!!
-            if(ESP.getFreeHeap() < 4096) {
-                DEBUG_ASYNC_TCP("[A-TCP] run out of Heap can not send all Data!\n");
-                return (len - bytesLeft);
-            }
-
-            cbuf * next = new cbuf(1460);
-
-            if(next == NULL) {
-                DEBUG_ASYNC_TCP("[A-TCP] run out of Heap!\n");
-                panic();
-            } else {
-                DEBUG_ASYNC_TCP("[A-TCP] new cbuf\n");
-            }
+    size_t toWrite = len;
 
-            // add new buffer to chain (current cbuf)
-            _TXbufferWrite->next = next;
+    // ring buffer would need to grow, to less ram!!!
+    if(_TXbuffer->room() < len && ESP.getFreeHeap() < 4096) {
+        DEBUG_ASYNC_TCP("[A-TCP] run out of Heap can not send all Data!\n");
+        toWrite = _TXbuffer->room();
+    }
 
-            // move ptr for next data
-            _TXbufferWrite = next;
-        }
+    size_t w = _TXbuffer->write(data, toWrite);
+    if(w < len) {
+        DEBUG_ASYNC_TCP("[A-TCP] TX buffer full, only %d of %d buffered\n", w, len);
     }
 
-    return len;
+    _sendBuffer();
+    return w;
 
 }
 
@@ -146,8 +116,8 @@ size_t AsyncTCPbuffer::write(const uint8_t *data, size_t len) {
  * wait until all data has send out
  */
 void AsyncTCPbuffer::flush() {
-    while(!_TXbufferWrite->empty()) {
-        while(!_client->canSend()) {
+    while(_client && _TXbuffer->pending()) {
+        while(_client && !_client->canSend()) {
             delay(0);
         }
         _sendBuffer();
@@ -218,6 +188,27 @@ void AsyncTCPbuffer::onDisconnect(AsyncTCPbufferDisconnectCb cb) {
     _cbDisconnect = cb;
 }
 
+void AsyncTCPbuffer::setTxWatermarks(size_t high, size_t low) {
+    _TXbuffer->setWatermarks(high, low);
+}
+
+void AsyncTCPbuffer::onTxWatermark(AsyncTCPbufferWatermarkCb cb) {
+    _cbWatermark = cb;
+    _TXbuffer->onWatermark([](void *obj, AsyncRingBuffer * rb, bool high) {
+        AsyncTCPbuffer* b = ((AsyncTCPbuffer*)(obj));
+        if(b->_cbWatermark) {
+            b->_cbWatermark(b, high);
+        }
+    }, this);
+}
+
+/**
+ * bytes written but not yet acked by the remote side
+ */
+size_t AsyncTCPbuffer::txBuffered() {
+    return _TXbuffer->length();
+}
+
 IPAddress AsyncTCPbuffer::remoteIP() {
     if(!_client) {
         return IPAddress(0U);
@@ -280,7 +271,7 @@ void AsyncTCPbuffer::_attachCallbacks() {
 
     _client->onPoll([](void *obj, AsyncClient* c) {
         AsyncTCPbuffer* b = ((AsyncTCPbuffer*)(obj));
-        if((b->_TXbufferRead != NULL) && !b->_TXbufferRead->empty()) {
+        if((b->_TXbuffer != NULL) && b->_TXbuffer->pending()) {
             b->_sendBuffer();
         }
         //    if(!b->_RXbuffer->empty()) {
@@ -290,7 +281,9 @@ void AsyncTCPbuffer::_attachCallbacks() {
 
     _client->onAck([](void *obj, AsyncClient* c, size_t len, uint32_t time) {
         DEBUG_ASYNC_TCP("[A-TCP] onAck\n");
-        ((AsyncTCPbuffer*)(obj))->_sendBuffer();
+        AsyncTCPbuffer* b = ((AsyncTCPbuffer*)(obj));
+        b->_TXbuffer->ack(len);
+        b->_sendBuffer();
     }, this);
 
     _client->onDisconnect([](void *obj, AsyncClient* c) {
@@ -322,51 +315,18 @@ void AsyncTCPbuffer::_attachCallbacks() {
 
 /**
  * send TX buffer if possible
+ * the data is added straight from the ring segments and stays buffered until acked
  */
 void AsyncTCPbuffer::_sendBuffer() {
     //DEBUG_ASYNC_TCP("[A-TCP] _sendBuffer...\n");
-    size_t available = _TXbufferRead->available();
-    if(available == 0 || _client == NULL || !_client->connected() || !_client->canSend()) {
+    if(_TXbuffer == NULL || _TXbuffer->pending() == 0 || _client == NULL || !_client->connected() || !_client->canSend()) {
         return;
     }
 
-    while((_client->space() > 0) && (_TXbufferRead->available() > 0) && _client->canSend()) {
-
-        available = _TXbufferRead->available();
-
-        if(available > _client->space()) {
-            available = _client->space();
-        }
-
-        char *out = new char[available];
-        if(out == NULL) {
-            DEBUG_ASYNC_TCP("[A-TCP] to less heap, try later.\n");
-            return;
-        }
-
-        // read data from buffer
-        _TXbufferRead->peek(out, available);
-
-        // send data
-        size_t send = _client->write((const char*) out, available);
-        if(send != available) {
-            DEBUG_ASYNC_TCP("[A-TCP] write failed send: %d available: %d \n", send, available);
-        }
-
-        // remove really send data from buffer
-        _TXbufferRead->remove(send);
-
-        // if buffer is empty and there is a other buffer in chain delete the empty one
-        if(_TXbufferRead->available() == 0 && _TXbufferRead->next != NULL) {
-            cbuf * old = _TXbufferRead;
-            _TXbufferRead = _TXbufferRead->next;
-            delete old;
-            DEBUG_ASYNC_TCP("[A-TCP] delete cbuf\n");
-        }
-
-        delete out;
+    size_t send = _TXbuffer->send(_client);
+    if(send == 0) {
+        DEBUG_ASYNC_TCP("[A-TCP] add failed pending: %d space: %d\n", _TXbuffer->pending(), _client->space());
     }
-
 }
 
 /**
@@ -35,6 +35,7 @@
 #include <cbuf.h>
 
 #include "ESPAsyncTCP.h"
+#include "AsyncRingBuffer.h"
 
 
 
@@ -53,6 +54,7 @@ class AsyncTCPbuffer: public Print {
         typedef std::function<size_t(uint8_t * payload, size_t length)> AsyncTCPbufferDataCb;
         typedef std::function<void(bool ok, void * ret)> AsyncTCPbufferDoneCb;
         typedef std::function<bool(AsyncTCPbuffer * obj)> AsyncTCPbufferDisconnectCb;
+        typedef std::function<void(AsyncTCPbuffer * obj, bool full)> AsyncTCPbufferWatermarkCb;
 
         AsyncTCPbuffer(AsyncClient* c);
         virtual ~AsyncTCPbuffer();
@@ -82,6 +84,11 @@ class AsyncTCPbuffer: public Print {
         void onData(AsyncTCPbufferDataCb cb);
         void onDisconnect(AsyncTCPbufferDisconnectCb cb);
 
+        // backpressure, cb(full = true) once high bytes are buffered, cb(full = false) when drained to low
+        void setTxWatermarks(size_t high, size_t low);
+        void onTxWatermark(AsyncTCPbufferWatermarkCb cb);
+        size_t txBuffered();
+
         IPAddress remoteIP();
         uint16_t  remotePort();
         IPAddress localIP();
@@ -94,8 +101,7 @@ class AsyncTCPbuffer: public Print {
 
     protected:
         AsyncClient* _client;
-        cbuf * _TXbufferRead;
-        cbuf * _TXbufferWrite;
+        AsyncRingBuffer * _TXbuffer;
         cbuf * _RXbuffer;
         atbRxMode_t _RXmode;
         size_t _rxSize;
@@ -106,6 +112,7 @@ class AsyncTCPbuffer: public Print {
         AsyncTCPbufferDataCb _cbRX;
         AsyncTCPbufferDoneCb _cbDone;
         AsyncTCPbufferDisconnectCb _cbDisconnect;
+        AsyncTCPbufferWatermarkCb _cbWatermark;
 
         void _attachCallbacks();
         void _sendBuffer();
@@ -0,0 +1,663 @@
+/*
+  Asynchronous TCP library for Espressif MCUs
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+  This file is part of the esp8266 core for Arduino environment.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "ESPAsyncTCP.h"
+
+#if ASYNC_TCP_POSIX
+
+#include "ESPAsyncTCPposix.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#define TCP_POSIX_MAX_EVENTS 64
+
+// lwIP tcp_state numbering
+#define TCP_POSIX_CLOSED 0
+#define TCP_POSIX_LISTEN 1
+#define TCP_POSIX_SYN_SENT 2
+#define TCP_POSIX_ESTABLISHED 4
+
+static int _epoll_fd = -1;
+static struct tcp_pcb *_queued = NULL;//pcbs with sent reports or errors to deliver
+static struct tcp_pcb *_dead = NULL;
+static struct tcp_pcb *_draining = NULL;
+
+static uint32_t _tcp_now(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int _tcp_epoll(){
+  if(_epoll_fd < 0)
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  return _epoll_fd;
+}
+
+static void _tcp_events(struct tcp_pcb *pcb, uint32_t events){
+  if(pcb->fd < 0 || (pcb->polled && pcb->events == events))
+    return;
+  //nothing wanted, take the fd out so a hung up peer does not wake us up until the window opens
+  if(!events){
+    if(pcb->polled)
+      epoll_ctl(_tcp_epoll(), EPOLL_CTL_DEL, pcb->fd, NULL);
+    pcb->polled = false;
+    pcb->events = 0;
+    return;
+  }
+  struct epoll_event ev;
+  ev.events = events;
+  ev.data.ptr = pcb;
+  epoll_ctl(_tcp_epoll(), pcb->polled ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, pcb->fd, &ev);
+  pcb->polled = true;
+  pcb->events = events;
+}
+
+static void _tcp_update_events(struct tcp_pcb *pcb){
+  uint32_t events = 0;
+  if(pcb->state == TCP_POSIX_LISTEN || (!pcb->closing && pcb->rx_unacked < TCP_WND))
+    events |= EPOLLIN | EPOLLRDHUP;
+  if(pcb->state == TCP_POSIX_SYN_SENT || pcb->tx_len)
+    events |= EPOLLOUT;
+  _tcp_events(pcb, events);
+}
+
+static void _tcp_queue(struct tcp_pcb *pcb){
+  if(pcb->queued)
+    return;
+  pcb->queued = true;
+  pcb->next_queued = _queued;
+  _queued = pcb;
+}
+
+static void _tcp_drain(struct tcp_pcb *pcb){
+  //the fd moves to a pcb of its own, the original one is freed as usual
+  struct tcp_pcb *d = (struct tcp_pcb *)calloc(1, sizeof(struct tcp_pcb));
+  if(d == NULL)
+    return;
+  shutdown(pcb->fd, SHUT_WR);
+  d->fd = pcb->fd;
+  d->polled = pcb->polled;
+  d->events = pcb->events;
+  d->draining = true;
+  d->drain_until = _tcp_now() + TCP_POSIX_DRAIN_TIME;
+  d->next_dead = _draining;
+  _draining = d;
+  _tcp_events(d, EPOLLIN | EPOLLRDHUP);
+  //force the update, the events may be equal but the pointer changed
+  struct epoll_event ev;
+  ev.events = d->events;
+  ev.data.ptr = d;
+  epoll_ctl(_tcp_epoll(), EPOLL_CTL_MOD, d->fd, &ev);
+  pcb->fd = -1;
+  pcb->polled = false;
+}
+
+static void _tcp_drain_close(struct tcp_pcb *d){
+  struct tcp_pcb **p = &_draining;
+  while(*p != NULL && *p != d)
+    p = &(*p)->next_dead;
+  if(*p != NULL)
+    *p = d->next_dead;
+  close(d->fd);
+  //events for it may still be pending in the current batch
+  d->fd = -1;
+  d->dead = true;
+  d->next_dead = _dead;
+  _dead = d;
+}
+
+static void _tcp_drain_read(struct tcp_pcb *d){
+  char buf[512];
+  while(true){
+    ssize_t n = recv(d->fd, buf, sizeof(buf), 0);
+    if(n > 0)
+      continue;
+    if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+      return;
+    _tcp_drain_close(d);
+    return;
+  }
+}
+
+static void _tcp_drain_expire(){
+  uint32_t now = _tcp_now();
+  struct tcp_pcb *d = _draining;
+  while(d != NULL){
+    struct tcp_pcb *next = d->next_dead;
+    if((int32_t)(now - d->drain_until) >= 0)
+      _tcp_drain_close(d);
+    d = next;
+  }
+}
+
+static void _tcp_free(struct tcp_pcb *pcb, bool reset){
+  if(pcb->dead)
+    return;
+  if(!reset && pcb->fd >= 0 && pcb->state == TCP_POSIX_ESTABLISHED)
+    _tcp_drain(pcb);
+  if(pcb->fd >= 0){
+    if(reset){
+      struct linger l = { 1, 0 };
+      setsockopt(pcb->fd, SOL_SOCKET, SO_LINGER, &l, sizeof(l));
+    }
+    if(pcb->polled)
+      epoll_ctl(_tcp_epoll(), EPOLL_CTL_DEL, pcb->fd, NULL);
+    pcb->polled = false;
+    close(pcb->fd);
+    pcb->fd = -1;
+  }
+  //memory is released at the end of the poll, callers may still touch the pcb
+  pcb->dead = true;
+  pcb->state = TCP_POSIX_CLOSED;
+  pcb->next_dead = _dead;
+  _dead = pcb;
+}
+
+static void _tcp_error(struct tcp_pcb *pcb, err_t err){
+  tcp_err_fn errf = pcb->errf;
+  void *arg = pcb->callback_arg;
+  _tcp_free(pcb, false);
+  if(errf)
+    errf(arg, err);
+}
+
+static void _tcp_addresses(struct tcp_pcb *pcb){
+  struct sockaddr_in sa;
+  socklen_t len = sizeof(sa);
+  if(getsockname(pcb->fd, (struct sockaddr*)&sa, &len) == 0){
+    pcb->local_ip.addr = sa.sin_addr.s_addr;
+    pcb->local_port = ntohs(sa.sin_port);
+  }
+  len = sizeof(sa);
+  if(getpeername(pcb->fd, (struct sockaddr*)&sa, &len) == 0){
+    pcb->remote_ip.addr = sa.sin_addr.s_addr;
+    pcb->remote_port = ntohs(sa.sin_port);
+  }
+}
+
+static void _tcp_flush(struct tcp_pcb *pcb){
+  while(pcb->tx_len){
+    ssize_t n = send(pcb->fd, pcb->tx + pcb->tx_off, pcb->tx_len, MSG_NOSIGNAL);
+    if(n > 0){
+      pcb->tx_off += n;
+      pcb->tx_len -= n;
+      pcb->tx_done += n;
+      _tcp_queue(pcb);
+      continue;
+    }
+    if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+      break;
+    //report from the poll loop, the caller may be inside a client callback
+    pcb->err = ERR_RST;
+    _tcp_queue(pcb);
+    return;
+  }
+  if(!pcb->tx_len)
+    pcb->tx_off = 0;
+  if(pcb->closing && !pcb->tx_len && !pcb->dead){
+    _tcp_free(pcb, false);
+    return;
+  }
+  _tcp_update_events(pcb);
+}
+
+static void _tcp_accept(struct tcp_pcb *listener){
+  while(!listener->dead){
+    int fd = accept4(listener->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if(fd < 0)
+      return;
+    struct tcp_pcb *pcb = tcp_new();
+    if(pcb == NULL){
+      close(fd);
+      return;
+    }
+    pcb->fd = fd;
+    pcb->state = TCP_POSIX_ESTABLISHED;
+    _tcp_addresses(pcb);
+    _tcp_update_events(pcb);
+    err_t err = ERR_VAL;
+    if(listener->accept)
+      err = listener->accept(listener->callback_arg, pcb, ERR_OK);
+    if(err != ERR_OK)
+      tcp_abort(pcb);
+  }
+}
+
+static void _tcp_connected(struct tcp_pcb *pcb){
+  int err = 0;
+  socklen_t len = sizeof(err);
+  if(getsockopt(pcb->fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0){
+    _tcp_error(pcb, ERR_CONN);
+    return;
+  }
+  pcb->state = TCP_POSIX_ESTABLISHED;
+  _tcp_addresses(pcb);
+  if(pcb->nodelay)
+    tcp_nagle_disable(pcb);
+  _tcp_update_events(pcb);
+  if(pcb->connected)
+    pcb->connected(pcb->callback_arg, pcb, ERR_OK);
+}
+
+static struct pbuf * _pbuf_alloc(uint16_t len){
+  struct pbuf *p = (struct pbuf *)malloc(sizeof(struct pbuf) + len);
+  if(p == NULL)
+    return NULL;
+  p->next = NULL;
+  p->payload = (uint8_t*)(p + 1);
+  p->tot_len = len;
+  p->len = len;
+  p->ref = 1;
+  return p;
+}
+
+static void _tcp_deliver(struct tcp_pcb *pcb, struct pbuf *p, err_t err){
+  if(pcb->recv){
+    pcb->recv(pcb->callback_arg, pcb, p, err);
+    return;
+  }
+  //like lwIP tcp_recv_null
+  if(p != NULL){
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+  } else {
+    tcp_close(pcb);
+  }
+}
+
+static void _tcp_read(struct tcp_pcb *pcb){
+  struct pbuf *chain = NULL;
+  bool eof = false;
+  while(!pcb->closing && pcb->rx_unacked < TCP_WND){
+    uint16_t room = TCP_WND - pcb->rx_unacked;
+    if(room > TCP_POSIX_MSS)
+      room = TCP_POSIX_MSS;
+    if(chain != NULL && (uint32_t)chain->tot_len + room > 0xFFFF)
+      break;
+    struct pbuf *p = _pbuf_alloc(room);
+    if(p == NULL)
+      break;
+    ssize_t n = recv(pcb->fd, p->payload, room, 0);
+    if(n <= 0){
+      free(p);
+      if(n == 0)
+        eof = true;
+      else if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR){
+        if(chain != NULL)
+          pbuf_free(chain);
+        _tcp_error(pcb, ERR_RST);
+        return;
+      }
+      break;
+    }
+    p->len = p->tot_len = n;
+    pcb->rx_unacked += n;
+    if(chain == NULL)
+      chain = p;
+    else
+      pbuf_cat(chain, p);
+    if(n < room)
+      break;
+  }
+  if(chain != NULL){
+    if(pcb->closing){
+      pbuf_free(chain);
+    } else {
+      _tcp_deliver(pcb, chain, ERR_OK);
+    }
+  }
+  if(pcb->dead)
+    return;
+  if(eof){
+    //stop listening for input, the closed socket stays readable
+    pcb->rx_unacked = TCP_WND;
+    _tcp_update_events(pcb);
+    if(!pcb->closing)
+      _tcp_deliver(pcb, NULL, ERR_OK);
+    else if(!pcb->tx_len)
+      _tcp_free(pcb, false);
+    return;
+  }
+  _tcp_update_events(pcb);
+}
+
+static void _tcp_run_queue(){
+  while(_queued != NULL){
+    struct tcp_pcb *pcb = _queued;
+    _queued = pcb->next_queued;
+    pcb->queued = false;
+    if(pcb->dead)
+      continue;
+    if(pcb->err != ERR_OK){
+      _tcp_error(pcb, pcb->err);
+      continue;
+    }
+    if(pcb->tx_done){
+      uint16_t len = pcb->tx_done;
+      pcb->tx_done = 0;
+      pcb->snd_buf += len;
+      if(pcb->sent && !pcb->closing)
+        pcb->sent(pcb->callback_arg, pcb, len);
+    }
+  }
+}
+
+static void _tcp_free_dead(){
+  while(_dead != NULL){
+    struct tcp_pcb *pcb = _dead;
+    _dead = pcb->next_dead;
+    free(pcb->tx);
+    free(pcb);
+  }
+}
+
+int tcp_posix_poll(uint32_t timeout){
+  struct epoll_event events[TCP_POSIX_MAX_EVENTS];
+  if(_queued != NULL)
+    timeout = 0;
+  int n = epoll_wait(_tcp_epoll(), events, TCP_POSIX_MAX_EVENTS, timeout);
+  for(int i = 0; i < n; i++){
+    struct tcp_pcb *pcb = (struct tcp_pcb *)events[i].data.ptr;
+    uint32_t ev = events[i].events;
+    if(pcb->dead)
+      continue;
+    if(pcb->draining){
+      _tcp_drain_read(pcb);
+      continue;
+    }
+    if(pcb->state == TCP_POSIX_LISTEN){
+      _tcp_accept(pcb);
+      continue;
+    }
+    if(pcb->state == TCP_POSIX_SYN_SENT){
+      if(ev & (EPOLLOUT | EPOLLERR | EPOLLHUP))
+        _tcp_connected(pcb);
+      continue;
+    }
+    if(ev & EPOLLOUT)
+      _tcp_flush(pcb);
+    if(!pcb->dead && (ev & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)))
+      _tcp_read(pcb);
+    if(!pcb->dead && (ev & EPOLLERR))
+      _tcp_error(pcb, ERR_RST);
+  }
+  _tcp_run_queue();
+  _tcp_free_dead();
+  if(_draining != NULL)
+    _tcp_drain_expire();
+  return n < 0 ? 0 : n;
+}
+
+// lwIP raw API
+
+struct tcp_pcb * tcp_new(void){
+  struct tcp_pcb *pcb = (struct tcp_pcb *)calloc(1, sizeof(struct tcp_pcb));
+  if(pcb == NULL)
+    return NULL;
+  pcb->tx = (char *)malloc(TCP_SND_BUF);
+  if(pcb->tx == NULL){
+    free(pcb);
+    return NULL;
+  }
+  pcb->fd = -1;
+  pcb->snd_buf = TCP_SND_BUF;
+  pcb->err = ERR_OK;
+  return pcb;
+}
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg){
+  if(pcb)
+    pcb->callback_arg = arg;
+}
+
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv){
+  if(pcb)
+    pcb->recv = recv;
+}
+
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent){
+  if(pcb)
+    pcb->sent = sent;
+}
+
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err){
+  if(pcb)
+    pcb->errf = err;
+}
+
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept){
+  if(pcb)
+    pcb->accept = accept;
+}
+
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, uint8_t interval){
+  //polling is done by the shared timer wheel
+}
+
+void tcp_setprio(struct tcp_pcb *pcb, uint8_t prio){}
+
+err_t tcp_bind(struct tcp_pcb *pcb, ip_addr_t *ipaddr, uint16_t port){
+  if(pcb == NULL || pcb->dead)
+    return ERR_ARG;
+  if(pcb->fd < 0)
+    pcb->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if(pcb->fd < 0)
+    return ERR_MEM;
+  int one = 1;
+  setsockopt(pcb->fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  struct sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_addr.s_addr = ipaddr ? ipaddr->addr : IPADDR_ANY;
+  sa.sin_port = htons(port);
+  if(bind(pcb->fd, (struct sockaddr*)&sa, sizeof(sa)) != 0)
+    return ERR_USE;
+  pcb->local_ip.addr = sa.sin_addr.s_addr;
+  pcb->local_port = port;
+  return ERR_OK;
+}
+
+struct tcp_pcb * tcp_listen(struct tcp_pcb *pcb){
+  if(pcb == NULL || pcb->fd < 0 || listen(pcb->fd, SOMAXCONN) != 0)
+    return NULL;
+  pcb->state = TCP_POSIX_LISTEN;
+  _tcp_update_events(pcb);
+  return pcb;
+}
+
+err_t tcp_connect(struct tcp_pcb *pcb, ip_addr_t *ipaddr, uint16_t port, tcp_connected_fn connected){
+  if(pcb == NULL || pcb->dead || ipaddr == NULL)
+    return ERR_ARG;
+  if(pcb->fd < 0)
+    pcb->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if(pcb->fd < 0)
+    return ERR_MEM;
+  struct sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_addr.s_addr = ipaddr->addr;
+  sa.sin_port = htons(port);
+  pcb->connected = connected;
+  pcb->state = TCP_POSIX_SYN_SENT;
+  //completion and failure are both reported from the poll loop, as lwIP does
+  if(connect(pcb->fd, (struct sockaddr*)&sa, sizeof(sa)) != 0 && errno != EINPROGRESS){
+    pcb->err = ERR_CONN;
+    _tcp_queue(pcb);
+    return ERR_OK;
+  }
+  _tcp_update_events(pcb);
+  return ERR_OK;
+}
+
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, uint16_t len, uint8_t apiflags){
+  if(pcb == NULL || pcb->dead || pcb->closing || pcb->state != TCP_POSIX_ESTABLISHED)
+    return ERR_CONN;
+  if(len > pcb->snd_buf)
+    return ERR_MEM;
+  //always copied, the data does not have to outlive the call on the host
+  if(pcb->tx_off + pcb->tx_len + len > TCP_SND_BUF){
+    memmove(pcb->tx, pcb->tx + pcb->tx_off, pcb->tx_len);
+    pcb->tx_off = 0;
+  }
+  memcpy(pcb->tx + pcb->tx_off + pcb->tx_len, dataptr, len);
+  pcb->tx_len += len;
+  pcb->snd_buf -= len;
+  _tcp_update_events(pcb);
+  return ERR_OK;
+}
+
+err_t tcp_output(struct tcp_pcb *pcb){
+  if(pcb == NULL || pcb->dead)
+    return ERR_CONN;
+  if(pcb->state == TCP_POSIX_ESTABLISHED)
+    _tcp_flush(pcb);
+  return ERR_OK;
+}
+
+void tcp_recved(struct tcp_pcb *pcb, uint16_t len){
+  if(pcb == NULL || pcb->dead)
+    return;
+  bool closed = pcb->rx_unacked >= TCP_WND;
+  if(len > pcb->rx_unacked)
+    len = pcb->rx_unacked;
+  pcb->rx_unacked -= len;
+  if(closed && pcb->rx_unacked < TCP_WND)
+    _tcp_update_events(pcb);
+}
+
+err_t tcp_close(struct tcp_pcb *pcb){
+  if(pcb == NULL || pcb->dead)
+    return ERR_OK;
+  pcb->closing = true;
+  if(pcb->state != TCP_POSIX_ESTABLISHED || !pcb->tx_len)
+    _tcp_free(pcb, false);
+  else
+    _tcp_update_events(pcb);
+  return ERR_OK;
+}
+
+void tcp_abort(struct tcp_pcb *pcb){
+  if(pcb == NULL || pcb->dead)
+    return;
+  tcp_err_fn errf = pcb->errf;
+  void *arg = pcb->callback_arg;
+  _tcp_free(pcb, true);
+  if(errf)
+    errf(arg, ERR_ABRT);
+}
+
+void tcp_nagle_disable(struct tcp_pcb *pcb){
+  int one = 1;
+  pcb->nodelay = true;
+  if(pcb->fd >= 0)
+    setsockopt(pcb->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+void tcp_nagle_enable(struct tcp_pcb *pcb){
+  int zero = 0;
+  pcb->nodelay = false;
+  if(pcb->fd >= 0)
+    setsockopt(pcb->fd, IPPROTO_TCP, TCP_NODELAY, &zero, sizeof(zero));
+}
+
+bool tcp_nagle_disabled(struct tcp_pcb *pcb){
+  return pcb->nodelay;
+}
+
+struct netif * ip_route(ip_addr_t *dest){
+  //the host routes for us, any non NULL netif will do
+  static char any;
+  return (struct netif *)&any;
+}
+
+err_t dns_gethostbyname(const char *hostname, ip_addr_t *addr, dns_found_callback found, void *callback_arg){
+  struct addrinfo hints;
+  struct addrinfo *res = NULL;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if(getaddrinfo(hostname, NULL, &hints, &res) != 0 || res == NULL)
+    return ERR_ARG;
+  addr->addr = ((struct sockaddr_in *)res->ai_addr)->sin_addr.s_addr;
+  freeaddrinfo(res);
+  return ERR_OK;
+}
+
+// pbufs
+
+uint8_t pbuf_free(struct pbuf *p){
+  uint8_t count = 0;
+  while(p != NULL){
+    if(--p->ref)
+      break;
+    struct pbuf *next = p->next;
+    free(p);
+    count++;
+    p = next;
+  }
+  return count;
+}
+
+void pbuf_ref(struct pbuf *p){
+  if(p)
+    p->ref++;
+}
+
+void pbuf_cat(struct pbuf *head, struct pbuf *tail){
+  if(head == NULL || tail == NULL)
+    return;
+  struct pbuf *p = head;
+  for(; p->next != NULL; p = p->next)
+    p->tot_len += tail->tot_len;
+  p->tot_len += tail->tot_len;
+  p->next = tail;
+}
+
+uint16_t pbuf_copy_partial(struct pbuf *p, void *dataptr, uint16_t len, uint16_t offset){
+  uint16_t copied = 0;
+  for(; p != NULL && copied < len; p = p->next){
+    if(offset >= p->len){
+      offset -= p->len;
+      continue;
+    }
+    uint16_t chunk = p->len - offset;
+    if(chunk > len - copied)
+      chunk = len - copied;
+    memcpy((uint8_t*)dataptr + copied, (uint8_t*)p->payload + offset, chunk);
+    copied += chunk;
+    offset = 0;
+  }
+  return copied;
+}
+
+#endif
@@ -0,0 +1,169 @@
+/*
+  Asynchronous TCP library for Espressif MCUs
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+  This file is part of the esp8266 core for Arduino environment.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*
+  Host backend: the subset of the lwIP raw TCP API used by AsyncClient and
+  AsyncServer, implemented over non-blocking sockets and epoll. Included by
+  the library sources instead of the lwIP headers when ASYNC_TCP_POSIX is set.
+
+  Callbacks are only made from tcp_posix_poll() (plus the error callback of
+  tcp_abort(), as in lwIP), so the async code keeps its single threaded model.
+  Written data is copied into the pcb and counts against snd_buf until it is
+  handed to the kernel, which is reported through the sent callback like an ACK.
+  Received data that has not been tcp_recved() closes the window at TCP_WND.
+  extras/host has a minimal Arduino core and a Makefile to build against it.
+*/
+
+#ifndef ESPASYNCTCPPOSIX_H_
+#define ESPASYNCTCPPOSIX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int8_t err_t;
+
+#define ERR_OK          0
+#define ERR_MEM        -1
+#define ERR_BUF        -2
+#define ERR_TIMEOUT    -3
+#define ERR_RTE        -4
+#define ERR_INPROGRESS -5
+#define ERR_VAL        -6
+#define ERR_WOULDBLOCK -7
+#define ERR_ABRT       -8
+#define ERR_RST        -9
+#define ERR_CLSD       -10
+#define ERR_CONN       -11
+#define ERR_ARG        -12
+#define ERR_USE        -13
+#define ERR_IF         -14
+#define ERR_ISCONN     -15
+
+#define TCP_PRIO_MIN 1
+#define TCP_POSIX_MSS 1460
+
+#ifndef TCP_SND_BUF
+#define TCP_SND_BUF (8 * TCP_POSIX_MSS)
+#endif
+
+#ifndef TCP_WND
+#define TCP_WND (8 * TCP_POSIX_MSS)
+#endif
+
+#ifndef TCP_POSIX_DRAIN_TIME
+#define TCP_POSIX_DRAIN_TIME 2000
+#endif
+
+#define IPADDR_ANY ((uint32_t)0x00000000UL)
+
+typedef struct ip_addr {
+  uint32_t addr;//network byte order
+} ip_addr_t;
+
+struct netif;
+
+struct pbuf {
+  struct pbuf *next;
+  void *payload;
+  uint16_t tot_len;
+  uint16_t len;
+  uint16_t ref;
+};
+
+struct tcp_pcb;
+
+typedef err_t (*tcp_recv_fn)(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
+typedef err_t (*tcp_sent_fn)(void *arg, struct tcp_pcb *tpcb, uint16_t len);
+typedef void  (*tcp_err_fn)(void *arg, err_t err);
+typedef err_t (*tcp_accept_fn)(void *arg, struct tcp_pcb *newpcb, err_t err);
+typedef err_t (*tcp_connected_fn)(void *arg, struct tcp_pcb *tpcb, err_t err);
+typedef err_t (*tcp_poll_fn)(void *arg, struct tcp_pcb *tpcb);
+typedef void  (*dns_found_callback)(const char *name, ip_addr_t *ipaddr, void *callback_arg);
+
+struct tcp_pcb {
+  //fields read by AsyncClient/AsyncServer, same names and numbering as lwIP
+  uint8_t state;
+  uint16_t snd_buf;
+  ip_addr_t local_ip;
+  ip_addr_t remote_ip;
+  uint16_t local_port;
+  uint16_t remote_port;
+
+  int fd;
+  uint32_t events;//registered epoll events
+  bool polled;//fd is in the epoll set
+  bool nodelay;
+  bool closing;//tcp_close() called, free once tx is flushed
+  bool dead;//freed at the end of the current poll
+  bool draining;//closed, reading until the peer closes so unread data does not turn into a reset
+  uint32_t drain_until;
+  err_t err;//deferred error
+  char *tx;
+  size_t tx_off;
+  size_t tx_len;
+  uint32_t tx_done;//handed to the kernel, not yet reported as sent
+  uint32_t rx_unacked;//delivered, not yet tcp_recved()
+  bool queued;
+  struct tcp_pcb *next_queued;
+  struct tcp_pcb *next_dead;//also links draining pcbs
+
+  void *callback_arg;
+  tcp_recv_fn recv;
+  tcp_sent_fn sent;
+  tcp_err_fn errf;
+  tcp_accept_fn accept;
+  tcp_connected_fn connected;
+};
+
+#define tcp_sndbuf(pcb) ((pcb)->snd_buf)
+
+struct tcp_pcb * tcp_new(void);
+void tcp_arg(struct tcp_pcb *pcb, void *arg);
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv);
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent);
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err);
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept);
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, uint8_t interval);
+void tcp_setprio(struct tcp_pcb *pcb, uint8_t prio);
+err_t tcp_bind(struct tcp_pcb *pcb, ip_addr_t *ipaddr, uint16_t port);
+struct tcp_pcb * tcp_listen(struct tcp_pcb *pcb);
+err_t tcp_connect(struct tcp_pcb *pcb, ip_addr_t *ipaddr, uint16_t port, tcp_connected_fn connected);
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, uint16_t len, uint8_t apiflags);
+err_t tcp_output(struct tcp_pcb *pcb);
+void tcp_recved(struct tcp_pcb *pcb, uint16_t len);
+err_t tcp_close(struct tcp_pcb *pcb);
+void tcp_abort(struct tcp_pcb *pcb);
+void tcp_nagle_disable(struct tcp_pcb *pcb);
+void tcp_nagle_enable(struct tcp_pcb *pcb);
+bool tcp_nagle_disabled(struct tcp_pcb *pcb);
+
+struct netif * ip_route(ip_addr_t *dest);
+err_t dns_gethostbyname(const char *hostname, ip_addr_t *addr, dns_found_callback found, void *callback_arg);
+
+uint8_t pbuf_free(struct pbuf *p);
+void pbuf_ref(struct pbuf *p);
+void pbuf_cat(struct pbuf *head, struct pbuf *tail);
+uint16_t pbuf_copy_partial(struct pbuf *p, void *dataptr, uint16_t len, uint16_t offset);
+
+//wait up to timeout ms for socket events and dispatch them, returns the number of handled events
+int tcp_posix_poll(uint32_t timeout);
+
+#endif /* ESPASYNCTCPPOSIX_H_ */
@@ -21,7 +21,14 @@
 #include "SyncClient.h"
 #include "Arduino.h"
 #include "ESPAsyncTCP.h"
-#include "cbuf.h"
+#include "AsyncRingBuffer.h"
+#if ASYNC_TCP_POSIX
+#include "ESPAsyncTCPposix.h"
+#else
+extern "C"{
+  #include "lwip/pbuf.h"
+}
+#endif
 
 
 SyncClient::SyncClient(size_t txBufLen)
@@ -29,28 +36,26 @@ SyncClient::SyncClient(size_t txBufLen)
   , _tx_buffer(NULL)
   , _tx_buffer_size(txBufLen)
   , _rx_buffer(NULL)
+  , _rx_offset(0)
 {}
 
 SyncClient::SyncClient(AsyncClient *client, size_t txBufLen)
   : _client(client)
-  , _tx_buffer(new cbuf(txBufLen))
+  , _tx_buffer(new AsyncRingBuffer(txBufLen, SYNC_CLIENT_TX_MAX_LEN))
   , _tx_buffer_size(txBufLen)
   , _rx_buffer(NULL)
+  , _rx_offset(0)
 {
   _attachCallbacks();
 }
 
 SyncClient::~SyncClient(){
   if(_tx_buffer != NULL){
-    cbuf *b = _tx_buffer;
+    AsyncRingBuffer *b = _tx_buffer;
     _tx_buffer = NULL;
     delete b;
   }
-  while(_rx_buffer != NULL){
-    cbuf *b = _rx_buffer;
-    _rx_buffer = _rx_buffer->next;
-    delete b;
-  }
+  _freeRx();
 }
 
 int SyncClient::connect(IPAddress ip, uint16_t port){
@@ -87,16 +92,12 @@ SyncClient & SyncClient::operator=(const SyncClient &other){
   }
   _tx_buffer_size = other._tx_buffer_size;
   if(_tx_buffer != NULL){
-    cbuf *b = _tx_buffer;
+    AsyncRingBuffer *b = _tx_buffer;
     _tx_buffer = NULL;
     delete b;
   }
-  while(_rx_buffer != NULL){
-    cbuf *b = _rx_buffer;
-    _rx_buffer = b->next;
-    delete b;
-  }
-  _tx_buffer = new cbuf(other._tx_buffer_size);
+  _freeRx();
+  _tx_buffer = new AsyncRingBuffer(other._tx_buffer_size, SYNC_CLIENT_TX_MAX_LEN);
   _client = other._client;
   _attachCallbacks();
   return *this;
@@ -122,34 +123,36 @@ void SyncClient::stop(){
     _client->close(true);
 }
 
+//pending data is added straight from the ring and released there once acked
 size_t SyncClient::_sendBuffer(){
-  size_t available = _tx_buffer->available();
-  if(!connected() || !_client->canSend() || available == 0)
+  if(_tx_buffer == NULL || !connected() || !_client->canSend() || _tx_buffer->pending() == 0)
     return 0;
-  size_t sendable = _client->space();
-  if(sendable < available)
-    available= sendable;
-  char *out = new char[available];
-  _tx_buffer->read(out, available);
-  size_t sent = _client->write(out, available);
-  delete[] out;
-  return sent;
+  return _tx_buffer->send(_client);
 }
 
-void SyncClient::_onData(void *data, size_t len){
-  _client->ackLater();
-  cbuf *b = new cbuf(len+1);
-  if(b != NULL){
-    b->write((const char *)data, len);
-    if(_rx_buffer == NULL)
-      _rx_buffer = b;
-    else {
-      cbuf *p = _rx_buffer;
-      while(p->next != NULL)
-        p = p->next;
-      p->next = b;
-    }
+void SyncClient::_onAck(size_t len){
+  if(_tx_buffer != NULL)
+    _tx_buffer->ack(len);
+  _sendBuffer();
+}
+
+//received pbufs are kept as they are and read from directly, each one is acked once fully read
+void SyncClient::_onPacket(pbuf *pb){
+  if(_rx_buffer == NULL)
+    _rx_buffer = pb;
+  else
+    pbuf_cat(_rx_buffer, pb);
+}
+
+void SyncClient::_freeRx(){
+  if(_rx_buffer != NULL){
+    if(_client != NULL)
+      _client->ackPacket(_rx_buffer);
+    else
+      pbuf_free(_rx_buffer);
+    _rx_buffer = NULL;
   }
+  _rx_offset = 0;
 }
 
 void SyncClient::_onDisconnect(){
@@ -157,31 +160,27 @@ void SyncClient::_onDisconnect(){
     _client = NULL;
   }
   if(_tx_buffer != NULL){
-    cbuf *b = _tx_buffer;
+    AsyncRingBuffer *b = _tx_buffer;
     _tx_buffer = NULL;
     delete b;
   }
-  while(_rx_buffer != NULL){
-    cbuf *b = _rx_buffer;
-    _rx_buffer = b->next;
-    delete b;
-  }
+  _freeRx();
 }
 
 void SyncClient::_onConnect(AsyncClient *c){
   if(_tx_buffer != NULL){
-    cbuf *b = _tx_buffer;
+    AsyncRingBuffer *b = _tx_buffer;
     _tx_buffer = NULL;
     delete b;
   }
-  _tx_buffer = new cbuf(_tx_buffer_size);
+  _tx_buffer = new AsyncRingBuffer(_tx_buffer_size, SYNC_CLIENT_TX_MAX_LEN);
   _attachCallbacks();
 }
 
 void SyncClient::_attachCallbacks(){
-  _client->onAck([](void *obj, AsyncClient* c, size_t len, uint32_t time){ ((SyncClient*)(obj))->_sendBuffer(); }, this);
+  _client->onAck([](void *obj, AsyncClient* c, size_t len, uint32_t time){ ((SyncClient*)(obj))->_onAck(len); }, this);
   _client->onDisconnect([](void *obj, AsyncClient* c){ ((SyncClient*)(obj))->_onDisconnect(); delete c; }, this);
-  _client->onData([](void *obj, AsyncClient* c, void *data, size_t len){ ((SyncClient*)(obj))->_onData(data, len); }, this);
+  _client->onPacket([](void *obj, AsyncClient* c, pbuf *pb){ ((SyncClient*)(obj))->_onPacket(pb); }, this);
   _client->onTimeout([](void *obj, AsyncClient* c, uint32_t time){ c->close(); }, this);
 }
 
@@ -193,52 +192,54 @@ size_t SyncClient::write(const uint8_t *data, size_t len){
   if(_tx_buffer == NULL || !connected()){
     return 0;
   }
-  size_t toWrite = 0;
-  size_t toSend = len;
-  while(_tx_buffer->room() < toSend){
-    toWrite = _tx_buffer->room();
-    _tx_buffer->write((const char*)data, toWrite);
-    while(!_client->canSend() && connected())
-      delay(0);
+  size_t written = 0;
+  while(written < len){
+    written += _tx_buffer->write(data + written, len - written);
     _sendBuffer();
-    toSend -= toWrite;
+    if(written < len){
+      //the ring is at its maximum size, wait for acks to free room
+      while(connected() && _tx_buffer->room() == 0)
+        delay(0);
+      if(!connected())
+        return written;
+    }
   }
-  _tx_buffer->write((const char*)(data+(len - toSend)), toSend);
-  if(_client->canSend() && connected())
-    _sendBuffer();
   return len;
 }
 
 int SyncClient::available(){
   if(_rx_buffer == NULL) return 0;
-  size_t a = 0;
-  cbuf *b = _rx_buffer;
-  while(b != NULL){
-    a += b->available();
-    b = b->next;
-  }
-  return a;
+  return _rx_buffer->tot_len - _rx_offset;
 }
 
 int SyncClient::peek(){
   if(_rx_buffer == NULL) return -1;
-  return _rx_buffer->peek();
+  return ((uint8_t*)_rx_buffer->payload)[_rx_offset];
 }
 
 int SyncClient::read(uint8_t *data, size_t len){
   if(_rx_buffer == NULL) return -1;
 
   size_t readSoFar = 0;
-  while(_rx_buffer != NULL && (len - readSoFar) >= _rx_buffer->available()){
-    cbuf *b = _rx_buffer;
-    _rx_buffer = _rx_buffer->next;
-    size_t toRead = b->available();
-    readSoFar += b->read((char*)(data+readSoFar), toRead);
-    _client->ack(b->size() - 1);
-    delete b;
-  }
-  if(_rx_buffer != NULL && readSoFar < len){
-    readSoFar += _rx_buffer->read((char*)(data+readSoFar), (len - readSoFar));
+  while(_rx_buffer != NULL && readSoFar < len){
+    pbuf *b = _rx_buffer;
+    size_t toRead = b->len - _rx_offset;
+    if(toRead > (len - readSoFar))
+      toRead = len - readSoFar;
+    memcpy(data + readSoFar, (uint8_t*)b->payload + _rx_offset, toRead);
+    readSoFar += toRead;
+    _rx_offset += toRead;
+    if(_rx_offset == b->len){
+      //unlink the consumed pbuf, the rest of the chain keeps its own reference
+      _rx_buffer = b->next;
+      b->next = NULL;
+      b->tot_len = b->len;
+      _rx_offset = 0;
+      if(_client != NULL)
+        _client->ackPacket(b);
+      else
+        pbuf_free(b);
+    }
   }
   return readSoFar;
 }
@@ -253,7 +254,7 @@ int SyncClient::read(){
 void SyncClient::flush(){
   if(_tx_buffer == NULL || !connected())
     return;
-  if(_tx_buffer->available()){
+  if(_tx_buffer->pending()){
     while(!_client->canSend() && connected())
       delay(0);
     _sendBuffer();
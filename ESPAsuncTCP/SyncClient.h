@@ -23,18 +23,27 @@
 #define SYNCCLIENT_H_
 
 #include "Client.h"
-class cbuf;
+class AsyncRingBuffer;
 class AsyncClient;
+struct pbuf;
+
+//the TX ring grows up to this so a full lwIP send window can be in flight
+#ifndef SYNC_CLIENT_TX_MAX_LEN
+#define SYNC_CLIENT_TX_MAX_LEN 5840
+#endif
 
 class SyncClient: public Client {
   private:
     AsyncClient *_client;
-    cbuf *_tx_buffer;
+    AsyncRingBuffer *_tx_buffer;
     size_t _tx_buffer_size;
-    cbuf *_rx_buffer;
+    pbuf *_rx_buffer;
+    size_t _rx_offset;
 
     size_t _sendBuffer();
-    void _onData(void *data, size_t len);
+    void _onAck(size_t len);
+    void _onPacket(pbuf *pb);
+    void _freeRx();
     void _onConnect(AsyncClient *c);
     void _onDisconnect();
     void _attachCallbacks();
@@ -0,0 +1,96 @@
+/*
+ * RxThroughput.ino
+ *
+ * Compares receive throughput of the copying onData() path with the
+ * zero-copy onPacket() path. Port 5001 copies every segment into a heap
+ * buffer (like SyncClient used to), port 5002 checksums the pbuf chain in
+ * place through AsyncPbufView and acks it with ackPacket().
+ *
+ * From a host:
+ *   dd if=/dev/urandom bs=1k count=4096 | nc -q1 <ip> 5001
+ *   dd if=/dev/urandom bs=1k count=4096 | nc -q1 <ip> 5002
+ */
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <ESPAsyncTCP.h>
+
+const char* ssid = "SSID";
+const char* password = "passpasspass";
+
+AsyncServer copyServer(5001);
+AsyncServer packetServer(5002);
+
+struct RxStats {
+  const char * name;
+  uint32_t start;
+  uint32_t bytes;
+  uint32_t calls;
+  uint32_t sum;
+};
+
+RxStats copyStats = { "onData copy", 0, 0, 0, 0 };
+RxStats packetStats = { "onPacket view", 0, 0, 0, 0 };
+
+void report(RxStats *s){
+  uint32_t ms = millis() - s->start;
+  Serial.printf("%s: %u bytes in %u ms, %u KB/s, %u callbacks, sum %08x, heap %u\n",
+    s->name, s->bytes, ms, ms ? s->bytes / ms : 0, s->calls, s->sum, ESP.getFreeHeap());
+}
+
+void begin(RxStats *s){
+  s->start = millis();
+  s->bytes = 0;
+  s->calls = 0;
+  s->sum = 0;
+}
+
+void setup(){
+  Serial.begin(115200);
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(ssid, password);
+  while(WiFi.status() != WL_CONNECTED){
+    delay(100);
+  }
+  Serial.print("IP: ");
+  Serial.println(WiFi.localIP());
+
+  copyServer.onClient([](void *arg, AsyncClient *client){
+    begin(&copyStats);
+    client->onData([](void *arg, AsyncClient *c, void *data, size_t len){
+      uint8_t *copy = (uint8_t*)malloc(len);
+      if(copy == NULL)
+        return;
+      memcpy(copy, data, len);
+      for(size_t i = 0; i < len; i++)
+        copyStats.sum += copy[i];
+      free(copy);
+      copyStats.bytes += len;
+      copyStats.calls++;
+    });
+    client->onDisconnect([](void *arg, AsyncClient *c){ report(&copyStats); delete c; });
+  }, NULL);
+
+  packetServer.onClient([](void *arg, AsyncClient *client){
+    begin(&packetStats);
+    client->onPacket([](void *arg, AsyncClient *c, struct pbuf *pb){
+      AsyncPbufView view(pb);
+      size_t segments = view.segments();
+      for(size_t s = 0; s < segments; s++){
+        size_t len;
+        const uint8_t *data = view.segment(s, &len);
+        for(size_t i = 0; i < len; i++)
+          packetStats.sum += data[i];
+      }
+      packetStats.bytes += view.length();
+      packetStats.calls++;
+      c->ackPacket(pb);
+    });
+    client->onDisconnect([](void *arg, AsyncClient *c){ report(&packetStats); delete c; });
+  }, NULL);
+
+  copyServer.begin();
+  packetServer.begin();
+}
+
+void loop(){}
@@ -0,0 +1,85 @@
+/*
+ * TimerWheelSim.ino
+ *
+ * Drives AsyncTimerWheel with a simulated clock and 1000 idle connections,
+ * each with an RX deadline that is pushed out when "data" arrives, and checks
+ * that no timer fires early or more than two ticks late. Compares the timers
+ * visited per tick with the per-connection poll callbacks of the old scheme.
+ * Does not need WiFi, the wheel only sees the times it is given.
+ */
+
+#include <Arduino.h>
+#include <AsyncTimerWheel.h>
+
+#define CONNECTIONS 1000
+#define RX_TIMEOUT 30000
+#define SIM_STEP 25
+#define SIM_TIME 600000
+
+struct SimConnection {
+  AsyncTimer timer;
+  uint32_t lastPacket;
+  bool open;
+  SimConnection();
+};
+
+AsyncTimerWheel wheel;
+SimConnection * connections;
+uint32_t simNow = 0;
+uint32_t early = 0;
+uint32_t maxLate = 0;
+uint32_t closed = 0;
+
+// like AsyncClient::_onRxTimer(), rearm for the rest of the deadline or close
+void rxTimeout(void * arg, AsyncTimer * timer){
+  SimConnection * c = (SimConnection *)arg;
+  uint32_t idle = simNow - c->lastPacket;
+  if(idle < RX_TIMEOUT){
+    wheel.start(timer, simNow, RX_TIMEOUT - idle);
+    return;
+  }
+  uint32_t late = idle - RX_TIMEOUT;
+  if(late > maxLate)
+    maxLate = late;
+  c->open = false;
+  closed++;
+}
+
+SimConnection::SimConnection() : timer(&rxTimeout, this), lastPacket(0), open(true) {}
+
+void setup(){
+  Serial.begin(115200);
+  connections = new SimConnection[CONNECTIONS];
+  wheel.begin(simNow);
+  for(int i = 0; i < CONNECTIONS; i++)
+    wheel.start(&connections[i].timer, simNow, RX_TIMEOUT);
+
+  uint32_t ticks = 0;
+  uint32_t start = micros();
+  while(simNow < SIM_TIME){
+    simNow += SIM_STEP;
+    // a few connections receive data, only the timestamp changes
+    for(int i = 0; i < 4; i++){
+      SimConnection * c = &connections[random(CONNECTIONS)];
+      if(c->open)
+        c->lastPacket = simNow;
+    }
+    if((simNow % wheel.tick()) == 0){
+      wheel.run(simNow);
+      ticks++;
+    }
+  }
+  uint32_t us = micros() - start;
+
+  for(int i = 0; i < CONNECTIONS; i++){
+    if(!connections[i].open && (connections[i].lastPacket + RX_TIMEOUT) > simNow)
+      early++;
+  }
+
+  Serial.printf("ticks: %u, fired: %u, visited: %u, poll callbacks without wheel: %u\n",
+    ticks, wheel.fired(), wheel.visited(), ticks * CONNECTIONS);
+  Serial.printf("closed: %u, early: %u, max late: %u ms, run time: %u us\n", closed, early, maxLate, us);
+  Serial.println((early == 0 && maxLate <= 2 * wheel.tick()) ? "PASS" : "FAIL");
+}
+
+void loop(){}
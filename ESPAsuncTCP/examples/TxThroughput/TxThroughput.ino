@@ -0,0 +1,113 @@
+/*
+ * TxThroughput.ino
+ *
+ * Bulk send through SyncClient and AsyncTCPbuffer, both backed by the
+ * AsyncRingBuffer TX ring, and report throughput, ring peak and lowest heap.
+ *
+ * On the host:
+ *   nc -l 5001 > /dev/null   (SyncClient)
+ *   nc -l 5002 > /dev/null   (AsyncTCPbuffer)
+ */
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <ESPAsyncTCP.h>
+#include <ESPAsyncTCPbuffer.h>
+#include <SyncClient.h>
+
+const char* ssid = "SSID";
+const char* password = "passpasspass";
+const char* host = "192.168.1.10";
+
+#define TOTAL_BYTES (4 * 1024 * 1024)
+#define CHUNK_SIZE 512
+
+uint8_t chunk[CHUNK_SIZE];
+uint32_t minHeap;
+
+void sampleHeap(){
+  uint32_t heap = ESP.getFreeHeap();
+  if(heap < minHeap)
+    minHeap = heap;
+}
+
+void report(const char * name, uint32_t bytes, uint32_t ms){
+  Serial.printf("%s: %u bytes in %u ms, %u KB/s, min heap %u\n", name, bytes, ms, ms ? bytes / ms : 0, minHeap);
+}
+
+void syncSend(){
+  SyncClient client;
+  if(!client.connect(host, 5001)){
+    Serial.println("SyncClient connect failed");
+    return;
+  }
+  minHeap = ESP.getFreeHeap();
+  uint32_t sent = 0;
+  uint32_t start = millis();
+  while(sent < TOTAL_BYTES && client.connected()){
+    sent += client.write(chunk, CHUNK_SIZE);
+    sampleHeap();
+  }
+  client.flush();
+  report("SyncClient", sent, millis() - start);
+  client.stop();
+}
+
+AsyncTCPbuffer * tcpBuffer = NULL;
+uint32_t asyncSent;
+uint32_t asyncStart;
+bool asyncFull;
+
+void asyncFill(){
+  while(tcpBuffer && !asyncFull && asyncSent < TOTAL_BYTES){
+    size_t w = tcpBuffer->write(chunk, CHUNK_SIZE);
+    asyncSent += w;
+    sampleHeap();
+    if(w < CHUNK_SIZE)
+      break;
+  }
+  if(tcpBuffer && asyncSent >= TOTAL_BYTES && !tcpBuffer->txBuffered()){
+    report("AsyncTCPbuffer", asyncSent, millis() - asyncStart);
+    tcpBuffer->close();
+    tcpBuffer = NULL;
+  }
+}
+
+void asyncSend(){
+  AsyncClient * client = new AsyncClient();
+  client->onConnect([](void *arg, AsyncClient *c){
+    tcpBuffer = new AsyncTCPbuffer(c);
+    // stop writing at 8 KB buffered, resume at 2 KB
+    tcpBuffer->setTxWatermarks(8192, 2048);
+    tcpBuffer->onTxWatermark([](AsyncTCPbuffer * obj, bool full){
+      asyncFull = full;
+    });
+    tcpBuffer->onDisconnect([](AsyncTCPbuffer * obj){
+      tcpBuffer = NULL;
+      return true;
+    });
+    minHeap = ESP.getFreeHeap();
+    asyncSent = 0;
+    asyncFull = false;
+    asyncStart = millis();
+  }, NULL);
+  client->connect(host, 5002);
+}
+
+void setup(){
+  Serial.begin(115200);
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(ssid, password);
+  while(WiFi.status() != WL_CONNECTED){
+    delay(100);
+  }
+  for(size_t i = 0; i < CHUNK_SIZE; i++)
+    chunk[i] = i;
+
+  syncSend();
+  asyncSend();
+}
+
+void loop(){
+  asyncFill();
+}
@@ -0,0 +1,160 @@
+/*
+ * echo_test.cpp
+ *
+ * AsyncServer on the POSIX backend against plain blocking sockets from a
+ * second thread: byte-exact echoes on concurrent connections, and an idle
+ * connection that the RX timeout closes.
+ *
+ * cd extras/host && make test
+ */
+
+#include <Arduino.h>
+#include <ESPAsyncTCP.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define PORT 47001
+#define CLIENTS 16
+#define ECHO_LEN 65536
+#define RX_TIMEOUT 1
+
+#define check(cond, ...) do { if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); exit(1); } } while (0)
+
+/* Server side: what could not be added yet waits for the next ack */
+struct EchoConnection {
+  std::string pending;
+};
+
+static int connections, disconnects;
+
+static void flush(AsyncClient *c, EchoConnection *e){
+  size_t len = e->pending.size();
+  if(len > c->space())
+    len = c->space();
+  if(!len)
+    return;
+  len = c->add(e->pending.data(), len);
+  e->pending.erase(0, len);
+  c->send();
+}
+
+static void onClient(void *arg, AsyncClient *c){
+  EchoConnection *e = new EchoConnection;
+  connections++;
+  c->setRxTimeout(RX_TIMEOUT);
+  c->onData([](void *arg, AsyncClient *c, void *data, size_t len){
+    EchoConnection *e = (EchoConnection *)arg;
+    e->pending.append((const char *)data, len);
+    flush(c, e);
+  }, e);
+  c->onAck([](void *arg, AsyncClient *c, size_t len, uint32_t time){
+    flush(c, (EchoConnection *)arg);
+  }, e);
+  c->onDisconnect([](void *arg, AsyncClient *c){
+    disconnects++;
+    delete (EchoConnection *)arg;
+    delete c;
+  }, e);
+}
+
+/* Client side, plain sockets */
+static std::atomic<int> echoed(0), idle_ms(-1);
+
+static int dial(){
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  sa.sin_port = htons(PORT);
+  if(fd >= 0 && connect(fd, (struct sockaddr *)&sa, sizeof(sa)) != 0){
+    close(fd);
+    fd = -1;
+  }
+  return fd;
+}
+
+static void echoClient(int id){
+  std::string out(ECHO_LEN, 0), in;
+  for(size_t i = 0; i < out.size(); i++)
+    out[i] = (char)(i * 31 + id * 7 + i / 251);
+  int fd = dial();
+  if(fd < 0)
+    return;
+  //in pieces of varying size, reading back in between
+  size_t sent = 0;
+  char buf[4096];
+  while(in.size() < out.size()){
+    if(sent < out.size()){
+      size_t len = 1 + (sent * 13 + id) % 3000;
+      if(len > out.size() - sent)
+        len = out.size() - sent;
+      ssize_t n = send(fd, out.data() + sent, len, 0);
+      if(n <= 0)
+        break;
+      sent += n;
+    }
+    ssize_t n = recv(fd, buf, sizeof(buf), sent < out.size() ? MSG_DONTWAIT : 0);
+    if(n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+      break;
+    if(n > 0)
+      in.append(buf, n);
+  }
+  close(fd);
+  if(in == out)
+    echoed++;
+}
+
+static void idleClient(){
+  int fd = dial();
+  if(fd < 0)
+    return;
+  unsigned long start = millis();
+  char c;
+  if(recv(fd, &c, 1, 0) == 0)
+    idle_ms = millis() - start;
+  close(fd);
+}
+
+int main(int argc, char **argv){
+  AsyncServer server(PORT);
+  server.onClient(onClient, NULL);
+  server.begin();
+
+  std::atomic<bool> done(false);
+  std::thread clients([&done](){
+    std::vector<std::thread> threads;
+    threads.push_back(std::thread(idleClient));
+    for(int i = 0; i < CLIENTS; i++)
+      threads.push_back(std::thread(echoClient, i));
+    for(size_t i = 0; i < threads.size(); i++)
+      threads[i].join();
+    done = true;
+  });
+
+  unsigned long start = millis();
+  while(!done){
+    check(millis() - start < 10000, "timeout, %d of %d echoed", echoed.load(), CLIENTS);
+    asyncTcpLoop();
+  }
+  clients.join();
+  //let the server see the last closes
+  start = millis();
+  while(disconnects < connections && millis() - start < 1000)
+    asyncTcpLoop();
+
+  check(connections == CLIENTS + 1, "%d connections", connections);
+  check(echoed == CLIENTS, "%d of %d echoed", echoed.load(), CLIENTS);
+  printf("PASS echo: %d connections, %d bytes each\n", CLIENTS, ECHO_LEN);
+
+  check(idle_ms >= RX_TIMEOUT * 1000 && idle_ms < RX_TIMEOUT * 1000 + 2 * ASYNC_TIMER_TICK + 100, "idle connection closed after %d ms", idle_ms.load());
+  check(disconnects == connections, "%d of %d disconnected", disconnects, connections);
+  printf("PASS rx timeout: idle connection closed after %d ms\n", idle_ms.load());
+  return 0;
+}
@@ -0,0 +1,232 @@
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+#include <time.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+ESP8266WiFiClass WiFi;
+
+static uint64_t _now_us(){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+unsigned long millis(void){
+  return (unsigned long)(uint32_t)(_now_us() / 1000);
+}
+
+unsigned long micros(void){
+  return (unsigned long)(uint32_t)_now_us();
+}
+
+void delay(unsigned long ms){
+  usleep(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us){
+  usleep(us);
+}
+
+void yield(void){}
+
+long random(long howbig){
+  if(howbig <= 0)
+    return 0;
+  return ::random() % howbig;
+}
+
+long random(long howsmall, long howbig){
+  if(howsmall >= howbig)
+    return howsmall;
+  return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed){
+  srandom(seed);
+}
+
+// HardwareSerial: stdout
+
+size_t HardwareSerial::write(uint8_t c){
+  return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size){
+  return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush(){
+  fflush(stdout);
+}
+
+// Print
+
+size_t Print::write(const uint8_t *buffer, size_t size){
+  size_t n = 0;
+  while(size--)
+    n += write(*buffer++);
+  return n;
+}
+
+size_t Print::printf(const char *format, ...){
+  char buf[64];
+  char *out = buf;
+  va_list arg;
+  va_start(arg, format);
+  int len = vsnprintf(buf, sizeof(buf), format, arg);
+  va_end(arg);
+  if(len < 0)
+    return 0;
+  if((size_t)len >= sizeof(buf)){
+    out = (char *)malloc(len + 1);
+    if(out == NULL)
+      return 0;
+    va_start(arg, format);
+    vsnprintf(out, len + 1, format, arg);
+    va_end(arg);
+  }
+  size_t n = write((const uint8_t *)out, len);
+  if(out != buf)
+    free(out);
+  return n;
+}
+
+size_t Print::print(long n, int base){
+  if(base == 10)
+    return print(String(n));
+  return print((unsigned long)n, base);
+}
+
+size_t Print::print(unsigned long n, int base){
+  return print(String(n, (unsigned char)base));
+}
+
+// Stream
+
+size_t Stream::readBytes(char *buffer, size_t length){
+  size_t count = 0;
+  unsigned long start = millis();
+  while(count < length && millis() - start < _timeout){
+    int c = read();
+    if(c < 0)
+      continue;
+    *buffer++ = (char)c;
+    count++;
+  }
+  return count;
+}
+
+String Stream::readStringUntil(char terminator){
+  String ret;
+  unsigned long start = millis();
+  while(millis() - start < _timeout){
+    int c = read();
+    if(c < 0)
+      continue;
+    if(c == terminator)
+      break;
+    ret += (char)c;
+  }
+  return ret;
+}
+
+// String
+
+static std::string _ultoa(unsigned long value, unsigned char base){
+  char buf[8 * sizeof(value) + 1];
+  char *p = buf + sizeof(buf) - 1;
+  if(base < 2)
+    base = 10;
+  *p = 0;
+  do {
+    unsigned long digit = value % base;
+    *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    value /= base;
+  } while(value);
+  return std::string(p);
+}
+
+static std::string _ltoa(long value, unsigned char base){
+  if(value < 0 && base == 10)
+    return "-" + _ultoa(-(unsigned long)value, base);
+  return _ultoa((unsigned long)value, base);
+}
+
+static std::string _dtoa(double value, unsigned char decimalPlaces){
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+  return std::string(buf);
+}
+
+String::String(unsigned char value, unsigned char base): _s(_ultoa(value, base)){}
+String::String(int value, unsigned char base): _s(_ltoa(value, base)){}
+String::String(unsigned int value, unsigned char base): _s(_ultoa(value, base)){}
+String::String(long value, unsigned char base): _s(_ltoa(value, base)){}
+String::String(unsigned long value, unsigned char base): _s(_ultoa(value, base)){}
+String::String(float value, unsigned char decimalPlaces): _s(_dtoa(value, decimalPlaces)){}
+String::String(double value, unsigned char decimalPlaces): _s(_dtoa(value, decimalPlaces)){}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const {
+  if(bufsize == 0 || buf == NULL)
+    return;
+  if(index >= _s.size()){
+    buf[0] = 0;
+    return;
+  }
+  unsigned int n = _s.size() - index;
+  if(n > bufsize - 1)
+    n = bufsize - 1;
+  memcpy(buf, _s.data() + index, n);
+  buf[n] = 0;
+}
+
+String String::substring(unsigned int left, unsigned int right) const {
+  if(left > right){
+    unsigned int t = left;
+    left = right;
+    right = t;
+  }
+  if(left >= _s.size())
+    return String();
+  if(right > _s.size())
+    right = _s.size();
+  return String(_s.substr(left, right - left));
+}
+
+void String::replace(char find, char replace){
+  for(size_t i = 0; i < _s.size(); i++){
+    if(_s[i] == find)
+      _s[i] = replace;
+  }
+}
+
+void String::replace(const String &find, const String &replace){
+  if(find._s.empty())
+    return;
+  size_t pos = 0;
+  while((pos = _s.find(find._s, pos)) != std::string::npos){
+    _s.replace(pos, find._s.size(), replace._s);
+    pos += replace._s.size();
+  }
+}
+
+void String::toLowerCase(){
+  for(size_t i = 0; i < _s.size(); i++)
+    _s[i] = tolower((unsigned char)_s[i]);
+}
+
+void String::toUpperCase(){
+  for(size_t i = 0; i < _s.size(); i++)
+    _s[i] = toupper((unsigned char)_s[i]);
+}
+
+void String::trim(){
+  size_t begin = _s.find_first_not_of(" \t\r\n\f\v");
+  if(begin == std::string::npos){
+    _s.clear();
+    return;
+  }
+  size_t end = _s.find_last_not_of(" \t\r\n\f\v");
+  _s = _s.substr(begin, end - begin + 1);
+}
@@ -0,0 +1,87 @@
+/*
+  Minimal Arduino core for building ESPAsyncTCP and the libraries on top of
+  it on a Linux host, with the POSIX backend (ESPAsyncTCPposix.cpp).
+  Only what those libraries use is here.
+*/
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define FPSTR(p) ((const __FlashStringHelper *)(p))
+#define F(s) ((const __FlashStringHelper *)(s))
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_byte_near(p) (*(const uint8_t *)(p))
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define memcpy_P memcpy
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+#define vsnprintf_P vsnprintf
+
+#define ICACHE_FLASH_ATTR
+#define ICACHE_RAM_ATTR
+
+#define os_printf printf
+#define os_strlen strlen
+#define os_malloc malloc
+#define os_free free
+#define os_memcpy memcpy
+
+#define RANDOM_REG32 ((uint32_t)random())
+
+#define bit(b) (1UL << (b))
+
+class __FlashStringHelper;
+
+/* Arduino.cpp: CLOCK_MONOTONIC based, delay() sleeps */
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+/* the sketch, main.cpp runs them for .ino builds */
+void setup(void);
+void loop(void);
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "IPAddress.h"
+
+class HardwareSerial: public Stream {
+  public:
+    void begin(unsigned long baud){}
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buffer, size_t size);
+    int available(){ return 0; }
+    int read(){ return -1; }
+    int peek(){ return -1; }
+    void flush();
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+#endif // Arduino_h
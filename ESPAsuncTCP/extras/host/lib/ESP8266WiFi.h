@@ -0,0 +1,14 @@
+#ifndef WiFi_h
+#define WiFi_h
+
+#include "Arduino.h"
+
+/* The host has its own network stack, only the station address is asked for */
+class ESP8266WiFiClass {
+  public:
+    IPAddress localIP(){ return IPAddress(); }
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif // WiFi_h
@@ -0,0 +1,40 @@
+#ifndef FS_H
+#define FS_H
+
+#include "Arduino.h"
+
+/* No file system on the host, every open() fails */
+namespace fs {
+
+class File: public Stream {
+  public:
+    size_t write(uint8_t){ return 0; }
+    size_t write(const uint8_t *buf, size_t size){ return 0; }
+    int available(){ return 0; }
+    int read(){ return -1; }
+    size_t read(uint8_t *buf, size_t size){ return 0; }
+    int peek(){ return -1; }
+    void flush(){}
+    size_t size() const { return 0; }
+    const char *name() const { return ""; }
+    bool isDirectory(){ return false; }
+    void close(){}
+    operator bool() const { return false; }
+    bool operator==(bool value) const { return value == false; }
+    using Print::write;
+};
+
+class FS {
+  public:
+    File open(const String &path, const char *mode){ return File(); }
+    File open(const char *path, const char *mode){ return File(); }
+    bool exists(const String &path){ return false; }
+    bool exists(const char *path){ return false; }
+};
+
+}
+
+using fs::File;
+using fs::FS;
+
+#endif // FS_H
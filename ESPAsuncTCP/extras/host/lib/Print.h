@@ -0,0 +1,29 @@
+#ifndef Print_h
+#define Print_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include "WString.h"
+
+class Print {
+  public:
+    virtual ~Print(){}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str){ return str == NULL ? 0 : write((const uint8_t *)str, strlen(str)); }
+    size_t write(const char *buffer, size_t size){ return write((const uint8_t *)buffer, size); }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char *str){ return write(str); }
+    size_t print(const String &s){ return write(s.c_str(), s.length()); }
+    size_t print(char c){ return write((uint8_t)c); }
+    size_t print(long n, int base = 10);
+    size_t print(unsigned long n, int base = 10);
+    size_t print(int n, int base = 10){ return print((long)n, base); }
+    size_t print(unsigned int n, int base = 10){ return print((unsigned long)n, base); }
+    size_t println(){ return write("\r\n"); }
+    template<typename T> size_t println(const T &value){ return print(value) + println(); }
+    template<typename T> size_t println(const T &value, int base){ return print(value, base) + println(); }
+};
+
+#endif // Print_h
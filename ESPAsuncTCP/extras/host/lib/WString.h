@@ -0,0 +1,98 @@
+#ifndef WString_h
+#define WString_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <string>
+
+class __FlashStringHelper;
+
+/* Arduino String on top of std::string, the methods the libraries use */
+class String {
+  private:
+    std::string _s;
+
+  public:
+    String(const char *cstr = ""): _s(cstr ? cstr : ""){}
+    String(const char *cstr, size_t length): _s(cstr, length){}
+    String(const __FlashStringHelper *str): _s(str ? (const char *)str : ""){}
+    String(const std::string &s): _s(s){}
+    explicit String(char c): _s(1, c){}
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(float value, unsigned char decimalPlaces = 2);
+    explicit String(double value, unsigned char decimalPlaces = 2);
+
+    unsigned int length() const { return _s.size(); }
+    const char *c_str() const { return _s.c_str(); }
+    bool reserve(unsigned int size){ _s.reserve(size); return true; }
+    operator bool() const { return true; }
+
+    String &operator=(const char *cstr){ _s = cstr ? cstr : ""; return *this; }
+
+    bool concat(const String &s){ _s += s._s; return true; }
+    bool concat(const char *cstr){ if(cstr) _s += cstr; return cstr != NULL; }
+    bool concat(const char *cstr, unsigned int length){ _s.append(cstr, length); return true; }
+    bool concat(char c){ _s += c; return true; }
+    bool concat(unsigned char c){ return concat(String(c)); }
+    bool concat(int n){ return concat(String(n)); }
+    bool concat(unsigned int n){ return concat(String(n)); }
+    bool concat(long n){ return concat(String(n)); }
+    bool concat(unsigned long n){ return concat(String(n)); }
+    template<typename T> String &operator+=(const T &v){ concat(v); return *this; }
+
+    int compareTo(const String &s) const { return _s.compare(s._s); }
+    bool equals(const String &s) const { return _s == s._s; }
+    bool equals(const char *cstr) const { return _s == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String &s) const { return _s.size() == s._s.size() && strcasecmp(_s.c_str(), s._s.c_str()) == 0; }
+    bool operator==(const String &s) const { return equals(s); }
+    bool operator==(const char *cstr) const { return equals(cstr); }
+    bool operator!=(const String &s) const { return !equals(s); }
+    bool operator!=(const char *cstr) const { return !equals(cstr); }
+    bool operator<(const String &s) const { return _s < s._s; }
+    bool startsWith(const String &prefix, unsigned int offset = 0) const { return offset <= _s.size() && _s.compare(offset, prefix._s.size(), prefix._s) == 0; }
+    bool endsWith(const String &suffix) const { return _s.size() >= suffix._s.size() && _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0; }
+
+    char charAt(unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+    void setCharAt(unsigned int index, char c){ if(index < _s.size()) _s[index] = c; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char &operator[](unsigned int index){ return _s[index]; }
+    void getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index = 0) const;
+    void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const { getBytes((unsigned char *)buf, bufsize, index); }
+
+    int indexOf(char c, unsigned int from = 0) const { return _pos(_s.find(c, from)); }
+    int indexOf(const String &s, unsigned int from = 0) const { return _pos(_s.find(s._s, from)); }
+    int lastIndexOf(char c) const { return _pos(_s.rfind(c)); }
+    int lastIndexOf(char c, unsigned int from) const { return _pos(_s.rfind(c, from)); }
+    int lastIndexOf(const String &s) const { return _pos(_s.rfind(s._s)); }
+    String substring(unsigned int left) const { return left < _s.size() ? String(_s.substr(left)) : String(); }
+    String substring(unsigned int left, unsigned int right) const;
+
+    void replace(char find, char replace);
+    void replace(const String &find, const String &replace);
+    void remove(unsigned int index){ if(index < _s.size()) _s.erase(index); }
+    void remove(unsigned int index, unsigned int count){ if(index < _s.size()) _s.erase(index, count); }
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const { return atol(_s.c_str()); }
+    float toFloat() const { return atof(_s.c_str()); }
+
+  private:
+    static int _pos(size_t p){ return p == std::string::npos ? -1 : (int)p; }
+};
+
+inline String operator+(const String &a, const String &b){ String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, const char *b){ String r(a); r.concat(b); return r; }
+inline String operator+(const char *a, const String &b){ String r(a); r.concat(b); return r; }
+inline String operator+(const String &a, char b){ String r(a); r.concat(b); return r; }
+template<typename T> String operator+(const String &a, T n){ String r(a); r.concat(n); return r; }
+
+#endif // WString_h
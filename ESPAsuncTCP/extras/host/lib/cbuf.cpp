@@ -0,0 +1,78 @@
+#include "cbuf.h"
+#include <stdlib.h>
+#include <string.h>
+
+cbuf::cbuf(size_t size)
+  : _buf((char *)malloc(size ? size : 1))
+  , _size(_buf ? size : 0)
+  , _begin(0)
+  , _len(0)
+  , next(NULL)
+{}
+
+cbuf::~cbuf(){
+  free(_buf);
+}
+
+size_t cbuf::resize(size_t newSize){
+  if(newSize < _len)
+    return _size;
+  char *buf = (char *)malloc(newSize ? newSize : 1);
+  if(buf == NULL)
+    return _size;
+  peek(buf, _len);
+  free(_buf);
+  _buf = buf;
+  _size = newSize;
+  _begin = 0;
+  return _size;
+}
+
+int cbuf::peek(){
+  if(empty())
+    return -1;
+  return (uint8_t)_buf[_begin];
+}
+
+size_t cbuf::peek(char *dst, size_t size){
+  if(size > _len)
+    size = _len;
+  size_t first = _size - _begin;
+  if(first > size)
+    first = size;
+  memcpy(dst, _buf + _begin, first);
+  memcpy(dst + first, _buf, size - first);
+  return size;
+}
+
+int cbuf::read(){
+  int c = peek();
+  if(c >= 0)
+    remove(1);
+  return c;
+}
+
+size_t cbuf::read(char *dst, size_t size){
+  return remove(peek(dst, size));
+}
+
+size_t cbuf::write(const char *src, size_t size){
+  if(size > room())
+    size = room();
+  size_t end = (_begin + _len) % (_size ? _size : 1);
+  size_t first = _size - end;
+  if(first > size)
+    first = size;
+  memcpy(_buf + end, src, first);
+  memcpy(_buf, src + first, size - first);
+  _len += size;
+  return size;
+}
+
+size_t cbuf::remove(size_t size){
+  if(size > _len)
+    size = _len;
+  _begin = _size ? (_begin + size) % _size : 0;
+  _len -= size;
+  return size;
+}
@@ -0,0 +1,39 @@
+#ifndef __cbuf_h
+#define __cbuf_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Byte FIFO with the interface of the ESP8266 core cbuf */
+class cbuf {
+  private:
+    char *_buf;
+    size_t _size;
+    size_t _begin;
+    size_t _len;
+
+  public:
+    cbuf(size_t size);
+    ~cbuf();
+
+    size_t resizeAdd(size_t addSize){ return resize(_size + addSize); }
+    size_t resize(size_t newSize);
+    size_t available() const { return _len; }
+    size_t size(){ return _size; }
+    size_t room() const { return _size - _len; }
+    bool empty() const { return _len == 0; }
+    bool full() const { return _len == _size; }
+
+    int peek();
+    size_t peek(char *dst, size_t size);
+    int read();
+    size_t read(char *dst, size_t size);
+    size_t write(char c){ return write(&c, 1); }
+    size_t write(const char *src, size_t size);
+    size_t remove(size_t size);
+    void flush(){ _begin = _len = 0; }
+
+    cbuf *next;
+};
+
+#endif // __cbuf_h
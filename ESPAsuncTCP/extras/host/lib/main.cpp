@@ -0,0 +1,8 @@
+#include "Arduino.h"
+
+int main(int argc, char **argv){
+  setup();
+  for(;;)
+    loop();
+  return 0;
+}
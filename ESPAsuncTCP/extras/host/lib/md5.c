@@ -0,0 +1,102 @@
+#include "md5.h"
+#include <string.h>
+
+#define ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static const uint32_t md5_k[64] = {
+  0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+  0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+  0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+  0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+  0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+  0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+  0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+  0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+static const uint8_t md5_r[64] = {
+  7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+  5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+  4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+  6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+static void md5_block(md5_context_t *ctx, const uint8_t *block){
+  uint32_t w[16];
+  uint32_t a = ctx->state[0], b = ctx->state[1], c = ctx->state[2], d = ctx->state[3];
+  int i;
+  for(i = 0; i < 16; i++)
+    w[i] = block[i * 4] | (block[i * 4 + 1] << 8) | (block[i * 4 + 2] << 16) | ((uint32_t)block[i * 4 + 3] << 24);
+  for(i = 0; i < 64; i++){
+    uint32_t f, g;
+    if(i < 16){
+      f = (b & c) | (~b & d);
+      g = i;
+    } else if(i < 32){
+      f = (d & b) | (~d & c);
+      g = (5 * i + 1) & 15;
+    } else if(i < 48){
+      f = b ^ c ^ d;
+      g = (3 * i + 5) & 15;
+    } else {
+      f = c ^ (b | ~d);
+      g = (7 * i) & 15;
+    }
+    f += a + md5_k[i] + w[g];
+    a = d;
+    d = c;
+    c = b;
+    b += ROTL(f, md5_r[i]);
+  }
+  ctx->state[0] += a;
+  ctx->state[1] += b;
+  ctx->state[2] += c;
+  ctx->state[3] += d;
+}
+
+void MD5Init(md5_context_t *ctx){
+  ctx->state[0] = 0x67452301;
+  ctx->state[1] = 0xefcdab89;
+  ctx->state[2] = 0x98badcfe;
+  ctx->state[3] = 0x10325476;
+  ctx->count[0] = ctx->count[1] = 0;
+}
+
+void MD5Update(md5_context_t *ctx, const uint8_t *input, const uint16_t len){
+  uint32_t used = ctx->count[0] & 63;
+  uint16_t i = 0;
+  if((ctx->count[0] += len) < len)
+    ctx->count[1]++;
+  while(i < len){
+    uint32_t n = 64 - used;
+    if(n > (uint32_t)(len - i))
+      n = len - i;
+    memcpy(ctx->buffer + used, input + i, n);
+    used += n;
+    i += n;
+    if(used == 64){
+      md5_block(ctx, ctx->buffer);
+      used = 0;
+    }
+  }
+}
+
+void MD5Final(uint8_t digest[16], md5_context_t *ctx){
+  static const uint8_t pad = 0x80;
+  static const uint8_t zero[64] = { 0 };
+  uint8_t bits[8];
+  uint32_t lo = ctx->count[0] << 3;
+  uint32_t hi = (ctx->count[1] << 3) | (ctx->count[0] >> 29);
+  uint32_t used;
+  int i;
+  for(i = 0; i < 4; i++){
+    bits[i] = lo >> (i * 8);
+    bits[i + 4] = hi >> (i * 8);
+  }
+  MD5Update(ctx, &pad, 1);
+  used = ctx->count[0] & 63;
+  MD5Update(ctx, zero, used <= 56 ? 56 - used : 120 - used);
+  MD5Update(ctx, bits, 8);
+  for(i = 0; i < 16; i++)
+    digest[i] = ctx->state[i / 4] >> ((i % 4) * 8);
+}
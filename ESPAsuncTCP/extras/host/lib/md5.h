@@ -0,0 +1,25 @@
+#ifndef __ESP8266_MD5__
+#define __ESP8266_MD5__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* MD5 (RFC 1321) with the interface of the ESP8266 ROM functions */
+typedef struct {
+  uint32_t state[4];
+  uint32_t count[2];
+  uint8_t buffer[64];
+} md5_context_t;
+
+void MD5Init(md5_context_t *ctx);
+void MD5Update(md5_context_t *ctx, const uint8_t *input, const uint16_t len);
+void MD5Final(uint8_t digest[16], md5_context_t *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * pbuf_test.cpp
+ *
+ * The zero-copy receive path without a network: pbuf chains are built by
+ * hand and handed to AsyncClient through the recv callback of a POSIX
+ * backend pcb, the way tcp_posix_poll() or lwIP deliver them. Covers
+ * AsyncPbufView over chained pbufs, onPacket()/ackPacket(), partial acks
+ * of onData() with ackLater(), and SyncClient reading across pbufs and
+ * acking each one as it is used up.
+ *
+ * cd extras/host && make test
+ */
+
+#include <Arduino.h>
+#include <ESPAsyncTCP.h>
+#include <ESPAsyncTCPposix.h>
+#include <SyncClient.h>
+
+#define check(cond, ...) do { if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); exit(1); } } while (0)
+
+/* Same layout as the backend allocates, pbuf_free() releases it */
+static pbuf *segment(const char *data){
+  uint16_t len = strlen(data);
+  pbuf *p = (pbuf *)malloc(sizeof(pbuf) + len);
+  p->next = NULL;
+  p->payload = p + 1;
+  p->tot_len = p->len = len;
+  p->ref = 1;
+  memcpy(p->payload, data, len);
+  return p;
+}
+
+static pbuf *chain(const char *a, const char *b = NULL, const char *c = NULL){
+  pbuf *p = segment(a);
+  if(b != NULL)
+    pbuf_cat(p, segment(b));
+  if(c != NULL)
+    pbuf_cat(p, segment(c));
+  return p;
+}
+
+/* An established pcb without a socket, the client registers its callbacks on it */
+static tcp_pcb *connection(){
+  tcp_pcb *pcb = tcp_new();
+  pcb->state = 4;
+  return pcb;
+}
+
+/* Counts against the receive window until tcp_recved(), like the backend */
+static void deliver(tcp_pcb *pcb, pbuf *p){
+  pcb->rx_unacked += p->tot_len;
+  pcb->recv(pcb->callback_arg, pcb, p, ERR_OK);
+}
+
+static void testView(){
+  pbuf *p = chain("GET / ", "HTTP/1.1\r", "\nHost: x\r\n");
+  AsyncPbufView v(p);
+  char buf[32];
+  size_t len;
+
+  check(v.length() == 25 && v.segments() == 3, "length %u segments %u", (unsigned)v.length(), (unsigned)v.segments());
+  check(v.segment(1, &len) == (const uint8_t *)p->next->payload && len == 9, "segment 1 len %u", (unsigned)len);
+  check(v.segment(3, &len) == NULL && len == 0, "segment past the end");
+  check(v.at(0) == 'G' && v.at(6) == 'H' && v.at(24) == '\n' && v.at(25) == -1, "at");
+  check(v.indexOf('\r') == 14 && v.indexOf('\n') == 15 && v.indexOf('\r', 15) == 23 && v.indexOf('z') == -1, "indexOf");
+  memset(buf, 0, sizeof(buf));
+  check(v.copy(buf, 10, 4) == 10 && !strcmp(buf, "/ HTTP/1.1"), "copy across segments '%s'", buf);
+
+  //the request line is parsed, the view moves to the headers
+  v.consume(v.indexOf('\n') + 1);
+  check(v.length() == 9 && v.segments() == 1, "consumed length %u segments %u", (unsigned)v.length(), (unsigned)v.segments());
+  check(v.segment(0, &len) == (const uint8_t *)p->next->next->payload + 1 && len == 9, "segment 0 after consume");
+  check(v.at(0) == 'H' && v.indexOf('\r') == 7, "at and indexOf after consume");
+  memset(buf, 0, sizeof(buf));
+  check(v.copy(buf, sizeof(buf)) == 9 && !strcmp(buf, "Host: x\r\n"), "copy after consume");
+  pbuf_free(p);
+  printf("PASS view\n");
+}
+
+static pbuf *kept;
+static int packets;
+
+static void testPacket(){
+  tcp_pcb *pcb = connection();
+  AsyncClient *c = new AsyncClient(pcb);
+  int data = 0;
+  c->onData([](void *arg, AsyncClient *c, void *buf, size_t len){ (*(int *)arg)++; }, &data);
+  c->onPacket([](void *arg, AsyncClient *c, pbuf *p){ packets++; kept = p; }, NULL);
+
+  //the handler owns the whole chain, nothing is acked until ackPacket()
+  pbuf *p = chain("abc", "defgh", "ij");
+  deliver(pcb, p);
+  check(packets == 1 && kept == p && data == 0, "packets %d data %d", packets, data);
+  check(pcb->rx_unacked == 10, "%u unacked", pcb->rx_unacked);
+  check(kept->ref == 1 && kept->next->ref == 1 && kept->tot_len == 10, "chain changed");
+  pbuf *q = chain("klm");
+  deliver(pcb, q);
+  check(packets == 2 && pcb->rx_unacked == 13, "%u unacked", pcb->rx_unacked);
+
+  //in any order, each for its own length
+  c->ackPacket(q);
+  check(pcb->rx_unacked == 10, "%u unacked after the second", pcb->rx_unacked);
+  pbuf_ref(p);
+  c->ackPacket(p);
+  check(pcb->rx_unacked == 0 && p->ref == 1, "%u unacked, ref %u", pcb->rx_unacked, p->ref);
+  pbuf_free(p);
+  c->ackPacket(NULL);
+  delete c;
+  printf("PASS packet: chains kept until ackPacket()\n");
+}
+
+static void testData(){
+  tcp_pcb *pcb = connection();
+  AsyncClient *c = new AsyncClient(pcb);
+  static size_t lens[4];
+  static int calls;
+  calls = 0;
+  //one call per segment, the second one is acked later
+  c->onData([](void *arg, AsyncClient *c, void *buf, size_t len){
+    lens[calls++] = len;
+    if(calls == 2)
+      c->ackLater();
+  }, NULL);
+  deliver(pcb, chain("abc", "defgh", "ij"));
+  check(calls == 3 && lens[0] == 3 && lens[1] == 5 && lens[2] == 2, "%d calls", calls);
+  check(pcb->rx_unacked == 5, "%u unacked", pcb->rx_unacked);
+  check(c->ack(3) == 3 && pcb->rx_unacked == 2, "%u unacked after ack(3)", pcb->rx_unacked);
+  check(c->ack(10) == 2 && pcb->rx_unacked == 0, "%u unacked after ack(10)", pcb->rx_unacked);
+  delete c;
+  printf("PASS data: one call per segment, ackLater() held back\n");
+}
+
+static void testSyncClient(){
+  tcp_pcb *pcb = connection();
+  AsyncClient *c = new AsyncClient(pcb);
+  SyncClient *sync = new SyncClient(c);
+  SyncClient &s = *sync;
+  char buf[32];
+
+  deliver(pcb, chain("Hello", ", pbuf", " world"));
+  deliver(pcb, chain("!\r\n"));
+  check(s.available() == 20, "available %d", s.available());
+  check(s.peek() == 'H' && pcb->rx_unacked == 20, "peek");
+
+  //within the first pbuf, nothing to ack yet
+  memset(buf, 0, sizeof(buf));
+  check(s.read((uint8_t *)buf, 3) == 3 && !strcmp(buf, "Hel"), "read '%s'", buf);
+  check(s.available() == 17 && pcb->rx_unacked == 20, "available %d unacked %u", s.available(), pcb->rx_unacked);
+
+  //across two, the first one is unlinked and acked on its own
+  memset(buf, 0, sizeof(buf));
+  check(s.read((uint8_t *)buf, 5) == 5 && !strcmp(buf, "lo, p"), "read '%s'", buf);
+  check(s.available() == 12 && pcb->rx_unacked == 15, "available %d unacked %u", s.available(), pcb->rx_unacked);
+  check(s.peek() == 'b', "peek after unlink");
+
+  //byte reads up to the end of a pbuf
+  check(s.read() == 'b' && s.read() == 'u' && s.read() == 'f', "read()");
+  check(pcb->rx_unacked == 9, "unacked %u", pcb->rx_unacked);
+
+  //the rest, into the next chain
+  memset(buf, 0, sizeof(buf));
+  check(s.read((uint8_t *)buf, sizeof(buf)) == 9 && !strcmp(buf, " world!\r\n"), "read '%s'", buf);
+  check(s.available() == 0 && s.read() == -1 && pcb->rx_unacked == 0, "available %d unacked %u", s.available(), pcb->rx_unacked);
+
+  //unread data is freed when the connection goes, which also deletes the client
+  deliver(pcb, chain("left", "over"));
+  check(s.read() == 'l' && s.available() == 7, "available %d", s.available());
+  s.stop();
+  check(s.available() == 0 && !s.connected(), "available %d after stop", s.available());
+  delete sync;
+  printf("PASS sync client: pbufs acked as they are read\n");
+}
+
+int main(int argc, char **argv){
+  testView();
+  testPacket();
+  testData();
+  testSyncClient();
+  return 0;
+}
@@ -0,0 +1,232 @@
+/*
+ * timer_wheel_test.cpp
+ *
+ * AsyncTimerWheel on a simulated clock: 1000 timers with deadlines of up
+ * to several laps of the wheel, run() at random steps of the clock. Every
+ * timer fires once, never before its deadline and at most a tick plus a
+ * step after it, in deadline order up to a tick. Covers stop(), moving an
+ * armed timer, re-arming from the handler, handlers stopping timers due in
+ * the same slot, falling behind by more than a lap and the clock wrapping.
+ *
+ * cd extras/host && make test
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <AsyncTimerWheel.h>
+
+#define check(cond, ...) do { if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); exit(1); } } while (0)
+
+#define TIMERS 1000
+#define MAX_DELAY (3 * ASYNC_TIMER_TICK * ASYNC_TIMER_SLOTS)
+#define MAX_STEP 40
+
+struct Entry;
+static void onFire(void *arg, AsyncTimer *timer);
+
+struct Entry {
+  AsyncTimer timer;
+  uint32_t deadline;
+  int fires;
+  int rearm;//times the handler starts it again
+  Entry *other;//stopped by the handler, NULL for none
+
+  Entry() : timer(onFire, this) {}
+};
+
+static AsyncTimerWheel wheel;
+static Entry entries[TIMERS];
+static uint32_t now;
+static uint32_t maxDeadline;
+static int fired;
+static bool ordered;
+static int32_t maxLate;
+
+static uint32_t seed = 12345;
+static uint32_t rnd(uint32_t n){
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) % n;
+}
+
+static void onFire(void *arg, AsyncTimer *timer){
+  Entry *e = (Entry *)arg;
+  int32_t late = (int32_t)(now - e->deadline);
+  check(timer == &e->timer, "timer %p of entry %d", (void *)timer, (int)(e - entries));
+  check(!timer->armed(), "entry %d armed in its handler", (int)(e - entries));
+  check(late >= 0, "entry %d fired %d ms early", (int)(e - entries), -late);
+  check(late < maxLate, "entry %d fired %d ms late", (int)(e - entries), late);
+  if(ordered){
+    if(fired)
+      check((int32_t)(e->deadline - maxDeadline) > -ASYNC_TIMER_TICK, "entry %d due %u fired after one due %u",
+        (int)(e - entries), e->deadline, maxDeadline);
+    if(!fired || (int32_t)(e->deadline - maxDeadline) > 0)
+      maxDeadline = e->deadline;
+  }
+  e->fires++;
+  fired++;
+  if(e->other != NULL)
+    wheel.stop(&e->other->timer);
+  if(e->rearm > 0){
+    e->rearm--;
+    e->deadline = now + rnd(MAX_DELAY);
+    wheel.start(timer, now, e->deadline - now);
+  }
+}
+
+static void reset(uint32_t start){
+  for(int i = 0; i < TIMERS; i++){
+    wheel.stop(&entries[i].timer);
+    entries[i].fires = 0;
+    entries[i].rearm = 0;
+    entries[i].other = NULL;
+  }
+  check(wheel.count() == 0, "%u timers left", (unsigned)wheel.count());
+  now = start;
+  fired = 0;
+  maxLate = ASYNC_TIMER_TICK + MAX_STEP;
+  wheel.begin(now);
+}
+
+static void arm(Entry *e, uint32_t delay){
+  e->deadline = now + delay;
+  wheel.start(&e->timer, now, delay);
+}
+
+/* Steps the clock until every timer fired */
+static void drive(){
+  uint32_t start = now;
+  while(wheel.count()){
+    check(now - start < 10 * MAX_DELAY, "%u timers never fired", (unsigned)wheel.count());
+    now += 1 + rnd(MAX_STEP);
+    wheel.run(now);
+  }
+}
+
+static void testExpiry(uint32_t start){
+  reset(start);
+  ordered = true;
+  for(int i = 0; i < TIMERS; i++)
+    arm(&entries[i], rnd(MAX_DELAY));
+  check(wheel.count() == TIMERS, "%u armed", (unsigned)wheel.count());
+  uint32_t visited = wheel.visited();
+  drive();
+  check(fired == TIMERS, "%d fired", fired);
+  for(int i = 0; i < TIMERS; i++)
+    check(entries[i].fires == 1, "entry %d fired %d times", i, entries[i].fires);
+  //every timer is looked at once per lap it waits, plus the lap it fires in
+  check(wheel.visited() - visited <= TIMERS * (MAX_DELAY / (ASYNC_TIMER_TICK * ASYNC_TIMER_SLOTS) + 1),
+    "%u visits", wheel.visited() - visited);
+  printf("PASS expiry from %u: %d timers, %u visits\n", start, TIMERS, wheel.visited() - visited);
+}
+
+static void testCancel(){
+  int stopped = 0, moved = 0;
+  reset(1000);
+  ordered = true;
+  for(int i = 0; i < TIMERS; i++)
+    arm(&entries[i], rnd(MAX_DELAY));
+  //stop every fifth, move every seventh while it is armed
+  for(int i = 0; i < TIMERS; i++){
+    if(i % 5 == 0){
+      wheel.stop(&entries[i].timer);
+      check(!entries[i].timer.armed(), "entry %d armed after stop()", i);
+      stopped++;
+    } else if(i % 7 == 0){
+      arm(&entries[i], rnd(MAX_DELAY));
+      moved++;
+    }
+  }
+  check(wheel.count() == (size_t)(TIMERS - stopped), "%u armed, %d stopped", (unsigned)wheel.count(), stopped);
+  //stop the rest half way through, from outside the handlers
+  uint32_t half = now + MAX_DELAY / 2;
+  while((int32_t)(now - half) < 0){
+    now += 1 + rnd(MAX_STEP);
+    wheel.run(now);
+  }
+  static bool armed[TIMERS];
+  int late = 0;
+  for(int i = 0; i < TIMERS; i++){
+    armed[i] = entries[i].timer.armed();
+    if(armed[i]){
+      check((int32_t)(entries[i].deadline - now) > -maxLate, "entry %d overdue", i);
+      wheel.stop(&entries[i].timer);
+      late++;
+    }
+  }
+  check(wheel.count() == 0, "%u armed", (unsigned)wheel.count());
+  check(fired + late + stopped == TIMERS, "%d fired, %d stopped late, %d stopped", fired, late, stopped);
+  for(int i = 0; i < TIMERS; i++)
+    check(entries[i].fires == (i % 5 != 0 && !armed[i]), "entry %d fired %d times", i, entries[i].fires);
+  for(int i = 0; i < 1000; i++){
+    now += 1 + rnd(MAX_STEP);
+    wheel.run(now);
+  }
+  check(fired + late + stopped == TIMERS, "%d fired after stop()", fired + late + stopped - TIMERS);
+  printf("PASS cancel: %d stopped, %d moved, %d stopped half way\n", stopped, moved, late);
+}
+
+static void testRearm(){
+  int rounds = 0;
+  reset(5000);
+  ordered = false;//the handlers start timers with deadlines before the ones already fired
+  for(int i = 0; i < TIMERS; i++){
+    entries[i].rearm = i % 3;
+    rounds += 1 + i % 3;
+    arm(&entries[i], rnd(MAX_DELAY));
+  }
+  //pairs due at the same time stop each other, only the first to run fires
+  int pairs = 0;
+  for(int i = 0; i + 1 < TIMERS; i += 50){
+    entries[i].rearm = entries[i + 1].rearm = 0;
+    rounds -= 1 + i % 3 + 1 + (i + 1) % 3;
+    entries[i].other = &entries[i + 1];
+    entries[i + 1].other = &entries[i];
+    arm(&entries[i + 1], entries[i].deadline - now);
+    pairs++;
+  }
+  drive();
+  check(fired == rounds + pairs, "%d fired, not %d", fired, rounds + pairs);
+  for(int i = 0; i < TIMERS; i++){
+    if(entries[i].other != NULL)
+      check(entries[i].fires + entries[i].other->fires == 1, "pair of %d fired %d times", i, entries[i].fires + entries[i].other->fires);
+    else
+      check(entries[i].fires == 1 + i % 3, "entry %d fired %d times", i, entries[i].fires);
+  }
+  printf("PASS re-arm: %d fired, %d pairs stopped in the same slot\n", fired, pairs);
+}
+
+/* run() after more than a lap fires everything due and keeps the rest */
+static void testBehind(){
+  reset(0xfffff000);//wraps during the test
+  ordered = false;
+  maxLate = MAX_DELAY;
+  for(int i = 0; i < TIMERS; i++)
+    arm(&entries[i], rnd(MAX_DELAY));
+  now += MAX_DELAY / 2;
+  wheel.run(now);
+  int due = 0;
+  for(int i = 0; i < TIMERS; i++){
+    bool past = (int32_t)(entries[i].deadline - now) <= 0;
+    check(entries[i].fires == past, "entry %d due in %d ms fired %d times", i, (int32_t)(entries[i].deadline - now), entries[i].fires);
+    check(entries[i].timer.armed() == !past, "entry %d armed", i);
+    due += past;
+  }
+  check(fired == due, "%d fired, %d due", fired, due);
+  //the wheel is aligned again, the rest is on time
+  ordered = true;
+  maxLate = ASYNC_TIMER_TICK + MAX_STEP;
+  fired = 0;
+  maxDeadline = now;
+  drive();
+  check(fired == TIMERS - due, "%d fired, not %d", fired, TIMERS - due);
+  printf("PASS behind: %d fired by one run() %u ms late, %d after\n", due, MAX_DELAY / 2, fired);
+}
+
+int main(int argc, char **argv){
+  testExpiry(0);
+  testExpiry(0xffffffff - MAX_DELAY / 2);
+  testCancel();
+  testRearm();
+  testBehind();
+  return 0;
+}
@@ -20,88 +20,93 @@
 #include "Arduino.h"
 #include "AsyncEventSource.h"
 
-static String generateEventMessage(const char *message, const char *event, uint32_t id, uint32_t reconnect){
-  String ev = "";
+static size_t putEventField(char *out, size_t pos, const char *data, size_t len){
+  if(out != NULL)
+    memcpy(out + pos, data, len);
+  return pos + len;
+}
 
-  if(reconnect){
-    ev += "retry: ";
-    ev += String(reconnect);
-    ev += "\r\n";
-  }
+static size_t putEventNumber(char *out, size_t pos, const char *field, uint32_t value){
+  char num[11];
+  size_t len = snprintf(num, sizeof(num), "%lu", (unsigned long)value);
+  pos = putEventField(out, pos, field, strlen(field));
+  pos = putEventField(out, pos, num, len);
+  return putEventField(out, pos, "\r\n", 2);
+}
 
-  if(id){
-    ev += "id: ";
-    ev += String(id);
-    ev += "\r\n";
-  }
+//encodes the event into out and returns its length. With out == NULL only the length is computed
+static size_t encodeEventMessage(char *out, const char *message, const char *event, uint32_t id, uint32_t reconnect){
+  size_t pos = 0;
+
+  if(reconnect)
+    pos = putEventNumber(out, pos, "retry: ", reconnect);
+
+  if(id)
+    pos = putEventNumber(out, pos, "id: ", id);
 
   if(event != NULL){
-    ev += "event: ";
-    ev += String(event);
-    ev += "\r\n";
+    pos = putEventField(out, pos, "event: ", 7);
+    pos = putEventField(out, pos, event, strlen(event));
+    pos = putEventField(out, pos, "\r\n", 2);
   }
 
   if(message != NULL){
-    size_t messageLen = strlen(message);
-    char * lineStart = (char *)message;
-    char * lineEnd;
+    //every line (terminated by \r\n, \r or \n) becomes its own data field
+    const char * lineStart = message;
+    const char * messageEnd = message + strlen(message);
     do {
-      char * nextN = strchr(lineStart, '\n');
-      char * nextR = strchr(lineStart, '\r');
-      if(nextN == NULL && nextR == NULL){
-        size_t llen = ((char *)message + messageLen) - lineStart;
-        char * ldata = (char *)malloc(llen+1);
-        if(ldata != NULL){
-          memcpy(ldata, lineStart, llen);
-          ldata[llen] = 0;
-          ev += "data: ";
-          ev += ldata;
-          ev += "\r\n\r\n";
-          free(ldata);
-        }
-        lineStart = (char *)message + messageLen;
-      } else {
-        char * nextLine = NULL;
-        if(nextN != NULL && nextR != NULL){
-          if(nextR < nextN){
-            lineEnd = nextR;
-            if(nextN == (nextR + 1))
-              nextLine = nextN + 1;
-            else
-              nextLine = nextR + 1;
-          } else {
-            lineEnd = nextN;
-            if(nextR == (nextN + 1))
-              nextLine = nextR + 1;
-            else
-              nextLine = nextN + 1;
-          }
-        } else if(nextN != NULL){
-          lineEnd = nextN;
-          nextLine = nextN + 1;
-        } else {
-          lineEnd = nextR;
-          nextLine = nextR + 1;
-        }
-
-        size_t llen = lineEnd - lineStart;
-        char * ldata = (char *)malloc(llen+1);
-        if(ldata != NULL){
-          memcpy(ldata, lineStart, llen);
-          ldata[llen] = 0;
-          ev += "data: ";
-          ev += ldata;
-          ev += "\r\n";
-          free(ldata);
-        }
-        lineStart = nextLine;
-        if(lineStart == ((char *)message + messageLen))
-          ev += "\r\n";
+      const char * lineEnd = lineStart;
+      while(lineEnd < messageEnd && *lineEnd != '\r' && *lineEnd != '\n') lineEnd++;
+      pos = putEventField(out, pos, "data: ", 6);
+      pos = putEventField(out, pos, lineStart, lineEnd - lineStart);
+      pos = putEventField(out, pos, "\r\n", 2);
+      if(lineEnd < messageEnd){
+        if(*lineEnd == '\r' && (lineEnd + 1) < messageEnd && lineEnd[1] == '\n')
+          lineEnd++;
+        lineEnd++;
       }
-    } while(lineStart < ((char *)message + messageLen));
+      lineStart = lineEnd;
+    } while(lineStart < messageEnd);
+    pos = putEventField(out, pos, "\r\n", 2);
   }
 
-  return ev;
+  return pos;
+}
+
+// Message
+
+AsyncEventSourceMessage::AsyncEventSourceMessage(const char * data, size_t len, uint32_t id)
+  : _data(NULL)
+  , _len(0)
+  , _id(id)
+  , _refs(1)
+{
+  _data = (uint8_t*)malloc(len+1);
+  if(_data != NULL){
+    memcpy(_data, data, len);
+    _data[len] = 0;
+    _len = len;
+  }
+}
+
+AsyncEventSourceMessage::AsyncEventSourceMessage(const char *message, const char *event, uint32_t id, uint32_t reconnect)
+  : _data(NULL)
+  , _len(0)
+  , _id(id)
+  , _refs(1)
+{
+  size_t len = encodeEventMessage(NULL, message, event, id, reconnect);
+  _data = (uint8_t*)malloc(len+1);
+  if(_data != NULL){
+    encodeEventMessage((char *)_data, message, event, id, reconnect);
+    _data[len] = 0;
+    _len = len;
+  }
+}
+
+AsyncEventSourceMessage::~AsyncEventSourceMessage(){
+  if(_data != NULL)
+    free(_data);
 }
 
 // Client
@@ -110,13 +115,15 @@ AsyncEventSourceClient::AsyncEventSourceClient(AsyncWebServerRequest *request, A
   _client = request->client();
   _server = server;
   _lastId = 0;
+  _messageQueue = NULL;
+  _queueLength = 0;
   next = NULL;
   if(request->hasHeader("Last-Event-ID"))
     _lastId = atoi(request->getHeader("Last-Event-ID")->value().c_str());
 
   _client->onError(NULL, NULL);
-  _client->onAck(NULL, NULL);
-  _client->onPoll(NULL, NULL);
+  _client->onAck([](void *r, AsyncClient* c, size_t len, uint32_t time){ ((AsyncEventSourceClient*)(r))->_onAck(len, time); }, this);
+  _client->onPoll([](void *r, AsyncClient* c){ ((AsyncEventSourceClient*)(r))->_onPoll(); }, this);
   _client->onData(NULL, NULL);
   _client->onTimeout([](void *r, AsyncClient* c, uint32_t time){ ((AsyncEventSourceClient*)(r))->_onTimeout(time); }, this);
   _client->onDisconnect([](void *r, AsyncClient* c){ ((AsyncEventSourceClient*)(r))->_onDisconnect(); delete c; }, this);
@@ -125,9 +132,79 @@ AsyncEventSourceClient::AsyncEventSourceClient(AsyncWebServerRequest *request, A
 }
 
 AsyncEventSourceClient::~AsyncEventSourceClient(){
+  while(_messageQueue != NULL){
+    QueueItem * i = _messageQueue;
+    _messageQueue = _messageQueue->next;
+    delete i;
+  }
   close();
 }
 
+bool AsyncEventSourceClient::_queueMessage(AsyncEventSourceMessage *message){
+  if(message == NULL || !message->valid() || !connected())
+    return false;
+  if(_queueLength >= SSE_MAX_QUEUED_MESSAGES)
+    return false;
+  QueueItem * item = new QueueItem(message);
+  if(_messageQueue == NULL){
+    _messageQueue = item;
+  } else {
+    QueueItem * i = _messageQueue;
+    while(i->next != NULL) i = i->next;
+    i->next = item;
+  }
+  _queueLength++;
+  _runQueue();
+  return true;
+}
+
+//queue items stay alive until their bytes are acked, lwIP may still reference the shared buffer
+void AsyncEventSourceClient::_runQueue(){
+  if(_client == NULL || !_client->canSend())
+    return;
+  bool added = false;
+  QueueItem * i = _messageQueue;
+  while(i != NULL){
+    size_t len = i->message->length();
+    if(i->sent < len){
+      size_t sent = _client->add((const char *)i->message->data() + i->sent, len - i->sent);
+      if(sent == 0)
+        break;
+      added = true;
+      i->sent += sent;
+      if(i->sent < len)
+        break;
+    }
+    i = i->next;
+  }
+  if(added)
+    _client->send();
+}
+
+void AsyncEventSourceClient::_onAck(size_t len, uint32_t time){
+  while(len && _messageQueue != NULL){
+    QueueItem * i = _messageQueue;
+    size_t pending = i->sent - i->acked;
+    if(len < pending){
+      i->acked += len;
+      break;
+    }
+    len -= pending;
+    i->acked = i->sent;
+    if(i->acked < i->message->length())
+      break;
+    _messageQueue = i->next;
+    _queueLength--;
+    delete i;
+  }
+  _runQueue();
+}
+
+void AsyncEventSourceClient::_onPoll(){
+  if(_messageQueue != NULL)
+    _runQueue();
+}
+
 void AsyncEventSourceClient::_onTimeout(uint32_t time){
   _client->close(true);
 }
@@ -143,18 +220,15 @@ void AsyncEventSourceClient::close(){
 }
 
 void AsyncEventSourceClient::write(const char * message, size_t len){
-  if(!_client->canSend()){
-    return;
-  }
-  if(_client->space() < len){
-    return;
-  }
-  _client->write(message, len);
+  AsyncEventSourceMessage * m = new AsyncEventSourceMessage(message, len);
+  _queueMessage(m);
+  m->release();
 }
 
 void AsyncEventSourceClient::send(const char *message, const char *event, uint32_t id, uint32_t reconnect){
-  String ev = generateEventMessage(message, event, id, reconnect);
-  write(ev.c_str(), ev.length());
+  AsyncEventSourceMessage * m = new AsyncEventSourceMessage(message, event, id, reconnect);
+  _queueMessage(m);
+  m->release();
 }
 
 
@@ -164,12 +238,53 @@ AsyncEventSource::AsyncEventSource(String url)
   : _url(url)
   , _clients(NULL)
   , _connectcb(NULL)
+#if SSE_REPLAY_BUFFER_SIZE > 0
+  , _replayHead(0)
+  , _replayCount(0)
+#endif
 {}
 
 AsyncEventSource::~AsyncEventSource(){
   close();
+#if SSE_REPLAY_BUFFER_SIZE > 0
+  while(_replayCount){
+    _replayHead = (_replayHead + SSE_REPLAY_BUFFER_SIZE - 1) % SSE_REPLAY_BUFFER_SIZE;
+    _replay[_replayHead]->release();
+    _replayCount--;
+  }
+#endif
+}
+
+#if SSE_REPLAY_BUFFER_SIZE > 0
+void AsyncEventSource::_storeReplay(AsyncEventSourceMessage *message){
+  if(_replayCount == SSE_REPLAY_BUFFER_SIZE)
+    _replay[_replayHead]->release();
+  else
+    _replayCount++;
+  _replay[_replayHead] = message->retain();
+  _replayHead = (_replayHead + 1) % SSE_REPLAY_BUFFER_SIZE;
 }
 
+//queue the events the client missed: everything after lastId if it is still in the ring,
+//otherwise every stored event with a newer id
+void AsyncEventSource::_sendReplay(AsyncEventSourceClient *client, uint32_t lastId){
+  size_t first = (_replayHead + SSE_REPLAY_BUFFER_SIZE - _replayCount) % SSE_REPLAY_BUFFER_SIZE;
+  size_t start = 0;
+  bool found = false;
+  for(size_t i = 0; i < _replayCount; i++){
+    if(_replay[(first + i) % SSE_REPLAY_BUFFER_SIZE]->id() == lastId){
+      start = i + 1;
+      found = true;
+    }
+  }
+  for(size_t i = start; i < _replayCount; i++){
+    AsyncEventSourceMessage * m = _replay[(first + i) % SSE_REPLAY_BUFFER_SIZE];
+    if(found || m->id() > lastId)
+      client->_queueMessage(m);
+  }
+}
+#endif
+
 void AsyncEventSource::onConnect(ArEventHandlerFunction cb){
   _connectcb = cb;
 }
@@ -189,13 +304,15 @@ void AsyncEventSource::_addClient(AsyncEventSourceClient * client){
   }*/
   if(_clients == NULL){
     _clients = client;
-    if(_connectcb)
-      _connectcb(client);
-    return;
+  } else {
+    AsyncEventSourceClient * c = _clients;
+    while(c->next != NULL) c = c->next;
+    c->next = client;
   }
-  AsyncEventSourceClient * c = _clients;
-  while(c->next != NULL) c = c->next;
-  c->next = client;
+#if SSE_REPLAY_BUFFER_SIZE > 0
+  if(client->lastId())
+    _sendReplay(client, client->lastId());
+#endif
   if(_connectcb)
     _connectcb(client);
 }
@@ -228,16 +345,35 @@ void AsyncEventSource::close(){
 }
 
 void AsyncEventSource::send(const char *message, const char *event, uint32_t id, uint32_t reconnect){
+#if SSE_REPLAY_BUFFER_SIZE > 0
+  if(_clients == NULL && !id)
+    return;
+#else
   if(_clients == NULL)
     return;
+#endif
+  send(new AsyncEventSourceMessage(message, event, id, reconnect));
+}
 
-  String ev = generateEventMessage(message, event, id, reconnect);
+//the event is encoded once and every client queues a reference to the same buffer
+void AsyncEventSource::send(AsyncEventSourceMessage *message){
+  if(message == NULL)
+    return;
+  if(!message->valid()){
+    message->release();
+    return;
+  }
+#if SSE_REPLAY_BUFFER_SIZE > 0
+  if(message->id())
+    _storeReplay(message);
+#endif
   AsyncEventSourceClient * c = _clients;
   while(c != NULL){
     if(c->connected())
-      c->write(ev.c_str(), ev.length());
+      c->_queueMessage(message);
     c = c->next;
   }
+  message->release();
 }
 
 size_t AsyncEventSource::count(){
@@ -273,15 +409,19 @@ AsyncEventSourceResponse::AsyncEventSourceResponse(AsyncEventSource *server){
   addHeader("Connection","keep-alive");
 }
 
+//the header stays in _content until it is acked, lwIP sends from it without copying
 void AsyncEventSourceResponse::_respond(AsyncWebServerRequest *request){
-  String out = _assembleHead(request->version());
-  request->client()->write(out.c_str(), _headLength);
+  _content = _assembleHead(request->version());
+  _sentLength = request->client()->write(_content.c_str(), _headLength);
   _state = RESPONSE_WAIT_ACK;
 }
 
+//the client takes over the connection once the whole header is acked, so its acks count only events
 size_t AsyncEventSourceResponse::_ack(AsyncWebServerRequest *request, size_t len, uint32_t time){
-  if(len){
+  _ackedLength += len;
+  if(_sentLength < _headLength)
+    _sentLength += request->client()->write(_content.c_str() + _sentLength, _headLength - _sentLength);
+  if(_headLength && _ackedLength >= _headLength)
     new AsyncEventSourceClient(request, _server);
-  }
   return 0;
 }
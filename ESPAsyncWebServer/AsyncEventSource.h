@@ -24,16 +24,65 @@
 #include <ESPAsyncTCP.h>
 #include <ESPAsyncWebServer.h>
 
+//number of id-tagged events kept for Last-Event-ID replay (0 disables replay)
+#ifndef SSE_REPLAY_BUFFER_SIZE
+#define SSE_REPLAY_BUFFER_SIZE 8
+#endif
+
+//number of encoded events a client may have waiting for TCP space before new ones are dropped
+#ifndef SSE_MAX_QUEUED_MESSAGES
+#define SSE_MAX_QUEUED_MESSAGES 8
+#endif
+
 class AsyncEventSource;
 class AsyncEventSourceResponse;
 class AsyncEventSourceClient;
 typedef std::function<void(AsyncEventSourceClient *client)> ArEventHandlerFunction;
 
+/*
+ * MESSAGE :: Encoded event text, shared by reference between all clients it is queued on
+ * */
+
+class AsyncEventSourceMessage {
+  private:
+    uint8_t * _data;
+    size_t _len;
+    uint32_t _id;
+    uint16_t _refs;
+
+  public:
+    AsyncEventSourceMessage(const char * data, size_t len, uint32_t id=0);
+    AsyncEventSourceMessage(const char *message, const char *event, uint32_t id, uint32_t reconnect);
+    ~AsyncEventSourceMessage();
+
+    const uint8_t * data(){ return _data; }
+    size_t length(){ return _len; }
+    uint32_t id(){ return _id; }
+    bool valid(){ return _data != NULL; }
+
+    AsyncEventSourceMessage * retain(){ _refs++; return this; }
+    void release(){ if(--_refs == 0) delete this; }
+};
+
 class AsyncEventSourceClient {
   private:
+    class QueueItem {
+      public:
+        AsyncEventSourceMessage * message;
+        size_t sent;
+        size_t acked;
+        QueueItem * next;
+        QueueItem(AsyncEventSourceMessage * m):message(m->retain()), sent(0), acked(0), next(NULL){}
+        ~QueueItem(){ message->release(); }
+    };
+
     AsyncClient *_client;
     AsyncEventSource *_server;
     uint32_t _lastId;
+    QueueItem * _messageQueue;
+    size_t _queueLength;
+
+    void _runQueue();
 
   public:
     AsyncEventSourceClient * next;
@@ -47,8 +96,12 @@ class AsyncEventSourceClient {
     void send(const char *message, const char *event=NULL, uint32_t id=0, uint32_t reconnect=0);
     bool connected(){ return (_client != NULL) && _client->connected(); }
     uint32_t lastId(){ return _lastId; }
+    size_t queueLength(){ return _queueLength; }
 
     //system callbacks (do not call)
+    bool _queueMessage(AsyncEventSourceMessage *message);
+    void _onAck(size_t len, uint32_t time);
+    void _onPoll();
     void _onTimeout(uint32_t time);
     void _onDisconnect();
 };
@@ -58,6 +111,14 @@ class AsyncEventSource: public AsyncWebHandler {
     String _url;
     AsyncEventSourceClient * _clients;
     ArEventHandlerFunction _connectcb;
+#if SSE_REPLAY_BUFFER_SIZE > 0
+    AsyncEventSourceMessage * _replay[SSE_REPLAY_BUFFER_SIZE];
+    size_t _replayHead;
+    size_t _replayCount;
+
+    void _storeReplay(AsyncEventSourceMessage *message);
+    void _sendReplay(AsyncEventSourceClient *client, uint32_t lastId);
+#endif
   public:
     AsyncEventSource(String url);
     ~AsyncEventSource();
@@ -66,6 +127,7 @@ class AsyncEventSource: public AsyncWebHandler {
     void close();
     void onConnect(ArEventHandlerFunction cb);
     void send(const char *message, const char *event=NULL, uint32_t id=0, uint32_t reconnect=0);
+    void send(AsyncEventSourceMessage *message); //queue an already encoded event on every client
     size_t count(); //number clinets connected
 
     //system callbacks (do not call)
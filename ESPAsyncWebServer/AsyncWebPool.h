@@ -0,0 +1,94 @@
+/*
+  Asynchronous WebServer library for Espressif MCUs
+
+  Copyright (c) 2016 Hristo Gochkov. All rights reserved.
+  This file is part of the esp8266 core for Arduino environment.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef ASYNCWEBPOOL_H_
+#define ASYNCWEBPOOL_H_
+
+#include "stddef.h"
+#include "stdint.h"
+#include "stdlib.h"
+
+/*
+ * POOL :: Fixed number of equally sized blocks taken from the heap once, so that
+ * connection bursts reuse the same memory instead of fragmenting the heap.
+ * Requests that do not fit (too big or pool exhausted) fall back to malloc.
+ * */
+
+class AsyncWebPool {
+  private:
+    uint8_t *_blocks;
+    size_t _blockSize;
+    uint8_t _count;
+    uint32_t _free;
+    uint32_t _hits;
+    uint32_t _misses;
+
+  public:
+    AsyncWebPool(size_t blockSize, uint8_t count)
+      :_blocks(NULL)
+      ,_blockSize((blockSize + 3) & ~3)
+      ,_count((count > 32)?32:count)
+      ,_free(0)
+      ,_hits(0)
+      ,_misses(0)
+    {}
+    ~AsyncWebPool(){
+      if(_blocks != NULL)
+        free(_blocks);
+    }
+    void *alloc(size_t size){
+      if(_blocks == NULL && _count){
+        _blocks = (uint8_t*)malloc(_blockSize * _count);
+        if(_blocks != NULL)
+          _free = (_count == 32)?0xFFFFFFFF:((1UL << _count) - 1);
+        else
+          _count = 0;
+      }
+      if(size <= _blockSize && _free){
+        uint8_t i = 0;
+        while(!(_free & (1UL << i))) i++;
+        _free &= ~(1UL << i);
+        _hits++;
+        return _blocks + (i * _blockSize);
+      }
+      _misses++;
+      return malloc(size);
+    }
+    void release(void *ptr){
+      uint8_t *p = (uint8_t*)ptr;
+      if(_blocks != NULL && p >= _blocks && p < (_blocks + (_blockSize * _count))){
+        _free |= 1UL << ((p - _blocks) / _blockSize);
+        return;
+      }
+      free(ptr);
+    }
+    size_t blockSize(){ return _blockSize; }
+    uint8_t count(){ return _count; }
+    uint8_t available(){
+      uint8_t n = 0;
+      uint32_t f = _free;
+      while(f){ n += f & 1; f >>= 1; }
+      return n;
+    }
+    uint32_t hits(){ return _hits; }
+    uint32_t misses(){ return _misses; }
+};
+
+#endif /* ASYNCWEBPOOL_H_ */
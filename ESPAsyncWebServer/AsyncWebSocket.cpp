@@ -21,24 +21,7 @@
 #include "Arduino.h"
 #include "AsyncWebSocket.h"
 
-#include <libb64/cencode.h>
-
-#ifndef ESP8266
-extern "C" {
-typedef struct {
-    uint32_t state[5];
-    uint32_t count[2];
-    unsigned char buffer[64];
-} SHA1_CTX;
-
-void SHA1Transform(uint32_t state[5], const unsigned char buffer[64]);
-void SHA1Init(SHA1_CTX* context);
-void SHA1Update(SHA1_CTX* context, const unsigned char* data, uint32_t len);
-void SHA1Final(unsigned char digest[20], SHA1_CTX* context);
-}
-#else
-#include <Hash.h>
-#endif
+#include <wshandshake.h>
 
 
 size_t webSocketSendFrameWindow(AsyncClient *client){
@@ -50,7 +33,7 @@ size_t webSocketSendFrameWindow(AsyncClient *client){
   return space - 8;
 }
 
-size_t webSocketSendFrame(AsyncClient *client, bool final, uint8_t opcode, bool mask, uint8_t *data, size_t len){
+size_t webSocketSendFrame(AsyncClient *client, bool final, uint8_t opcode, bool mask, uint8_t *data, size_t len, bool compressed=false){
   if(!client->canSend())
     return 0;
   size_t space = client->space();
@@ -82,6 +65,8 @@ size_t webSocketSendFrame(AsyncClient *client, bool final, uint8_t opcode, bool
   buf[0] = opcode & 0x0F;
   if(final)
     buf[0] |= 0x80;
+  if(compressed)
+    buf[0] |= 0x40;
   if(len < 126)
     buf[1] = len & 0x7F;
   else {
@@ -175,13 +160,15 @@ class AsyncWebSocketBasicMessage: public AsyncWebSocketMessage {
     size_t _sent;
     size_t _ack;
     size_t _acked;
+    bool _compressed;
 
   public:
-    AsyncWebSocketBasicMessage(const char * data, size_t len, uint8_t opcode=WS_TEXT, bool mask=false)
+    AsyncWebSocketBasicMessage(const char * data, size_t len, uint8_t opcode=WS_TEXT, bool mask=false, bool compressed=false)
       :_len(len)
       ,_sent(0)
       ,_ack(0)
       ,_acked(0)
+      ,_compressed(compressed)
     {
       _opcode = opcode & 0x07;
       _mask = mask;
@@ -221,7 +208,8 @@ class AsyncWebSocketBasicMessage: public AsyncWebSocketMessage {
       size_t toSend = _len - _sent;
       if(window < toSend) toSend = window;
       bool final = ((toSend + _sent) == _len);
-      size_t sent = webSocketSendFrame(client, final, (_sent == 0)?_opcode:WS_CONTINUATION, _mask, (uint8_t*)(_data+_sent), toSend);
+      //RSV1 is only set on the first frame of a compressed message
+      size_t sent = webSocketSendFrame(client, final, (_sent == 0)?_opcode:WS_CONTINUATION, _mask, (uint8_t*)(_data+_sent), toSend, _compressed && _sent == 0);
       _sent += sent;
       uint8_t headLen = ((sent < 126)?2:4)+(_mask*4);
       _ack += sent + headLen;
@@ -239,7 +227,7 @@ class AsyncWebSocketBasicMessage: public AsyncWebSocketMessage {
  const char * AWSC_PING_PAYLOAD = "ESPAsyncWebServer-PING";
  const size_t AWSC_PING_PAYLOAD_LEN = 22;
 
-AsyncWebSocketClient::AsyncWebSocketClient(AsyncWebServerRequest *request, AsyncWebSocket *server){
+AsyncWebSocketClient::AsyncWebSocketClient(AsyncWebServerRequest *request, AsyncWebSocket *server, const ws_deflate_params_t * deflate){
   _client = request->client();
   _server = server;
   _clientId = _server->_getNextId();
@@ -249,6 +237,11 @@ AsyncWebSocketClient::AsyncWebSocketClient(AsyncWebServerRequest *request, Async
   _pstate = 0;
   _lastMessageTime = millis();
   _keepAlivePeriod = 0;
+  _deflate = (deflate != NULL)?ws_deflate_new(deflate):NULL;
+  _rxCompressed = false;
+  _rxOpcode = WS_CONTINUATION;
+  _rxMessage = NULL;
+  _rxLen = 0;
   next = NULL;
   _client->onError([](void *r, AsyncClient* c, int8_t error){ ((AsyncWebSocketClient*)(r))->_onError(error); }, this);
   _client->onAck([](void *r, AsyncClient* c, size_t len, uint32_t time){ ((AsyncWebSocketClient*)(r))->_onAck(len, time); }, this);
@@ -272,6 +265,10 @@ AsyncWebSocketClient::~AsyncWebSocketClient(){
     _controlQueue = _controlQueue->next;
     delete(c);
   }
+  if(_rxMessage != NULL)
+    free(_rxMessage);
+  if(_deflate != NULL)
+    ws_deflate_free(_deflate);
   _server->_handleEvent(this, WS_EVT_DISCONNECT, NULL, NULL, 0);
 }
 
@@ -403,6 +400,17 @@ void AsyncWebSocketClient::_onData(void *buf, size_t plen){
     _pinfo.opcode = fdata[0] & 0x0F;
     _pinfo.masked = (fdata[1] & 0x80) != 0;
     _pinfo.len = fdata[1] & 0x7F;
+    //RSV1 marks the first frame of a compressed message
+    bool rsv1 = (fdata[0] & 0x40) != 0;
+    if((fdata[0] & 0x30) || (rsv1 && (_deflate == NULL || (_pinfo.opcode != WS_TEXT && _pinfo.opcode != WS_BINARY)))){
+      close(1002);
+      _status = WS_DISCONNECTING;
+      return;
+    }
+    if(_pinfo.opcode == WS_TEXT || _pinfo.opcode == WS_BINARY){
+      _rxCompressed = rsv1;
+      _rxOpcode = _pinfo.opcode;
+    }
     data += 2;
     plen = plen - 2;
     if(_pinfo.len == 126){
@@ -439,7 +447,10 @@ void AsyncWebSocketClient::_onData(void *buf, size_t plen){
         _pinfo.num = 0;
       } else _pinfo.num += 1;
     }
-    _server->_handleEvent(this, WS_EVT_DATA, (void *)&_pinfo, (uint8_t*)data, plen);
+    if(_rxCompressed)
+      _compressedData(data, plen, false);
+    else
+      _server->_handleEvent(this, WS_EVT_DATA, (void *)&_pinfo, (uint8_t*)data, plen);
 
     _pinfo.index += plen;
   } else if((plen + _pinfo.index) == _pinfo.len){
@@ -465,7 +476,10 @@ void AsyncWebSocketClient::_onData(void *buf, size_t plen){
       if(plen != AWSC_PING_PAYLOAD_LEN || memcmp(AWSC_PING_PAYLOAD, data, AWSC_PING_PAYLOAD_LEN) != 0)
         _server->_handleEvent(this, WS_EVT_PONG, NULL, (uint8_t*)data, plen);
     } else if(_pinfo.opcode < 8){//continuation or text/binary frame
-      _server->_handleEvent(this, WS_EVT_DATA, (void *)&_pinfo, (uint8_t*)data, plen);
+      if(_rxCompressed)
+        _compressedData(data, plen, _pinfo.final);
+      else
+        _server->_handleEvent(this, WS_EVT_DATA, (void *)&_pinfo, (uint8_t*)data, plen);
     }
   } else {
     //os_printf("frame error: len: %u, index: %llu, total: %llu\n", plen, _pinfo.index, _pinfo.len);
@@ -473,6 +487,53 @@ void AsyncWebSocketClient::_onData(void *buf, size_t plen){
   }
 }
 
+//compressed messages are put together and inflated, then passed on as one WS_EVT_DATA
+void AsyncWebSocketClient::_compressedData(uint8_t *data, size_t len, bool final){
+  if(_status != WS_CONNECTED)
+    return;
+  if(len){
+    if(_rxLen + len > ASYNCWEBSOCKET_MAX_INFLATE_SIZE){
+      close(1009);
+      _status = WS_DISCONNECTING;
+      return;
+    }
+    uint8_t * message = (uint8_t*)realloc(_rxMessage, _rxLen + len);
+    if(message == NULL){
+      close(1011);
+      _status = WS_DISCONNECTING;
+      return;
+    }
+    memcpy(message + _rxLen, data, len);
+    _rxMessage = message;
+    _rxLen += len;
+  }
+  if(!final)
+    return;
+  size_t outLen = 0;
+  uint8_t * out = ws_inflate_message(_deflate, _rxMessage, _rxLen, ASYNCWEBSOCKET_MAX_INFLATE_SIZE, &outLen);
+  if(_rxMessage != NULL)
+    free(_rxMessage);
+  _rxMessage = NULL;
+  _rxLen = 0;
+  _rxCompressed = false;
+  if(out == NULL){
+    close(1007);
+    _status = WS_DISCONNECTING;
+    return;
+  }
+  AwsFrameInfo info;
+  info.message_opcode = _rxOpcode;
+  info.num = 0;
+  info.final = 1;
+  info.masked = _pinfo.masked;
+  info.opcode = _rxOpcode;
+  info.len = outLen;
+  memcpy(info.mask, _pinfo.mask, 4);
+  info.index = 0;
+  _server->_handleEvent(this, WS_EVT_DATA, (void *)&info, out, outLen);
+  free(out);
+}
+
 size_t AsyncWebSocketClient::printf(const char *format, ...) {
   va_list arg;
   va_start(arg, format);
@@ -527,8 +588,22 @@ size_t AsyncWebSocketClient::printf_P(PGM_P formatP, ...) {
   return len;
 }
 
+//compresses the message at queue time, so the window of the client follows the order messages go out in
+AsyncWebSocketMessage * AsyncWebSocketClient::_dataMessage(const char * message, size_t len, uint8_t opcode){
+  if(_deflate != NULL && _status == WS_CONNECTED){
+    size_t dlen = 0;
+    uint8_t * d = ws_deflate_message(_deflate, (const uint8_t *)message, len, 0, &dlen);
+    if(d != NULL){
+      AsyncWebSocketMessage * m = new AsyncWebSocketBasicMessage((const char *)d, dlen, opcode, false, true);
+      free(d);
+      return m;
+    }
+  }
+  return new AsyncWebSocketBasicMessage(message, len, opcode);
+}
+
 void AsyncWebSocketClient::text(const char * message, size_t len){
-  _queueMessage(new AsyncWebSocketBasicMessage(message, len));
+  _queueMessage(_dataMessage(message, len, WS_TEXT));
 }
 void AsyncWebSocketClient::text(const char * message){
   text(message, strlen(message));
@@ -559,7 +634,7 @@ void AsyncWebSocketClient::text(const __FlashStringHelper *data){
 }
 
 void AsyncWebSocketClient::binary(const char * message, size_t len){
-  _queueMessage(new AsyncWebSocketBasicMessage(message, len, WS_BINARY));
+  _queueMessage(_dataMessage(message, len, WS_BINARY));
 }
 void AsyncWebSocketClient::binary(const char * message){
   binary(message, strlen(message));
@@ -608,12 +683,21 @@ AsyncWebSocket::AsyncWebSocket(String url)
   ,_clients(NULL)
   ,_cNextId(1)
   ,_enabled(true)
+  ,_deflate(false)
 {
   _eventHandler = NULL;
+  _deflateConfig.windowBits = ASYNCWEBSOCKET_DEFLATE_WINDOW_BITS;
+  _deflateConfig.noContextTakeover = 0;
 }
 
 AsyncWebSocket::~AsyncWebSocket(){}
 
+void AsyncWebSocket::deflate(bool enable, uint8_t windowBits, bool noContextTakeover){
+  _deflate = enable;
+  _deflateConfig.windowBits = windowBits;
+  _deflateConfig.noContextTakeover = noContextTakeover;
+}
+
 void AsyncWebSocket::_handleEvent(AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len){
   if(_eventHandler != NULL){
     _eventHandler(this, client, type, arg, data, len);
@@ -905,7 +989,7 @@ const char * WS_STR_VERSION = "Sec-WebSocket-Version";
 const char * WS_STR_KEY = "Sec-WebSocket-Key";
 const char * WS_STR_PROTOCOL = "Sec-WebSocket-Protocol";
 const char * WS_STR_ACCEPT = "Sec-WebSocket-Accept";
-const char * WS_STR_UUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+const char * WS_STR_EXTENSIONS = "Sec-WebSocket-Extensions";
 
 bool AsyncWebSocket::canHandle(AsyncWebServerRequest *request){
   if(!_enabled)
@@ -920,6 +1004,8 @@ bool AsyncWebSocket::canHandle(AsyncWebServerRequest *request){
   request->addInterestingHeader(WS_STR_VERSION);
   request->addInterestingHeader(WS_STR_KEY);
   request->addInterestingHeader(WS_STR_PROTOCOL);
+  if(_deflate)
+    request->addInterestingHeader(WS_STR_EXTENSIONS);
   return true;
 }
 
@@ -936,12 +1022,21 @@ void AsyncWebSocket::handleRequest(AsyncWebServerRequest *request){
     return;
   }
   AsyncWebHeader* key = request->getHeader(WS_STR_KEY);
-  AsyncWebServerResponse *response = new AsyncWebSocketResponse(key->value(), this);
+  ws_deflate_params_t params;
+  char extensions[WS_DEFLATE_HEADER_SIZE];
+  bool deflate = false;
+  if(_deflate && request->hasHeader(WS_STR_EXTENSIONS)){
+    AsyncWebHeader* offer = request->getHeader(WS_STR_EXTENSIONS);
+    deflate = ws_deflate_accept(offer->value().c_str(), &_deflateConfig, &params, extensions);
+  }
+  AsyncWebServerResponse *response = new AsyncWebSocketResponse(key->value(), this, deflate?&params:NULL);
   if(request->hasHeader(WS_STR_PROTOCOL)){
     AsyncWebHeader* protocol = request->getHeader(WS_STR_PROTOCOL);
     //ToDo: check protocol
     response->addHeader(WS_STR_PROTOCOL, protocol->value());
   }
+  if(deflate)
+    response->addHeader(WS_STR_EXTENSIONS, extensions);
   request->send(response);
 }
 
@@ -951,38 +1046,17 @@ void AsyncWebSocket::handleRequest(AsyncWebServerRequest *request){
  * Authentication code from https://github.com/Links2004/arduinoWebSockets/blob/master/src/WebSockets.cpp#L480
  */
 
-AsyncWebSocketResponse::AsyncWebSocketResponse(String key, AsyncWebSocket *server){
+AsyncWebSocketResponse::AsyncWebSocketResponse(String key, AsyncWebSocket *server, const ws_deflate_params_t * deflate){
   _server = server;
   _code = 101;
-  uint8_t * hash = (uint8_t*)malloc(20);
-  if(hash == NULL){
-    _state = RESPONSE_FAILED;
-    return;
-  }
-  char * buffer = (char *) malloc(33);
-  if(buffer == NULL){
-    free(hash);
-    _state = RESPONSE_FAILED;
-    return;
-  }
-#ifdef ESP8266
-  sha1(key + WS_STR_UUID, hash);
-#else
-  key += WS_STR_UUID;
-  SHA1_CTX ctx;
-  SHA1Init(&ctx);
-  SHA1Update(&ctx, (const unsigned char*)key.c_str(), key.length());
-  SHA1Final(hash, &ctx);
-#endif
-  base64_encodestate _state;
-  base64_init_encodestate(&_state);
-  int len = base64_encode_block((const char *) hash, 20, buffer, &_state);
-  len = base64_encode_blockend((buffer + len), &_state);
+  _deflate = (deflate != NULL);
+  if(_deflate)
+    _deflateParams = *deflate;
+  char accept[WS_ACCEPT_KEY_SIZE];
+  ws_accept_key(key.c_str(), key.length(), accept);
   addHeader(WS_STR_CONNECTION, WS_STR_UPGRADE);
   addHeader(WS_STR_UPGRADE, "websocket");
-  addHeader(WS_STR_ACCEPT,buffer);
-  free(buffer);
-  free(hash);
+  addHeader(WS_STR_ACCEPT,accept);
 }
 
 void AsyncWebSocketResponse::_respond(AsyncWebServerRequest *request){
@@ -997,7 +1071,7 @@ void AsyncWebSocketResponse::_respond(AsyncWebServerRequest *request){
 
 size_t AsyncWebSocketResponse::_ack(AsyncWebServerRequest *request, size_t len, uint32_t time){
   if(len){
-    new AsyncWebSocketClient(request, _server);
+    new AsyncWebSocketClient(request, _server, _deflate?&_deflateParams:NULL);
   }
   return 0;
 }
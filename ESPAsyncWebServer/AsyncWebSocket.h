@@ -24,6 +24,17 @@
 #include <Arduino.h>
 #include <ESPAsyncTCP.h>
 #include <ESPAsyncWebServer.h>
+#include <wsdeflate.h>
+
+//default LZ77 window for permessage-deflate, each compressing client keeps up to 2 windows
+#ifndef ASYNCWEBSOCKET_DEFLATE_WINDOW_BITS
+#define ASYNCWEBSOCKET_DEFLATE_WINDOW_BITS 10
+#endif
+
+//largest compressed message that is buffered and inflated, bigger ones close the connection
+#ifndef ASYNCWEBSOCKET_MAX_INFLATE_SIZE
+#define ASYNCWEBSOCKET_MAX_INFLATE_SIZE (16*1024)
+#endif
 
 class AsyncWebSocket;
 class AsyncWebSocketResponse;
@@ -77,6 +88,15 @@ class AsyncWebSocketClient {
     uint32_t _lastMessageTime;
     uint32_t _keepAlivePeriod;
 
+    //permessage-deflate, NULL if not negotiated
+    ws_deflate_t * _deflate;
+    bool _rxCompressed;
+    uint8_t _rxOpcode;
+    uint8_t * _rxMessage;
+    size_t _rxLen;
+
+    AsyncWebSocketMessage * _dataMessage(const char * message, size_t len, uint8_t opcode);
+    void _compressedData(uint8_t *data, size_t len, bool final);
     void _queueMessage(AsyncWebSocketMessage *dataMessage);
     void _queueControl(AsyncWebSocketControl *controlMessage);
     void _runQueue();
@@ -84,13 +104,14 @@ class AsyncWebSocketClient {
   public:
     AsyncWebSocketClient * next;
 
-    AsyncWebSocketClient(AsyncWebServerRequest *request, AsyncWebSocket *server);
+    AsyncWebSocketClient(AsyncWebServerRequest *request, AsyncWebSocket *server, const ws_deflate_params_t * deflate=NULL);
     ~AsyncWebSocketClient();
 
     //client id increments for the given server
     uint32_t id(){ return _clientId; }
     AwsClientStatus status(){ return _status; }
     AsyncClient* client(){ return _client; }
+    bool compressed(){ return _deflate != NULL; }
 
     IPAddress remoteIP();
     uint16_t  remotePort();
@@ -146,6 +167,8 @@ class AsyncWebSocket: public AsyncWebHandler {
     uint32_t _cNextId;
     AwsEventHandler _eventHandler;
     bool _enabled;
+    bool _deflate;
+    ws_deflate_config_t _deflateConfig;
   public:
     AsyncWebSocket(String url);
     ~AsyncWebSocket();
@@ -153,6 +176,10 @@ class AsyncWebSocket: public AsyncWebHandler {
     void enable(bool e){ _enabled = e; }
     bool enabled() { return _enabled; }
 
+    //accept permessage-deflate from clients that offer it, text and binary messages are then
+    //compressed when that makes them smaller. noContextTakeover trades compression for RAM
+    void deflate(bool enable, uint8_t windowBits=ASYNCWEBSOCKET_DEFLATE_WINDOW_BITS, bool noContextTakeover=false);
+
     size_t count();
     AsyncWebSocketClient * client(uint32_t id);
     bool hasClient(uint32_t id){ return client(id) != NULL; }
@@ -218,8 +245,10 @@ class AsyncWebSocketResponse: public AsyncWebServerResponse {
   private:
     String _content;
     AsyncWebSocket *_server;
+    bool _deflate;
+    ws_deflate_params_t _deflateParams;
   public:
-    AsyncWebSocketResponse(String key, AsyncWebSocket *server);
+    AsyncWebSocketResponse(String key, AsyncWebSocket *server, const ws_deflate_params_t * deflate=NULL);
     void _respond(AsyncWebServerRequest *request);
     size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t time);
     bool _sourceValid(){ return true; }
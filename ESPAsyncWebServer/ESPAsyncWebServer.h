@@ -28,6 +28,7 @@
 #include "FS.h"
 
 #include "StringArray.h"
+#include "AsyncWebPool.h"
 
 #if defined(ESP31B)
 #include <ESP31BWiFi.h>
@@ -39,6 +40,28 @@
 
 #define DEBUGF(...) //Serial.printf(__VA_ARGS__)
 
+//request objects kept in a preallocated pool, more concurrent requests are allocated from the heap
+#ifndef ASYNCWEBSERVER_REQUEST_POOL_SIZE
+#define ASYNCWEBSERVER_REQUEST_POOL_SIZE 4
+#endif
+
+//scratch buffers used by the responses to assemble outgoing packets
+#ifndef ASYNCWEBSERVER_RESPONSE_POOL_SIZE
+#define ASYNCWEBSERVER_RESPONSE_POOL_SIZE 2
+#endif
+#ifndef ASYNCWEBSERVER_RESPONSE_BUFFER_SIZE
+#define ASYNCWEBSERVER_RESPONSE_BUFFER_SIZE 1460
+#endif
+//buffers a response keeps until lwIP has the ack for them, tcp_write does not copy
+#ifndef ASYNCWEBSERVER_RESPONSE_INFLIGHT
+#define ASYNCWEBSERVER_RESPONSE_INFLIGHT 4
+#endif
+
+//concurrent requests served before new connections are answered with 503 (0 for no limit)
+#ifndef ASYNCWEBSERVER_MAX_CONNECTIONS
+#define ASYNCWEBSERVER_MAX_CONNECTIONS 8
+#endif
+
 
 class AsyncWebServer;
 class AsyncWebServerRequest;
@@ -155,8 +178,7 @@ class AsyncWebServerRequest {
     String _itemFilename;
     String _itemType;
     String _itemValue;
-    uint8_t *_itemBuffer;
-    size_t _itemBufferIndex;
+    uint8_t *_boundarySkip;
     bool _itemIsFile;
 
     void _onPoll();
@@ -172,12 +194,16 @@ class AsyncWebServerRequest {
     bool _parseReqHeader();
     void _parseLine();
     void _parsePlainPostChar(uint8_t data);
-    void _parseMultipartPostByte(uint8_t data, bool last);
+    bool _beginMultipart();
+    void _parseMultipartPostChunk(uint8_t *data, size_t len);
+    size_t _parseMultipartHeaders(uint8_t *data, size_t len);
+    void _parseMultipartHeader(const char *line, size_t len);
+    size_t _parseMultipartData(uint8_t *data, size_t len);
+    size_t _findMultipartBoundary(const uint8_t *data, size_t len);
+    void _endMultipartItem();
     void _addGetParams(String params);
 
-    void _handleUploadStart();
-    void _handleUploadByte(uint8_t data, bool last);
-    void _handleUploadEnd();
+    void _handleUploadData(uint8_t *data, size_t len, bool final);
 
   public:
     File _tempFile;
@@ -187,6 +213,9 @@ class AsyncWebServerRequest {
     AsyncWebServerRequest(AsyncWebServer*, AsyncClient*);
     ~AsyncWebServerRequest();
 
+    static void* operator new(size_t size) noexcept;
+    static void operator delete(void *ptr);
+
     AsyncClient* client(){ return _client; }
     uint8_t version(){ return _version; }
     WebRequestMethodComposite method(){ return _method; }
@@ -359,12 +388,28 @@ typedef std::function<void(AsyncWebServerRequest *request)> ArRequestHandlerFunc
 typedef std::function<void(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final)> ArUploadHandlerFunction;
 typedef std::function<void(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total)> ArBodyHandlerFunction;
 
+typedef struct {
+  uint16_t connections;
+  uint16_t maxConnections;
+  uint32_t rejected;
+  uint32_t requestPoolHits;
+  uint32_t requestPoolMisses;
+  uint32_t bufferPoolHits;
+  uint32_t bufferPoolMisses;
+} AsyncWebServerStats;
+
+extern AsyncWebPool asyncWebRequestPool;
+extern AsyncWebPool asyncWebBufferPool;
+
 class AsyncWebServer {
   private:
     AsyncServer _server;
     AsyncWebRewrite* _rewrites;
     AsyncWebHandler* _handlers;
     AsyncWebHandler* _catchAllHandler;
+    uint16_t _connections;
+    uint16_t _maxConnections;
+    uint32_t _rejected;
   public:
     AsyncWebServer(uint16_t port);
     ~AsyncWebServer();
@@ -388,6 +433,12 @@ class AsyncWebServer {
     void onFileUpload(ArUploadHandlerFunction fn); //handle file uploads
     void onRequestBody(ArBodyHandlerFunction fn); //handle posts with plain body content (JSON often transmitted this way as a request)
 
+    void setMaxConnections(uint16_t max){ _maxConnections = max; } //0 for no limit
+    uint16_t connections(){ return _connections; }
+    AsyncWebServerStats stats();
+
+    void _addRequest(){ _connections++; }
+    void _removeRequest(){ _connections--; }
     void _handleDisconnect(AsyncWebServerRequest *request);
     void _attachHandler(AsyncWebServerRequest *request);
     void _rewriteRequest(AsyncWebServerRequest *request);
@@ -30,6 +30,16 @@
 
 enum { PARSE_REQ_START, PARSE_REQ_HEADERS, PARSE_REQ_BODY, PARSE_REQ_END, PARSE_REQ_FAIL };
 
+AsyncWebPool asyncWebRequestPool(sizeof(AsyncWebServerRequest), ASYNCWEBSERVER_REQUEST_POOL_SIZE);
+
+void* AsyncWebServerRequest::operator new(size_t size) noexcept {
+  return asyncWebRequestPool.alloc(size);
+}
+
+void AsyncWebServerRequest::operator delete(void *ptr){
+  asyncWebRequestPool.release(ptr);
+}
+
 AsyncWebServerRequest::AsyncWebServerRequest(AsyncWebServer* s, AsyncClient* c)
   : _client(c)
   , _server(s)
@@ -61,8 +71,7 @@ AsyncWebServerRequest::AsyncWebServerRequest(AsyncWebServer* s, AsyncClient* c)
   , _itemFilename()
   , _itemType()
   , _itemValue()
-  , _itemBuffer(0)
-  , _itemBufferIndex(0)
+  , _boundarySkip(NULL)
   , _itemIsFile(false)
   , _tempObject(NULL)
   , next(NULL)
@@ -73,6 +82,7 @@ AsyncWebServerRequest::AsyncWebServerRequest(AsyncWebServer* s, AsyncClient* c)
   c->onTimeout([](void *r, AsyncClient* c, uint32_t time){ AsyncWebServerRequest *req = (AsyncWebServerRequest*)r; req->_onTimeout(time); }, this);
   c->onData([](void *r, AsyncClient* c, void *buf, size_t len){ AsyncWebServerRequest *req = (AsyncWebServerRequest*)r; req->_onData(buf, len); }, this);
   c->onPoll([](void *r, AsyncClient* c){ AsyncWebServerRequest *req = (AsyncWebServerRequest*)r; req->_onPoll(); }, this);
+  _server->_addRequest();
 }
 
 AsyncWebServerRequest::~AsyncWebServerRequest(){
@@ -99,6 +109,11 @@ AsyncWebServerRequest::~AsyncWebServerRequest(){
     free(_tempObject);
   }
 
+  if(_boundarySkip != NULL){
+    free(_boundarySkip);
+  }
+
+  _server->_removeRequest();
 }
 
 void AsyncWebServerRequest::_onData(void *buf, size_t len){
@@ -122,11 +137,8 @@ void AsyncWebServerRequest::_onData(void *buf, size_t len){
     }
   } else if(_parseState == PARSE_REQ_BODY){
     if(_isMultipart){
-      size_t i;
-      for(i=0; i<len; i++){
-        _parseMultipartPostByte(((uint8_t*)buf)[i], i == len - 1);
-        _parsedLength++;
-      }
+      _parseMultipartPostChunk((uint8_t*)buf, len);
+      _parsedLength += len;
     } else {
       if(_parsedLength == 0){
         if(_contentType.startsWith("application/x-www-form-urlencoded")){
@@ -274,6 +286,8 @@ bool AsyncWebServerRequest::_parseReqHeader(){
     } else if(name == "Content-Type"){
       if (value.startsWith("multipart/")){
         _boundary = value.substring(value.indexOf('=')+1);
+        if(_boundary.startsWith("\"") && _boundary.endsWith("\""))
+          _boundary = _boundary.substring(1, _boundary.length() - 1);
         _contentType = value.substring(0, value.indexOf(';'));
         _isMultipart = true;
       } else {
@@ -323,188 +337,255 @@ void AsyncWebServerRequest::_parsePlainPostChar(uint8_t data){
   }
 }
 
-void AsyncWebServerRequest::_handleUploadByte(uint8_t data, bool last){
-  _itemBuffer[_itemBufferIndex++] = data;
-
-  if(last || _itemBufferIndex == 1460){
-    //check if authenticated before calling the upload
-    if(_handler)
-      _handler->handleUpload(this, _itemFilename, _itemSize - _itemBufferIndex, _itemBuffer, _itemBufferIndex, false);
-    _itemBufferIndex = 0;
-  }
+void AsyncWebServerRequest::_handleUploadData(uint8_t *data, size_t len, bool final){
+  //file data is handed over straight from the received segment, _itemSize is the index of the first byte
+  if(_handler && (len || (final && _itemSize)))
+    _handler->handleUpload(this, _itemFilename, _itemSize, data, len, final);
+  _itemSize += len;
 }
 
+//RFC 2046 limits the boundary to 70 characters, the delimiter adds "\r\n--"
+#define MULTIPART_BOUNDARY_MAX 70
+#define MULTIPART_DELIMITER_MAX (MULTIPART_BOUNDARY_MAX + 4)
+
 enum {
   EXPECT_BOUNDARY,
   PARSE_HEADERS,
-  WAIT_FOR_RETURN1,
-  EXPECT_FEED1,
-  EXPECT_DASH1,
+  PARSE_DATA,
+  BOUNDARY_END,
   EXPECT_DASH2,
-  BOUNDARY_OR_DATA,
-  DASH3_OR_RETURN2,
   EXPECT_FEED2,
   PARSING_FINISHED,
   PARSE_ERROR
 };
 
-void AsyncWebServerRequest::_parseMultipartPostByte(uint8_t data, bool last){
-#define itemWriteByte(b) do { _itemSize++; if(_itemIsFile) _handleUploadByte(b, last); else _itemValue+=(char)(b); } while(0)
+static void appendRange(String &str, const char *data, size_t len){
+  str.reserve(str.length() + len);
+  while(len--)
+    str += *data++;
+}
 
-  if(!_parsedLength){
-    _multiParseState = EXPECT_BOUNDARY;
-    _temp = String();
-    _itemName = String();
-    _itemFilename = String();
-    _itemType = String();
-  }
+static String rangeToString(const char *data, size_t len){
+  String str;
+  appendRange(str, data, len);
+  return str;
+}
 
-  if(_multiParseState == WAIT_FOR_RETURN1){
-    if(data != '\r'){
-      itemWriteByte(data);
+//turns _boundary into the full "\r\n--boundary" delimiter and builds the Horspool skip table for it
+bool AsyncWebServerRequest::_beginMultipart(){
+  if(!_boundary.length() || _boundary.length() > MULTIPART_BOUNDARY_MAX)
+    return false;
+  _boundary = String("\r\n--") + _boundary;
+  if(_boundarySkip == NULL)
+    _boundarySkip = (uint8_t*)malloc(256);
+  if(_boundarySkip == NULL)
+    return false;
+  const uint8_t *delimiter = (const uint8_t *)_boundary.c_str();
+  size_t dlen = _boundary.length();
+  memset(_boundarySkip, dlen, 256);
+  for(size_t i = 0; i < dlen - 1; i++)
+    _boundarySkip[delimiter[i]] = dlen - 1 - i;
+  _temp = String();
+  _itemName = String();
+  _itemFilename = String();
+  _itemType = String();
+  _itemIsFile = false;
+  //the body starts with the delimiter without its leading CRLF, treat the CRLF as already matched
+  _boundaryPosition = 2;
+  return true;
+}
+
+void AsyncWebServerRequest::_parseMultipartPostChunk(uint8_t *data, size_t len){
+  if(!_parsedLength)
+    _multiParseState = _beginMultipart() ? EXPECT_BOUNDARY : PARSE_ERROR;
+
+  size_t pos = 0;
+  while(pos < len && _multiParseState != PARSING_FINISHED && _multiParseState != PARSE_ERROR){
+    if(_multiParseState == EXPECT_BOUNDARY || _multiParseState == PARSE_DATA){
+      pos += _parseMultipartData(data + pos, len - pos);
+    } else if(_multiParseState == PARSE_HEADERS){
+      pos += _parseMultipartHeaders(data + pos, len - pos);
+      if(_multiParseState == PARSE_DATA)
+        _itemStartIndex = _parsedLength + pos;
     } else {
-      _multiParseState = EXPECT_FEED1;
-    }
-  } else if(_multiParseState == EXPECT_BOUNDARY){
-    if(_parsedLength < 2 && data != '-'){
-      _multiParseState = PARSE_ERROR;
-      return;
-    } else if(_parsedLength - 2 < _boundary.length() && _boundary.c_str()[_parsedLength - 2] != data){
-      _multiParseState = PARSE_ERROR;
-      return;
-    } else if(_parsedLength - 2 == _boundary.length() && data != '\r'){
-      _multiParseState = PARSE_ERROR;
-      return;
-    } else if(_parsedLength - 3 == _boundary.length()){
-      if(data != '\n'){
-        _multiParseState = PARSE_ERROR;
-        return;
-      }
-      _multiParseState = PARSE_HEADERS;
-      _itemIsFile = false;
-    }
-  } else if(_multiParseState == PARSE_HEADERS){
-    if((char)data != '\r' && (char)data != '\n')
-       _temp += (char)data;
-    if((char)data == '\n'){
-      if(_temp.length()){
-        if(_temp.startsWith("Content-Type:")){
-          _itemType = _temp.substring(14);
-          _itemIsFile = true;
-        } else if(_temp.startsWith("Content-Disposition:")){
-          _temp = _temp.substring(_temp.indexOf(';') + 2);
-          while(_temp.indexOf(';') > 0){
-            String name = _temp.substring(0, _temp.indexOf('='));
-            String nameVal = _temp.substring(_temp.indexOf('=') + 2, _temp.indexOf(';') - 1);
-            if(name == "name"){
-              _itemName = nameVal;
-            } else if(name == "filename"){
-              _itemFilename = nameVal;
-              _itemIsFile = true;
-            }
-            _temp = _temp.substring(_temp.indexOf(';') + 2);
-          }
-          String name = _temp.substring(0, _temp.indexOf('='));
-          String nameVal = _temp.substring(_temp.indexOf('=') + 2, _temp.length() - 1);
-          if(name == "name"){
-            _itemName = nameVal;
-          } else if(name == "filename"){
-            _itemFilename = nameVal;
-            _itemIsFile = true;
-          }
-        }
-        _temp = String();
-      } else {
-        _multiParseState = WAIT_FOR_RETURN1;
-        //value starts from here
-        _itemSize = 0;
-        _itemStartIndex = _parsedLength;
-        _itemValue = String();
-        if(_itemIsFile){
-          if(_itemBuffer)
-            free(_itemBuffer);
-          _itemBuffer = (uint8_t*)malloc(1460);
-          if(_itemBuffer == NULL){
-            _multiParseState = PARSE_ERROR;
-            return;
-          }
-          _itemBufferIndex = 0;
+      uint8_t b = data[pos++];
+      if(_multiParseState == BOUNDARY_END){
+        if(b == '-')
+          _multiParseState = EXPECT_DASH2;
+        else if(b == '\r')
+          _multiParseState = EXPECT_FEED2;
+        else if(b != ' ' && b != '\t')
+          _multiParseState = PARSE_ERROR;
+      } else if(_multiParseState == EXPECT_DASH2){
+        _multiParseState = (b == '-') ? PARSING_FINISHED : PARSE_ERROR;
+      } else if(_multiParseState == EXPECT_FEED2){
+        if(b == '\n'){
+          _multiParseState = PARSE_HEADERS;
+          _itemName = String();
+          _itemFilename = String();
+          _itemType = String();
+          _itemIsFile = false;
+        } else {
+          _multiParseState = PARSE_ERROR;
         }
       }
     }
-  } else if(_multiParseState == EXPECT_FEED1){
-    if(data != '\n'){
-      _multiParseState = WAIT_FOR_RETURN1;
-      itemWriteByte('\r'); _parseMultipartPostByte(data, last);
-    } else {
-      _multiParseState = EXPECT_DASH1;
-    }
-  } else if(_multiParseState == EXPECT_DASH1){
-    if(data != '-'){
-      _multiParseState = WAIT_FOR_RETURN1;
-      itemWriteByte('\r'); itemWriteByte('\n');  _parseMultipartPostByte(data, last);
-    } else {
-      _multiParseState = EXPECT_DASH2;
-    }
-  } else if(_multiParseState == EXPECT_DASH2){
-    if(data != '-'){
-      _multiParseState = WAIT_FOR_RETURN1;
-      itemWriteByte('\r'); itemWriteByte('\n'); itemWriteByte('-');  _parseMultipartPostByte(data, last);
-    } else {
-      _multiParseState = BOUNDARY_OR_DATA;
-      _boundaryPosition = 0;
-    }
-  } else if(_multiParseState == BOUNDARY_OR_DATA){
-    if(_boundaryPosition < _boundary.length() && _boundary.c_str()[_boundaryPosition] != data){
-      _multiParseState = WAIT_FOR_RETURN1;
-      itemWriteByte('\r'); itemWriteByte('\n'); itemWriteByte('-');  itemWriteByte('-');
-      uint8_t i;
-      for(i=0; i<_boundaryPosition; i++)
-        itemWriteByte(_boundary.c_str()[i]);
-      _parseMultipartPostByte(data, last);
-    } else if(_boundaryPosition == _boundary.length() - 1){
-      _multiParseState = DASH3_OR_RETURN2;
-      if(!_itemIsFile){
-        _addParam(new AsyncWebParameter(_itemName, _itemValue, true));
+  }
+}
+
+//part headers are parsed in place when the whole line is in the segment, _temp only holds lines split between segments
+size_t AsyncWebServerRequest::_parseMultipartHeaders(uint8_t *data, size_t len){
+  uint8_t *nl = (uint8_t *)memchr(data, '\n', len);
+  if(nl == NULL){
+    appendRange(_temp, (const char *)data, len);
+    return len;
+  }
+  size_t lineLen = nl - data;
+  const char *line = (const char *)data;
+  if(_temp.length()){
+    appendRange(_temp, line, lineLen);
+    line = _temp.c_str();
+    lineLen = _temp.length();
+  }
+  if(lineLen && line[lineLen - 1] == '\r')
+    lineLen--;
+  if(lineLen){
+    _parseMultipartHeader(line, lineLen);
+  } else {
+    //empty line, value starts from here
+    _multiParseState = PARSE_DATA;
+    _itemSize = 0;
+    _itemValue = String();
+  }
+  _temp = String();
+  return (nl - data) + 1;
+}
+
+void AsyncWebServerRequest::_parseMultipartHeader(const char *line, size_t len){
+  const char *end = line + len;
+  if(len > 13 && strncasecmp(line, "Content-Type:", 13) == 0){
+    const char *p = line + 13;
+    while(p < end && *p == ' ') p++;
+    _itemType = rangeToString(p, end - p);
+    _itemIsFile = true;
+  } else if(len > 20 && strncasecmp(line, "Content-Disposition:", 20) == 0){
+    const char *p = line + 20;
+    while(p < end){
+      while(p < end && (*p == ';' || *p == ' ' || *p == '\t')) p++;
+      const char *key = p;
+      while(p < end && *p != '=' && *p != ';') p++;
+      size_t keyLen = p - key;
+      if(p == end || *p != '=')
+        continue;
+      p++;
+      const char *value = p;
+      size_t valueLen;
+      if(p < end && *p == '"'){
+        value = ++p;
+        while(p < end && *p != '"') p++;
+        valueLen = p - value;
+        if(p < end) p++;
       } else {
-        if(_itemSize){
-          //check if authenticated before calling the upload
-          if(_handler) _handler->handleUpload(this, _itemFilename, _itemSize - _itemBufferIndex, _itemBuffer, _itemBufferIndex, true);
-          _itemBufferIndex = 0;
-          _addParam(new AsyncWebParameter(_itemName, _itemFilename, true, true, _itemSize));
-        }
-        free(_itemBuffer);
+        while(p < end && *p != ';') p++;
+        valueLen = p - value;
       }
+      if(keyLen == 4 && strncasecmp(key, "name", 4) == 0){
+        _itemName = rangeToString(value, valueLen);
+      } else if(keyLen == 8 && strncasecmp(key, "filename", 8) == 0){
+        _itemFilename = rangeToString(value, valueLen);
+        _itemIsFile = true;
+      }
+    }
+  }
+}
 
-    } else {
+//Boyer-Moore-Horspool search for the delimiter, returns len if it is not fully contained in data
+size_t AsyncWebServerRequest::_findMultipartBoundary(const uint8_t *data, size_t len){
+  const uint8_t *delimiter = (const uint8_t *)_boundary.c_str();
+  size_t dlen = _boundary.length();
+  uint8_t last = delimiter[dlen - 1];
+  size_t i = 0;
+  while(i + dlen <= len){
+    uint8_t c = data[i + dlen - 1];
+    if(c == last && memcmp(data + i, delimiter, dlen - 1) == 0)
+      return i;
+    i += _boundarySkip[c];
+  }
+  return len;
+}
+
+size_t AsyncWebServerRequest::_parseMultipartData(uint8_t *data, size_t len){
+  const uint8_t *delimiter = (const uint8_t *)_boundary.c_str();
+  size_t dlen = _boundary.length();
+  bool preamble = _multiParseState == EXPECT_BOUNDARY;
+  size_t pos = 0;
+
+  //continue a delimiter that started at the end of the previous segment
+  if(_boundaryPosition){
+    while(pos < len && _boundaryPosition < dlen && data[pos] == delimiter[_boundaryPosition]){
+      pos++;
       _boundaryPosition++;
     }
-  } else if(_multiParseState == DASH3_OR_RETURN2){
-    if(data == '-' && (_contentLength - _parsedLength - 4) != 0){
-      os_printf("ERROR: The parser got to the end of the POST but is expecting %u bytes more!\nDrop an issue so we can have more info on the matter!\n", _contentLength - _parsedLength - 4);
-      _contentLength = _parsedLength + 4;//lets close the request gracefully
+    if(_boundaryPosition == dlen){
+      _boundaryPosition = 0;
+      if(!preamble){
+        _handleUploadData(data, 0, true);
+        _endMultipartItem();
+      }
+      _multiParseState = BOUNDARY_END;
+      return pos;
     }
-    if(data == '\r'){
-      _multiParseState = EXPECT_FEED2;
-    } else if(data == '-' && _contentLength == (_parsedLength + 4)){
-      _multiParseState = PARSING_FINISHED;
-    } else {
-      _multiParseState = WAIT_FOR_RETURN1;
-      itemWriteByte('\r'); itemWriteByte('\n'); itemWriteByte('-');  itemWriteByte('-');
-      uint8_t i; for(i=0; i<_boundary.length(); i++) itemWriteByte(_boundary.c_str()[i]);
-      _parseMultipartPostByte(data, last);
+    if(pos == len)
+      return pos;
+    //not a delimiter after all, the held back bytes were data. The delimiter holds no CR past
+    //its first byte, so no other delimiter can start inside them
+    if(!preamble){
+      uint8_t held[MULTIPART_DELIMITER_MAX];
+      memcpy(held, delimiter, _boundaryPosition);
+      if(_itemIsFile)
+        _handleUploadData(held, _boundaryPosition, false);
+      else
+        appendRange(_itemValue, (const char *)held, _boundaryPosition);
     }
-  } else if(_multiParseState == EXPECT_FEED2){
-    if(data == '\n'){
-      _multiParseState = PARSE_HEADERS;
-      _itemIsFile = false;
-    } else {
-      _multiParseState = WAIT_FOR_RETURN1;
-      itemWriteByte('\r'); itemWriteByte('\n'); itemWriteByte('-');  itemWriteByte('-');
-      uint8_t i; for(i=0; i<_boundary.length(); i++) itemWriteByte(_boundary.c_str()[i]);
-      itemWriteByte('\r'); _parseMultipartPostByte(data, last);
+    _boundaryPosition = 0;
+    return pos;
+  }
+
+  size_t found = _findMultipartBoundary(data, len);
+  size_t dataLen = found;
+  if(found == len){
+    //hold back a tail that may be the start of a delimiter split between segments
+    size_t tail = (len > dlen - 1) ? len - (dlen - 1) : 0;
+    uint8_t *cr = (uint8_t *)memchr(data + tail, '\r', len - tail);
+    while(cr != NULL && memcmp(cr, delimiter, len - (cr - data)) != 0)
+      cr = (uint8_t *)memchr(cr + 1, '\r', len - (cr + 1 - data));
+    if(cr != NULL){
+      dataLen = cr - data;
+      _boundaryPosition = len - dataLen;
     }
   }
+
+  if(!preamble){
+    if(_itemIsFile)
+      _handleUploadData(data, dataLen, found != len);
+    else
+      appendRange(_itemValue, (const char *)data, dataLen);
+  }
+
+  if(found == len)
+    return len;
+  if(!preamble)
+    _endMultipartItem();
+  _multiParseState = BOUNDARY_END;
+  return found + dlen;
+}
+
+void AsyncWebServerRequest::_endMultipartItem(){
+  if(!_itemIsFile){
+    _addParam(new AsyncWebParameter(_itemName, _itemValue, true));
+  } else if(_itemSize){
+    _addParam(new AsyncWebParameter(_itemName, _itemFilename, true, true, _itemSize));
+  }
 }
 
 void AsyncWebServerRequest::_parseLine(){
@@ -34,7 +34,16 @@ class AsyncBasicResponse: public AsyncWebServerResponse {
 class AsyncAbstractResponse: public AsyncWebServerResponse {
   private:
     String _head;
+    //written buffers and the stream offset they end at, released once acked
+    uint8_t *_inflightBuf[ASYNCWEBSERVER_RESPONSE_INFLIGHT];
+    size_t _inflightEnd[ASYNCWEBSERVER_RESPONSE_INFLIGHT];
+    uint8_t _inflightCount;
+    size_t _writtenLength;
+    size_t _writeBuffer(AsyncWebServerRequest *request, uint8_t *buf, size_t len);
+    void _releaseAcked();
   public:
+    AsyncAbstractResponse();
+    ~AsyncAbstractResponse();
     void _respond(AsyncWebServerRequest *request);
     size_t _ack(AsyncWebServerRequest *request, size_t len, uint32_t time);
     bool _sourceValid(){ return false; }
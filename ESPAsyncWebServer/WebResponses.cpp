@@ -22,6 +22,8 @@
 #include "WebResponseImpl.h"
 #include "cbuf.h"
 
+AsyncWebPool asyncWebBufferPool(ASYNCWEBSERVER_RESPONSE_BUFFER_SIZE, ASYNCWEBSERVER_RESPONSE_POOL_SIZE);
+
 /*
  * Abstract Response
  * */
@@ -240,6 +242,41 @@ size_t AsyncBasicResponse::_ack(AsyncWebServerRequest *request, size_t len, uint
  * Abstract Response
  * */
 
+AsyncAbstractResponse::AsyncAbstractResponse()
+  : _inflightCount(0)
+  , _writtenLength(0)
+{}
+
+AsyncAbstractResponse::~AsyncAbstractResponse(){
+  while(_inflightCount)
+    asyncWebBufferPool.release(_inflightBuf[--_inflightCount]);
+}
+
+//lwIP sends and retransmits straight from buf, so it stays ours until acked
+size_t AsyncAbstractResponse::_writeBuffer(AsyncWebServerRequest *request, uint8_t *buf, size_t len){
+  if(len)
+    len = request->client()->write((const char*)buf, len);
+  if(!len){
+    asyncWebBufferPool.release(buf);
+    return 0;
+  }
+  _writtenLength += len;
+  _inflightBuf[_inflightCount] = buf;
+  _inflightEnd[_inflightCount++] = _writtenLength;
+  return len;
+}
+
+void AsyncAbstractResponse::_releaseAcked(){
+  uint8_t n = 0;
+  while(n < _inflightCount && _inflightEnd[n] <= _ackedLength)
+    asyncWebBufferPool.release(_inflightBuf[n++]);
+  if(!n)
+    return;
+  _inflightCount -= n;
+  memmove(_inflightBuf, _inflightBuf + n, _inflightCount * sizeof(_inflightBuf[0]));
+  memmove(_inflightEnd, _inflightEnd + n, _inflightCount * sizeof(_inflightEnd[0]));
+}
+
 void AsyncAbstractResponse::_respond(AsyncWebServerRequest *request){
   addHeader("Connection","close");
   _head = _assembleHead(request->version());
@@ -254,6 +291,7 @@ size_t AsyncAbstractResponse::_ack(AsyncWebServerRequest *request, size_t len, u
     return 0;
   }
   _ackedLength += len;
+  _releaseAcked();
   size_t space = request->client()->space();
 
   size_t headLen = _head.length();
@@ -262,14 +300,21 @@ size_t AsyncAbstractResponse::_ack(AsyncWebServerRequest *request, size_t len, u
       _state = RESPONSE_CONTENT;
       space -= headLen;
     } else {
-      String out = _head.substring(0, space);
+      //the rest goes out once an ack frees a slot
+      if(!space || _inflightCount == ASYNCWEBSERVER_RESPONSE_INFLIGHT)
+        return 0;
+      uint8_t *buf = (uint8_t *)asyncWebBufferPool.alloc(space);
+      if(!buf)
+        return 0;
+      memcpy(buf, _head.c_str(), space);
       _head = _head.substring(space);
-      request->client()->write(out.c_str(), out.length());
-      return out.length();
+      return _writeBuffer(request, buf, space);
     }
   }
 
   if(_state == RESPONSE_CONTENT){
+    if(_inflightCount == ASYNCWEBSERVER_RESPONSE_INFLIGHT)
+      return 0;
     size_t outLen;
     if(_chunked || !_sendContentLength){
       outLen = space;
@@ -277,7 +322,11 @@ size_t AsyncAbstractResponse::_ack(AsyncWebServerRequest *request, size_t len, u
       outLen = ((_contentLength - _sentLength) > space)?space:(_contentLength - _sentLength);
     }
 
-    uint8_t *buf = (uint8_t *)malloc(outLen+headLen);
+    //keep the packet within a pooled buffer, the rest goes out on the next ack
+    if(outLen + headLen > ASYNCWEBSERVER_RESPONSE_BUFFER_SIZE && headLen + 16 < ASYNCWEBSERVER_RESPONSE_BUFFER_SIZE)
+      outLen = ASYNCWEBSERVER_RESPONSE_BUFFER_SIZE - headLen;
+
+    uint8_t *buf = (uint8_t *)asyncWebBufferPool.alloc(outLen+headLen);
     if (!buf) {
       // os_printf("_ack malloc %d failed\n", outLen+headLen);
       return 0;
@@ -305,16 +354,13 @@ size_t AsyncAbstractResponse::_ack(AsyncWebServerRequest *request, size_t len, u
       outLen = _fillBuffer(buf+headLen, outLen) + headLen;
     }
 
-    if(outLen)
-      outLen = request->client()->write((const char*)buf, outLen);
+    outLen = _writeBuffer(request, buf, outLen);
 
     if(_chunked)
       _sentLength += readLen;
     else
       _sentLength += outLen - headLen;
 
-    free(buf);
-
     if((_chunked && readLen == 0) || (!_sendContentLength && outLen == 0) || _sentLength == _contentLength){
       _state = RESPONSE_WAIT_ACK;
     }
@@ -22,14 +22,32 @@
 #include "WebHandlerImpl.h"
 
 
-AsyncWebServer::AsyncWebServer(uint16_t port):_server(port), _rewrites(0), _handlers(0){
+static const char * ASYNCWEBSERVER_BUSY_RESPONSE = "HTTP/1.1 503 Service Unavailable\r\nConnection: close\r\nRetry-After: 1\r\nContent-Length: 0\r\n\r\n";
+
+AsyncWebServer::AsyncWebServer(uint16_t port)
+  : _server(port)
+  , _rewrites(0)
+  , _handlers(0)
+  , _connections(0)
+  , _maxConnections(ASYNCWEBSERVER_MAX_CONNECTIONS)
+  , _rejected(0)
+{
   _catchAllHandler = new AsyncCallbackWebHandler();
   if(_catchAllHandler == NULL)
     return;
   _server.onClient([](void *s, AsyncClient* c){
     if(c == NULL)
       return;
-    AsyncWebServerRequest *r = new AsyncWebServerRequest((AsyncWebServer*)s, c);
+    AsyncWebServer *server = (AsyncWebServer*)s;
+    if(server->_maxConnections && server->_connections >= server->_maxConnections){
+      //answer right away instead of allocating a request, the client is freed once closed
+      server->_rejected++;
+      c->onDisconnect([](void *r, AsyncClient* c){ delete c; });
+      c->write(ASYNCWEBSERVER_BUSY_RESPONSE, strlen(ASYNCWEBSERVER_BUSY_RESPONSE));
+      c->close();
+      return;
+    }
+    AsyncWebServerRequest *r = new AsyncWebServerRequest(server, c);
     if(r == NULL){
       c->close(true);
       c->free();
@@ -88,6 +106,18 @@ void AsyncWebServer::_handleDisconnect(AsyncWebServerRequest *request){
   delete request;
 }
 
+AsyncWebServerStats AsyncWebServer::stats(){
+  AsyncWebServerStats s;
+  s.connections = _connections;
+  s.maxConnections = _maxConnections;
+  s.rejected = _rejected;
+  s.requestPoolHits = asyncWebRequestPool.hits();
+  s.requestPoolMisses = asyncWebRequestPool.misses();
+  s.bufferPoolHits = asyncWebBufferPool.hits();
+  s.bufferPoolMisses = asyncWebBufferPool.misses();
+  return s;
+}
+
 void AsyncWebServer::_rewriteRequest(AsyncWebServerRequest *request){
   AsyncWebRewrite *r = _rewrites;
   while(r){
@@ -0,0 +1,59 @@
+/*
+ * ConnectionFlood.ino
+ *
+ * Serves a small page and prints the request/buffer pool counters, the
+ * number of rejected (503) connections and the free heap every second.
+ *
+ * Flood it from a host with:
+ *   python connection_flood.py <ip> --connections 64 --rounds 20
+ */
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <ESPAsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+
+const char* ssid = "SSID";
+const char* password = "passpasspass";
+
+AsyncWebServer server(80);
+uint32_t lastReport = 0;
+uint32_t minHeap = 0xFFFFFFFF;
+
+void setup(){
+  Serial.begin(115200);
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(ssid, password);
+  while(WiFi.status() != WL_CONNECTED){
+    delay(100);
+  }
+  Serial.print("IP: ");
+  Serial.println(WiFi.localIP());
+
+  server.setMaxConnections(4);
+  server.on("/", HTTP_GET, [](AsyncWebServerRequest *request){
+    request->send(200, "text/plain", "Hello World");
+  });
+  server.on("/stream", HTTP_GET, [](AsyncWebServerRequest *request){
+    request->sendChunked("text/plain", [](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+      if(index >= 16384)
+        return 0;
+      memset(buffer, 'x', maxLen);
+      return maxLen;
+    });
+  });
+  server.begin();
+}
+
+void loop(){
+  uint32_t heap = ESP.getFreeHeap();
+  if(heap < minHeap)
+    minHeap = heap;
+  if(millis() - lastReport >= 1000){
+    AsyncWebServerStats s = server.stats();
+    Serial.printf("conn: %u/%u, rejected: %u, request pool: %u hit %u miss, buffer pool: %u hit %u miss, heap: %u (min %u)\n",
+      s.connections, s.maxConnections, s.rejected, s.requestPoolHits, s.requestPoolMisses,
+      s.bufferPoolHits, s.bufferPoolMisses, heap, minHeap);
+    lastReport = millis();
+  }
+}
@@ -0,0 +1,64 @@
+#!/usr/bin/env python
+#
+# Opens many connections to ConnectionFlood.ino at once, sends a request on
+# each and counts how they were answered (200, 503, reset or timeout).
+#
+import argparse
+import collections
+import socket
+import threading
+import time
+
+
+def fetch(host, port, path, timeout, results, lock):
+    status = 'timeout'
+    try:
+        sock = socket.create_connection((host, port), timeout=timeout)
+        sock.sendall(('GET %s HTTP/1.1\r\nHost: %s\r\n\r\n' % (path, host)).encode())
+        response = b''
+        while True:
+            data = sock.recv(4096)
+            if not data:
+                break
+            response += data
+        sock.close()
+        line = response.split(b'\r\n', 1)[0].decode(errors='replace')
+        status = line.split(' ')[1] if line.startswith('HTTP/') else 'empty'
+    except socket.timeout:
+        status = 'timeout'
+    except (ConnectionResetError, ConnectionRefusedError, BrokenPipeError):
+        status = 'reset'
+    except OSError as e:
+        status = 'error:%s' % e.errno
+    with lock:
+        results[status] += 1
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('host')
+    parser.add_argument('--port', type=int, default=80)
+    parser.add_argument('--path', default='/')
+    parser.add_argument('--connections', type=int, default=32)
+    parser.add_argument('--rounds', type=int, default=10)
+    parser.add_argument('--timeout', type=float, default=10)
+    args = parser.parse_args()
+
+    total = collections.Counter()
+    for r in range(args.rounds):
+        results = collections.Counter()
+        lock = threading.Lock()
+        threads = [threading.Thread(target=fetch, args=(args.host, args.port, args.path, args.timeout, results, lock))
+                   for _ in range(args.connections)]
+        start = time.time()
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        print('round %d: %.2f s %s' % (r + 1, time.time() - start, dict(results)))
+        total.update(results)
+    print('total: %s' % dict(total))
+
+
+if __name__ == '__main__':
+    main()
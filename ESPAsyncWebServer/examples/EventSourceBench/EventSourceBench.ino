@@ -0,0 +1,66 @@
+/*
+ * EventSourceBench.ino
+ *
+ * Measures the time AsyncEventSource::send() spends encoding and fanning out
+ * one event to every connected subscriber, together with the free heap.
+ *
+ * Open many subscribers from a host, e.g.
+ *   for i in $(seq 1 32); do curl -sN http://<ip>/events > /dev/null & done
+ *
+ * Reconnect with a Last-Event-ID to check the replay ring, only the events
+ * after that id are sent back:
+ *   curl -N -H "Last-Event-ID: 100" http://<ip>/events
+ */
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <ESPAsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+
+const char* ssid = "SSID";
+const char* password = "passpasspass";
+
+AsyncWebServer server(80);
+AsyncEventSource events("/events");
+
+uint32_t eventId = 0;
+uint32_t sendCount = 0;
+uint32_t sendMicros = 0;
+uint32_t lastReport = 0;
+
+void setup(){
+  Serial.begin(115200);
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(ssid, password);
+  while(WiFi.status() != WL_CONNECTED){
+    delay(100);
+  }
+  Serial.print("IP: ");
+  Serial.println(WiFi.localIP());
+
+  events.onConnect([](AsyncEventSourceClient *client){
+    Serial.printf("subscriber connected, lastId: %u\n", client->lastId());
+  });
+  server.addHandler(&events);
+  server.begin();
+}
+
+void loop(){
+  char message[96];
+  snprintf(message, sizeof(message), "{\"id\":%u,\"heap\":%u,\"uptime\":%lu}", eventId + 1, ESP.getFreeHeap(), millis());
+
+  uint32_t start = micros();
+  events.send(message, "telemetry", ++eventId);
+  sendMicros += micros() - start;
+  sendCount++;
+
+  if(millis() - lastReport >= 1000){
+    size_t clients = events.count();
+    Serial.printf("subscribers: %u, send: %u us avg, %u us/subscriber, heap: %u\n",
+      clients, sendMicros / sendCount, clients ? (sendMicros / sendCount) / clients : 0, ESP.getFreeHeap());
+    sendCount = 0;
+    sendMicros = 0;
+    lastReport = millis();
+  }
+  delay(20);
+}
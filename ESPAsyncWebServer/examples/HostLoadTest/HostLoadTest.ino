@@ -0,0 +1,56 @@
+/*
+ * HostLoadTest.ino
+ *
+ * Runs the web server on a Linux host on top of the epoll backend of
+ * ESPAsyncTCP (ESPAsyncTCPposix.cpp), so the HTTP and WebSocket layers can
+ * be load tested and profiled without a board.
+ *
+ * Build it with the host Arduino core of ESPAsyncTCP:
+ *   cd ESPAsuncTCP/extras/host && make HostLoadTest && ./HostLoadTest
+ * then hit it with:
+ *   wrk -t4 -c64 -d30s http://127.0.0.1:8080/
+ *   python ../ConnectionFlood/connection_flood.py 127.0.0.1 --port 8080 --connections 256
+ *
+ * /ws echoes every complete WebSocket message back to its sender.
+ */
+
+#include <Arduino.h>
+#include <ESPAsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+
+AsyncWebServer server(8080);
+AsyncWebSocket ws("/ws");
+uint32_t lastReport = 0;
+
+void onWsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len){
+  if(type != WS_EVT_DATA)
+    return;
+  AwsFrameInfo * info = (AwsFrameInfo*)arg;
+  if(info->final && info->index == 0 && info->len == len){
+    if(info->opcode == WS_TEXT)
+      client->text(data, len);
+    else
+      client->binary(data, len);
+  }
+}
+
+void setup(){
+  Serial.begin(115200);
+  server.setMaxConnections(1024);
+  server.on("/", HTTP_GET, [](AsyncWebServerRequest *request){
+    request->send(200, "text/plain", "Hello World");
+  });
+  ws.onEvent(onWsEvent);
+  server.addHandler(&ws);
+  server.begin();
+}
+
+void loop(){
+  //socket events and ESPAsyncTCP timers, blocks for at most one timer tick
+  asyncTcpLoop();
+  if(millis() - lastReport >= 1000){
+    AsyncWebServerStats s = server.stats();
+    Serial.printf("conn: %u, rejected: %u, ws clients: %u\n", s.connections, s.rejected, (unsigned)ws.count());
+    lastReport = millis();
+  }
+}
@@ -0,0 +1,87 @@
+/*
+ * UploadBench.ino
+ *
+ * Reports multipart upload throughput and how the data reaches the upload
+ * handler (number of calls, average and largest slice).
+ *
+ * Run upload_bench.py from a host to post a 1 MB file in randomly sized
+ * TCP fragments:
+ *   python upload_bench.py <ip> --size 1048576
+ *
+ * It also builds on a Linux host with the host Arduino core of ESPAsyncTCP,
+ * on top of its epoll backend:
+ *   cd ESPAsuncTCP/extras/host && make UploadBench && ./UploadBench
+ *   python upload_bench.py 127.0.0.1 --port 8080 --count 20
+ */
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <ESPAsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+
+#if ASYNC_TCP_POSIX
+AsyncWebServer server(8080);
+#else
+const char* ssid = "SSID";
+const char* password = "passpasspass";
+
+AsyncWebServer server(80);
+#endif
+
+uint32_t uploadStart = 0;
+uint32_t uploadCalls = 0;
+size_t uploadBytes = 0;
+size_t uploadMaxSlice = 0;
+uint32_t uploadChecksum = 0;
+
+void onUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final){
+  if(!index){
+    uploadStart = micros();
+    uploadCalls = 0;
+    uploadBytes = 0;
+    uploadMaxSlice = 0;
+    uploadChecksum = 0;
+  }
+  uploadCalls++;
+  uploadBytes += len;
+  if(len > uploadMaxSlice)
+    uploadMaxSlice = len;
+  for(size_t i = 0; i < len; i++)
+    uploadChecksum += data[i];
+  if(final){
+    uint32_t us = micros() - uploadStart;
+    Serial.printf("%s: %u bytes in %u us (%u KB/s), %u calls, %u bytes/call, max %u, sum %08x\n",
+      filename.c_str(), (unsigned)uploadBytes, us, us ? (unsigned)((uint64_t)uploadBytes * 1000 / us) : 0, uploadCalls,
+      uploadCalls ? (unsigned)(uploadBytes / uploadCalls) : 0, (unsigned)uploadMaxSlice, uploadChecksum);
+#if !ASYNC_TCP_POSIX
+    Serial.printf("heap %u\n", ESP.getFreeHeap());
+#endif
+  }
+}
+
+void setup(){
+  Serial.begin(115200);
+#if !ASYNC_TCP_POSIX
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(ssid, password);
+  while(WiFi.status() != WL_CONNECTED){
+    delay(100);
+  }
+  Serial.print("IP: ");
+  Serial.println(WiFi.localIP());
+#endif
+
+  server.on("/upload", HTTP_POST, [](AsyncWebServerRequest *request){
+    char body[64];
+    snprintf(body, sizeof(body), "%u %08x\n", (unsigned)uploadBytes, uploadChecksum);
+    request->send(200, "text/plain", body);
+  }, onUpload);
+  server.begin();
+}
+
+void loop(){
+#if ASYNC_TCP_POSIX
+  //socket events and ESPAsyncTCP timers, blocks for at most one timer tick
+  asyncTcpLoop();
+#endif
+}
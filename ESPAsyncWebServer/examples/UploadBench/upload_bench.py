@@ -0,0 +1,74 @@
+#!/usr/bin/env python
+#
+# Posts a multipart/form-data upload to UploadBench.ino and writes the body in
+# randomly sized TCP fragments, so the boundary lands at arbitrary offsets
+# inside the segments the server receives.
+#
+import argparse
+import random
+import socket
+import sys
+import time
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('host')
+    parser.add_argument('--port', type=int, default=80)
+    parser.add_argument('--size', type=int, default=1024 * 1024)
+    parser.add_argument('--min-fragment', type=int, default=1)
+    parser.add_argument('--max-fragment', type=int, default=2920)
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--count', type=int, default=1, help='uploads, each on its own connection')
+    args = parser.parse_args()
+
+    rnd = random.Random(args.seed)
+    payload = bytearray(rnd.getrandbits(8) for _ in range(args.size))
+    boundary = '----UploadBench%08x' % rnd.getrandbits(32)
+    head = ('--%s\r\n'
+            'Content-Disposition: form-data; name="file"; filename="bench.bin"\r\n'
+            'Content-Type: application/octet-stream\r\n\r\n' % boundary).encode()
+    tail = ('\r\n--%s--\r\n' % boundary).encode()
+    body = head + bytes(payload) + tail
+    request = ('POST /upload HTTP/1.1\r\n'
+               'Host: %s\r\n'
+               'Content-Type: multipart/form-data; boundary=%s\r\n'
+               'Content-Length: %d\r\n\r\n' % (args.host, boundary, len(body))).encode()
+
+    expected = '%d %08x' % (args.size, sum(payload) & 0xffffffff)
+    total = 0.0
+    failed = 0
+    for i in range(args.count):
+        sock = socket.create_connection((args.host, args.port))
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        start = time.time()
+        sock.sendall(request)
+        pos = 0
+        fragments = 0
+        while pos < len(body):
+            n = rnd.randint(args.min_fragment, args.max_fragment)
+            sock.sendall(body[pos:pos + n])
+            pos += n
+            fragments += 1
+        response = b''
+        while b'\r\n\r\n' not in response or not response.endswith(b'\n'):
+            data = sock.recv(1024)
+            if not data:
+                break
+            response += data
+        elapsed = time.time() - start
+        total += elapsed
+        sock.close()
+
+        server = response.split(b'\r\n\r\n', 1)[-1].decode().strip()
+        if server != expected:
+            failed += 1
+        print('%d bytes in %d fragments, %.3f s, %.1f KB/s, server: %s' % (args.size, fragments, elapsed, args.size / 1024.0 / elapsed, server))
+    print('expected: %s' % expected)
+    if args.count > 1:
+        print('%d uploads, %.1f KB/s on average, %d wrong' % (args.count, args.count * args.size / 1024.0 / total, failed))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
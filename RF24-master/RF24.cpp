@@ -10,6 +10,20 @@
 #include "RF24_config.h"
 #include "RF24.h"
 
+#if defined (RF24_ASYNC)
+  // handleIRQ() runs in the interrupt handler, the other async calls lock it out
+  #if defined (RF24_SPIDEV) || defined (RF24_RPi) || defined (RF24_SIM)
+    #define rf24_irq_off() rfNoInterrupts()
+    #define rf24_irq_on() rfInterrupts()
+  #elif defined (ARDUINO)
+    #define rf24_irq_off() noInterrupts()
+    #define rf24_irq_on() interrupts()
+  #else
+    #define rf24_irq_off()
+    #define rf24_irq_on()
+  #endif
+#endif
+
 /****************************************************************************/
 
 void RF24::csn(bool mode)
@@ -420,6 +434,14 @@ RF24::RF24(uint8_t _cepin, uint8_t _cspin):
   payload_size(32), dynamic_payloads_enabled(false), addr_width(5)//,pipe0_reading_address(0)
 {
   pipe0_reading_address[0]=0;
+#if defined (RF24_ASYNC)
+  async_tx_head = async_tx_cnt = async_tx_fifo = async_tx_retry = async_tx_retries = 0;
+  async_tx_ce = false;
+  async_rx_head = async_rx_cnt = 0;
+  async_rx_full = false;
+  async_tx_ok = async_tx_fail = NULL;
+  async_rx_ready = NULL;
+#endif
 }
 
 /****************************************************************************/
@@ -429,6 +451,14 @@ RF24::RF24(uint8_t _cepin, uint8_t _cspin, uint32_t _spi_speed):
   ce_pin(_cepin),csn_pin(_cspin),spi_speed(_spi_speed),p_variant(false), payload_size(32), dynamic_payloads_enabled(false),addr_width(5)//,pipe0_reading_address(0) 
 {
   pipe0_reading_address[0]=0;
+#if defined (RF24_ASYNC)
+  async_tx_head = async_tx_cnt = async_tx_fifo = async_tx_retry = async_tx_retries = 0;
+  async_tx_ce = false;
+  async_rx_head = async_rx_cnt = 0;
+  async_rx_full = false;
+  async_tx_ok = async_tx_fail = NULL;
+  async_rx_ready = NULL;
+#endif
 }
 #endif
 
@@ -1108,6 +1138,251 @@ void RF24::whatHappened(bool& tx_ok,bool& tx_fail,bool& rx_ready)
   rx_ready = status & _BV(RX_DR);
 }
 
+/****************************************************************************/
+#if defined (RF24_ASYNC)
+
+void RF24::startAsync(void)
+{
+  rf24_irq_off();
+  async_tx_head = async_tx_cnt = async_tx_fifo = async_tx_retry = 0;
+  async_tx_ce = false;
+  async_rx_head = async_rx_cnt = 0;
+  async_rx_full = false;
+  maskIRQ(0,0,0);
+  write_register(NRF_STATUS,_BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT) );
+  if( !(read_register(NRF_CONFIG) & _BV(PRIM_RX)) ){
+	flush_tx();
+  }
+  // Payloads received before the start
+  async_rx_drain();
+  rf24_irq_on();
+}
+
+/****************************************************************************/
+
+bool RF24::writeAsync(const void* buf, uint8_t len, const bool multicast)
+{
+  if( async_tx_cnt >= RF24_ASYNC_TX_SIZE ){
+	return 0;
+  }
+  uint8_t data_len = rf24_min(len,32);
+
+  rf24_irq_off();
+  uint8_t i = ( async_tx_head + async_tx_cnt ) % RF24_ASYNC_TX_SIZE;
+  memcpy(async_tx_buf[i],buf,data_len);
+  async_tx_len[i] = data_len | ( multicast ? 0x80 : 0 );
+  async_tx_cnt++;
+  async_tx_fill();
+  rf24_irq_on();
+  return 1;
+}
+
+/****************************************************************************/
+
+uint8_t RF24::readAsync(void* buf, uint8_t len, uint8_t* pipe_num)
+{
+  if( !async_rx_cnt ){
+	return 0;
+  }
+  uint8_t data_len = async_rx_len[async_rx_head];
+  memcpy(buf,async_rx_buf[async_rx_head],rf24_min(len,data_len));
+  if( pipe_num ){
+	*pipe_num = async_rx_pipe[async_rx_head];
+  }
+
+  rf24_irq_off();
+  async_rx_head = ( async_rx_head + 1 ) % RF24_ASYNC_RX_SIZE;
+  async_rx_cnt--;
+  // There is room again for the payloads waiting in the RX FIFO
+  if( async_rx_full ){
+	async_rx_full = false;
+	async_rx_drain();
+  }
+  rf24_irq_on();
+  return data_len;
+}
+
+/****************************************************************************/
+
+uint8_t RF24::availableAsync(void)
+{
+  return async_rx_cnt;
+}
+
+/****************************************************************************/
+
+uint8_t RF24::pendingAsync(void)
+{
+  return async_tx_cnt;
+}
+
+/****************************************************************************/
+
+void RF24::setAsyncCallbacks(rf24_tx_callback tx_ok, rf24_tx_callback tx_fail, rf24_rx_callback rx_ready)
+{
+  rf24_irq_off();
+  async_tx_ok = tx_ok;
+  async_tx_fail = tx_fail;
+  async_rx_ready = rx_ready;
+  rf24_irq_on();
+}
+
+/****************************************************************************/
+
+void RF24::setAsyncRetries(uint8_t count)
+{
+  async_tx_retries = count;
+}
+
+/****************************************************************************/
+
+void RF24::handleIRQ(void)
+{
+  uint8_t status = get_status();
+
+  while( status & ( _BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT) ) ){
+	// Unlike whatHappened(), CE goes low before MAX_RT is cleared,
+	// otherwise the radio starts to send the failed payload again
+	if( ( status & _BV(MAX_RT) ) && async_tx_ce ){
+	  ce(LOW);
+	  async_tx_ce = false;
+	}
+	// Flags set from now on raise the IRQ again
+	write_register(NRF_STATUS, status & ( _BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT) ) );
+
+	if( status & _BV(RX_DR) ){
+	  async_rx_drain();
+	}
+	if( status & _BV(MAX_RT) ){
+	  async_tx_failed();
+	}else if( status & _BV(TX_DS) ){
+	  async_tx_sent();
+	}
+	status = get_status();
+  }
+}
+
+/****************************************************************************/
+
+void RF24::async_tx_fill(void)
+{
+  while( async_tx_fifo < async_tx_cnt && async_tx_fifo < 3 ){
+	uint8_t i = ( async_tx_head + async_tx_fifo ) % RF24_ASYNC_TX_SIZE;
+	startFastWrite(async_tx_buf[i], async_tx_len[i] & 0x3F, async_tx_len[i] & 0x80, 0);
+	async_tx_fifo++;
+  }
+  if( async_tx_fifo && !async_tx_ce ){
+	ce(HIGH);
+	async_tx_ce = true;
+  }
+}
+
+/****************************************************************************/
+
+void RF24::async_tx_sent(void)
+{
+  uint8_t fifo = read_register(FIFO_STATUS);
+  // Payloads left in the TX FIFO: exact if empty or full, at most 2 otherwise
+  uint8_t left = ( fifo & _BV(TX_EMPTY) ) ? 0 : ( fifo & _BV(FIFO_FULL) ) ? 3 : 2;
+
+  for(;;){
+	if( async_tx_fifo > left ){
+	  async_tx_confirm(async_tx_fifo - left);
+	}
+	async_tx_fill();
+	if( async_tx_fifo < 3 ){
+	  break;
+	}
+	// Keep the FIFO full: if it is not, another payload was sent
+	if( get_status() & _BV(TX_FULL) ){
+	  break;
+	}
+	left = 2;
+  }
+
+  if( !async_tx_fifo && async_tx_ce ){
+	ce(LOW);			   //Set STANDBY-I mode
+	async_tx_ce = false;
+  }
+}
+
+/****************************************************************************/
+
+void RF24::async_tx_confirm(uint8_t count)
+{
+  while( count-- ){
+	if( async_tx_ok ){
+	  async_tx_ok(async_tx_buf[async_tx_head], async_tx_len[async_tx_head] & 0x3F);
+	}
+	async_tx_head = ( async_tx_head + 1 ) % RF24_ASYNC_TX_SIZE;
+	async_tx_cnt--;
+	async_tx_fifo--;
+	async_tx_retry = 0;
+  }
+}
+
+/****************************************************************************/
+
+void RF24::async_tx_failed(void)
+{
+  if( !async_tx_fifo ){
+	return;
+  }
+  // The radio stopped with the failed payload first in the TX FIFO
+  uint8_t left = 1;
+  if( get_status() & _BV(TX_FULL) ){
+	left = 3;
+  }else if( async_tx_fifo > 1 ){
+	// One or two left: write the failed payload once more, it is flushed anyway
+	startFastWrite(async_tx_buf[async_tx_head], async_tx_len[async_tx_head] & 0x3F, 0, 0);
+	left = ( get_status() & _BV(TX_FULL) ) ? 2 : 1;
+  }
+  flush_tx();
+  async_tx_confirm(async_tx_fifo - left);
+  async_tx_fifo = 0;
+
+  if( async_tx_retry < async_tx_retries ){
+	async_tx_retry++;
+  }else{
+	if( async_tx_fail ){
+	  async_tx_fail(async_tx_buf[async_tx_head], async_tx_len[async_tx_head] & 0x3F);
+	}
+	async_tx_head = ( async_tx_head + 1 ) % RF24_ASYNC_TX_SIZE;
+	async_tx_cnt--;
+	async_tx_retry = 0;
+  }
+  // Write the rest of the queue again, in order
+  async_tx_fill();
+}
+
+/****************************************************************************/
+
+void RF24::async_rx_drain(void)
+{
+  uint8_t pipe;
+
+  while( ( pipe = ( get_status() >> RX_P_NO ) & 0b111 ) < 6 ){
+	if( async_rx_cnt >= RF24_ASYNC_RX_SIZE ){
+	  // The radio does not acknowledge while its RX FIFO is full
+	  async_rx_full = true;
+	  return;
+	}
+	uint8_t len = dynamic_payloads_enabled ? getDynamicPayloadSize() : payload_size;
+	if( !len ){
+	  continue; // Corrupt payload, the RX FIFO was flushed
+	}
+	uint8_t i = ( async_rx_head + async_rx_cnt ) % RF24_ASYNC_RX_SIZE;
+	read_payload(async_rx_buf[i], len);
+	async_rx_len[i] = len;
+	async_rx_pipe[i] = pipe;
+	async_rx_cnt++;
+	if( async_rx_ready ){
+	  async_rx_ready(pipe, len);
+	}
+  }
+}
+
+#endif
 /****************************************************************************/
 
 void RF24::openWritingPipe(uint64_t value)
@@ -44,6 +44,22 @@ typedef enum { RF24_1MBPS = 0, RF24_2MBPS, RF24_250KBPS } rf24_datarate_e;
  */
 typedef enum { RF24_CRC_DISABLED = 0, RF24_CRC_8, RF24_CRC_16 } rf24_crclength_e;
 
+#if defined (RF24_ASYNC)
+/**
+ * Called when a payload of writeAsync() was sent or failed.
+ *
+ * For use with setAsyncCallbacks()
+ */
+typedef void (*rf24_tx_callback)(const void* buf, uint8_t len);
+
+/**
+ * Called when a payload was received into the RX ring of readAsync().
+ *
+ * For use with setAsyncCallbacks()
+ */
+typedef void (*rf24_rx_callback)(uint8_t pipe, uint8_t len);
+#endif
+
 /**
  * Driver for nRF24L01(+) 2.4GHz Wireless Transceiver
  */
@@ -77,6 +93,25 @@ private:
   uint8_t pipe0_reading_address[5]; /**< Last address set on pipe 0 for reading. */
   uint8_t addr_width; /**< The address width to use - 3,4 or 5 bytes. */
   uint32_t txRxDelay; /**< Var for adjusting delays depending on datarate */
+#if defined (RF24_ASYNC)
+  uint8_t async_tx_buf[RF24_ASYNC_TX_SIZE][32]; /**< Queue of writeAsync() */
+  uint8_t async_tx_len[RF24_ASYNC_TX_SIZE]; /**< Length of the queued payloads, bit 7 for multicast */
+  uint8_t async_tx_head; /**< First payload of the queue */
+  volatile uint8_t async_tx_cnt; /**< Payloads in the queue */
+  uint8_t async_tx_fifo; /**< Payloads of the queue written to the TX FIFO and not confirmed yet */
+  uint8_t async_tx_retry; /**< Failures of the first payload */
+  uint8_t async_tx_retries; /**< Failures before a payload is dropped, see setAsyncRetries() */
+  bool async_tx_ce; /**< CE is high for the queue */
+  uint8_t async_rx_buf[RF24_ASYNC_RX_SIZE][32]; /**< Ring of readAsync() */
+  uint8_t async_rx_len[RF24_ASYNC_RX_SIZE]; /**< Length of the received payloads */
+  uint8_t async_rx_pipe[RF24_ASYNC_RX_SIZE]; /**< Pipe of the received payloads */
+  uint8_t async_rx_head; /**< First payload of the ring */
+  volatile uint8_t async_rx_cnt; /**< Payloads in the ring */
+  volatile bool async_rx_full; /**< Payloads wait in the RX FIFO for room in the ring */
+  rf24_tx_callback async_tx_ok; /**< Callback for sent payloads */
+  rf24_tx_callback async_tx_fail; /**< Callback for failed payloads */
+  rf24_rx_callback async_rx_ready; /**< Callback for received payloads */
+#endif
   
 
 protected:
@@ -907,6 +942,109 @@ s   *
   void maskIRQ(bool tx_ok,bool tx_fail,bool rx_ready);
   
   /**@}*/
+#if defined (RF24_ASYNC)
+  /**
+   * @name Asynchronous operation
+   *
+   *  Interrupt driven TX queue and RX ring. Instead of polling the status
+   *  register over SPI like write() and available(), handleIRQ() is called
+   *  from the interrupt of the IRQ pin. It refills the TX FIFO from a software
+   *  queue as the radio sends the payloads and drains the RX FIFO into a ring.
+   *  Always available on Linux, define RF24_ASYNC in RF24_config.h for Arduino.
+   *  The sizes of the queue and the ring are RF24_ASYNC_TX_SIZE and RF24_ASYNC_RX_SIZE.
+   *
+   * @code
+   * void intHandler(){ radio.handleIRQ(); }
+   *
+   * radio.begin();
+   * radio.openWritingPipe(addresses[0]);
+   * radio.startAsync();
+   * attachInterrupt(interruptPin, INT_EDGE_FALLING, intHandler); // Linux
+   * attachInterrupt(0, intHandler, FALLING); // Arduino
+   *
+   * while(!radio.writeAsync(&data,sizeof(data))){ delay(1); }
+   * @endcode
+   */
+  /**@{*/
+
+  /**
+   * Start the asynchronous operation
+   *
+   * Enables all interrupts of the radio, clears the TX queue, the RX ring
+   * and the TX FIFO. Call it after startListening() or stopListening(),
+   * before the interrupt handler is attached.
+   */
+  void startAsync(void);
+
+  /**
+   * Queue a payload for the open writing pipe
+   *
+   * Returns immediately. The payload is written to the TX FIFO as soon as
+   * there is room, the radio stays in TX mode while the queue is not empty.
+   * The radio has to be a transmitter, see stopListening().
+   *
+   * @param buf Pointer to the data to be sent
+   * @param len Number of bytes to be sent
+   * @param multicast Request ACK (0) or NOACK (1)
+   * @return True if the payload was queued, false if the queue is full
+   */
+  bool writeAsync(const void* buf, uint8_t len, const bool multicast = 0);
+
+  /**
+   * Take the next payload from the RX ring
+   *
+   * Ack payloads received by a transmitter arrive here as well, on pipe 0.
+   *
+   * @param buf Pointer to a buffer where the data should be written
+   * @param len Maximum number of bytes to read into the buffer
+   * @param[out] pipe_num Which pipe has the payload, or NULL
+   * @return Length of the payload, 0 if the ring is empty
+   */
+  uint8_t readAsync(void* buf, uint8_t len, uint8_t* pipe_num = NULL);
+
+  /**
+   * @return Number of payloads in the RX ring
+   */
+  uint8_t availableAsync(void);
+
+  /**
+   * @return Number of payloads in the TX queue, which are not sent yet
+   */
+  uint8_t pendingAsync(void);
+
+  /**
+   * Set the callbacks of the asynchronous operation, NULL for none
+   *
+   * @warning The callbacks are called from handleIRQ() with interrupts disabled.
+   * They must be short and must not call writeAsync() or readAsync().
+   *
+   * @param tx_ok Called when a payload was sent (and acknowledged)
+   * @param tx_fail Called when a payload is dropped after all retries
+   * @param rx_ready Called when a payload was received into the ring
+   */
+  void setAsyncCallbacks(rf24_tx_callback tx_ok, rf24_tx_callback tx_fail, rf24_rx_callback rx_ready);
+
+  /**
+   * How often a payload is sent again after the auto retransmit of the
+   * radio failed (MAX_RT), before it is dropped and tx_fail is called.
+   *
+   * @param count Failures before a payload is dropped, 0 drops at the first
+   */
+  void setAsyncRetries(uint8_t count);
+
+  /**
+   * Call this from the interrupt handler of the IRQ pin
+   *
+   * Clears the interrupt flags, drains the RX FIFO into the ring, confirms
+   * the sent payloads and refills the TX FIFO from the queue.
+   *
+   * @note On Linux, attachInterrupt() runs the handler with the lock of
+   * rfNoInterrupts() held, so handleIRQ() does not lock again.
+   */
+  void handleIRQ(void);
+
+  /**@}*/
+#endif
   /**
    * @name Deprecated
    *
@@ -1116,6 +1254,38 @@ private:
 	void errNotify(void);
   #endif
   
+#if defined (RF24_ASYNC)
+  /**
+   * Write queued payloads to the TX FIFO, while there is room
+   */
+  void async_tx_fill(void);
+
+  /**
+   * Remove sent payloads from the queue after TX_DS and refill the TX FIFO
+   *
+   * The TX FIFO only tells empty, full or in between. In between, at most
+   * two payloads are left, the rest is confirmed once it is known.
+   */
+  void async_tx_sent(void);
+
+  /**
+   * Remove the first payloads from the queue and call the tx_ok callback
+   *
+   * @param count Number of sent payloads
+   */
+  void async_tx_confirm(uint8_t count);
+
+  /**
+   * Handle MAX_RT: retry or drop the first payload of the TX FIFO
+   */
+  void async_tx_failed(void);
+
+  /**
+   * Read the RX FIFO into the ring, while there is room
+   */
+  void async_rx_drain(void);
+#endif
+
   /**@}*/
 
 };
@@ -20,6 +20,7 @@
   //#define MINIMAL
   //#define SPI_UART  // Requires library from https://github.com/TMRh20/Sketches/tree/master/SPI_UART
   //#define SOFTSPI   // Requires library from https://github.com/greiman/DigitalIO
+  //#define RF24_ASYNC // Interrupt driven writeAsync()/readAsync(), always enabled on Linux
   
   /**********************/
   #define rf24_max(a,b) (a>b?a:b)
@@ -153,7 +154,27 @@
 
 #endif
 
+// Interrupt driven TX queue and RX ring, see RF24::handleIRQ()
+#if defined (RF24_LINUX) && !defined (RF24_ASYNC)
+  #define RF24_ASYNC
+#endif
 
+#if defined (RF24_ASYNC)
+  #if !defined (RF24_ASYNC_TX_SIZE)
+    #if defined (RF24_LINUX)
+      #define RF24_ASYNC_TX_SIZE 32
+    #else
+      #define RF24_ASYNC_TX_SIZE 4
+    #endif
+  #endif
+  #if !defined (RF24_ASYNC_RX_SIZE)
+    #if defined (RF24_LINUX)
+      #define RF24_ASYNC_RX_SIZE 32
+    #else
+      #define RF24_ASYNC_RX_SIZE 4
+    #endif
+  #endif
+#endif
 
 #endif // __RF24_CONFIG_H__
 
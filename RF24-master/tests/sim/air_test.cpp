@@ -0,0 +1,150 @@
+/*
+ * air_test.cpp
+ *
+ * write() between simulated radios over the air: addresses, channel, data
+ * rate, NO_ACK, ACK payloads, full RX FIFO and lost ACKs.
+ *
+ * ./configure --driver=Sim && cd tests/sim && make test
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <RF24.h>
+#include <nRF24L01.h>
+
+SimRadio tx_sim(22, 0);
+SimRadio rx1_sim(24, 1);
+SimRadio rx2_sim(26, 2);
+
+RF24 tx(22, 0);
+RF24 rx1(24, 1);
+RF24 rx2(26, 2);
+
+const uint8_t addresses[][6] = {"1Node","2Node","3Node"};
+
+#define check(cond, ...) do { if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); exit(1); } } while (0)
+
+/* rx1 listens to 1Node on pipe 1, rx2 to 2Node on pipe 1 and 1Node on pipe 2 */
+static void setup(void)
+{
+	SimRadio::setLoss(0, 0);
+	tx.begin();
+	rx1.begin();
+	rx2.begin();
+	tx.openWritingPipe(addresses[0]);
+	rx1.openReadingPipe(1, addresses[0]);
+	rx2.openReadingPipe(1, addresses[1]);
+	rx2.openReadingPipe(2, addresses[0]);
+	tx.stopListening();
+	rx1.startListening();
+	rx2.startListening();
+}
+
+static int receive(RF24& radio, uint32_t* value, uint8_t* pipe)
+{
+	uint8_t buf[32];
+	if (!radio.available(pipe))
+		return 0;
+	radio.read(buf, sizeof(buf));
+	memcpy(value, buf, sizeof(*value));
+	return 1;
+}
+
+static bool send(uint32_t value, bool multicast = 0)
+{
+	uint8_t buf[32];
+	memset(buf, 0, sizeof(buf));
+	memcpy(buf, &value, sizeof(value));
+	return tx.write(buf, sizeof(buf), multicast);
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t value, before;
+	uint8_t pipe;
+	int i;
+
+	// Both receivers get it, on the pipe with the address
+	setup();
+	check(send(1), "write");
+	check(receive(rx1, &value, &pipe) && value == 1 && pipe == 1, "rx1 value %u pipe %d", value, pipe);
+	check(receive(rx2, &value, &pipe) && value == 1 && pipe == 2, "rx2 value %u pipe %d", value, pipe);
+	tx.openWritingPipe(addresses[1]);
+	check(send(2), "write");
+	check(!receive(rx1, &value, &pipe), "rx1 got 2Node");
+	check(receive(rx2, &value, &pipe) && value == 2 && pipe == 1, "rx2 value %u pipe %d", value, pipe);
+	tx.openWritingPipe(addresses[2]);
+	check(!send(3), "3Node acknowledged");
+	printf("PASS addresses\n");
+
+	setup();
+	tx.setChannel(90);
+	check(!send(4), "other channel acknowledged");
+	rx1.setChannel(90);
+	check(send(5) && receive(rx1, &value, &pipe) && value == 5, "same channel");
+	check(!receive(rx2, &value, &pipe), "rx2 on the old channel");
+	printf("PASS channel\n");
+
+	setup();
+	tx.setDataRate(RF24_2MBPS);
+	check(!send(6), "other data rate acknowledged");
+	rx2.setDataRate(RF24_2MBPS);
+	check(send(7) && receive(rx2, &value, &pipe) && value == 7, "same data rate");
+	printf("PASS data rate\n");
+
+	// NO_ACK is sent once, without receiver as well
+	setup();
+	tx.enableDynamicAck();
+	before = tx_sim.tx_attempts;
+	check(send(8, 1), "multicast");
+	check(tx_sim.tx_attempts == before + 1, "%u attempts", tx_sim.tx_attempts - before);
+	check(receive(rx1, &value, &pipe) && value == 8, "multicast rx1");
+	tx.openWritingPipe(addresses[2]);
+	check(send(9, 1), "multicast without receiver");
+	printf("PASS no ack\n");
+
+	// Full RX FIFO: no ACK, until the receiver reads
+	setup();
+	rx2.stopListening();
+	for (i = 0; i < 3; i++)
+		check(send(10 + i), "write %d", i);
+	check(!send(13), "full RX FIFO acknowledged");
+	check(receive(rx1, &value, &pipe) && value == 10, "first of the FIFO");
+	check(send(13), "write after read");
+	for (i = 11; i <= 13; i++)
+		check(receive(rx1, &value, &pipe) && value == (uint32_t)i, "value %u, not %d", value, i);
+	printf("PASS rx fifo full\n");
+
+	// ACK payloads
+	setup();
+	rx2.stopListening();
+	tx.enableAckPayload();
+	rx1.enableAckPayload();
+	rx1.startListening();
+	for (i = 0; i < 10; i++) {
+		uint8_t ack[4] = { (uint8_t)i, 0xA5, 0x5A, 0 };
+		rx1.writeAckPayload(1, ack, 3);
+		check(send(20 + i), "write %d", i);
+		check(tx.available(&pipe) && tx.getDynamicPayloadSize() == 3, "no ACK payload %d", i);
+		tx.read(ack, 3);
+		check(ack[0] == i && ack[1] == 0xA5 && ack[2] == 0x5A, "ACK payload %d", i);
+		check(receive(rx1, &value, &pipe) && value == (uint32_t)(20 + i), "value %u", value);
+	}
+	printf("PASS ack payloads\n");
+
+	// Lost ACKs: the retransmits are acknowledged, but stored once
+	setup();
+	rx2.stopListening();
+	SimRadio::setLoss(100, 400);
+	before = rx1_sim.rx_duplicates;
+	for (uint32_t n = 0; n < 500; n++) {
+		check(send(n), "write %u", n);
+		check(receive(rx1, &value, &pipe) && value == n, "value %u, not %u", value, n);
+		check(!receive(rx1, &value, &pipe), "%u twice", n);
+	}
+	check(rx1_sim.rx_duplicates > before, "no duplicates");
+	printf("PASS lost acks: %u duplicates\n", rx1_sim.rx_duplicates - before);
+
+	return 0;
+}
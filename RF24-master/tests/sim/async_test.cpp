@@ -0,0 +1,232 @@
+/*
+ * async_test.cpp
+ *
+ * writeAsync()/readAsync() between two simulated radios. The link of the
+ * transmitter can drop the attempts of chosen payloads, to force MAX_RT.
+ *
+ * ./configure --driver=Sim && cd tests/sim && make test
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <RF24.h>
+#include <nRF24L01.h>
+
+#define N 200
+
+SimRadio tx_sim(22, 0, 23);
+SimRadio rx_sim(24, 1, 25);
+
+RF24 tx(22, 0);
+RF24 rx(24, 1);
+
+const uint8_t addresses[][6] = {"1Node","2Node"};
+
+/* Attempts of a payload which are dropped, by sequence number */
+static uint8_t drops[N];
+
+/* What happened, in order */
+static uint16_t tx_ok[N], tx_fail[N], rx_got[N], acks[N];
+static int tx_ok_cnt, tx_fail_cnt, rx_got_cnt, ack_cnt, tx_irq_cnt;
+
+static bool link(SimRadio& radio, const uint8_t* buf, uint8_t len, uint8_t* ack, uint8_t* ack_len)
+{
+	uint16_t seq = buf[0] | buf[1] << 8;
+	if (seq < N && drops[seq]) {
+		drops[seq]--;
+		return false;
+	}
+	return rx_sim.receive(1, buf, len, ack, ack_len);
+}
+
+static void tx_isr() { tx_irq_cnt++; tx.handleIRQ(); }
+static void rx_isr() { rx.handleIRQ(); }
+
+static void on_tx_ok(const void* buf, uint8_t len)
+{
+	const uint8_t* p = (const uint8_t*)buf;
+	if (tx_ok_cnt < N)
+		tx_ok[tx_ok_cnt++] = p[0] | p[1] << 8;
+}
+
+static void on_tx_fail(const void* buf, uint8_t len)
+{
+	const uint8_t* p = (const uint8_t*)buf;
+	if (tx_fail_cnt < N)
+		tx_fail[tx_fail_cnt++] = p[0] | p[1] << 8;
+}
+
+#define check(cond, ...) do { if (!(cond)) { printf("FAIL %s:%d: ", __FILE__, __LINE__); printf(__VA_ARGS__); printf("\n"); exit(1); } } while (0)
+
+struct options {
+	uint8_t async_retries;
+	bool ack_payloads;
+	uint32_t rx_pause_ms;	/* the receiver does not read at first */
+	uint32_t irq_latency_us;	/* interrupts of the host are blocked in between */
+};
+
+static void setup(const options& o)
+{
+	memset(drops, 0, sizeof(drops));
+	tx_ok_cnt = tx_fail_cnt = rx_got_cnt = ack_cnt = tx_irq_cnt = 0;
+
+	tx.begin();
+	rx.begin();
+	tx.setRetries(1, 3);
+	if (o.ack_payloads) {
+		tx.enableAckPayload();
+		rx.enableAckPayload();
+	}
+	tx.openWritingPipe(addresses[0]);
+	rx.openReadingPipe(1, addresses[0]);
+	tx.stopListening();
+	rx.startListening();
+
+	tx.setAsyncRetries(o.async_retries);
+	tx.setAsyncCallbacks(on_tx_ok, on_tx_fail, NULL);
+	tx.startAsync();
+	rx.startAsync();
+}
+
+static void drain(void)
+{
+	uint8_t buf[32];
+	uint8_t pipe;
+	uint8_t len;
+
+	while ((len = rx.readAsync(buf, sizeof(buf), &pipe)) > 0) {
+		check(pipe == 1 && len == 32, "rx pipe %d len %d", pipe, len);
+		if (rx_got_cnt < N)
+			rx_got[rx_got_cnt++] = buf[0] | buf[1] << 8;
+	}
+	while ((len = tx.readAsync(buf, sizeof(buf), &pipe)) > 0) {
+		check(pipe == 0 && len == 2, "ack pipe %d len %d", pipe, len);
+		if (ack_cnt < N)
+			acks[ack_cnt++] = buf[0] | buf[1] << 8;
+	}
+}
+
+/* Send N payloads, returns the virtual time in ms */
+static uint32_t run(const options& o)
+{
+	uint8_t buf[32];
+	uint16_t seq = 0;
+	uint16_t ack_seq = 0;
+	uint32_t start = millis();
+
+	while (seq < N || tx.pendingAsync() > 0) {
+		check(millis() - start < 10000, "timeout, %d of %d sent", seq, N);
+		// Keep the TX FIFO of the receiver full of ACK payloads
+		if (o.ack_payloads && ack_seq < N && !(rx_sim.getRegister(FIFO_STATUS) & _BV(FIFO_FULL))) {
+			buf[0] = ack_seq;
+			buf[1] = ack_seq >> 8;
+			rx.writeAckPayload(1, buf, 2);
+			ack_seq++;
+		}
+		if (seq < N) {
+			memset(buf, seq, sizeof(buf));
+			buf[0] = seq;
+			buf[1] = seq >> 8;
+			if (tx.writeAsync(buf, sizeof(buf))) {
+				seq++;
+				continue;
+			}
+		}
+		if (millis() - start >= o.rx_pause_ms)
+			drain();
+		if (o.irq_latency_us) {
+			rfNoInterrupts();
+			delayMicroseconds(o.irq_latency_us);
+			rfInterrupts();
+		} else {
+			delayMicroseconds(100);
+		}
+	}
+	delay(10);
+	drain();
+	return millis() - start;
+}
+
+/* Received and confirmed in order, except the failed ones */
+static void verify(void)
+{
+	int i, j = 0, f = 0;
+
+	check(tx_ok_cnt + tx_fail_cnt == N, "%d ok + %d failed", tx_ok_cnt, tx_fail_cnt);
+	check(rx_got_cnt == tx_ok_cnt, "%d received, %d ok", rx_got_cnt, tx_ok_cnt);
+	for (i = 0; i < N; i++) {
+		if (f < tx_fail_cnt && tx_fail[f] == i) {
+			f++;
+			continue;
+		}
+		check(tx_ok[j] == i, "ok %d is %d, not %d", j, tx_ok[j], i);
+		check(rx_got[j] == i, "received %d is %d, not %d", j, rx_got[j], i);
+		j++;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	options o;
+	uint32_t ms;
+
+	tx_sim.setLink(link);
+	attachInterrupt(23, INT_EDGE_FALLING, tx_isr);
+	attachInterrupt(25, INT_EDGE_FALLING, rx_isr);
+
+	memset(&o, 0, sizeof(o));
+	setup(o);
+	ms = run(o);
+	verify();
+	check(tx_fail_cnt == 0, "%d failed", tx_fail_cnt);
+	printf("PASS stream: %d payloads in %u ms, %u SPI transactions\n", N, ms, tx_sim.spi_transactions);
+
+	setup(o);
+	drops[5] = 100;
+	drops[17] = 100;
+	drops[N - 1] = 100;
+	ms = run(o);
+	verify();
+	check(tx_fail_cnt == 3 && tx_fail[0] == 5 && tx_fail[1] == 17 && tx_fail[2] == N - 1, "failed %d", tx_fail_cnt);
+	printf("PASS failures: %d failed\n", tx_fail_cnt);
+
+	o.async_retries = 2;
+	setup(o);
+	drops[7] = 8;	/* two times MAX_RT with 3 retransmits */
+	drops[8] = 4;
+	ms = run(o);
+	verify();
+	check(tx_fail_cnt == 0, "%d failed", tx_fail_cnt);
+	printf("PASS retries: all sent\n");
+
+	o.async_retries = 255;
+	o.rx_pause_ms = 50;
+	setup(o);
+	ms = run(o);
+	verify();
+	check(tx_fail_cnt == 0, "%d failed", tx_fail_cnt);
+	printf("PASS backpressure: receiver paused %u ms\n", o.rx_pause_ms);
+
+	o.async_retries = 0;
+	o.rx_pause_ms = 0;
+	o.ack_payloads = true;
+	setup(o);
+	ms = run(o);
+	verify();
+	check(ack_cnt == N, "%d ACK payloads", ack_cnt);
+	for (int i = 0; i < N; i++)
+		check(acks[i] == i, "ACK payload %d is %d", i, acks[i]);
+	printf("PASS ack payloads: %d\n", ack_cnt);
+
+	o.ack_payloads = false;
+	o.irq_latency_us = 1500;
+	setup(o);
+	ms = run(o);
+	verify();
+	check(tx_fail_cnt == 0, "%d failed", tx_fail_cnt);
+	check(tx_irq_cnt < N, "%d interrupts", tx_irq_cnt);
+	printf("PASS irq latency: %d payloads with %d interrupts\n", N, tx_irq_cnt);
+
+	return 0;
+}
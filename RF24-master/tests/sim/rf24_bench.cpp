@@ -0,0 +1,211 @@
+/*
+ * rf24_bench.cpp
+ *
+ * Throughput and latency of the write methods between two simulated radios,
+ * at each data rate. The receiver runs on another host (its SPI transfers
+ * take no time) and reads in its interrupt handler, the time is virtual.
+ *
+ * - write:       write() of each payload, blocks until the ACK
+ * - writeFast:   writeFast() of each payload, txStandBy() at the end
+ * - txStandBy:   writeFast() of 3 payloads, then txStandBy()
+ * - ack payload: write() and read() of the ACK payload of the receiver
+ * - writeAsync:  writeAsync(), handleIRQ() in the interrupt handler
+ *
+ * Latency is the time from the call with the payload until the receiver
+ * has it, SPI is the number of transactions of the sender per payload.
+ *
+ * ./configure --driver=Sim && cd tests/sim && make rf24_bench && ./rf24_bench [payloads] [loss]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <RF24.h>
+#include <nRF24L01.h>
+
+#define MAX_PAYLOADS 10000
+
+SimRadio tx_sim(22, 0, 23);
+SimRadio rx_sim(24, 1, 25);
+
+RF24 tx(22, 0);
+RF24 rx(24, 1);
+
+const uint8_t addresses[][6] = {"1Node","2Node"};
+
+static uint64_t sent_at[MAX_PAYLOADS];
+static bool got[MAX_PAYLOADS];
+static int received;
+static uint64_t last_at, latency_sum, latency_max;
+static bool ack_payloads;
+
+struct rate {
+	const char* name;
+	rf24_datarate_e value;
+};
+
+static const rate rates[] = {
+	{ "250KBPS", RF24_250KBPS },
+	{ "1MBPS", RF24_1MBPS },
+	{ "2MBPS", RF24_2MBPS },
+};
+
+static void rx_isr()
+{
+	bool tx_ok, tx_fail, rx_ready;
+	uint8_t buf[32];
+	uint32_t seq;
+
+	rx.whatHappened(tx_ok, tx_fail, rx_ready);
+	while (rx.available()) {
+		rx.read(buf, sizeof(buf));
+		if (ack_payloads)
+			rx.writeAckPayload(1, buf, sizeof(buf));
+		memcpy(&seq, buf, sizeof(seq));
+		if (seq < MAX_PAYLOADS && !got[seq]) {
+			uint64_t latency = sim_now() - sent_at[seq];
+			got[seq] = true;
+			received++;
+			latency_sum += latency;
+			if (latency > latency_max)
+				latency_max = latency;
+			last_at = sim_now();
+		}
+	}
+}
+
+static void tx_isr() { tx.handleIRQ(); }
+
+static void setup(rf24_datarate_e rate, bool ack)
+{
+	uint8_t buf[32];
+
+	tx.begin();
+	rx.begin();
+	tx.setDataRate(rate);
+	rx.setDataRate(rate);
+	ack_payloads = ack;
+	if (ack) {
+		tx.enableAckPayload();
+		rx.enableAckPayload();
+	}
+	tx.openWritingPipe(addresses[0]);
+	rx.openReadingPipe(1, addresses[0]);
+	tx.stopListening();
+	rx.startListening();
+	if (ack) {
+		memset(buf, 0xff, sizeof(buf));
+		rx.writeAckPayload(1, buf, sizeof(buf));
+	}
+	memset(got, 0, sizeof(got));
+	received = 0;
+	latency_sum = latency_max = 0;
+}
+
+static const uint8_t* payload(uint32_t seq)
+{
+	static uint8_t buf[32];
+	memset(buf, seq, sizeof(buf));
+	memcpy(buf, &seq, sizeof(seq));
+	sent_at[seq] = sim_now();
+	return buf;
+}
+
+static void run_write(int n)
+{
+	for (int i = 0; i < n; i++)
+		tx.write(payload(i), 32);
+}
+
+static void run_writeFast(int n)
+{
+	for (int i = 0; i < n; i++) {
+		// 0 after MAX_RT: the payload stays in the FIFO, like the last one
+		tx.writeFast(payload(i), 32);
+	}
+	tx.txStandBy();
+}
+
+static void run_txStandBy(int n)
+{
+	for (int i = 0; i < n; i++) {
+		tx.writeFast(payload(i), 32);
+		if (i % 3 == 2 || i == n - 1)
+			tx.txStandBy();
+	}
+}
+
+static void run_ack_payload(int n)
+{
+	uint8_t buf[32];
+	for (int i = 0; i < n; i++) {
+		if (tx.write(payload(i), 32))
+			while (tx.available())
+				tx.read(buf, sizeof(buf));
+	}
+}
+
+static void run_writeAsync(int n)
+{
+	tx.startAsync();
+	attachInterrupt(23, INT_EDGE_FALLING, tx_isr);
+	for (int i = 0; i < n; ) {
+		if (tx.writeAsync(payload(i), 32))
+			i++;
+		else
+			delayMicroseconds(50);
+	}
+	while (tx.pendingAsync())
+		delayMicroseconds(50);
+	detachInterrupt(23);
+}
+
+struct mode {
+	const char* name;
+	void (*fn)(int n);
+	bool ack;
+};
+
+static const mode modes[] = {
+	{ "write", run_write, false },
+	{ "writeFast", run_writeFast, false },
+	{ "txStandBy", run_txStandBy, false },
+	{ "ack payload", run_ack_payload, true },
+	{ "writeAsync", run_writeAsync, false },
+};
+
+int main(int argc, char** argv)
+{
+	int n = argc > 1 ? atoi(argv[1]) : 1000;
+	int loss = argc > 2 ? atoi(argv[2]) : 0;
+
+	if (n < 1 || n > MAX_PAYLOADS)
+		n = 1000;
+	rx_sim.setRemote(true);
+	attachInterrupt(25, INT_EDGE_FALLING, rx_isr);
+
+	printf("%d payloads of 32 bytes, %d/1000 packets and ACKs lost\n\n", n, loss);
+	printf("%-8s %-12s %9s %9s %9s %9s %7s %8s\n", "rate", "method", "payload/s", "kbit/s", "lat us", "max us", "SPI", "attempts");
+	for (unsigned r = 0; r < sizeof(rates) / sizeof(*rates); r++) {
+		for (unsigned m = 0; m < sizeof(modes) / sizeof(*modes); m++) {
+			setup(rates[r].value, modes[m].ack);
+			SimRadio::setLoss(loss, loss);
+			uint32_t spi = tx_sim.spi_transactions;
+			uint32_t attempts = tx_sim.tx_attempts;
+			uint64_t start = sim_now();
+			modes[m].fn(n);
+			delay(10);
+			SimRadio::setLoss(0, 0);
+
+			double s = (last_at - start) / 1e9;
+			printf("%-8s %-12s %9.0f %9.1f %9.1f %9.1f %7.2f %8.2f", rates[r].name, modes[m].name,
+				received / s, received * 32 * 8 / s / 1000,
+				received ? latency_sum / 1e3 / received : 0.0, latency_max / 1e3,
+				(double)(tx_sim.spi_transactions - spi) / n, (double)(tx_sim.tx_attempts - attempts) / n);
+			if (received < n)
+				printf("  %d lost", n - received);
+			printf("\n");
+		}
+	}
+	return 0;
+}
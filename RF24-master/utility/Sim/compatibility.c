@@ -0,0 +1,30 @@
+
+#include "compatibility.h"
+#include "sim.h"
+
+/**********************************************************************/
+/**
+ * delay() and delayMicroseconds() let the virtual time pass,
+ * interrupt handlers of the simulated radios run meanwhile
+ */
+void __msleep(int milisec)
+{
+	sim_sleep(milisec * 1000000ULL);
+}
+
+void __usleep(int milisec)
+{
+	sim_sleep(milisec * 1000ULL);
+}
+
+/**
+ * millis() is the virtual time, which starts at 0
+ */
+void __start_timer()
+{
+}
+
+long __millis()
+{
+	return (long)(sim_now() / 1000000ULL);
+}
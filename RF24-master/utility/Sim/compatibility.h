@@ -0,0 +1,27 @@
+/*
+ * File:   compatibility.h
+ *
+ * Arduino timing functions on the virtual time of the simulated radio
+ */
+
+#ifndef COMPATIBLITY_H
+#define	COMPATIBLITY_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <time.h>
+#include <sys/time.h>
+
+void __msleep(int milisec);
+void __usleep(int milisec);
+void __start_timer();
+long __millis();
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* COMPATIBLITY_H */
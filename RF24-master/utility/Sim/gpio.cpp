@@ -0,0 +1,37 @@
+/*
+ * File:   gpio.cpp
+ *
+ * CE and IRQ pins of the simulated radios
+ */
+
+#include "gpio.h"
+#include "sim.h"
+
+GPIO::GPIO() {
+}
+
+GPIO::~GPIO() {
+}
+
+void GPIO::open(int port, int DDR)
+{
+}
+
+void GPIO::close(int port)
+{
+}
+
+int GPIO::read(int port)
+{
+	SimRadio* radio = SimRadio::byIRQ(port);
+	if (radio == NULL)
+		return 1;
+	return !radio->irq();
+}
+
+void GPIO::write(int port, int value)
+{
+	SimRadio* radio = SimRadio::byCE(port);
+	if (radio != NULL)
+		radio->setCE(value != 0);
+}
@@ -0,0 +1,8 @@
+
+#ifndef __RF24_INCLUDES_H__
+#define __RF24_INCLUDES_H__
+
+#define RF24_SIM
+  #include "Sim/RF24_arch_config.h"
+  #include "Sim/interrupt.h"
+#endif
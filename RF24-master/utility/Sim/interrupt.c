@@ -0,0 +1,76 @@
+/*
+ * File:   interrupt.c
+ *
+ * attachInterrupt() for the IRQ pins of the simulated radios. There are no
+ * threads: a pending handler runs when the host would give the interrupt
+ * thread of the SPIDEV driver a chance to lock the pin mutex.
+ */
+
+#include "interrupt.h"
+
+static int disabled ;
+
+// ISR Data
+static void (*isrFunctions [64])(void) ;
+static int isrModes [64] ;
+static volatile int isrPending [64] ;
+
+int attachInterrupt (int pin, int mode, void (*function)(void))
+{
+  if (pin < 0 || pin >= 64)
+    return -1 ;
+  isrModes [pin] = mode ;
+  isrPending [pin] = 0 ;
+  isrFunctions [pin] = function ;
+  return 0 ;
+}
+
+int detachInterrupt (int pin)
+{
+  if (pin < 0 || pin >= 64)
+    return 0 ;
+  isrFunctions [pin] = NULL ;
+  isrPending [pin] = 0 ;
+  return 1 ;
+}
+
+void sim_irq_edge (int pin, int level)
+{
+  int mode ;
+
+  if (pin < 0 || pin >= 64 || isrFunctions [pin] == NULL)
+    return ;
+  mode = isrModes [pin] ;
+  if (mode == INT_EDGE_BOTH || (mode == INT_EDGE_FALLING && !level) || (mode == INT_EDGE_RISING && level))
+    isrPending [pin] = 1 ;
+}
+
+void sim_irq_dispatch (void)
+{
+  int pin ;
+
+  if (disabled)
+    return ;
+  for (pin = 0 ; pin < 64 ; pin++)
+  {
+    if (isrPending [pin] && isrFunctions [pin] != NULL)
+    {
+      isrPending [pin] = 0 ;
+      // The handler holds the pin mutex, like the interrupt thread of SPIDEV
+      disabled++ ;
+      isrFunctions [pin] () ;
+      disabled-- ;
+      pin = -1 ;	// A handler may raise another interrupt
+    }
+  }
+}
+
+void rfNoInterrupts(){
+  disabled++ ;
+}
+
+void rfInterrupts(){
+  if (disabled > 0)
+    disabled-- ;
+  sim_irq_dispatch() ;
+}
@@ -0,0 +1,60 @@
+/*
+ * File:   interrupt.h
+ *
+ * attachInterrupt() for the IRQ pins of the simulated radios
+ */
+
+#include "RF24_arch_config.h"
+
+#define INT_EDGE_SETUP          0
+#define INT_EDGE_FALLING        1
+#define INT_EDGE_RISING         2
+#define INT_EDGE_BOTH           3
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * attachInterrupt:
+ *      The function is called when the pin changes like given by mode.
+ *      It runs at the next point where a thread could run: during a
+ *      delay() or after an SPI transfer, not between rfNoInterrupts()
+ *      and rfInterrupts().
+ *********************************************************************************
+ */
+extern int attachInterrupt (int pin, int mode, void (*function)(void));
+
+/*
+ * detachInterrupt:
+ *      Remove the function of the pin.
+ *********************************************************************************
+ */
+extern int detachInterrupt (int pin);
+
+/*
+ * rfNoInterrupts, rfInterrupts:
+ *      Like the pin mutex of the SPIDEV driver, no handler runs in between.
+ *      Pending handlers run in rfInterrupts().
+ *********************************************************************************
+ */
+extern void rfNoInterrupts();
+extern void rfInterrupts();
+
+/*
+ * sim_irq_edge:
+ *      Called by the radio model when the level of an IRQ pin changes.
+ *********************************************************************************
+ */
+extern void sim_irq_edge (int pin, int level);
+
+/*
+ * sim_irq_dispatch:
+ *      Run the handlers of all pending interrupts, if not disabled.
+ *********************************************************************************
+ */
+extern void sim_irq_dispatch (void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,559 @@
+/*
+ * File:   sim.cpp
+ *
+ * Simulated nRF24L01+ for host builds (./configure --driver=Sim)
+ */
+
+#include "sim.h"
+#include "interrupt.h"
+#include "../../nRF24L01.h"
+#include <string.h>
+
+#ifndef _BV
+#define _BV(x) (1<<(x))
+#endif
+
+/* Settling time of the PLL before a transmission and before the ACK is received */
+#define SIM_SETTLE_NS 130000ULL
+
+static uint64_t sim_time;
+static SimRadio* radios[SIM_MAX_RADIOS];
+static uint32_t spi_hz = 8000000;
+static uint32_t spi_overhead_ns = 2000;
+static uint16_t loss_packet;
+static uint16_t loss_ack;
+static uint32_t rnd_state = 1;
+
+/* Deterministic, so a run can be repeated */
+static bool lost(uint16_t per_mille)
+{
+	if (per_mille == 0)
+		return false;
+	rnd_state = rnd_state * 1103515245 + 12345;
+	return (rnd_state >> 16) % 1000 < per_mille;
+}
+
+/****************************************************************************/
+
+uint64_t sim_now(void)
+{
+	return sim_time;
+}
+
+void sim_sleep(uint64_t ns)
+{
+	SimRadio::run(sim_time + ns, true);
+}
+
+/****************************************************************************/
+
+SimRadio::SimRadio(uint8_t _ce_pin, uint8_t _csn_pin, uint8_t _irq_pin):
+	spi_transactions(0), spi_bytes(0), tx_attempts(0), rx_packets(0), rx_duplicates(0),
+	ce_pin(_ce_pin), csn_pin(_csn_pin), irq_pin(_irq_pin), remote(false), link(NULL)
+{
+	reset();
+	for (int i = 0; i < SIM_MAX_RADIOS; i++) {
+		if (radios[i] == NULL) {
+			radios[i] = this;
+			break;
+		}
+	}
+}
+
+SimRadio::~SimRadio()
+{
+	for (int i = 0; i < SIM_MAX_RADIOS; i++) {
+		if (radios[i] == this)
+			radios[i] = NULL;
+	}
+}
+
+SimRadio* SimRadio::byCSN(uint8_t pin)
+{
+	for (int i = 0; i < SIM_MAX_RADIOS; i++) {
+		if (radios[i] != NULL && radios[i]->csn_pin == pin)
+			return radios[i];
+	}
+	return NULL;
+}
+
+SimRadio* SimRadio::byCE(uint8_t pin)
+{
+	for (int i = 0; i < SIM_MAX_RADIOS; i++) {
+		if (radios[i] != NULL && radios[i]->ce_pin == pin)
+			return radios[i];
+	}
+	return NULL;
+}
+
+SimRadio* SimRadio::byIRQ(uint8_t pin)
+{
+	for (int i = 0; i < SIM_MAX_RADIOS; i++) {
+		if (radios[i] != NULL && radios[i]->irq_pin == pin)
+			return radios[i];
+	}
+	return NULL;
+}
+
+void SimRadio::setSPITiming(uint32_t hz, uint32_t overhead_ns)
+{
+	spi_hz = hz;
+	spi_overhead_ns = overhead_ns;
+}
+
+void SimRadio::setLoss(uint16_t packet, uint16_t ack)
+{
+	loss_packet = packet;
+	loss_ack = ack;
+}
+
+/****************************************************************************/
+
+/* Power on reset values of the nRF24L01+ */
+void SimRadio::reset(void)
+{
+	memset(reg, 0, sizeof(reg));
+	reg[NRF_CONFIG] = 0x08;
+	reg[EN_AA] = 0x3F;
+	reg[EN_RXADDR] = 0x03;
+	reg[SETUP_AW] = 0x03;
+	reg[SETUP_RETR] = 0x03;
+	reg[RF_CH] = 0x02;
+	reg[RF_SETUP] = 0x0E;
+	memset(addr, 0, sizeof(addr));
+	memset(addr[RX_ADDR_P0 - RX_ADDR_P0], 0xE7, 5);
+	memset(addr[RX_ADDR_P1 - RX_ADDR_P0], 0xC2, 5);
+	addr[RX_ADDR_P2 - RX_ADDR_P0][0] = 0xC3;
+	addr[RX_ADDR_P3 - RX_ADDR_P0][0] = 0xC4;
+	addr[RX_ADDR_P4 - RX_ADDR_P0][0] = 0xC5;
+	addr[RX_ADDR_P5 - RX_ADDR_P0][0] = 0xC6;
+	memset(addr[TX_ADDR - RX_ADDR_P0], 0xE7, 5);
+	ce = false;
+	irq_low = false;
+	reuse = false;
+	tx_cnt = 0;
+	rx_cnt = 0;
+	state = IDLE;
+	event_time = 0;
+	arc_cnt = 0;
+	ack_len = 0;
+	pid = 0;
+	last_pid = 0xff;
+	last_len = 0;
+}
+
+/* reg[NRF_STATUS] only holds the interrupt flags */
+uint8_t SimRadio::status(void)
+{
+	return (reg[NRF_STATUS] & (_BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT))) |
+		((rx_cnt ? rx_fifo[0].pipe : 7) << RX_P_NO) |
+		(tx_cnt == SIM_FIFO_SIZE ? _BV(TX_FULL) : 0);
+}
+
+uint8_t SimRadio::fifoStatus(void)
+{
+	return (reuse ? _BV(TX_REUSE) : 0) |
+		(tx_cnt == SIM_FIFO_SIZE ? _BV(FIFO_FULL) : 0) |
+		(tx_cnt == 0 ? _BV(TX_EMPTY) : 0) |
+		(rx_cnt == SIM_FIFO_SIZE ? _BV(RX_FULL) : 0) |
+		(rx_cnt == 0 ? _BV(RX_EMPTY) : 0);
+}
+
+uint8_t SimRadio::getRegister(uint8_t r)
+{
+	if (r == NRF_STATUS)
+		return status();
+	if (r == FIFO_STATUS)
+		return fifoStatus();
+	if (r >= RX_ADDR_P0 && r <= TX_ADDR)
+		return addr[r - RX_ADDR_P0][0];
+	if (r < sizeof(reg))
+		return reg[r];
+	return 0;
+}
+
+void SimRadio::readRegister(uint8_t r, uint8_t* buf, uint32_t len)
+{
+	if (len == 0)
+		return;
+	if (r >= RX_ADDR_P0 && r <= TX_ADDR) {
+		for (uint32_t i = 0; i < len; i++)
+			buf[i] = i < 5 ? addr[r - RX_ADDR_P0][i] : 0;
+		return;
+	}
+	buf[0] = getRegister(r);
+}
+
+void SimRadio::writeRegister(uint8_t r, const uint8_t* buf, uint32_t len)
+{
+	if (len == 0)
+		return;
+	switch (r) {
+	case NRF_STATUS:
+		// Write 1 to clear
+		reg[NRF_STATUS] &= ~(buf[0] & (_BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT)));
+		if (buf[0] & _BV(MAX_RT))
+			kick(sim_time);
+		break;
+	case OBSERVE_TX:
+	case CD:
+	case FIFO_STATUS:
+		break;
+	case RF_CH:
+		reg[RF_CH] = buf[0] & 0x7F;
+		reg[OBSERVE_TX] &= 0x0F; // PLOS_CNT is reset by writing RF_CH
+		break;
+	case NRF_CONFIG:
+		reg[NRF_CONFIG] = buf[0] & 0x7F;
+		if (!(reg[NRF_CONFIG] & _BV(PWR_UP)) || (reg[NRF_CONFIG] & _BV(PRIM_RX)))
+			state = IDLE;
+		kick(sim_time);
+		break;
+	default:
+		if (r >= RX_ADDR_P0 && r <= TX_ADDR) {
+			uint32_t n = (r == RX_ADDR_P0 || r == RX_ADDR_P1 || r == TX_ADDR) ? 5 : 1;
+			memcpy(addr[r - RX_ADDR_P0], buf, len < n ? len : n);
+		} else if (r < sizeof(reg)) {
+			reg[r] = buf[0];
+		}
+		break;
+	}
+	updateIRQ();
+}
+
+/****************************************************************************/
+
+void SimRadio::transfer(const uint8_t* tx, uint8_t* rx, uint32_t len)
+{
+	uint8_t in[64];
+	uint8_t out[64];
+	uint32_t n;
+
+	if (len == 0)
+		return;
+	// The command runs at the end of the transfer
+	if (!remote)
+		run(sim_time + spi_overhead_ns + (uint64_t)len * 8 * 1000000000ULL / spi_hz, false);
+	spi_transactions++;
+	spi_bytes += len;
+
+	n = len < sizeof(in) ? len : sizeof(in);
+	memcpy(in, tx, n);
+	memset(out, 0, sizeof(out));
+	out[0] = status();
+	n--;
+
+	uint8_t cmd = in[0];
+	if (cmd < W_REGISTER) {
+		readRegister(cmd & REGISTER_MASK, out + 1, n);
+	} else if (cmd < W_REGISTER + 0x20) {
+		writeRegister(cmd & REGISTER_MASK, in + 1, n);
+	} else if (cmd == R_RX_PAYLOAD) {
+		if (rx_cnt) {
+			memcpy(out + 1, rx_fifo[0].data, n < rx_fifo[0].len ? n : rx_fifo[0].len);
+			rx_cnt--;
+			memmove(rx_fifo, rx_fifo + 1, rx_cnt * sizeof(Payload));
+		}
+	} else if (cmd == R_RX_PL_WID) {
+		out[1] = rx_cnt ? rx_fifo[0].len : 0;
+	} else if (cmd == W_TX_PAYLOAD || cmd == W_TX_PAYLOAD_NO_ACK) {
+		// NO_ACK is only accepted with EN_DYN_ACK
+		bool no_ack = cmd == W_TX_PAYLOAD_NO_ACK;
+		if (n > 0 && n <= 32 && tx_cnt < SIM_FIFO_SIZE && (!no_ack || (reg[FEATURE] & _BV(EN_DYN_ACK)))) {
+			tx_fifo[tx_cnt].len = n;
+			tx_fifo[tx_cnt].pipe = 0;
+			// The packet ID tells a retransmit from a new payload
+			pid = (pid + 1) & 0x03;
+			tx_fifo[tx_cnt].pid = pid;
+			tx_fifo[tx_cnt].no_ack = no_ack;
+			memcpy(tx_fifo[tx_cnt].data, in + 1, n);
+			tx_cnt++;
+			reuse = false;
+			kick(sim_time);
+		}
+	} else if ((cmd & ~0x07) == W_ACK_PAYLOAD) {
+		if (n > 0 && n <= 32 && tx_cnt < SIM_FIFO_SIZE && (reg[FEATURE] & _BV(EN_ACK_PAY))) {
+			tx_fifo[tx_cnt].len = n;
+			tx_fifo[tx_cnt].pipe = cmd & 0x07;
+			tx_fifo[tx_cnt].pid = 0;
+			tx_fifo[tx_cnt].no_ack = false;
+			memcpy(tx_fifo[tx_cnt].data, in + 1, n);
+			tx_cnt++;
+		}
+	} else if (cmd == FLUSH_TX) {
+		tx_cnt = 0;
+		reuse = false;
+		if (state != IDLE && !(reg[NRF_CONFIG] & _BV(PRIM_RX)))
+			state = IDLE;
+	} else if (cmd == FLUSH_RX) {
+		rx_cnt = 0;
+	} else if (cmd == REUSE_TX_PL) {
+		reuse = tx_cnt > 0;
+	}
+	// ACTIVATE and NOP only return the status
+
+	updateIRQ();
+	memcpy(rx, out, len < sizeof(out) ? len : sizeof(out));
+	sim_irq_dispatch();
+}
+
+void SimRadio::setCE(bool level)
+{
+	bool rise = level && !ce;
+	ce = level;
+	if (rise)
+		kick(sim_time);
+}
+
+/****************************************************************************/
+
+bool SimRadio::receive(uint8_t pipe, const void* buf, uint8_t len, uint8_t* ack, uint8_t* _ack_len)
+{
+	if (_ack_len)
+		*_ack_len = 0;
+	if (!(reg[NRF_CONFIG] & _BV(PWR_UP)) || !(reg[NRF_CONFIG] & _BV(PRIM_RX)) || !ce)
+		return false;
+	if (pipe > 5 || !(reg[EN_RXADDR] & _BV(pipe)) || rx_cnt == SIM_FIFO_SIZE || len == 0 || len > 32)
+		return false;
+
+	rx_fifo[rx_cnt].len = len;
+	rx_fifo[rx_cnt].pipe = pipe;
+	rx_fifo[rx_cnt].no_ack = false;
+	memcpy(rx_fifo[rx_cnt].data, buf, len);
+	rx_cnt++;
+	rx_packets++;
+	reg[NRF_STATUS] |= _BV(RX_DR);
+
+	// The first ACK payload for the pipe goes out with the ACK
+	if (ack != NULL && _ack_len != NULL) {
+		for (uint8_t i = 0; i < tx_cnt; i++) {
+			if (tx_fifo[i].pipe == pipe) {
+				memcpy(ack, tx_fifo[i].data, tx_fifo[i].len);
+				*_ack_len = tx_fifo[i].len;
+				tx_cnt--;
+				memmove(tx_fifo + i, tx_fifo + i + 1, (tx_cnt - i) * sizeof(Payload));
+				reg[NRF_STATUS] |= _BV(TX_DS);
+				break;
+			}
+		}
+	}
+	updateIRQ();
+	return true;
+}
+
+/****************************************************************************/
+
+/* IRQ is active low, while an interrupt flag is set which is not masked in CONFIG */
+void SimRadio::updateIRQ(void)
+{
+	bool low = (reg[NRF_STATUS] & ~reg[NRF_CONFIG] & (_BV(RX_DR) | _BV(TX_DS) | _BV(MAX_RT))) != 0;
+	if (low != irq_low) {
+		irq_low = low;
+		if (irq_pin != 0xff)
+			sim_irq_edge(irq_pin, !low);
+	}
+}
+
+/* CRC is forced on while auto ACK is enabled on any pipe */
+uint8_t SimRadio::crcLength(void)
+{
+	if (!(reg[NRF_CONFIG] & _BV(EN_CRC)) && !reg[EN_AA])
+		return 0;
+	return (reg[NRF_CONFIG] & _BV(CRCO)) ? 2 : 1;
+}
+
+bool SimRadio::dynamic(uint8_t pipe)
+{
+	return (reg[FEATURE] & _BV(EN_DPL)) && (reg[DYNPD] & _BV(pipe));
+}
+
+/* Time on air: preamble, address, 9 bit packet control field, payload and CRC */
+uint64_t SimRadio::airTime(uint8_t len)
+{
+	uint32_t aw = (reg[SETUP_AW] & 0x03) + 2;
+	uint32_t crc = crcLength();
+	uint32_t rate = 1000000;
+
+	if (reg[RF_SETUP] & _BV(RF_DR_LOW))
+		rate = 250000;
+	else if (reg[RF_SETUP] & _BV(RF_DR_HIGH))
+		rate = 2000000;
+	return (uint64_t)(8 * (1 + aw + len + crc) + 9) * 1000000000ULL / rate;
+}
+
+/* Start the first payload of the TX FIFO, if the radio is a PTX with CE high */
+void SimRadio::kick(uint64_t t)
+{
+	if (state != IDLE || !ce || tx_cnt == 0)
+		return;
+	if (!(reg[NRF_CONFIG] & _BV(PWR_UP)) || (reg[NRF_CONFIG] & _BV(PRIM_RX)) || (reg[NRF_STATUS] & _BV(MAX_RT)))
+		return;
+	state = TX;
+	arc_cnt = 0;
+	reg[OBSERVE_TX] &= 0xF0;
+	tx_attempts++;
+	event_time = t + SIM_SETTLE_NS + airTime(tx_fifo[0].len);
+}
+
+/* The first payload was sent, or acknowledged */
+void SimRadio::txDone(uint64_t t)
+{
+	if (!reuse) {
+		tx_cnt--;
+		memmove(tx_fifo, tx_fifo + 1, tx_cnt * sizeof(Payload));
+	}
+	reg[NRF_STATUS] |= _BV(TX_DS);
+	state = IDLE;
+	updateIRQ();
+	kick(t);
+}
+
+void SimRadio::event(void)
+{
+	uint64_t t = event_time;
+	Payload* p = tx_fifo;
+
+	switch (state) {
+	case TX: {
+		// End of a transmission attempt
+		bool expect_ack = (reg[EN_AA] & _BV(ENAA_P0)) && !p->no_ack;
+		bool ok;
+		ack_len = 0;
+		ok = link != NULL ? link(*this, p->data, p->len, ack_buf, &ack_len) : air(*p, ack_buf, &ack_len);
+		if (!expect_ack) {
+			txDone(t);
+		} else if (ok && !(ack_len && rx_cnt == SIM_FIFO_SIZE)) {
+			state = ACK;
+			event_time = t + SIM_SETTLE_NS + airTime(ack_len);
+		} else if (arc_cnt < (reg[SETUP_RETR] & 0x0F)) {
+			// Auto retransmit, ARD after the end of the attempt
+			arc_cnt++;
+			reg[OBSERVE_TX] = (reg[OBSERVE_TX] & 0xF0) | arc_cnt;
+			tx_attempts++;
+			event_time = t + ((reg[SETUP_RETR] >> ARD) + 1) * 250000ULL + airTime(p->len);
+		} else {
+			state = LOST;
+			event_time = t + SIM_SETTLE_NS + airTime(0);
+		}
+		break;
+	}
+	case ACK:
+		if (ack_len) {
+			rx_fifo[rx_cnt].len = ack_len;
+			rx_fifo[rx_cnt].pipe = 0;
+			rx_fifo[rx_cnt].no_ack = false;
+			memcpy(rx_fifo[rx_cnt].data, ack_buf, ack_len);
+			rx_cnt++;
+			reg[NRF_STATUS] |= _BV(RX_DR);
+		}
+		txDone(t);
+		break;
+	case LOST:
+		// No ACK after the last retransmit, the payload stays in the FIFO
+		state = IDLE;
+		if ((reg[OBSERVE_TX] >> PLOS_CNT) < 15)
+			reg[OBSERVE_TX] += 1 << PLOS_CNT;
+		reg[NRF_STATUS] |= _BV(MAX_RT);
+		updateIRQ();
+		break;
+	}
+}
+
+/****************************************************************************/
+
+/* Pipe of this radio which receives the packet of tx, -1 for none */
+int SimRadio::match(SimRadio& tx, const Payload& p)
+{
+	const uint8_t rate = _BV(RF_DR_LOW) | _BV(RF_DR_HIGH);
+	const uint8_t* tx_addr = tx.addr[TX_ADDR - RX_ADDR_P0];
+	uint8_t aw = (reg[SETUP_AW] & 0x03) + 2;
+
+	if (!(reg[NRF_CONFIG] & _BV(PWR_UP)) || !(reg[NRF_CONFIG] & _BV(PRIM_RX)) || !ce)
+		return -1;
+	if (reg[RF_CH] != tx.reg[RF_CH] || (reg[RF_SETUP] & rate) != (tx.reg[RF_SETUP] & rate) ||
+	    reg[SETUP_AW] != tx.reg[SETUP_AW] || crcLength() != tx.crcLength())
+		return -1;
+	for (uint8_t pipe = 0; pipe < 6; pipe++) {
+		if (!(reg[EN_RXADDR] & _BV(pipe)))
+			continue;
+		// Pipes 2-5 share all but the first byte with pipe 1
+		if (addr[pipe][0] != tx_addr[0] || memcmp(addr[pipe < 2 ? pipe : 1] + 1, tx_addr + 1, aw - 1) != 0)
+			continue;
+		// Without dynamic payloads, the length is set by RX_PW_Px
+		if (dynamic(pipe) != tx.dynamic(0))
+			continue;
+		if (!dynamic(pipe) && p.len != (reg[RX_PW_P0 + pipe] & 0x3F))
+			continue;
+		return pipe;
+	}
+	return -1;
+}
+
+/* The packet goes to all radios which receive it, the first ACK payload comes back */
+bool SimRadio::air(const Payload& p, uint8_t* ack, uint8_t* _ack_len)
+{
+	uint8_t aw = (reg[SETUP_AW] & 0x03) + 2;
+	bool acked = false;
+
+	*_ack_len = 0;
+	if (lost(loss_packet))
+		return false;
+	for (int i = 0; i < SIM_MAX_RADIOS; i++) {
+		SimRadio* r = radios[i];
+		uint8_t buf[32];
+		uint8_t len = 0;
+		if (r == NULL || r == this)
+			continue;
+		int pipe = r->match(*this, p);
+		if (pipe < 0)
+			continue;
+		bool ack_req = !p.no_ack && (r->reg[EN_AA] & _BV(pipe));
+
+		if (p.pid == r->last_pid && p.len == r->last_len && memcmp(p.data, r->last_data, p.len) == 0) {
+			// The ACK was lost, acknowledge again without storing
+			r->rx_duplicates++;
+		} else if (r->receive(pipe, p.data, p.len, ack_req ? buf : NULL, &len)) {
+			r->last_pid = p.pid;
+			r->last_len = p.len;
+			memcpy(r->last_data, p.data, p.len);
+		} else {
+			// RX FIFO full, no ACK
+			continue;
+		}
+		if (!ack_req)
+			continue;
+		// The ACK is received on pipe 0, with the TX address
+		if (!(reg[EN_RXADDR] & _BV(ERX_P0)) || memcmp(addr[0], addr[TX_ADDR - RX_ADDR_P0], aw) != 0 || lost(loss_ack))
+			continue;
+		if (!acked) {
+			memcpy(ack, buf, len);
+			*_ack_len = len;
+		}
+		acked = true;
+	}
+	return acked;
+}
+
+/****************************************************************************/
+
+void SimRadio::run(uint64_t until, bool dispatch)
+{
+	for (;;) {
+		SimRadio* r = NULL;
+		for (int i = 0; i < SIM_MAX_RADIOS; i++) {
+			SimRadio* s = radios[i];
+			if (s != NULL && s->state != IDLE && s->event_time <= until && (r == NULL || s->event_time < r->event_time))
+				r = s;
+		}
+		if (r == NULL)
+			break;
+		// A long interrupt handler may be late, the radio is not
+		if (r->event_time > sim_time)
+			sim_time = r->event_time;
+		r->event();
+		if (dispatch)
+			sim_irq_dispatch();
+	}
+	if (sim_time < until)
+		sim_time = until;
+}
@@ -0,0 +1,250 @@
+/*
+ * File:   sim.h
+ *
+ * Simulated nRF24L01+ for host builds (./configure --driver=Sim)
+ */
+
+#ifndef __RF24_SIM_H__
+#define __RF24_SIM_H__
+
+/**
+ * @file sim.h
+ * \cond HIDDEN_SYMBOLS
+ * Class declaration for the simulated radio
+ */
+
+/**
+ * Simulated nRF24L01+
+ *
+ * @defgroup Sim Simulated radio
+ *
+ * The Sim arch replaces spidev and the GPIO pins by a model of the radio:
+ * register file, 3 level TX and RX FIFOs, STATUS flags, IRQ pin with the
+ * masks of the CONFIG register, CE and the Enhanced ShockBurst timing of
+ * a transmission (130us settling, air time at the selected data rate,
+ * auto retransmit delay and count).
+ *
+ * Time is virtual: SPI transfers take the time of their bytes on the bus,
+ * delay() and delayMicroseconds() let the time pass and millis() returns it.
+ * Interrupt handlers attached with attachInterrupt() run when the IRQ pin of
+ * a radio falls, at the next point where a thread of the host could run:
+ * during a delay or between two SPI transfers, not between rfNoInterrupts()
+ * and rfInterrupts().
+ *
+ * A radio is found by the CSN pin (SPI bus number) and the CE pin given to
+ * RF24. A transmitted packet goes over the air to all radios which listen on
+ * the same channel, data rate, address width and CRC length, to the pipe with
+ * the TX address. The receivers acknowledge it with auto ACK, with the ACK
+ * payload of the pipe, unless their RX FIFO is full or it was sent with NO_ACK.
+ * Retransmits with the same packet ID (PID) are acknowledged but not stored
+ * again. The packets and the ACKs can be lost at random, see setLoss().
+ * A link function replaces the air for a transmitting radio, see setLink().
+ * @{
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Virtual time in ns
+ */
+uint64_t sim_now(void);
+
+/**
+ * Let the virtual time pass like a sleeping thread
+ *
+ * Interrupt handlers run at the time of their IRQ.
+ * @param ns Time to sleep in ns
+ */
+void sim_sleep(uint64_t ns);
+
+#ifdef __cplusplus
+}
+
+/** Depth of the TX and RX FIFO */
+#define SIM_FIFO_SIZE 3
+/** Radios which can be simulated at the same time */
+#define SIM_MAX_RADIOS 8
+
+class SimRadio {
+public:
+
+	/**
+	 * Decides the fate of one transmission attempt
+	 *
+	 * Typically the link calls receive() of another SimRadio.
+	 * @param radio Transmitting radio
+	 * @param buf Payload
+	 * @param len Length of the payload
+	 * @param ack Buffer for the payload of the ACK (32 bytes)
+	 * @param ack_len Length of the payload of the ACK, 0 for an empty ACK
+	 * @return True if the packet was received (and acknowledged, if requested)
+	 */
+	typedef bool (*LinkFn)(SimRadio& radio, const uint8_t* buf, uint8_t len, uint8_t* ack, uint8_t* ack_len);
+
+	/**
+	 * Create a radio, connected to the given pins
+	 *
+	 * @param ce_pin CE pin, as given to RF24
+	 * @param csn_pin CSN pin (SPI bus number), as given to RF24
+	 * @param irq_pin IRQ pin for attachInterrupt(), 0xff if not connected
+	 */
+	SimRadio(uint8_t ce_pin, uint8_t csn_pin, uint8_t irq_pin = 0xff);
+
+	~SimRadio();
+
+	/**
+	 * Set the link of this radio, NULL to send over the air
+	 */
+	void setLink(LinkFn fn) { link = fn; }
+
+	/**
+	 * The radio is operated by another host: its SPI transfers take no time
+	 */
+	void setRemote(bool enable) { remote = enable; }
+
+	/**
+	 * A packet arrives on a pipe of this radio
+	 *
+	 * The packet is stored if the radio is listening (PRIM_RX, PWR_UP, CE),
+	 * the pipe is enabled and the RX FIFO is not full. An ACK payload for
+	 * the pipe is taken from the TX FIFO.
+	 *
+	 * @param pipe Pipe number, 0-5
+	 * @param buf Payload
+	 * @param len Length of the payload
+	 * @param ack Buffer for the ACK payload (32 bytes), or NULL
+	 * @param ack_len Length of the ACK payload, or NULL
+	 * @return True if the packet was stored
+	 */
+	bool receive(uint8_t pipe, const void* buf, uint8_t len, uint8_t* ack = NULL, uint8_t* ack_len = NULL);
+
+	/**
+	 * Value of a register, without SPI transfer
+	 */
+	uint8_t getRegister(uint8_t reg);
+
+	/**
+	 * @return True while the IRQ pin is low
+	 */
+	bool irq(void) { return irq_low; }
+
+	/**
+	 * One SPI transaction, CSN low to CSN high
+	 */
+	void transfer(const uint8_t* tx, uint8_t* rx, uint32_t len);
+
+	/**
+	 * Set the CE pin
+	 */
+	void setCE(bool level);
+
+	/**
+	 * Find the radio on a CSN, CE or IRQ pin, NULL if there is none
+	 */
+	static SimRadio* byCSN(uint8_t pin);
+	static SimRadio* byCE(uint8_t pin);
+	static SimRadio* byIRQ(uint8_t pin);
+
+	/**
+	 * Timing of the SPI bus
+	 *
+	 * @param hz SPI clock, default 8MHz
+	 * @param overhead_ns Time per transaction (driver, CSN), default 2us
+	 */
+	static void setSPITiming(uint32_t hz, uint32_t overhead_ns);
+
+	/**
+	 * Packet loss over the air
+	 *
+	 * @param packet Lost packets per 1000
+	 * @param ack Lost ACKs per 1000
+	 */
+	static void setLoss(uint16_t packet, uint16_t ack);
+
+	/**
+	 * Process the events of all radios up to the given time
+	 *
+	 * @param until Virtual time in ns
+	 * @param dispatch Run interrupt handlers at the time of their IRQ
+	 */
+	static void run(uint64_t until, bool dispatch);
+
+	/** SPI transactions */
+	uint32_t spi_transactions;
+	/** Bytes transferred over SPI */
+	uint32_t spi_bytes;
+	/** Transmission attempts, including retransmissions */
+	uint32_t tx_attempts;
+	/** Packets stored in the RX FIFO */
+	uint32_t rx_packets;
+	/** Retransmitted packets which were not stored again */
+	uint32_t rx_duplicates;
+
+private:
+
+	struct Payload {
+		uint8_t len;
+		uint8_t pipe;
+		uint8_t pid;
+		bool no_ack;
+		uint8_t data[32];
+	};
+
+	enum { IDLE, TX, ACK, LOST };
+
+	uint8_t ce_pin;
+	uint8_t csn_pin;
+	uint8_t irq_pin;
+	bool ce;
+	bool irq_low;
+	bool reuse;
+	bool remote;
+	LinkFn link;
+
+	uint8_t reg[0x1E];
+	uint8_t addr[7][5];
+
+	Payload tx_fifo[SIM_FIFO_SIZE];
+	uint8_t tx_cnt;
+	Payload rx_fifo[SIM_FIFO_SIZE];
+	uint8_t rx_cnt;
+
+	uint8_t state;
+	uint64_t event_time;
+	uint8_t arc_cnt;
+	uint8_t ack_buf[32];
+	uint8_t ack_len;
+
+	uint8_t pid;
+	uint8_t last_pid;
+	uint8_t last_len;
+	uint8_t last_data[32];
+
+	void reset(void);
+	uint8_t status(void);
+	uint8_t fifoStatus(void);
+	void readRegister(uint8_t r, uint8_t* buf, uint32_t len);
+	void writeRegister(uint8_t r, const uint8_t* buf, uint32_t len);
+	void updateIRQ(void);
+	uint64_t airTime(uint8_t len);
+	void kick(uint64_t t);
+	void event(void);
+	void txDone(uint64_t t);
+	bool air(const Payload& p, uint8_t* ack, uint8_t* ack_len);
+	int match(SimRadio& tx, const Payload& p);
+	uint8_t crcLength(void);
+	bool dynamic(uint8_t pipe);
+};
+
+#endif
+
+/**
+ * \endcond
+ */
+/*@}*/
+#endif	/* __RF24_SIM_H__ */
@@ -0,0 +1,43 @@
+/*
+ * File:   spi.cpp
+ *
+ * SPI bus of the simulated radios: each transfer is one transaction
+ * (CSN low to high) of the radio on the CSN pin given to begin()
+ */
+
+#include "spi.h"
+#include "sim.h"
+#include <string.h>
+
+SPI::SPI():bus(-1) {
+}
+
+void SPI::begin(int busNo){
+	this->bus = busNo;
+}
+
+uint8_t SPI::transfer(uint8_t tx_)
+{
+	uint8_t rx = 0xff;
+	transfernb((char*)&tx_, (char*)&rx, 1);
+	return rx;
+}
+
+void SPI::transfernb(char* tbuf, char* rbuf, uint32_t len)
+{
+	SimRadio* radio = SimRadio::byCSN(this->bus);
+	if (radio == NULL) {
+		// Nothing connected, MISO is pulled high
+		memset(rbuf, 0xff, len);
+		return;
+	}
+	radio->transfer((const uint8_t*)tbuf, (uint8_t*)rbuf, len);
+}
+
+void SPI::transfern(char* buf, uint32_t len)
+{
+    transfernb(buf, buf, len);
+}
+
+SPI::~SPI() {
+}
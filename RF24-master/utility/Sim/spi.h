@@ -0,0 +1,75 @@
+/*
+ * File:   spi.h
+ *
+ * SPI bus of the simulated radios
+ */
+
+#ifndef SPI_H
+#define	SPI_H
+
+/**
+ * @file spi.h
+ * \cond HIDDEN_SYMBOLS
+ * Class declaration for SPI helper files
+ */
+
+/**
+ * SPI of the simulated radios
+ *
+ * @defgroup SPI SPI Example
+ *
+ * The bus number given to begin() is the CSN pin of a SimRadio.
+ * See RF24_arch_config.h for additional information
+ * @{
+ */
+
+#include <stdint.h>
+
+class SPI {
+public:
+
+	/**
+	* SPI constructor
+	*/
+	SPI();
+
+	/**
+	* Start SPI
+	*/
+	void begin(int busNo);
+
+	/**
+	* Transfer a single byte
+	* @param tx_ Byte to send
+	* @return Data returned via spi
+	*/
+	uint8_t transfer(uint8_t tx_);
+
+	/**
+	* Transfer a buffer of data
+	* @param tbuf Transmit buffer
+	* @param rbuf Receive buffer
+	* @param len Length of the data
+	*/
+	void transfernb(char* tbuf, char* rbuf, uint32_t len);
+
+	/**
+	* Transfer a buffer of data without an rx buffer
+	* @param buf Pointer to a buffer of data
+	* @param len Length of the data
+	*/
+	void transfern(char* buf, uint32_t len);
+
+	virtual ~SPI();
+
+private:
+
+	/** CSN pin of the radio */
+	int bus;
+};
+
+/**
+ * \endcond
+ */
+/*@}*/
+#endif	/* SPI_H */
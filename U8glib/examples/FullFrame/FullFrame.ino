@@ -0,0 +1,96 @@
+/*
+
+  FullFrame.pde
+  
+  Full frame devices (constructors ending in _F) keep the complete
+  display content in RAM (1024 bytes for 128x64). The draw procedures
+  are executed only once per frame instead of once per page and the
+  buffer is kept after sendBuffer(), so only the changed parts need
+  to be redrawn.
+  
+  >>> Before compiling: Please remove comment from the constructor of the 
+  >>> connected graphics display (see below).
+  
+  Universal 8bit Graphics Library, https://github.com/olikraus/u8glib/
+  
+  Copyright (c) 2026, olikraus@gmail.com
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification, 
+  are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this list 
+    of conditions and the following disclaimer.
+    
+  * Redistributions in binary form must reproduce the above copyright notice, this 
+    list of conditions and the following disclaimer in the documentation and/or other 
+    materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND 
+  CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF 
+  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  
+  
+*/
+
+
+#include "U8glib.h"
+
+// setup u8g object, please remove comment from one of the following constructor calls
+
+//U8GLIB_SSD1306_128X64_F u8g(13, 11, 10, 9);	// SW SPI Com: SCK = 13, MOSI = 11, CS = 10, A0 = 9
+//U8GLIB_SSD1306_128X64_F u8g(10, 9);		// HW SPI Com: CS = 10, A0 = 9 (Hardware Pins are  SCK = 13 and MOSI = 11)
+//U8GLIB_SSD1306_128X64_F u8g(U8G_I2C_OPT_NONE|U8G_I2C_OPT_DEV_0);	// I2C / TWI 
+//U8GLIB_SH1106_128X64_F u8g(U8G_I2C_OPT_NONE|U8G_I2C_OPT_DEV_0);	// I2C / TWI 
+//U8GLIB_SSD1306_128X32_F u8g(U8G_I2C_OPT_NONE);	// I2C / TWI 
+
+uint8_t seconds = 0;
+
+#if defined(U8G_WITH_DAMAGE)
+// checksums of the transferred data, sendBuffer() only sends the changed columns
+uint8_t damage[U8G_DAMAGE_SIZE(128, 64/8)];
+#endif
+
+void drawBackground(void) {
+  u8g.setFont(u8g_font_6x10);
+  u8g.drawStr( 0, 10, "Full Frame");
+  u8g.drawFrame(0, 14, 128, 50);
+}
+
+void drawSeconds(void) {
+  // erase the old value, then draw the new one
+  u8g.setColorIndex(0);
+  u8g.drawBox(40, 24, 48, 30);
+  u8g.setColorIndex(1);
+  u8g.setFont(u8g_font_fub20n);
+  u8g.drawStr(48, 50, u8g_u8toa(seconds, 2));
+}
+
+void setup(void) {
+#if defined(U8G_WITH_DAMAGE)
+  u8g.setDamageTracking(damage);
+#endif
+  u8g.clearBuffer();
+  drawBackground();
+  drawSeconds();
+  u8g.sendBuffer();
+}
+
+void loop(void) {
+  delay(1000);
+  seconds = (seconds + 1) % 60;
+  
+  // no picture loop: only the changed part is drawn into the buffer
+  drawSeconds();
+  u8g.sendBuffer();
+}
+
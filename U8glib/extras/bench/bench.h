@@ -0,0 +1,66 @@
+/*
+
+  bench.h
+
+  helper procedures for the host benchmarks in this directory
+
+*/
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "u8g.h"
+
+static inline double bench_now_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* typical dashboard: title, large value, bar graph, trend line and a round gauge */
+static inline void bench_dashboard(u8g_t *u8g, uint16_t frame)
+{
+  static const uint8_t bars[16] = { 3, 7, 12, 18, 22, 19, 14, 9, 5, 8, 13, 17, 21, 16, 10, 6 };
+  char value[8];
+  uint8_t i;
+  uint8_t y, y_next;
+
+  u8g_DrawFrame(u8g, 0, 0, 128, 64);
+  u8g_DrawHLine(u8g, 0, 11, 128);
+  u8g_SetFont(u8g, u8g_font_6x10);
+  u8g_DrawStr(u8g, 2, 9, "Boiler 2  Temp");
+  u8g_DrawStr(u8g, 98, 9, u8g_u8toa(frame % 60, 2));
+
+  sprintf(value, "%d.%d", 40 + (frame % 50), frame % 10);
+  u8g_SetFont(u8g, u8g_font_fub20n);
+  u8g_DrawStr(u8g, 3, 38, value);
+
+  /* bar graph */
+  for( i = 0; i < 16; i++ )
+  {
+    y = bars[(i + frame) & 15];
+    u8g_DrawBox(u8g, 2 + i * 4, 62 - y, 3, y);
+  }
+
+  /* trend line */
+  for( i = 0; i < 15; i++ )
+  {
+    y = bars[(i + frame) & 15];
+    y_next = bars[(i + 1 + frame) & 15];
+    u8g_DrawLine(u8g, 68 + i * 4, 62 - y, 72 + i * 4, 62 - y_next);
+  }
+
+  /* gauge */
+  u8g_DrawCircle(u8g, 106, 28, 14, U8G_DRAW_ALL);
+  u8g_DrawDisc(u8g, 106, 28, 2, U8G_DRAW_ALL);
+  u8g_DrawLine(u8g, 106, 28, 96 + (frame % 20), 17);
+}
+
+#endif /* _BENCH_H */
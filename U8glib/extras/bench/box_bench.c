@@ -0,0 +1,181 @@
+/*
+
+  box_bench.c
+
+  boxes and lines with U8G_DEV_MSG_SET_BOX (masked byte writes in the
+  page buffer) compared with the Draw8Pixel procedures, which are still
+  used if u8g->is_set_box is 0.
+
+  First both ways have to produce the same frame for each page buffer,
+  then the number of primitives per second is measured for a 128x64 display.
+
+  make box_bench && ./box_bench [frames]
+
+*/
+
+#include "bench.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+
+static uint8_t buf[WIDTH*HEIGHT*3];
+static uint8_t frame_box[WIDTH*HEIGHT*3];
+static uint8_t frame_pixel[WIDTH*HEIGHT*3];
+
+struct buffer
+{
+  const char *name;
+  u8g_dev_fnptr fn;
+  u8g_uint_t page_height;
+  uint8_t bits_per_pixel;
+};
+
+static const struct buffer buffers[] = {
+  { "pb8v1", u8g_dev_pb8v1_base_fn, 8, 1 },
+  { "pb16v1", u8g_dev_pb16v1_base_fn, 16, 1 },
+  { "pbxv1 (full)", u8g_dev_pbxv1_base_fn, HEIGHT, 1 },
+  { "pb8h1", u8g_dev_pb8h1_base_fn, 8, 1 },
+  { "pb16h1", u8g_dev_pb16h1_base_fn, 16, 1 },
+  { "pb8h8", u8g_dev_pb8h8_base_fn, 8, 8 },
+  { "pbxh16", u8g_dev_pbxh16_base_fn, 8, 16 },
+  { "pbxh24", u8g_dev_pbxh24_base_fn, 8, 24 },
+};
+
+static u8g_pb_t pb;
+static u8g_dev_t dev = { NULL, &pb, u8g_com_null_fn };
+
+static unsigned seed;
+
+static unsigned rnd(unsigned n)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % n;
+}
+
+static void set_color(u8g_t *u8g)
+{
+  u8g->arg_pixel.color = rnd(2) ? rnd(256) : 0;
+  if ( u8g->mode == U8G_MODE_BW )
+    u8g->arg_pixel.color = u8g->arg_pixel.color != 0;
+  u8g->arg_pixel.hi_color = rnd(256);
+  u8g->arg_pixel.blue = rnd(256);
+}
+
+/* all primitives which use u8g_draw_hline(), u8g_draw_vline() or u8g_draw_box() */
+static void draw_mix(u8g_t *u8g, unsigned n)
+{
+  unsigned i;
+  seed = n;
+  for( i = 0; i < 40; i++ )
+  {
+    set_color(u8g);
+    switch( rnd(7) )
+    {
+      case 0: u8g_DrawBox(u8g, rnd(WIDTH+8), rnd(HEIGHT+8), 1+rnd(70), 1+rnd(40)); break;
+      case 1: u8g_DrawHLine(u8g, rnd(WIDTH+8), rnd(HEIGHT+8), rnd(140)); break;
+      case 2: u8g_DrawVLine(u8g, rnd(WIDTH+8), rnd(HEIGHT+8), rnd(80)); break;
+      case 3: u8g_DrawFrame(u8g, rnd(WIDTH), rnd(HEIGHT), 1+rnd(60), 1+rnd(40)); break;
+      case 4: u8g_DrawDisc(u8g, rnd(WIDTH), rnd(HEIGHT), rnd(30), U8G_DRAW_ALL); break;
+      case 5: u8g_DrawRBox(u8g, rnd(WIDTH-40), rnd(HEIGHT-20), 12+rnd(40), 12+rnd(20), 1+rnd(5)); break;
+      case 6: u8g_DrawBox(u8g, (u8g_uint_t)(-rnd(10)), (u8g_uint_t)(-rnd(10)), 1+rnd(40), 1+rnd(20)); break;
+    }
+  }
+}
+
+static void init(u8g_t *u8g, const struct buffer *b, uint8_t is_set_box)
+{
+  pb.p.page_height = b->page_height;
+  pb.p.total_height = HEIGHT;
+  pb.width = WIDTH;
+  pb.buf = buf;
+  dev.dev_fn = b->fn;
+  u8g_Init(u8g, &dev);
+  u8g->is_set_box &= is_set_box;
+}
+
+static void render(const struct buffer *b, uint8_t is_set_box, unsigned n, uint8_t *frame)
+{
+  u8g_t u8g;
+  unsigned page_size = WIDTH * b->page_height * b->bits_per_pixel / 8;
+  init(&u8g, b, is_set_box);
+  u8g_FirstPage(&u8g);
+  do
+  {
+    draw_mix(&u8g, n);
+    memcpy(frame + pb.p.page * page_size, buf, page_size);
+  } while( u8g_NextPage(&u8g) );
+}
+
+typedef void (*prim_fn)(u8g_t *u8g, unsigned i);
+
+static void prim_box(u8g_t *u8g, unsigned i) { u8g_DrawBox(u8g, i & 63, i & 31, 48, 24); }
+static void prim_hline(u8g_t *u8g, unsigned i) { u8g_DrawHLine(u8g, i & 15, i & 63, 100); }
+static void prim_vline(u8g_t *u8g, unsigned i) { u8g_DrawVLine(u8g, i & 127, i & 15, 40); }
+static void prim_disc(u8g_t *u8g, unsigned i) { u8g_DrawDisc(u8g, 20 + (i & 63), 32, 16, U8G_DRAW_ALL); }
+
+/* primitives per second, 64 primitives per frame */
+static double measure(const struct buffer *b, uint8_t is_set_box, prim_fn fn, unsigned frames)
+{
+  u8g_t u8g;
+  unsigned f, i;
+  double start;
+  init(&u8g, b, is_set_box);
+  start = bench_now_us();
+  for( f = 0; f < frames; f++ )
+  {
+    u8g_FirstPage(&u8g);
+    do
+    {
+      for( i = 0; i < 64; i++ )
+        fn(&u8g, f + i);
+    } while( u8g_NextPage(&u8g) );
+  }
+  return frames * 64.0 * 1e6 / (bench_now_us() - start);
+}
+
+static const struct
+{
+  const char *name;
+  prim_fn fn;
+} prims[] = {
+  { "box 48x24", prim_box },
+  { "hline 100", prim_hline },
+  { "vline 40", prim_vline },
+  { "disc r=16", prim_disc },
+};
+
+int main(int argc, char **argv)
+{
+  unsigned frames = argc > 1 ? (unsigned)atoi(argv[1]) : 2000;
+  unsigned b, n, p;
+  double pixel, box;
+
+  for( b = 0; b < sizeof(buffers)/sizeof(*buffers); b++ )
+  {
+    size_t size = WIDTH * HEIGHT * buffers[b].bits_per_pixel / 8;
+    for( n = 0; n < 200; n++ )
+    {
+      render(buffers + b, 0, n, frame_pixel);
+      render(buffers + b, 1, n, frame_box);
+      if ( memcmp(frame_pixel, frame_box, size) != 0 )
+      {
+        printf("%s, frame %u: U8G_DEV_MSG_SET_BOX differs from Draw8Pixel\n", buffers[b].name, n);
+        return 1;
+      }
+    }
+  }
+  printf("all page buffers: same frames with and without U8G_DEV_MSG_SET_BOX\n\n");
+
+  printf("%u frames 128x64, primitives per second\n\n", frames);
+  printf("%-13s %-10s %12s %12s\n", "buffer", "primitive", "Draw8Pixel", "SET_BOX");
+  for( b = 0; b < sizeof(buffers)/sizeof(*buffers); b++ )
+  {
+    for( p = 0; p < sizeof(prims)/sizeof(*prims); p++ )
+    {
+      pixel = measure(buffers + b, 0, prims[p].fn, frames);
+      box = measure(buffers + b, 1, prims[p].fn, frames);
+      printf("%-13s %-10s %12.0f %12.0f  %5.1fx\n", buffers[b].name, prims[p].name, pixel, box, box / pixel);
+    }
+  }
+  return 0;
+}
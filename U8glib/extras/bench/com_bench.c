@@ -0,0 +1,238 @@
+/*
+
+  com_bench.c
+
+  system calls per frame of the Linux com procedures
+    u8g_com_linux_ssd_i2c_fn         (i2c-dev, I2C_RDWR or write())
+    u8g_com_raspberrypi_hw_spi_fn    (spidev)
+  compared with the former procedures (one write() per command byte and
+  per 64 data bytes, one wiringPiSPIDataRW() per com message).
+
+  open(), close(), write() and ioctl() are replaced with a mock /dev
+  (mock/mock_dev.c), which counts the calls and emulates the RAM of a
+  SSD1306 (I2C control bytes, SPI with the A0 line). After each frame,
+  the emulated display must show the same picture as the buffer.
+
+  The I2C frame rate is calculated for a 400 kHz bus: start, address byte
+  and stop for each message, 9 clocks per byte.
+
+  make com_bench && ./com_bench [frames]
+
+*/
+
+#include "bench.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+#include "mock_dev.h"
+#include "wiringPi.h"
+#include "wiringPiSPI.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+
+#define I2C_BUS 1
+#define SPI_CHANNEL 0
+#define PIN_A0 MOCK_SPI_A0(SPI_CHANNEL)
+#define PIN_RESET 25
+
+static uint8_t frame[WIDTH*HEIGHT/8];
+
+uint8_t u8g_com_linux_ssd_i2c_fn(u8g_t *u8g, uint8_t msg, uint8_t arg_val, void *arg_ptr);
+uint8_t u8g_com_raspberrypi_hw_spi_fn(u8g_t *u8g, uint8_t msg, uint8_t arg_val, void *arg_ptr);
+
+/*========================================================================*/
+/* the former com procedures */
+
+static uint8_t legacy_i2c_burst(u8g_t *u8g, uint8_t *buf, size_t buflen)
+{
+  uint8_t i2cbuf[2*64];
+  uint8_t i2clen;
+  if ( u8g->pin_list[U8G_PI_A0_STATE] )
+  {
+    i2clen = 0;
+    while( buflen > 0 )
+    {
+      i2cbuf[i2clen++] = 0x80;
+      i2cbuf[i2clen++] = *buf++;
+      buflen--;
+    }
+  }
+  else
+  {
+    i2cbuf[0] = 0x40;
+    memcpy(i2cbuf+1, buf, buflen);
+    i2clen = buflen + 1;
+  }
+  return write(MOCK_I2C_FD(I2C_BUS), i2cbuf, i2clen) == i2clen;
+}
+
+static uint8_t legacy_i2c_fn(u8g_t *u8g, uint8_t msg, uint8_t arg_val, void *arg_ptr)
+{
+  uint8_t *ptr = arg_ptr;
+  switch(msg)
+  {
+    case U8G_COM_MSG_INIT:
+      ioctl(open("/dev/i2c-1", O_RDWR), I2C_SLAVE, 0x3c);	/* I2C_BUS */
+      break;
+    case U8G_COM_MSG_CHIP_SELECT:
+      u8g->pin_list[U8G_PI_A0_STATE] = 1;
+      break;
+    case U8G_COM_MSG_WRITE_BYTE:
+      legacy_i2c_burst(u8g, &arg_val, 1);
+      break;
+    case U8G_COM_MSG_WRITE_SEQ:
+    case U8G_COM_MSG_WRITE_SEQ_P:
+      while( arg_val > 64 )
+      {
+        legacy_i2c_burst(u8g, ptr, 64);
+        ptr += 64;
+        arg_val -= 64;
+      }
+      legacy_i2c_burst(u8g, ptr, arg_val);
+      break;
+    case U8G_COM_MSG_ADDRESS:
+      u8g->pin_list[U8G_PI_A0_STATE] = !arg_val;
+      break;
+  }
+  return 1;
+}
+
+static uint8_t legacy_spi_fn(u8g_t *u8g, uint8_t msg, uint8_t arg_val, void *arg_ptr)
+{
+  /* the former procedure received into the page buffer, use a copy here */
+  uint8_t buf[256];
+  switch(msg)
+  {
+    case U8G_COM_MSG_INIT:
+      wiringPiSPISetup(SPI_CHANNEL, 100000);
+      break;
+    case U8G_COM_MSG_ADDRESS:
+      u8g_SetPILevel(u8g, U8G_PI_A0, arg_val);
+      break;
+    case U8G_COM_MSG_RESET:
+      u8g_SetPILevel(u8g, U8G_PI_RESET, arg_val);
+      break;
+    case U8G_COM_MSG_WRITE_BYTE:
+      wiringPiSPIDataRW(SPI_CHANNEL, &arg_val, 1);
+      break;
+    case U8G_COM_MSG_WRITE_SEQ:
+    case U8G_COM_MSG_WRITE_SEQ_P:
+      memcpy(buf, arg_ptr, arg_val);
+      wiringPiSPIDataRW(SPI_CHANNEL, buf, arg_val);
+      break;
+  }
+  return 1;
+}
+
+/*========================================================================*/
+/* measurement */
+
+struct com
+{
+  const char *name;
+  u8g_com_fnptr fn;
+  unsigned long i2c_funcs;
+  uint8_t is_i2c;
+};
+
+static const struct com coms[] = {
+  { "i2c, former", legacy_i2c_fn, I2C_FUNC_I2C, 1 },
+  { "i2c, I2C_RDWR", u8g_com_linux_ssd_i2c_fn, I2C_FUNC_I2C, 1 },
+  { "i2c, write()", u8g_com_linux_ssd_i2c_fn, 0, 1 },
+  { "spi, former", legacy_spi_fn, 0, 0 },
+  { "spi, spidev", u8g_com_raspberrypi_hw_spi_fn, 0, 0 },
+};
+
+struct device
+{
+  const char *name;
+  u8g_dev_t *dev;
+  uint8_t is_full;
+};
+
+static const struct device devices[] = {
+  { "ssd1306_128x64", &u8g_dev_ssd1306_128x64_i2c, 0 },
+  { "ssd1306_128x64_f", &u8g_dev_ssd1306_128x64_f_i2c, 1 },
+};
+
+static void draw(u8g_t *u8g, uint8_t is_full, uint16_t n)
+{
+  u8g_pb_t *pb = (u8g_pb_t *)(u8g->dev->dev_mem);
+  if ( is_full )
+  {
+    u8g_ClearBuffer(u8g);
+    bench_dashboard(u8g, n);
+    memcpy(frame, pb->buf, sizeof(frame));
+    u8g_SendBuffer(u8g);
+    return;
+  }
+  u8g_FirstPage(u8g);
+  do
+  {
+    bench_dashboard(u8g, n);
+    memcpy(frame + pb->p.page * WIDTH, pb->buf, WIDTH);
+  } while( u8g_NextPage(u8g) );
+}
+
+static int run(const struct device *d, const struct com *c, unsigned frames)
+{
+  u8g_t u8g;
+  struct mock_dev *m = c->is_i2c ? mock_i2c(I2C_BUS) : mock_spi(SPI_CHANNEL);
+  struct mock_dev cnt;
+  unsigned i;
+  double start, us, i2c_us;
+
+  mock_i2c_funcs = c->i2c_funcs;
+  u8g_InitComFn(&u8g, d->dev, c->fn);
+  /* I2C bus, SPI channel, A0 and reset, init again */
+  u8g.pin_list[U8G_PI_I2C_OPTION] = I2C_BUS;
+  u8g.pin_list[U8G_PI_CS] = SPI_CHANNEL;
+  u8g.pin_list[U8G_PI_A0] = PIN_A0;
+  u8g.pin_list[U8G_PI_RESET] = PIN_RESET;
+  u8g_Begin(&u8g);
+
+  for( i = 0; i < 10; i++ )
+  {
+    draw(&u8g, d->is_full, i);
+    if ( memcmp(m->ram, frame, sizeof(frame)) != 0 )
+    {
+      printf("%s, %s, frame %u: display differs from buffer\n", d->name, c->name, i);
+      return 0;
+    }
+  }
+
+  mock_clear_counters();
+  start = bench_now_us();
+  for( i = 0; i < frames; i++ )
+    draw(&u8g, d->is_full, i);
+  us = (bench_now_us() - start) / frames;
+  mock_sum_counters(&cnt);
+
+  printf("%-17s %-14s %8.1f %8.0f %8.2f", d->name, c->name,
+    (double)cnt.cnt_syscall / frames, (double)cnt.cnt_bytes / frames, us);
+  if ( c->is_i2c )
+  {
+    /* start, address byte, stop (or repeated start) per message, 9 clocks per byte */
+    i2c_us = (cnt.cnt_i2c_msgs * 11.0 + cnt.cnt_bytes * 9.0) / frames / 0.4;
+    printf(" %8.0f", 1e6 / i2c_us);
+  }
+  printf("\n");
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned frames = argc > 1 ? (unsigned)atoi(argv[1]) : 2000;
+  unsigned d, c;
+
+  printf("%u frames, dashboard scene, mock /dev\n\n", frames);
+  printf("%-17s %-14s %8s %8s %8s %8s\n", "device", "com", "syscalls", "bytes", "us/frame", "fps@400k");
+  for( d = 0; d < sizeof(devices)/sizeof(*devices); d++ )
+    for( c = 0; c < sizeof(coms)/sizeof(*coms); c++ )
+      if ( run(devices + d, coms + c, frames) == 0 )
+        return 1;
+  return 0;
+}
@@ -0,0 +1,239 @@
+/*
+
+  damage_bench.c
+
+  bytes sent to a 128x64 SSD1306/SH1106 per frame for some typical
+  screen updates, with and without damage tracking (u8g_SetDamageTracking()).
+
+  The com procedure counts all bytes and also emulates the display RAM
+  (page addressing: 0x0b0 page, 0x01x/0x00x column). After each frame,
+  the emulated display must show the same picture as the page buffer.
+
+  At the end, the time for the dashboard frame shows the cost of the checksums.
+
+  make damage_bench && ./damage_bench [frames]
+
+*/
+
+#include "bench.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+#define RAM_WIDTH 132
+
+static uint8_t frame[WIDTH*HEIGHT/8];
+static uint8_t ram[HEIGHT/8][RAM_WIDTH];
+static uint8_t damage[U8G_DAMAGE_SIZE(WIDTH, HEIGHT/8)];
+
+static unsigned long cnt_data;
+static unsigned long cnt_cmd;
+static uint8_t com_is_data;
+static uint8_t ram_page;
+static uint8_t ram_col;
+
+static void ram_write(uint8_t b)
+{
+  if ( com_is_data )
+  {
+    cnt_data++;
+    if ( ram_col < RAM_WIDTH )
+      ram[ram_page & 7][ram_col++] = b;
+    return;
+  }
+  cnt_cmd++;
+  if ( (b & 0x0f0) == 0x0b0 )
+    ram_page = b & 0x0f;
+  else if ( (b & 0x0f0) == 0x010 )
+    ram_col = (ram_col & 0x0f) | ((b & 0x0f) << 4);
+  else if ( (b & 0x0f0) == 0x000 )
+    ram_col = (ram_col & 0x0f0) | b;
+}
+
+static uint8_t count_com_fn(u8g_t *u8g, uint8_t msg, uint8_t arg_val, void *arg_ptr)
+{
+  uint8_t *ptr = (uint8_t *)arg_ptr;
+  switch(msg)
+  {
+    case U8G_COM_MSG_ADDRESS:
+      com_is_data = arg_val;
+      break;
+    case U8G_COM_MSG_WRITE_BYTE:
+      ram_write(arg_val);
+      break;
+    case U8G_COM_MSG_WRITE_SEQ:
+    case U8G_COM_MSG_WRITE_SEQ_P:
+      while( arg_val > 0 )
+      {
+        ram_write(*ptr++);
+        arg_val--;
+      }
+      break;
+  }
+  return 1;
+}
+
+/* menu, nothing changes */
+static void scene_menu(u8g_t *u8g, uint16_t n)
+{
+  u8g_SetFont(u8g, u8g_font_6x10);
+  u8g_DrawStr(u8g, 2, 10, "Settings");
+  u8g_DrawHLine(u8g, 0, 12, 128);
+  u8g_DrawStr(u8g, 8, 24, "Brightness");
+  u8g_DrawStr(u8g, 8, 36, "Timeout");
+  u8g_DrawStr(u8g, 8, 48, "Language");
+  u8g_DrawBox(u8g, 0, 15, 4, 10);
+}
+
+/* clock, the seconds change */
+static void scene_clock(u8g_t *u8g, uint16_t n)
+{
+  char s[12];
+  sprintf(s, "12:%02d:%02d", 34 + n / 60, n % 60);
+  u8g_SetFont(u8g, u8g_font_6x10);
+  u8g_DrawStr(u8g, 2, 10, "Mon 12 Oct");
+  u8g_SetFont(u8g, u8g_font_fub20n);
+  u8g_DrawStr(u8g, 4, 48, s);
+}
+
+/* progress bar, grows by one pixel */
+static void scene_progress(u8g_t *u8g, uint16_t n)
+{
+  u8g_SetFont(u8g, u8g_font_6x10);
+  u8g_DrawStr(u8g, 2, 10, "Downloading");
+  u8g_DrawFrame(u8g, 4, 40, 120, 10);
+  u8g_DrawBox(u8g, 6, 42, n % 117, 6);
+}
+
+/* everything changes */
+static void scene_dashboard(u8g_t *u8g, uint16_t n)
+{
+  bench_dashboard(u8g, n);
+}
+
+typedef void (*scene_fn)(u8g_t *u8g, uint16_t n);
+
+struct scene
+{
+  const char *name;
+  scene_fn fn;
+};
+
+static const struct scene scenes[] = {
+  { "menu (no change)", scene_menu },
+  { "clock (seconds)", scene_clock },
+  { "progress bar", scene_progress },
+  { "dashboard", scene_dashboard },
+};
+
+static void draw(u8g_t *u8g, scene_fn fn, uint16_t n)
+{
+  u8g_pb_t *pb = (u8g_pb_t *)(u8g->dev->dev_mem);
+  u8g_FirstPage(u8g);
+  do
+  {
+    fn(u8g, n);
+    memcpy(frame + (pb->p.page_y0 / 8) * WIDTH, pb->buf, WIDTH * (pb->p.page_height / 8));
+  } while( u8g_NextPage(u8g) );
+}
+
+static int check_ram(uint8_t col_offset)
+{
+  uint8_t page;
+  for( page = 0; page < HEIGHT/8; page++ )
+    if ( memcmp(ram[page] + col_offset, frame + page * WIDTH, WIDTH) != 0 )
+      return 0;
+  return 1;
+}
+
+static double measure(u8g_dev_t *dev, uint8_t is_damage, unsigned frames)
+{
+  u8g_t u8g;
+  unsigned i;
+  double start;
+
+  u8g_InitComFn(&u8g, dev, count_com_fn);
+  u8g_SetDamageTracking(&u8g, is_damage ? damage : NULL);
+  start = bench_now_us();
+  for( i = 0; i < frames; i++ )
+  {
+    u8g_ClearBuffer(&u8g);
+    bench_dashboard(&u8g, i);
+    u8g_SendBuffer(&u8g);
+  }
+  u8g_SetDamageTracking(&u8g, NULL);
+  return (bench_now_us() - start) / frames;
+}
+
+/* average bytes per frame, without the first frame, -1 if the display shows something else */
+static int run(u8g_dev_t *dev, uint8_t col_offset, scene_fn fn, uint8_t is_damage, unsigned frames, double *cmd)
+{
+  u8g_t u8g;
+  unsigned i;
+
+  memset(ram, 0x055, sizeof(ram));
+  u8g_InitComFn(&u8g, dev, count_com_fn);
+  u8g_SetDamageTracking(&u8g, is_damage ? damage : NULL);
+  for( i = 0; i <= frames; i++ )
+  {
+    if ( i == 1 )
+    {
+      cnt_data = 0;
+      cnt_cmd = 0;
+    }
+    draw(&u8g, fn, i);
+    if ( check_ram(col_offset) == 0 )
+    {
+      printf("frame %u: display differs from buffer\n", i);
+      return -1;
+    }
+  }
+  u8g_SetDamageTracking(&u8g, NULL);
+  *cmd = (double)cnt_cmd / frames;
+  return (int)((cnt_data + frames / 2) / frames);
+}
+
+struct device
+{
+  const char *name;
+  u8g_dev_t *dev;
+  uint8_t col_offset;
+};
+
+static const struct device devices[] = {
+  { "ssd1306_128x64", &u8g_dev_ssd1306_128x64_hw_spi, 0 },
+  { "ssd1306_128x64_2x", &u8g_dev_ssd1306_128x64_2x_hw_spi, 0 },
+  { "ssd1306_128x64_f", &u8g_dev_ssd1306_128x64_f_hw_spi, 0 },
+  { "sh1106_128x64", &u8g_dev_sh1106_128x64_hw_spi, 2 },
+  { "sh1106_128x64_f", &u8g_dev_sh1106_128x64_f_hw_spi, 2 },
+};
+
+int main(int argc, char **argv)
+{
+  unsigned frames = argc > 1 ? (unsigned)atoi(argv[1]) : 200;
+  unsigned d, s;
+  int full, damaged;
+  double full_cmd, damaged_cmd;
+
+  printf("%u frames, data bytes (+ command bytes) per frame\n\n", frames);
+  printf("%-18s %-18s %14s %14s\n", "device", "scene", "all pages", "damage");
+  for( d = 0; d < sizeof(devices)/sizeof(*devices); d++ )
+  {
+    for( s = 0; s < sizeof(scenes)/sizeof(*scenes); s++ )
+    {
+      full = run(devices[d].dev, devices[d].col_offset, scenes[s].fn, 0, frames, &full_cmd);
+      damaged = run(devices[d].dev, devices[d].col_offset, scenes[s].fn, 1, frames, &damaged_cmd);
+      if ( full < 0 || damaged < 0 )
+      {
+        printf("%s, %s: failed\n", devices[d].name, scenes[s].name);
+        return 1;
+      }
+      printf("%-18s %-18s %6d (+%5.1f) %6d (+%5.1f)\n", devices[d].name, scenes[s].name,
+        full, full_cmd, damaged, damaged_cmd);
+    }
+  }
+  
+  printf("\nssd1306_128x64_f dashboard: %.2f us/frame, with damage tracking %.2f us/frame\n",
+    measure(&u8g_dev_ssd1306_128x64_f_hw_spi, 0, frames * 50),
+    measure(&u8g_dev_ssd1306_128x64_f_hw_spi, 1, frames * 50));
+  return 0;
+}
@@ -0,0 +1,245 @@
+/*
+
+  edge_bench.c
+
+  filled polygons, discs and filled ellipses with and without edge table
+  (u8g_SetEdgeTable()). Without table, each page calculates the complete
+  primitive, with table the spans are calculated once and each page draws
+  only its own rows.
+
+  First the table has to produce the same frames as before:
+  - discs and ellipses of all sizes and quadrants, also partly outside
+  - random convex polygons with 3 to 6 points, also partly outside
+  - a table which is too small and a picture loop which skips primitives
+  Then the frame time of some scenes is measured on a 128x64 and a
+  240x128 page buffer (pb8v1, 8 and 16 pages).
+
+  make edge_bench && ./edge_bench [frames]
+
+*/
+
+#include "bench.h"
+
+#define MAX_WIDTH 240
+#define MAX_HEIGHT 128
+
+static uint8_t buf[MAX_WIDTH];
+static uint8_t frame_ref[MAX_WIDTH*MAX_HEIGHT/8];
+static uint8_t frame_edge[MAX_WIDTH*MAX_HEIGHT/8];
+static uint16_t edge_table[2048];
+
+static u8g_pb_t pb_128x64 = { {8, 64, 0, 0, 0}, 128, buf };
+static u8g_dev_t dev_128x64 = { u8g_dev_pb8v1_base_fn, &pb_128x64, u8g_com_null_fn };
+static u8g_pb_t pb_240x128 = { {8, 128, 0, 0, 0}, 240, buf };
+static u8g_dev_t dev_240x128 = { u8g_dev_pb8v1_base_fn, &pb_240x128, u8g_com_null_fn };
+
+struct display
+{
+  const char *name;
+  u8g_dev_t *dev;
+  u8g_uint_t w, h;
+};
+
+static const struct display displays[] = {
+  { "128x64", &dev_128x64, 128, 64 },
+  { "240x128", &dev_240x128, 240, 128 },
+};
+
+typedef void (*scene_fn)(u8g_t *u8g, u8g_uint_t w, u8g_uint_t h, uint16_t n);
+
+static uint32_t rnd_state;
+
+static unsigned rnd(unsigned max)
+{
+  rnd_state = rnd_state * 1103515245 + 12345;
+  return (rnd_state >> 16) % max;
+}
+
+/*========================================================================*/
+/* scenes */
+
+/* check: discs of all sizes with all quadrant options */
+static void check_discs(u8g_t *u8g, u8g_uint_t w, u8g_uint_t h, uint16_t n)
+{
+  u8g_uint_t r = n % 64;
+  uint8_t option = 1 + n % 15;
+  u8g_DrawDisc(u8g, w / 2 + n % 7, h / 2 - n % 5, r, option);
+  u8g_DrawDisc(u8g, 10 + n % 20, 10 + n % 9, r / 4, U8G_DRAW_ALL);
+  u8g_DrawDisc(u8g, w - 5, h - 3, r / 2, option);		/* partly outside */
+}
+
+static void check_ellipses(u8g_t *u8g, u8g_uint_t w, u8g_uint_t h, uint16_t n)
+{
+  /* radius 0 is not supported by u8g_DrawFilledEllipse() */
+  u8g_uint_t rx = 1 + n % 60, ry = 1 + (n / 3) % 40;
+  uint8_t option = 1 + n % 15;
+  u8g_DrawFilledEllipse(u8g, w / 2, h / 2, rx, ry, option);
+  u8g_DrawFilledEllipse(u8g, w - 10, 8 + n % 9, 1 + ry / 2, 1 + rx / 3, U8G_DRAW_ALL);
+}
+
+/* corners of an octagon, counter clockwise */
+static const int8_t octagon[8][2] = {
+  { 3, 0 }, { 2, -2 }, { 0, -3 }, { -2, -2 }, { -3, 0 }, { -2, 2 }, { 0, 3 }, { 2, 2 } };
+
+/* u8g_DrawPolygon() requires convex polygons: 3 to 6 corners of a stretched octagon */
+static void check_polygons(u8g_t *u8g, u8g_uint_t w, u8g_uint_t h, uint16_t n)
+{
+  uint8_t i, j, cnt;
+  int16_t x0, y0, sx, sy;
+  rnd_state = n;
+  for( j = 0; j < 3; j++ )
+  {
+    cnt = 3 + rnd(4);
+    x0 = (int16_t)rnd(w + 40) - 20;
+    y0 = (int16_t)rnd(h + 40) - 20;
+    sx = 1 + rnd(20);
+    sy = 1 + rnd(12);
+    u8g_ClearPolygonXY();
+    for( i = 0; i < 8; i++ )
+      if ( rnd(8 - i) < cnt )
+      {
+        u8g_AddPolygonXY(u8g, x0 + octagon[i][0] * sx, y0 + octagon[i][1] * sy);
+        cnt--;
+      }
+    u8g_DrawPolygon(u8g);
+  }
+}
+
+/* some primitives are only drawn on some pages */
+static void check_skip(u8g_t *u8g, u8g_uint_t w, u8g_uint_t h, uint16_t n)
+{
+  if ( u8g_IsBBXIntersection(u8g, 0, 0, w, h / 2) )
+    u8g_DrawDisc(u8g, 20, 20, 10 + n % 5, U8G_DRAW_ALL);
+  u8g_DrawTriangle(u8g, 0, h - 1, w / 2, n % h, w - 1, h - 1);
+  if ( u8g_IsBBXIntersection(u8g, 0, h / 2, w, h / 2) )
+    u8g_DrawFilledEllipse(u8g, w / 2, h - 10, 30, 8, U8G_DRAW_ALL);
+  u8g_DrawDisc(u8g, w - 20, 20, 15, U8G_DRAW_UPPER_LEFT | U8G_DRAW_LOWER_RIGHT);
+}
+
+/* measure: pie chart, round buttons and a filled area graph */
+static void scene_dashboard(u8g_t *u8g, u8g_uint_t w, u8g_uint_t h, uint16_t n)
+{
+  u8g_uint_t r = h / 4;
+  uint8_t i;
+  u8g_DrawDisc(u8g, r + 2, r + 2, r, U8G_DRAW_ALL);
+  for( i = 0; i < 4; i++ )
+    u8g_DrawDisc(u8g, w / 2 + i * (h / 8), h / 8, h / 16, U8G_DRAW_ALL);
+  for( i = 0; i < 8; i++ )
+    u8g_DrawTriangle(u8g, i * (w / 8), h - 1, (i + 1) * (w / 8), h - 1, i * (w / 8) + (w / 16), h / 2 + (i * 5 + n) % (h / 2));
+}
+
+static void scene_discs(u8g_t *u8g, u8g_uint_t w, u8g_uint_t h, uint16_t n)
+{
+  u8g_DrawDisc(u8g, w / 2, h / 2, h / 2 - 2, U8G_DRAW_ALL);
+  u8g_DrawDisc(u8g, h / 4, h / 4, h / 5, U8G_DRAW_ALL);
+  u8g_DrawDisc(u8g, w - h / 4, h - h / 4, h / 5, U8G_DRAW_ALL);
+  u8g_DrawFilledEllipse(u8g, w / 2, h - 8, w / 3, 6, U8G_DRAW_UPPER_LEFT | U8G_DRAW_UPPER_RIGHT);
+}
+
+static void scene_polygons(u8g_t *u8g, u8g_uint_t w, u8g_uint_t h, uint16_t n)
+{
+  u8g_DrawTriangle(u8g, 2, h - 2, w / 3, 2, w / 2, h - 2);
+  u8g_DrawTriangle(u8g, w / 2, 2, w - 2, h / 3, w / 2 + 10, h - 2);
+  u8g_ClearPolygonXY();
+  u8g_AddPolygonXY(u8g, w / 4, h / 4);
+  u8g_AddPolygonXY(u8g, w / 2, 2);
+  u8g_AddPolygonXY(u8g, 3 * w / 4, h / 4);
+  u8g_AddPolygonXY(u8g, 3 * w / 4, 3 * h / 4);
+  u8g_AddPolygonXY(u8g, w / 2, h - 2);
+  u8g_AddPolygonXY(u8g, w / 4, 3 * h / 4);
+  u8g_DrawPolygon(u8g);
+}
+
+struct scene
+{
+  const char *name;
+  scene_fn fn;
+  uint16_t cnt;
+};
+
+static const struct scene checks[] = {
+  { "discs", check_discs, 64 * 15 },
+  { "ellipses", check_ellipses, 600 },
+  { "polygons", check_polygons, 1000 },
+  { "skip", check_skip, 64 },
+};
+
+static const struct scene scenes[] = {
+  { "dashboard", scene_dashboard, 0 },
+  { "discs", scene_discs, 0 },
+  { "polygons", scene_polygons, 0 },
+};
+
+/*========================================================================*/
+
+static void init(u8g_t *u8g, const struct display *d, uint16_t table_cnt)
+{
+  u8g_Init(u8g, d->dev);
+  if ( table_cnt > 0 )
+    u8g_SetEdgeTable(u8g, edge_table, table_cnt);
+}
+
+static void render(u8g_t *u8g, const struct display *d, scene_fn fn, uint16_t n, uint8_t *frame)
+{
+  u8g_pb_t *pb = (u8g_pb_t *)(u8g->dev->dev_mem);
+  u8g_FirstPage(u8g);
+  do
+  {
+    fn(u8g, d->w, d->h, n);
+    if ( frame != NULL )
+      memcpy(frame + pb->p.page * d->w, buf, d->w);
+  } while( u8g_NextPage(u8g) );
+}
+
+static double measure(const struct display *d, scene_fn fn, uint16_t table_cnt, unsigned frames)
+{
+  u8g_t u8g;
+  unsigned i;
+  double start;
+
+  init(&u8g, d, table_cnt);
+  start = bench_now_us();
+  for( i = 0; i < frames; i++ )
+    render(&u8g, d, fn, i, NULL);
+  return (bench_now_us() - start) / frames;
+}
+
+int main(int argc, char **argv)
+{
+  static const uint16_t table_cnts[] = { sizeof(edge_table)/sizeof(*edge_table), 100 };
+  unsigned frames = argc > 1 ? (unsigned)atoi(argv[1]) : 2000;
+  u8g_t u8g_ref, u8g_edge;
+  unsigned d, s, t;
+  uint16_t n;
+  double ref, edge;
+
+  for( d = 0; d < sizeof(displays)/sizeof(*displays); d++ )
+    for( s = 0; s < sizeof(checks)/sizeof(*checks); s++ )
+      for( t = 0; t < sizeof(table_cnts)/sizeof(*table_cnts); t++ )
+      {
+        init(&u8g_ref, displays + d, 0);
+        init(&u8g_edge, displays + d, table_cnts[t]);
+        for( n = 0; n < checks[s].cnt; n++ )
+        {
+          render(&u8g_ref, displays + d, checks[s].fn, n, frame_ref);
+          render(&u8g_edge, displays + d, checks[s].fn, n, frame_edge);
+          if ( memcmp(frame_ref, frame_edge, displays[d].w * displays[d].h / 8) != 0 )
+          {
+            printf("%s %s, frame %u: edge table (%u words) differs\n", displays[d].name, checks[s].name, n, table_cnts[t]);
+            return 1;
+          }
+        }
+      }
+  printf("all primitives: same frames with the edge table\n\n");
+
+  printf("%u frames, us per frame\n\n", frames);
+  printf("%-8s %-10s %10s %10s\n", "display", "scene", "no table", "table");
+  for( d = 0; d < sizeof(displays)/sizeof(*displays); d++ )
+    for( s = 0; s < sizeof(scenes)/sizeof(*scenes); s++ )
+    {
+      ref = measure(displays + d, scenes[s].fn, 0, frames);
+      edge = measure(displays + d, scenes[s].fn, table_cnts[0], frames);
+      printf("%-8s %-10s %10.2f %10.2f  %5.2fx\n", displays[d].name, scenes[s].name, ref, edge, ref / edge);
+    }
+  return 0;
+}
@@ -0,0 +1,453 @@
+/*
+
+  fontrle.c
+
+  convert u8glib fonts (format 0 and 1) into the run length encoded
+  font format 3 (see u8g_draw_rle_glyph() in u8g_font.c)
+
+  fontrle [-a] file.c [fontname ...] > file_rle.c
+
+  Reads the font arrays of file.c (for example src/clib/u8g_font_data.c)
+  and writes each font as "<fontname>_rle" in the same C format.
+  With -a, all fonts in file.c are converted. Anti aliased fonts (format 2)
+  are skipped.
+
+  Each glyph uses the pair of run lengths bit sizes which gives the
+  smallest data. The result is decoded again and compared with the
+  original bitmap.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define FONT_DATA_STRUCT_SIZE 17
+#define MAX_FONT_SIZE 0x10000
+#define MAX_RUNS 4096
+
+struct font
+{
+  char name[128];
+  unsigned char data[MAX_FONT_SIZE];
+  size_t size;
+};
+
+static struct font in, out;
+
+/*========================================================================*/
+/* glyph bitmap */
+
+static int glyph_w, glyph_h;
+static unsigned char bitmap[256*256];
+
+/* run pairs: count of 0 pixels, count of 1 pixels */
+static int run0[MAX_RUNS], run1[MAX_RUNS];
+static int run_cnt;
+
+static void bitmap_to_runs(void)
+{
+  int i, cnt = glyph_w * glyph_h;
+  int a, b;
+
+  run_cnt = 0;
+  i = 0;
+  while( i < cnt )
+  {
+    a = 0;
+    while( i < cnt && bitmap[i] == 0 )
+      a++, i++;
+    b = 0;
+    while( i < cnt && bitmap[i] != 0 )
+      b++, i++;
+    if ( b == 0 )
+      break;                   /* trailing 0 pixels are not stored */
+    run0[run_cnt] = a;
+    run1[run_cnt] = b;
+    run_cnt++;
+  }
+}
+
+/*========================================================================*/
+/* bit stream */
+
+static unsigned char stream[512];
+static int stream_bits;
+
+static void put_bits(unsigned val, int cnt)
+{
+  int i;
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( (val >> i) & 1 )
+      stream[stream_bits / 8] |= 1 << (stream_bits % 8);
+    stream_bits++;
+  }
+}
+
+/* split the runs into pairs which fit into m0/m1 bits, returns the number of bits */
+static int encode(int m0, int m1, int is_write)
+{
+  static int pair0[MAX_RUNS*4], pair1[MAX_RUNS*4];
+  int max0 = (1 << m0) - 1;
+  int max1 = (1 << m1) - 1;
+  int pair_cnt = 0;
+  int i, a, b, bits;
+
+  for( i = 0; i < run_cnt; i++ )
+  {
+    a = run0[i];
+    b = run1[i];
+    while( a > max0 )
+    {
+      pair0[pair_cnt] = max0; pair1[pair_cnt++] = 0;
+      a -= max0;
+    }
+    while( b > max1 )
+    {
+      pair0[pair_cnt] = a; pair1[pair_cnt++] = max1;
+      a = 0;
+      b -= max1;
+    }
+    pair0[pair_cnt] = a; pair1[pair_cnt++] = b;
+  }
+
+  if ( is_write )
+  {
+    memset(stream, 0, sizeof(stream));
+    stream_bits = 0;
+  }
+  bits = 0;
+  for( i = 0; i < pair_cnt; i++ )
+  {
+    if ( i > 0 && pair0[i] == pair0[i-1] && pair1[i] == pair1[i-1] )
+    {
+      /* repeat bit of the previous pair */
+      if ( is_write )
+        stream[(stream_bits - 1) / 8] |= 1 << ((stream_bits - 1) % 8);
+      if ( is_write )
+        put_bits(0, 1);
+      bits++;
+      continue;
+    }
+    if ( is_write )
+    {
+      put_bits(pair0[i], m0);
+      put_bits(pair1[i], m1);
+      put_bits(0, 1);
+    }
+    bits += m0 + m1 + 1;
+  }
+  return bits;
+}
+
+static int get_pos;
+
+static int get_bits(int cnt)
+{
+  int i, val = 0;
+  for( i = 0; i < cnt; i++, get_pos++ )
+    val |= ((stream[get_pos / 8] >> (get_pos % 8)) & 1) << i;
+  return val;
+}
+
+/* same procedure as u8g_draw_rle_glyph(), draws into a bitmap */
+static int decode_check(int m0, int m1, int size)
+{
+  static unsigned char check[256*256];
+  int bits = size * 8;
+  int col = 0, row = 0;
+  int a, b, len, i;
+
+  get_pos = 0;
+  memset(check, 0, sizeof(check));
+  while( bits > m0 + m1 && row < glyph_h )
+  {
+    a = get_bits(m0);
+    b = get_bits(m1);
+    bits -= m0 + m1;
+    for(;;)
+    {
+      col += a;
+      while( col >= glyph_w )
+      {
+        col -= glyph_w;
+        row++;
+      }
+      for( len = b; len > 0 && row < glyph_h; len-- )
+      {
+        check[row * glyph_w + col] = 1;
+        if ( ++col >= glyph_w )
+        {
+          col = 0;
+          row++;
+        }
+      }
+      bits--;
+      if ( get_bits(1) == 0 )
+        break;
+      if ( bits == 0 )
+        return 0;
+    }
+  }
+  for( i = 0; i < glyph_w * glyph_h; i++ )
+    if ( (bitmap[i] != 0) != check[i] )
+      return 0;
+  return 1;
+}
+
+/*========================================================================*/
+/* font conversion */
+
+static void out_byte(int b)
+{
+  if ( out.size >= MAX_FONT_SIZE )
+  {
+    fprintf(stderr, "%s: font too large\n", in.name);
+    exit(1);
+  }
+  out.data[out.size++] = (unsigned char)b;
+}
+
+/* returns 0 if the font can not be converted */
+static int convert(void)
+{
+  const unsigned char *p = in.data + FONT_DATA_STRUCT_SIZE;
+  int format = in.data[0];
+  int start = in.data[10];
+  int end = in.data[11];
+  int enc, x, y, i, m0, m1, best_m0, best_m1, bits, best_bits;
+  int dx, gx, gy, bytes_per_line, size;
+
+  if ( format != 0 && format != 1 )
+  {
+    fprintf(stderr, "%s: format %d not supported\n", in.name, format);
+    return 0;
+  }
+
+  out.size = 0;
+  memcpy(out.data, in.data, FONT_DATA_STRUCT_SIZE);
+  out.data[0] = 3;
+  out.data[6] = out.data[7] = 0;
+  out.data[8] = out.data[9] = 0;
+  out.size = FONT_DATA_STRUCT_SIZE;
+
+  for( enc = start; enc <= end; enc++ )
+  {
+    if ( enc == 65 || enc == 97 )
+    {
+      out.data[enc == 65 ? 6 : 8] = out.size >> 8;
+      out.data[enc == 65 ? 7 : 9] = out.size & 255;
+    }
+
+    if ( *p == 255 )
+    {
+      out_byte(255);
+      p++;
+      continue;
+    }
+
+    if ( format == 0 )
+    {
+      glyph_w = p[0];
+      glyph_h = p[1];
+      size = p[2];
+      dx = p[3];
+      gx = p[4];
+      gy = p[5];
+      p += 6;
+    }
+    else
+    {
+      gx = p[0] >> 4;
+      gy = (signed char)((p[0] & 15) - 2);
+      glyph_w = p[1] >> 4;
+      glyph_h = p[1] & 15;
+      size = p[2] & 15;
+      dx = p[2] >> 4;
+      p += 3;
+    }
+
+    bytes_per_line = (glyph_w + 7) / 8;
+    for( y = 0; y < glyph_h; y++ )
+      for( x = 0; x < glyph_w; x++ )
+        bitmap[y * glyph_w + x] = (p[y * bytes_per_line + x / 8] >> (7 - x % 8)) & 1;
+    p += size;
+
+    bitmap_to_runs();
+    best_bits = -1;
+    best_m0 = best_m1 = 1;
+    for( m0 = 1; m0 <= 8; m0++ )
+      for( m1 = 1; m1 <= 8; m1++ )
+      {
+        bits = encode(m0, m1, 0);
+        if ( best_bits < 0 || bits < best_bits )
+        {
+          best_bits = bits;
+          best_m0 = m0;
+          best_m1 = m1;
+        }
+      }
+    encode(best_m0, best_m1, 1);
+    size = (stream_bits + 7) / 8;
+    if ( size > 255 )
+    {
+      fprintf(stderr, "%s: glyph %d too large (%d bytes)\n", in.name, enc, size);
+      return 0;
+    }
+    if ( decode_check(best_m0, best_m1, size) == 0 )
+    {
+      fprintf(stderr, "%s: glyph %d decodes to a different bitmap\n", in.name, enc);
+      return 0;
+    }
+
+    out_byte(glyph_w);
+    out_byte(glyph_h);
+    out_byte(size);
+    out_byte(dx);
+    out_byte(gx);
+    out_byte(gy);
+    out_byte((best_m0 << 4) | best_m1);
+    for( i = 0; i < size; i++ )
+      out_byte(stream[i]);
+  }
+  return 1;
+}
+
+static void write_font(void)
+{
+  size_t i;
+  printf("const u8g_fntpgm_uint8_t %s_rle[%lu] U8G_FONT_SECTION(\"%s_rle\") = {\n",
+    in.name, (unsigned long)out.size, in.name);
+  for( i = 0; i < out.size; i++ )
+  {
+    if ( i % 16 == 0 )
+      printf("  ");
+    printf("%u", out.data[i]);
+    if ( i + 1 == out.size )
+      printf("};\n");
+    else if ( i % 16 == 15 )
+      printf(",\n");
+    else
+      printf(",");
+  }
+}
+
+/*========================================================================*/
+/* parse the C source */
+
+static char *src;
+
+static char *read_file(const char *filename)
+{
+  FILE *fp = fopen(filename, "rb");
+  long len;
+  char *s;
+  if ( fp == NULL )
+  {
+    perror(filename);
+    exit(1);
+  }
+  fseek(fp, 0, SEEK_END);
+  len = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  s = malloc(len + 1);
+  if ( s == NULL || fread(s, 1, len, fp) != (size_t)len )
+  {
+    perror(filename);
+    exit(1);
+  }
+  s[len] = '\0';
+  fclose(fp);
+  return s;
+}
+
+/* find the next font array, returns the position after the array or NULL */
+static char *parse_font(char *s)
+{
+  static const char *decl = "const u8g_fntpgm_uint8_t ";
+  char *e;
+  size_t n;
+
+  s = strstr(s, decl);
+  if ( s == NULL )
+    return NULL;
+  s += strlen(decl);
+  n = 0;
+  while( (isalnum((unsigned char)*s) || *s == '_') && n < sizeof(in.name) - 1 )
+    in.name[n++] = *s++;
+  in.name[n] = '\0';
+
+  s = strchr(s, '{');
+  if ( s == NULL )
+    return NULL;
+  s++;
+  in.size = 0;
+  for(;;)
+  {
+    while( isspace((unsigned char)*s) || *s == ',' )
+      s++;
+    if ( *s == '}' || *s == '\0' )
+      break;
+    if ( in.size >= MAX_FONT_SIZE )
+    {
+      fprintf(stderr, "%s: font too large\n", in.name);
+      exit(1);
+    }
+    in.data[in.size++] = (unsigned char)strtoul(s, &e, 0);
+    if ( e == s )
+    {
+      fprintf(stderr, "%s: parse error\n", in.name);
+      exit(1);
+    }
+    s = e;
+  }
+  return s;
+}
+
+static int is_selected(const char *name, int argc, char **argv)
+{
+  int i;
+  for( i = 0; i < argc; i++ )
+    if ( strcmp(name, argv[i]) == 0 )
+      return 1;
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  int is_all = 0;
+  unsigned long size_in = 0, size_out = 0;
+  char *s;
+
+  if ( argc > 1 && strcmp(argv[1], "-a") == 0 )
+  {
+    is_all = 1;
+    argc--;
+    argv++;
+  }
+  if ( argc < 2 )
+  {
+    fprintf(stderr, "fontrle [-a] file.c [fontname ...] > file_rle.c\n");
+    return 1;
+  }
+  src = read_file(argv[1]);
+
+  printf("/*\n  generated by fontrle from %s\n*/\n#include \"u8g.h\"\n", argv[1]);
+  s = src;
+  while( (s = parse_font(s)) != NULL )
+  {
+    if ( is_all == 0 && is_selected(in.name, argc - 2, argv + 2) == 0 )
+      continue;
+    if ( convert() == 0 )
+      continue;
+    write_font();
+    fprintf(stderr, "%-32s %6lu -> %6lu bytes%s\n", in.name, (unsigned long)in.size, (unsigned long)out.size,
+      out.size > in.size ? " (larger than the original font)" : "");
+    size_in += in.size;
+    size_out += out.size;
+  }
+  fprintf(stderr, "total %lu -> %lu bytes (%.1f%%)\n", size_in, size_out, size_in ? 100.0 * size_out / size_in : 0.0);
+  return 0;
+}
@@ -0,0 +1,115 @@
+/*
+
+  frame_bench.c
+
+  frame time of a dashboard scene with the picture loop (8 pages of 128x8)
+  compared with a full frame buffer (1 page of 128x64), which executes
+  the draw procedures only once.
+
+  The gprof devices do not transfer anything, the ssd1306 devices send
+  their buffer to u8g_com_null_fn.
+
+  Both ways must produce the same frame, this is checked first.
+
+  make frame_bench && ./frame_bench [frames]
+
+*/
+
+#include "bench.h"
+
+#define FRAME_SIZE (128*64/8)
+
+static uint8_t frame_paged[FRAME_SIZE];
+static uint8_t frame_full[FRAME_SIZE];
+
+/* picture loop, the content of each page is copied into frame */
+static void draw_paged(u8g_t *u8g, uint16_t n, uint8_t *frame)
+{
+  u8g_pb_t *pb = (u8g_pb_t *)(u8g->dev->dev_mem);
+  u8g_FirstPage(u8g);
+  do
+  {
+    bench_dashboard(u8g, n);
+    if ( frame != NULL )
+      memcpy(frame + pb->p.page * pb->width, pb->buf, pb->width);
+  } while( u8g_NextPage(u8g) );
+}
+
+static void draw_full(u8g_t *u8g, uint16_t n)
+{
+  u8g_ClearBuffer(u8g);
+  bench_dashboard(u8g, n);
+  u8g_SendBuffer(u8g);
+}
+
+static double measure(u8g_dev_t *dev, uint8_t is_full, unsigned frames)
+{
+  u8g_t u8g;
+  unsigned i;
+  double start;
+
+  u8g_Init(&u8g, dev);
+  start = bench_now_us();
+  for( i = 0; i < frames; i++ )
+  {
+    if ( is_full )
+      draw_full(&u8g, i);
+    else
+      draw_paged(&u8g, i, NULL);
+  }
+  return (bench_now_us() - start) / frames;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned frames = argc > 1 ? (unsigned)atoi(argv[1]) : 20000;
+  u8g_t u8g;
+  uint16_t n;
+  double paged, full;
+
+  /* same pixels with both buffers */
+  for( n = 0; n < 100; n++ )
+  {
+    u8g_Init(&u8g, &u8g_dev_gprof);
+    draw_paged(&u8g, n, frame_paged);
+    u8g_Init(&u8g, &u8g_dev_gprof_f);
+    draw_full(&u8g, n);
+    memcpy(frame_full, ((u8g_pb_t *)u8g_dev_gprof_f.dev_mem)->buf, FRAME_SIZE);
+    if ( memcmp(frame_paged, frame_full, FRAME_SIZE) != 0 )
+    {
+      printf("frame %u: full frame buffer differs from picture loop\n", n);
+      return 1;
+    }
+  }
+
+  /* picture loop with a full frame device: one iteration only */
+  {
+    uint8_t loops = 0;
+    u8g_Init(&u8g, &u8g_dev_gprof_f);
+    u8g_FirstPage(&u8g);
+    do
+    {
+      loops++;
+    } while( u8g_NextPage(&u8g) );
+    if ( loops != 1 )
+    {
+      printf("picture loop with full frame device: %u iterations\n", loops);
+      return 1;
+    }
+  }
+
+  printf("%u frames, dashboard scene 128x64\n\n", frames);
+  printf("device                     us/frame  frames/s\n");
+
+  paged = measure(&u8g_dev_gprof, 0, frames);
+  printf("gprof (8 pages)            %8.2f  %8.0f\n", paged, 1e6 / paged);
+  full = measure(&u8g_dev_gprof_f, 1, frames);
+  printf("gprof_f (full frame)       %8.2f  %8.0f  %.2fx\n", full, 1e6 / full, paged / full);
+
+  paged = measure(&u8g_dev_ssd1306_128x64_hw_spi, 0, frames);
+  printf("ssd1306_128x64 (8 pages)   %8.2f  %8.0f\n", paged, 1e6 / paged);
+  full = measure(&u8g_dev_ssd1306_128x64_f_hw_spi, 1, frames);
+  printf("ssd1306_128x64_f           %8.2f  %8.0f  %.2fx\n", full, 1e6 / full, paged / full);
+
+  return 0;
+}
@@ -0,0 +1,167 @@
+/*
+
+  golden_test.c
+
+  Golden image test for the primitives in prim.h: each scene is drawn on the
+  memory devices of all page buffer layouts (u8g_dev_mem.c) and compared
+  with golden/<scene>.pbm. Gray and color devices draw with full intensity,
+  so every layout must set exactly the pixels of the golden image.
+  The pbm devices are checked with the "u8g.pbm" file they write.
+
+  A frame which differs is written to <scene>_<layout>_fail.pnm.
+
+  make golden_test && ./golden_test
+  ./golden_test -u	writes new golden images (u8g_dev_mem_8v1)
+
+*/
+
+#include "bench.h"
+#include "prim.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+
+static uint8_t golden[WIDTH*HEIGHT];
+static uint8_t pixel[WIDTH*HEIGHT];
+
+/* reads P4, P5 or P6 (as written by u8g_dev_mem_WritePNM()), 1 for each black pixel */
+static int read_pnm(const char *filename, uint8_t *dest)
+{
+  FILE *fp = fopen(filename, "rb");
+  int type, w, h, max = 1, c = 0, i, j, k;
+  uint8_t rgb[3];
+
+  if ( fp == NULL )
+    return 0;
+  if ( fscanf(fp, "P%d %d %d", &type, &w, &h) != 3 || w != WIDTH || h != HEIGHT )
+  {
+    fclose(fp);
+    return 0;
+  }
+  if ( type != 4 && fscanf(fp, "%d", &max) != 1 )
+  {
+    fclose(fp);
+    return 0;
+  }
+  getc(fp);
+  for( i = 0; i < WIDTH*HEIGHT; i++ )
+  {
+    if ( type == 4 )
+    {
+      if ( (i & 7) == 0 )
+        c = getc(fp);
+      dest[i] = (c >> (7 - (i & 7))) & 1;
+    }
+    else if ( type == 5 )
+      dest[i] = getc(fp) != max;
+    else
+    {
+      k = 0;
+      for( j = 0; j < 3; j++ )
+      {
+        rgb[j] = getc(fp);
+        k |= rgb[j];
+      }
+      dest[i] = k != 0;
+    }
+  }
+  c = ferror(fp) || feof(fp);
+  fclose(fp);
+  return !c;
+}
+
+/* 1 for each pixel which is not the background color */
+static void get_pixel(u8g_t *u8g, u8g_dev_t *dev, uint8_t *dest)
+{
+  uint8_t *frame = u8g_dev_mem_GetFrame(dev);
+  int i;
+  for( i = 0; i < WIDTH*HEIGHT; i++ )
+  {
+    if ( U8G_MODE_IS_COLOR(u8g_GetMode(u8g)) )
+      dest[i] = (frame[i*3] | frame[i*3+1] | frame[i*3+2]) != 0;
+    else
+      dest[i] = frame[i] != 0;
+  }
+}
+
+static int compare(const char *scene, const char *layout, u8g_dev_t *dev)
+{
+  char name[64];
+  int i, diff = 0;
+  for( i = 0; i < WIDTH*HEIGHT; i++ )
+    if ( pixel[i] != golden[i] )
+      diff++;
+  if ( diff == 0 )
+    return 1;
+  printf("%s, %s: %d pixel differ from golden/%s.pbm\n", scene, layout, diff, scene);
+  if ( dev != NULL )
+  {
+    sprintf(name, "%s_%s_fail.pnm", scene, layout);
+    u8g_dev_mem_WritePNM(dev, name);
+  }
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  static u8g_dev_t *pbm_devs[] = { &u8g_dev_pbm, &u8g_dev_pbm_8h1, &u8g_dev_pbm_8h2 };
+  static const char *pbm_names[] = { "pbm", "pbm_8h1", "pbm_8h2" };
+  u8g_t u8g;
+  char name[64];
+  unsigned p, d, failed = 0, checked = 0;
+
+  for( p = 0; p < PRIM_CNT; p++ )
+  {
+    sprintf(name, "golden/%s.pbm", prims[p].name);
+    if ( argc > 1 && strcmp(argv[1], "-u") == 0 )
+    {
+      prim_init(&u8g, &u8g_dev_mem_8v1);
+      prim_render(&u8g, prims + p, 0);
+      if ( u8g_dev_mem_WritePNM(&u8g_dev_mem_8v1, name) == 0 )
+      {
+        printf("%s: write error\n", name);
+        return 1;
+      }
+      printf("%s written\n", name);
+      continue;
+    }
+
+    if ( read_pnm(name, golden) == 0 )
+    {
+      printf("%s: read error\n", name);
+      return 1;
+    }
+    for( d = 0; d < PRIM_DEV_CNT; d++ )
+    {
+      prim_init(&u8g, prim_devs[d].dev);
+      prim_render(&u8g, prims + p, 0);
+      get_pixel(&u8g, prim_devs[d].dev, pixel);
+      failed += !compare(prims[p].name, prim_devs[d].name, prim_devs[d].dev);
+      checked++;
+    }
+    for( d = 0; d < sizeof(pbm_devs)/sizeof(*pbm_devs); d++ )
+    {
+      remove("u8g.pbm");
+      prim_init(&u8g, pbm_devs[d]);
+      prim_render(&u8g, prims + p, 0);
+      if ( read_pnm("u8g.pbm", pixel) == 0 )
+      {
+        printf("%s, %s: u8g.pbm not written\n", prims[p].name, pbm_names[d]);
+        failed++;
+      }
+      else
+        failed += !compare(prims[p].name, pbm_names[d], NULL);
+      checked++;
+    }
+    remove("u8g.pbm");
+  }
+  if ( checked == 0 )
+    return 0;
+  if ( failed != 0 )
+  {
+    printf("%u of %u frames differ\n", failed, checked);
+    return 1;
+  }
+  printf("all %u frames: same as the golden images\n", checked);
+  return 0;
+}
@@ -0,0 +1,259 @@
+/*
+
+  mock_dev.c
+
+  mock /dev and wiringPi for the Linux com procedures, see mock_dev.h
+
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <linux/spi/spidev.h>
+#include "mock_dev.h"
+#include "wiringPi.h"
+#include "wiringPiSPI.h"
+
+unsigned long mock_i2c_funcs = I2C_FUNC_I2C;
+long mock_ns_per_byte = 0;
+
+static struct mock_dev i2c_dev[MOCK_I2C_CNT];
+static struct mock_dev spi_dev[MOCK_SPI_CNT];
+static int pin_level[64];
+
+struct mock_dev *mock_i2c(int bus)
+{
+  return i2c_dev + bus;
+}
+
+struct mock_dev *mock_spi(int channel)
+{
+  return spi_dev + channel;
+}
+
+static struct mock_dev *mock_fd(int fd)
+{
+  if ( fd >= MOCK_I2C_FD(0) && fd < MOCK_I2C_FD(MOCK_I2C_CNT) )
+    return i2c_dev + fd - MOCK_I2C_FD(0);
+  if ( fd >= MOCK_SPI_FD(0) && fd < MOCK_SPI_FD(MOCK_SPI_CNT) )
+    return spi_dev + fd - MOCK_SPI_FD(0);
+  return NULL;
+}
+
+void mock_clear_counters(void)
+{
+  int i;
+  for( i = 0; i < MOCK_I2C_CNT; i++ )
+    i2c_dev[i].cnt_syscall = i2c_dev[i].cnt_bytes = i2c_dev[i].cnt_i2c_msgs = 0;
+  for( i = 0; i < MOCK_SPI_CNT; i++ )
+    spi_dev[i].cnt_syscall = spi_dev[i].cnt_bytes = spi_dev[i].cnt_i2c_msgs = 0;
+}
+
+static void add_counters(struct mock_dev *sum, const struct mock_dev *d)
+{
+  sum->cnt_syscall += d->cnt_syscall;
+  sum->cnt_bytes += d->cnt_bytes;
+  sum->cnt_i2c_msgs += d->cnt_i2c_msgs;
+}
+
+void mock_sum_counters(struct mock_dev *sum)
+{
+  int i;
+  memset(sum, 0, sizeof(*sum));
+  for( i = 0; i < MOCK_I2C_CNT; i++ )
+    add_counters(sum, i2c_dev + i);
+  for( i = 0; i < MOCK_SPI_CNT; i++ )
+    add_counters(sum, spi_dev + i);
+}
+
+/*========================================================================*/
+/* emulated SSD1306, page addressing */
+
+static void ssd_write(struct mock_dev *d, uint8_t is_data, uint8_t b)
+{
+  if ( is_data )
+  {
+    if ( d->col < MOCK_WIDTH )
+      d->ram[d->page & 7][d->col++] = b;
+    return;
+  }
+  if ( (b & 0x0f0) == 0x0b0 )
+    d->page = b & 0x0f;
+  else if ( (b & 0x0f0) == 0x010 )
+    d->col = (d->col & 0x0f) | ((b & 0x0f) << 4);
+  else if ( (b & 0x0f0) == 0x000 )
+    d->col = (d->col & 0x0f0) | b;
+}
+
+/* bus time of a transfer */
+static void bus_wait(size_t len)
+{
+  struct timespec ts;
+  long ns = len * mock_ns_per_byte;
+  if ( ns == 0 )
+    return;
+  ts.tv_sec = ns / 1000000000L;
+  ts.tv_nsec = ns % 1000000000L;
+  nanosleep(&ts, NULL);
+}
+
+/* one I2C message: control byte(s) and data */
+static void i2c_msg(struct mock_dev *d, const uint8_t *buf, size_t len)
+{
+  size_t i;
+  d->cnt_i2c_msgs++;
+  d->cnt_bytes += len;
+  for( i = 0; i < len; i++ )
+  {
+    if ( buf[i] & 0x080 )
+    {
+      /* Co = 1: one byte follows, then the next control byte */
+      if ( i + 1 < len )
+        ssd_write(d, (buf[i] & 0x040) != 0, buf[i+1]);
+      i++;
+    }
+    else
+    {
+      /* Co = 0: all following bytes */
+      uint8_t is_data = (buf[i] & 0x040) != 0;
+      for( i++; i < len; i++ )
+        ssd_write(d, is_data, buf[i]);
+    }
+  }
+  bus_wait(len);
+}
+
+/*========================================================================*/
+/* system calls */
+
+int __real_open(const char *path, int flags, ...);
+int __real_close(int fd);
+ssize_t __real_write(int fd, const void *buf, size_t cnt);
+int __real_ioctl(int fd, unsigned long request, ...);
+
+int __wrap_open(const char *path, int flags, ...)
+{
+  va_list va;
+  int mode, n;
+  if ( strncmp(path, "/dev/i2c-", 9) == 0 )
+  {
+    n = atoi(path + 9);
+    if ( n < 0 || n >= MOCK_I2C_CNT )
+      return -1;
+    i2c_dev[n].cnt_syscall++;
+    return MOCK_I2C_FD(n);
+  }
+  if ( strncmp(path, "/dev/spidev0.", 13) == 0 )
+  {
+    n = atoi(path + 13);
+    if ( n < 0 || n >= MOCK_SPI_CNT )
+      return -1;
+    spi_dev[n].cnt_syscall++;
+    return MOCK_SPI_FD(n);
+  }
+  va_start(va, flags);
+  mode = va_arg(va, int);
+  va_end(va);
+  return __real_open(path, flags, mode);
+}
+
+int __wrap_close(int fd)
+{
+  struct mock_dev *d = mock_fd(fd);
+  if ( d != NULL )
+  {
+    d->cnt_syscall++;
+    return 0;
+  }
+  return __real_close(fd);
+}
+
+ssize_t __wrap_write(int fd, const void *buf, size_t cnt)
+{
+  struct mock_dev *d = mock_fd(fd);
+  if ( d != NULL && fd < MOCK_SPI_FD(0) )
+  {
+    d->cnt_syscall++;
+    i2c_msg(d, buf, cnt);
+    return cnt;
+  }
+  return __real_write(fd, buf, cnt);
+}
+
+int __wrap_ioctl(int fd, unsigned long request, ...)
+{
+  struct mock_dev *d = mock_fd(fd);
+  va_list va;
+  void *arg;
+  va_start(va, request);
+  arg = va_arg(va, void *);
+  va_end(va);
+
+  if ( d == NULL )
+    return __real_ioctl(fd, request, arg);
+  d->cnt_syscall++;
+  if ( fd < MOCK_SPI_FD(0) )
+  {
+    if ( request == I2C_FUNCS )
+    {
+      *(unsigned long *)arg = mock_i2c_funcs;
+    }
+    else if ( request == I2C_RDWR )
+    {
+      struct i2c_rdwr_ioctl_data *rdwr = arg;
+      unsigned i;
+      if ( (mock_i2c_funcs & I2C_FUNC_I2C) == 0 )
+        return -1;
+      for( i = 0; i < rdwr->nmsgs; i++ )
+        i2c_msg(d, rdwr->msgs[i].buf, rdwr->msgs[i].len);
+    }
+    return 0;
+  }
+  if ( request == SPI_IOC_MESSAGE(1) )
+  {
+    struct spi_ioc_transfer *tr = arg;
+    const uint8_t *p = (const uint8_t *)(unsigned long)tr->tx_buf;
+    int a0 = pin_level[MOCK_SPI_A0(fd - MOCK_SPI_FD(0))];
+    unsigned i;
+    d->cnt_bytes += tr->len;
+    for( i = 0; i < tr->len; i++ )
+      ssd_write(d, a0, p[i]);
+    bus_wait(tr->len);
+  }
+  return 0;
+}
+
+/*========================================================================*/
+/* wiringPi, only what u8glib needs */
+
+int wiringPiSetup(void) { return 0; }
+void pinMode(int pin, int mode) { }
+void digitalWrite(int pin, int value) { pin_level[pin & 63] = value; }
+int digitalRead(int pin) { return pin_level[pin & 63]; }
+void delay(unsigned int ms) { }
+void delayMicroseconds(unsigned int us) { }
+
+int wiringPiSPISetup(int channel, int speed)
+{
+  return open(channel == 0 ? "/dev/spidev0.0" : "/dev/spidev0.1", O_RDWR);
+}
+
+int wiringPiSPIGetFd(int channel) { return MOCK_SPI_FD(channel & 1); }
+
+int wiringPiSPIDataRW(int channel, unsigned char *data, int len)
+{
+  struct spi_ioc_transfer tr;
+  memset(&tr, 0, sizeof(tr));
+  tr.tx_buf = (unsigned long)data;
+  tr.rx_buf = (unsigned long)data;
+  tr.len = len;
+  return ioctl(wiringPiSPIGetFd(channel), SPI_IOC_MESSAGE(1), &tr);
+}
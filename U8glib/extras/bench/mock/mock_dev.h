@@ -0,0 +1,55 @@
+/*
+
+  mock_dev.h
+
+  mock /dev for the Linux com procedures (com_bench, vs_bench)
+
+  open(), close(), write() and ioctl() are replaced with ld --wrap (see
+  Makefile). /dev/i2c-<bus> and /dev/spidev0.<channel> are emulated
+  SSD1306 displays in page addressing mode, each with its own RAM and
+  counters (I2C control bytes, SPI with the A0 line). One thread may use
+  each device at the same time.
+
+  mock_ns_per_byte is the bus time, which write() and ioctl() spend with
+  nanosleep() for each transferred byte, like a blocking i2c-dev or spidev
+  transfer.
+
+*/
+
+#ifndef _MOCK_DEV_H
+#define _MOCK_DEV_H
+
+#include <stdint.h>
+
+#define MOCK_WIDTH 128
+#define MOCK_PAGES 8
+
+#define MOCK_I2C_CNT 256
+#define MOCK_SPI_CNT 2
+#define MOCK_I2C_FD(bus) (1000 + (bus))
+#define MOCK_SPI_FD(channel) (1300 + (channel))
+
+/* A0 pin of the display at SPI channel 0 and 1 */
+#define MOCK_SPI_A0(channel) ((channel) == 0 ? 24 : 22)
+
+struct mock_dev
+{
+  uint8_t ram[MOCK_PAGES][MOCK_WIDTH];
+  uint8_t page;
+  uint8_t col;
+  unsigned long cnt_syscall;
+  unsigned long cnt_bytes;	/* bytes on the bus, including I2C control bytes */
+  unsigned long cnt_i2c_msgs;
+};
+
+extern unsigned long mock_i2c_funcs;	/* result of I2C_FUNCS */
+extern long mock_ns_per_byte;
+
+struct mock_dev *mock_i2c(int bus);
+struct mock_dev *mock_spi(int channel);
+
+/* counters of all devices */
+void mock_clear_counters(void);
+void mock_sum_counters(struct mock_dev *sum);
+
+#endif /* _MOCK_DEV_H */
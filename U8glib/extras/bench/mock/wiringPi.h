@@ -0,0 +1,23 @@
+/*
+
+  wiringPi.h
+
+  stand-in for the wiringPi header, only the procedures used by u8glib,
+  implemented by mock_dev.c
+
+*/
+
+#ifndef _WIRINGPI_H
+#define _WIRINGPI_H
+
+#define INPUT 0
+#define OUTPUT 1
+
+int wiringPiSetup(void);
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+int digitalRead(int pin);
+void delay(unsigned int ms);
+void delayMicroseconds(unsigned int us);
+
+#endif /* _WIRINGPI_H */
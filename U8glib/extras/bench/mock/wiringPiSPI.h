@@ -0,0 +1,16 @@
+/*
+
+  wiringPiSPI.h
+
+  stand-in for the wiringPi SPI header, implemented by mock_dev.c
+
+*/
+
+#ifndef _WIRINGPISPI_H
+#define _WIRINGPISPI_H
+
+int wiringPiSPIGetFd(int channel);
+int wiringPiSPIDataRW(int channel, unsigned char *data, int len);
+int wiringPiSPISetup(int channel, int speed);
+
+#endif /* _WIRINGPISPI_H */
@@ -0,0 +1,145 @@
+/*
+
+  prim.h
+
+  scenes for prim_bench and golden_test: each scene uses one kind of
+  primitive, partly outside of the 128x64 display
+
+*/
+
+#ifndef _PRIM_H
+#define _PRIM_H
+
+#include "u8g.h"
+
+/* 16x16 arrow, 2 bytes per line (u8g_DrawBitmap) */
+static const uint8_t prim_arrow_bitmap[32] = {
+  0x01, 0x80, 0x03, 0xc0, 0x07, 0xe0, 0x0f, 0xf0, 0x1f, 0xf8, 0x3f, 0xfc, 0x7f, 0xfe, 0xff, 0xff,
+  0x07, 0xe0, 0x07, 0xe0, 0x07, 0xe0, 0x07, 0xe0, 0x07, 0xe0, 0x07, 0xe0, 0x07, 0xe0, 0x07, 0xe0 };
+
+/* 12x12 check mark, XBM format (lsb first) */
+static const uint8_t prim_check_xbm[24] = {
+  0x00, 0x08, 0x00, 0x0c, 0x00, 0x0e, 0x00, 0x07, 0x80, 0x03, 0xc1, 0x01,
+  0xe3, 0x00, 0x77, 0x00, 0x3e, 0x00, 0x1c, 0x00, 0x08, 0x00, 0x00, 0x00 };
+
+static void prim_lines(u8g_t *u8g, uint16_t n)
+{
+  uint8_t i;
+  for( i = 0; i < 16; i++ )
+  {
+    u8g_DrawLine(u8g, 0, 0, 127, (i * 4 + n) & 63);
+    u8g_DrawLine(u8g, 127, 63, (i * 8 + n) & 127, 0);
+  }
+  u8g_DrawLine(u8g, 64, 32, 64 + n % 8, 63);
+  u8g_DrawLine(u8g, 10, 60, 120, 5);
+  u8g_DrawLine(u8g, 120, 60, 10, 2);
+  u8g_DrawLine(u8g, 5, 5, 5, 60);
+  u8g_DrawLine(u8g, 3, 40, 124, 40);
+  u8g_DrawHLine(u8g, 100, 50, 60);		/* clipped at the right border */
+  u8g_DrawVLine(u8g, 90, 30, 50);		/* clipped at the lower border */
+}
+
+static void prim_circles(u8g_t *u8g, uint16_t n)
+{
+  u8g_DrawCircle(u8g, 20, 20, 15, U8G_DRAW_ALL);
+  u8g_DrawCircle(u8g, 64, 32, 30 + n % 4, U8G_DRAW_ALL);
+  u8g_DrawDisc(u8g, 100, 20, 12, U8G_DRAW_UPPER_RIGHT | U8G_DRAW_LOWER_LEFT);
+  u8g_DrawDisc(u8g, 40, 50, 8, U8G_DRAW_ALL);
+  u8g_DrawDisc(u8g, 120, 60, 14, U8G_DRAW_ALL);	/* partly outside */
+  u8g_DrawEllipse(u8g, 64, 32, 50, 20, U8G_DRAW_ALL);
+  u8g_DrawFilledEllipse(u8g, 90, 45, 10, 6, U8G_DRAW_ALL);
+  u8g_DrawFilledEllipse(u8g, 5, 60, 20, 8, U8G_DRAW_UPPER_RIGHT);
+}
+
+static void prim_polygons(u8g_t *u8g, uint16_t n)
+{
+  u8g_DrawTriangle(u8g, 5, 5, 40, 10, 20, 50);
+  u8g_DrawTriangle(u8g, 60, 2, 70 + n % 8, 60, 50, 40);
+  u8g_DrawTriangle(u8g, 100, 10, 140, 30, 90, 70);	/* partly outside */
+  u8g_DrawTriangle(u8g, -10, 55, 30, 62, 20, 45);
+  u8g_DrawRFrame(u8g, 75, 5, 20, 25, 5);
+  u8g_DrawRBox(u8g, 30, 30, 18, 14, 4);
+  u8g_DrawFrame(u8g, 0, 0, 128, 64);
+  u8g_DrawBox(u8g, 110, 40, 10, 10);
+}
+
+static void prim_glyphs(u8g_t *u8g, uint16_t n)
+{
+  u8g_SetFont(u8g, u8g_font_6x10);
+  u8g_DrawStr(u8g, 2, 10, "Temp 23.5 C ok");
+  u8g_DrawStr90(u8g, 118, 2, "up 90");
+  u8g_SetFont(u8g, u8g_font_helvR08);
+  u8g_DrawStr180(u8g, 100, 20, "Valve B");
+  u8g_DrawStr270(u8g, 6, 60, "down");
+  u8g_SetFont(u8g, u8g_font_fub20);
+  u8g_DrawStr(u8g, 20 + n % 4, 50, "47.3%");
+  u8g_SetFont(u8g, u8g_font_4x6);
+  u8g_DrawStr(u8g, 100, 62, "clipped text");
+}
+
+static void prim_bitmaps(u8g_t *u8g, uint16_t n)
+{
+  uint8_t i;
+  for( i = 0; i < 6; i++ )
+  {
+    u8g_DrawBitmap(u8g, i * 21 + n % 3, 4, 2, 16, prim_arrow_bitmap);
+    u8g_DrawXBM(u8g, i * 21 + 3, 28, 12, 12, prim_check_xbm);
+  }
+  u8g_DrawBitmap(u8g, 120, 50, 2, 16, prim_arrow_bitmap);	/* partly outside */
+  u8g_DrawXBM(u8g, 40, 44, 12, 12, prim_check_xbm);
+  u8g_DrawXBM(u8g, 60, 46, 12, 12, prim_check_xbm);
+}
+
+struct prim
+{
+  const char *name;
+  void (*draw)(u8g_t *u8g, uint16_t n);
+};
+
+static const struct prim prims[] = {
+  { "lines", prim_lines },
+  { "circles", prim_circles },
+  { "polygons", prim_polygons },
+  { "glyphs", prim_glyphs },
+  { "bitmaps", prim_bitmaps },
+};
+
+#define PRIM_CNT (sizeof(prims)/sizeof(*prims))
+
+struct prim_dev
+{
+  const char *name;
+  u8g_dev_t *dev;
+};
+
+static const struct prim_dev prim_devs[] = {
+  { "8v1", &u8g_dev_mem_8v1 },
+  { "8h1", &u8g_dev_mem_8h1 },
+  { "8v2", &u8g_dev_mem_8v2 },
+  { "16h2", &u8g_dev_mem_16h2 },
+  { "xh16", &u8g_dev_mem_xh16 },
+  { "xh24", &u8g_dev_mem_xh24 },
+};
+
+#define PRIM_DEV_CNT (sizeof(prim_devs)/sizeof(*prim_devs))
+
+/* white (full intensity) for all modes */
+static void prim_init(u8g_t *u8g, u8g_dev_t *dev)
+{
+  u8g_Init(u8g, dev);
+  if ( u8g_GetMode(u8g) == U8G_MODE_TRUECOLOR )
+    u8g_SetRGB(u8g, 255, 255, 255);
+  else
+    u8g_SetDefaultForegroundColor(u8g);
+}
+
+static void prim_render(u8g_t *u8g, const struct prim *p, uint16_t n)
+{
+  u8g_FirstPage(u8g);
+  do
+  {
+    p->draw(u8g, n);
+  } while( u8g_NextPage(u8g) );
+}
+
+#endif /* _PRIM_H */
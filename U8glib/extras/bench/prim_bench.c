@@ -0,0 +1,95 @@
+/*
+
+  prim_bench.c
+
+  frame time of the primitives in prim.h (lines, circles, polygons, glyphs
+  and bitmaps) on the memory devices of all page buffer layouts
+  (u8g_dev_mem.c). The time includes the copy of each page into the frame
+  memory of the device.
+
+  First all layouts have to set the same pixels as pb8v1 for several
+  variations of each scene, golden_test compares with fixed images.
+
+  make prim_bench && ./prim_bench [frames]
+
+*/
+
+#include "bench.h"
+#include "prim.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+
+static uint8_t ref[WIDTH*HEIGHT];
+
+/* 1 for each pixel which is not the background color */
+static void get_pixel(u8g_t *u8g, u8g_dev_t *dev, uint8_t *dest)
+{
+  uint8_t *frame = u8g_dev_mem_GetFrame(dev);
+  int i;
+  for( i = 0; i < WIDTH*HEIGHT; i++ )
+  {
+    if ( U8G_MODE_IS_COLOR(u8g_GetMode(u8g)) )
+      dest[i] = (frame[i*3] | frame[i*3+1] | frame[i*3+2]) != 0;
+    else
+      dest[i] = frame[i] != 0;
+  }
+}
+
+static double measure(const struct prim *p, u8g_dev_t *dev, unsigned frames)
+{
+  u8g_t u8g;
+  unsigned i;
+  double start;
+
+  prim_init(&u8g, dev);
+  start = bench_now_us();
+  for( i = 0; i < frames; i++ )
+    prim_render(&u8g, p, i);
+  return (bench_now_us() - start) / frames;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned frames = argc > 1 ? (unsigned)atoi(argv[1]) : 2000;
+  static uint8_t pixel[WIDTH*HEIGHT];
+  u8g_t u8g;
+  unsigned p, d;
+  uint16_t n;
+
+  for( p = 0; p < PRIM_CNT; p++ )
+  {
+    for( n = 0; n < 8; n++ )
+    {
+      prim_init(&u8g, prim_devs[0].dev);
+      prim_render(&u8g, prims + p, n);
+      get_pixel(&u8g, prim_devs[0].dev, ref);
+      for( d = 1; d < PRIM_DEV_CNT; d++ )
+      {
+        prim_init(&u8g, prim_devs[d].dev);
+        prim_render(&u8g, prims + p, n);
+        get_pixel(&u8g, prim_devs[d].dev, pixel);
+        if ( memcmp(ref, pixel, sizeof(ref)) != 0 )
+        {
+          printf("%s, frame %u: %s differs from %s\n", prims[p].name, n, prim_devs[d].name, prim_devs[0].name);
+          return 1;
+        }
+      }
+    }
+  }
+  printf("all layouts: same pixels as %s\n\n", prim_devs[0].name);
+
+  printf("%u frames 128x64, us per frame\n\n", frames);
+  printf("%-10s", "scene");
+  for( d = 0; d < PRIM_DEV_CNT; d++ )
+    printf(" %8s", prim_devs[d].name);
+  printf("\n");
+  for( p = 0; p < PRIM_CNT; p++ )
+  {
+    printf("%-10s", prims[p].name);
+    for( d = 0; d < PRIM_DEV_CNT; d++ )
+      printf(" %8.2f", measure(prims + p, prim_devs[d].dev, frames));
+    printf("\n");
+  }
+  return 0;
+}
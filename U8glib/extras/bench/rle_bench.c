@@ -0,0 +1,143 @@
+/*
+
+  rle_bench.c
+
+  run length encoded fonts (format 3, converted by fontrle into rle_fonts.c)
+  compared with the original fonts (format 0 and 1): font size and glyphs
+  per second on a 128x64 page buffer (pb8v1).
+
+  First the converted font has to produce the same frames as the original
+  font, for all four directions, with and without U8G_DEV_MSG_SET_BOX.
+
+  make rle_bench && ./rle_bench [frames]
+
+*/
+
+#include "bench.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+
+extern const u8g_fntpgm_uint8_t u8g_font_6x10_rle[];
+extern const u8g_fntpgm_uint8_t u8g_font_helvR08_rle[];
+extern const u8g_fntpgm_uint8_t u8g_font_fub11_rle[];
+extern const u8g_fntpgm_uint8_t u8g_font_fub20_rle[];
+extern const u8g_fntpgm_uint8_t u8g_font_courB24_rle[];
+extern const u8g_fntpgm_uint8_t u8g_font_fub30_rle[];
+extern const u8g_fntpgm_uint8_t u8g_font_fub49n_rle[];
+
+static uint8_t buf[WIDTH];
+static uint8_t frame_orig[WIDTH*HEIGHT/8];
+static uint8_t frame_rle[WIDTH*HEIGHT/8];
+
+static u8g_pb_t pb = { {8, HEIGHT, 0, 0, 0}, WIDTH, buf };
+static u8g_dev_t dev = { u8g_dev_pb8v1_base_fn, &pb, u8g_com_null_fn };
+
+struct font
+{
+  const char *name;
+  const u8g_fntpgm_uint8_t *orig;
+  const u8g_fntpgm_uint8_t *rle;
+  const char *str;
+};
+
+static const struct font fonts[] = {
+  { "6x10", u8g_font_6x10, u8g_font_6x10_rle, "Temp 23.5 C ok" },
+  { "helvR08", u8g_font_helvR08, u8g_font_helvR08_rle, "Valve B closed" },
+  { "fub11", u8g_font_fub11, u8g_font_fub11_rle, "Flow 4.2 l/m" },
+  { "fub20", u8g_font_fub20, u8g_font_fub20_rle, "Pump 42%" },
+  { "courB24", u8g_font_courB24, u8g_font_courB24_rle, "12:45" },
+  { "fub30", u8g_font_fub30, u8g_font_fub30_rle, "61.5" },
+  { "fub49n", u8g_font_fub49n, u8g_font_fub49n_rle, "47.3" },
+};
+
+static void draw_text(u8g_t *u8g, const u8g_fntpgm_uint8_t *font, const char *s, uint16_t n)
+{
+  u8g_SetFont(u8g, font);
+  u8g_DrawStr(u8g, (n * 7) % 50 - 10, 10 + (n * 13) % 60, s);
+  u8g_DrawStr90(u8g, 90 + n % 30, (n * 5) % 40 - 10, s);
+  u8g_DrawStr180(u8g, 120 - (n * 3) % 30, n % 50, s);
+  u8g_DrawStr270(u8g, 10 + n % 30, 70 - n % 20, s);
+}
+
+static void render(u8g_t *u8g, const u8g_fntpgm_uint8_t *font, const char *s, uint16_t n, uint8_t *frame)
+{
+  u8g_FirstPage(u8g);
+  do
+  {
+    draw_text(u8g, font, s, n);
+    memcpy(frame + pb.p.page * WIDTH, buf, WIDTH);
+  } while( u8g_NextPage(u8g) );
+}
+
+/* glyphs per second */
+static double measure(const u8g_fntpgm_uint8_t *font, const char *s, unsigned frames)
+{
+  u8g_t u8g;
+  unsigned f;
+  uint8_t i;
+  double start;
+  unsigned long glyphs = 0;
+
+  u8g_Init(&u8g, &dev);
+  u8g_SetFont(&u8g, font);
+  start = bench_now_us();
+  for( f = 0; f < frames; f++ )
+  {
+    u8g_FirstPage(&u8g);
+    do
+    {
+      for( i = 0; i < 4; i++ )
+        u8g_DrawStr(&u8g, i * 6, 16 + i * 16, s);
+    } while( u8g_NextPage(&u8g) );
+    glyphs += 4 * strlen(s);
+  }
+  return glyphs * 1e6 / (bench_now_us() - start);
+}
+
+int main(int argc, char **argv)
+{
+  unsigned frames = argc > 1 ? (unsigned)atoi(argv[1]) : 500;
+  u8g_t u8g;
+  unsigned f;
+  uint16_t n;
+  uint8_t is_set_box;
+  size_t size_orig, size_rle, total_orig = 0, total_rle = 0;
+  double orig, rle;
+
+  for( f = 0; f < sizeof(fonts)/sizeof(*fonts); f++ )
+  {
+    for( is_set_box = 0; is_set_box < 2; is_set_box++ )
+    {
+      u8g_Init(&u8g, &dev);
+      u8g.is_set_box &= is_set_box;
+      for( n = 0; n < 50; n++ )
+      {
+        render(&u8g, fonts[f].orig, fonts[f].str, n, frame_orig);
+        render(&u8g, fonts[f].rle, fonts[f].str, n, frame_rle);
+        if ( memcmp(frame_orig, frame_rle, sizeof(frame_orig)) != 0 )
+        {
+          printf("%s, frame %u: rle font differs from original font (set box %u)\n", fonts[f].name, n, is_set_box);
+          return 1;
+        }
+      }
+    }
+  }
+  printf("all fonts: same frames with the rle font\n\n");
+
+  printf("%u frames 128x64, font size in bytes, glyphs per second\n\n", frames);
+  printf("%-8s %7s %7s        %10s %10s\n", "font", "size", "rle", "glyphs/s", "rle");
+  for( f = 0; f < sizeof(fonts)/sizeof(*fonts); f++ )
+  {
+    size_orig = u8g_font_GetSize(fonts[f].orig);
+    size_rle = u8g_font_GetSize(fonts[f].rle);
+    total_orig += size_orig;
+    total_rle += size_rle;
+    orig = measure(fonts[f].orig, fonts[f].str, frames);
+    rle = measure(fonts[f].rle, fonts[f].str, frames);
+    printf("%-8s %7lu %7lu %5.0f%% %10.0f %10.0f  %5.2fx\n", fonts[f].name,
+      (unsigned long)size_orig, (unsigned long)size_rle, 100.0 * size_rle / size_orig, orig, rle, rle / orig);
+  }
+  printf("%-8s %7lu %7lu %5.0f%%\n", "total", (unsigned long)total_orig, (unsigned long)total_rle, 100.0 * total_rle / total_orig);
+  return 0;
+}
@@ -0,0 +1,159 @@
+/*
+
+  rot_bench.c
+
+  rotation (u8g_rot.c) and scaling (u8g_scale.c) with boxes: the wrappers
+  rotate and scale U8G_DEV_MSG_SET_BOX as one block and the page buffer
+  fills it, a scaled pixel is one 2x2 box.
+  For comparison, a filter device below the wrappers does not support
+  boxes, like the wrappers before: all lines and boxes are drawn with
+  U8G_DEV_MSG_SET_8PIXEL and each message passes the wrappers.
+
+  First, the box path must set the same pixels as the pixel path for
+  all scenes of prim.h and the dashboard, with all transformations and all
+  page buffer layouts (u8g_dev_mem.c). Then the frame time is measured
+  on the pb8v1 memory device.
+
+  make rot_bench && ./rot_bench [frames]
+
+*/
+
+#include "bench.h"
+#include "prim.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+
+static uint8_t frame_pixel[WIDTH*HEIGHT*3];
+static uint8_t frame_box[WIDTH*HEIGHT*3];
+
+/* device without U8G_DEV_MSG_SET_BOX, dev_mem is the device below */
+static uint8_t nobox_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
+{
+  if ( msg == U8G_DEV_MSG_IS_SET_BOX )
+    return 1;
+  return u8g_call_dev_fn(u8g, (u8g_dev_t *)(dev->dev_mem), msg, arg);
+}
+
+static u8g_dev_t nobox_dev = { nobox_fn, NULL, NULL };
+
+struct transform
+{
+  const char *name;
+  uint8_t rot;		/* 0, 1: 90, 2: 180, 3: 270 degree */
+  uint8_t is_scale;
+};
+
+static const struct transform transforms[] = {
+  { "none", 0, 0 },
+  { "rot90", 1, 0 },
+  { "rot180", 2, 0 },
+  { "rot270", 3, 0 },
+  { "scale2x2", 0, 1 },
+  { "rot90 2x2", 1, 1 },
+  { "rot270 2x2", 3, 1 },
+};
+
+#define TRANSFORM_CNT (sizeof(transforms)/sizeof(*transforms))
+
+static void dashboard(u8g_t *u8g, uint16_t n)
+{
+  bench_dashboard(u8g, n);
+}
+
+static const struct prim scenes[] = {
+  { "dashboard", dashboard },
+  { "lines", prim_lines },
+  { "circles", prim_circles },
+  { "polygons", prim_polygons },
+  { "glyphs", prim_glyphs },
+  { "bitmaps", prim_bitmaps },
+};
+
+#define SCENE_CNT (sizeof(scenes)/sizeof(*scenes))
+
+static void init(u8g_t *u8g, u8g_dev_t *dev, uint8_t is_box, const struct transform *t)
+{
+  if ( is_box == 0 )
+  {
+    nobox_dev.dev_mem = dev;
+    dev = &nobox_dev;
+  }
+  prim_init(u8g, dev);
+  if ( t->rot == 1 )
+    u8g_SetRot90(u8g);
+  else if ( t->rot == 2 )
+    u8g_SetRot180(u8g);
+  else if ( t->rot == 3 )
+    u8g_SetRot270(u8g);
+  if ( t->is_scale )
+    u8g_SetScale2x2(u8g);
+}
+
+static void render(u8g_t *u8g, const struct prim *scene, uint16_t n, u8g_dev_t *mem_dev, uint8_t *frame)
+{
+  prim_render(u8g, scene, n);
+  if ( frame != NULL )
+    memcpy(frame, u8g_dev_mem_GetFrame(mem_dev), WIDTH*HEIGHT*(U8G_MODE_IS_COLOR(u8g_GetMode(u8g)) ? 3 : 1));
+}
+
+static double measure(const struct transform *t, uint8_t is_box, const struct prim *scene, unsigned frames)
+{
+  u8g_t u8g;
+  unsigned i;
+  double start;
+
+  init(&u8g, &u8g_dev_mem_8v1, is_box, t);
+  start = bench_now_us();
+  for( i = 0; i < frames; i++ )
+    prim_render(&u8g, scene, i);
+  return (bench_now_us() - start) / frames;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned frames = argc > 1 ? (unsigned)atoi(argv[1]) : 1000;
+  unsigned t, s, d;
+  uint16_t n;
+  double pixel, box, pixel_sum, box_sum;
+  u8g_t u8g;
+
+  for( t = 0; t < TRANSFORM_CNT; t++ )
+    for( s = 0; s < SCENE_CNT; s++ )
+      for( d = 0; d < PRIM_DEV_CNT; d++ )
+        for( n = 0; n < 4; n++ )
+        {
+          memset(frame_pixel, 0, sizeof(frame_pixel));
+          memset(frame_box, 0, sizeof(frame_box));
+          init(&u8g, prim_devs[d].dev, 0, transforms + t);
+          render(&u8g, scenes + s, n, prim_devs[d].dev, frame_pixel);
+          init(&u8g, prim_devs[d].dev, 1, transforms + t);
+          render(&u8g, scenes + s, n, prim_devs[d].dev, frame_box);
+          if ( memcmp(frame_pixel, frame_box, sizeof(frame_pixel)) != 0 )
+          {
+            printf("%s, %s, %s, frame %u: boxes differ from pixels\n", transforms[t].name, scenes[s].name, prim_devs[d].name, n);
+            return 1;
+          }
+        }
+  printf("all transformations: same pixels with boxes\n\n");
+
+  printf("%u frames 128x64 pb8v1, us per frame (pixel: without boxes, box: with boxes)\n\n", frames);
+  printf("%-11s %10s %10s %10s %10s\n", "transform", "dashboard", "", "all", "");
+  printf("%-11s %10s %10s %10s %10s\n", "", "pixel", "box", "pixel", "box");
+  for( t = 0; t < TRANSFORM_CNT; t++ )
+  {
+    pixel_sum = box_sum = 0.0;
+    printf("%-11s", transforms[t].name);
+    for( s = 0; s < SCENE_CNT; s++ )
+    {
+      pixel = measure(transforms + t, 0, scenes + s, frames);
+      box = measure(transforms + t, 1, scenes + s, frames);
+      if ( s == 0 )
+        printf(" %10.2f %10.2f", pixel, box);
+      pixel_sum += pixel;
+      box_sum += box;
+    }
+    printf(" %10.2f %10.2f  %5.2fx\n", pixel_sum, box_sum, pixel_sum / box_sum);
+  }
+  return 0;
+}
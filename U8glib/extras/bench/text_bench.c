@@ -0,0 +1,165 @@
+/*
+
+  text_bench.c
+
+  text rendering with and without a glyph lookup table (u8g_SetFontGlyphTable()).
+  Without the table, u8g_GetGlyph() searches the font linearly from the
+  start, 'A' or 'a' glyph. With the table, the glyph is found directly.
+
+  First both ways have to produce the same frames for several fonts (format 0
+  and 1, 7 bit and 8 bit), then the frame time of a text heavy 128x64 screen
+  and the number of u8g_GetGlyph() calls per second are measured.
+
+  make text_bench && ./text_bench [frames]
+
+*/
+
+#include "bench.h"
+
+#define FRAME_SIZE (128*64/8)
+
+/* not part of u8g.h, see u8g_font.c */
+typedef void * u8g_glyph_t;
+u8g_glyph_t u8g_GetGlyph(u8g_t *u8g, uint8_t requested_encoding);
+
+static uint8_t frame_scan[FRAME_SIZE];
+static uint8_t frame_table[FRAME_SIZE];
+static uint16_t glyph_table[256];
+
+struct font
+{
+  const char *name;
+  const u8g_fntpgm_uint8_t *font;
+};
+
+static const struct font fonts[] = {
+  { "6x10", u8g_font_6x10 },
+  { "4x6", u8g_font_4x6 },
+  { "helvR08", u8g_font_helvR08 },
+  { "profont12", u8g_font_profont12 },
+  { "courB10", u8g_font_courB10 },
+  { "timR10", u8g_font_timR10 },
+  { "fub11", u8g_font_fub11 },
+  { "unifont", u8g_font_unifont },
+};
+
+/* log view: six lines of text, some characters above 127 (latin-1) */
+static void scene_text(u8g_t *u8g, const u8g_fntpgm_uint8_t *font, uint16_t n)
+{
+  static const char *lines[] = {
+    "12:04 pump on  23.5\xb0" "C",
+    "12:05 valve B closed",
+    "12:07 flow 4.2 l/min",
+    "12:09 W\xe4rme \xb1" "0.5 K ok",
+    "12:10 ZONE 3 ~ {idle}",
+    "12:12 |level| 78% full",
+    "12:15 boiler: 61 degC",
+    "12:18 xyz qwerty #&@!",
+  };
+  uint8_t i;
+  u8g_SetFont(u8g, font);
+  u8g_SetFontPosTop(u8g);
+  for( i = 0; i < 6; i++ )
+    u8g_DrawStr(u8g, 0, i * 11, lines[(i + n) & 7]);
+}
+
+static void draw(u8g_t *u8g, const u8g_fntpgm_uint8_t *font, uint16_t n, uint8_t *frame)
+{
+  u8g_pb_t *pb = (u8g_pb_t *)(u8g->dev->dev_mem);
+  u8g_FirstPage(u8g);
+  do
+  {
+    scene_text(u8g, font, n);
+    if ( frame != NULL )
+      memcpy(frame + pb->p.page * pb->width, pb->buf, pb->width);
+  } while( u8g_NextPage(u8g) );
+}
+
+static void init(u8g_t *u8g, uint8_t is_table)
+{
+  u8g_Init(u8g, &u8g_dev_gprof);
+  if ( is_table )
+    u8g_SetFontGlyphTable(u8g, glyph_table, 256);
+}
+
+static double measure_frame(const u8g_fntpgm_uint8_t *font, uint8_t is_table, unsigned frames)
+{
+  u8g_t u8g;
+  unsigned i;
+  double start;
+  init(&u8g, is_table);
+  start = bench_now_us();
+  for( i = 0; i < frames; i++ )
+    draw(&u8g, font, i, NULL);
+  return (bench_now_us() - start) / frames;
+}
+
+/* u8g_GetGlyph() calls per second for all printable characters */
+static double measure_lookup(const u8g_fntpgm_uint8_t *font, uint8_t is_table, unsigned frames)
+{
+  u8g_t u8g;
+  unsigned i, c;
+  unsigned long found = 0;
+  double start;
+  init(&u8g, is_table);
+  u8g_SetFont(&u8g, font);
+  start = bench_now_us();
+  for( i = 0; i < frames; i++ )
+    for( c = 32; c < 256; c++ )
+      if ( u8g_GetGlyph(&u8g, (uint8_t)c) != NULL )
+        found++;
+  if ( found == 0 )
+    printf("no glyphs found\n");
+  return frames * 224.0 * 1e6 / (bench_now_us() - start);
+}
+
+int main(int argc, char **argv)
+{
+  unsigned frames = argc > 1 ? (unsigned)atoi(argv[1]) : 5000;
+  u8g_t u8g_scan, u8g_table;
+  unsigned f, c;
+  uint16_t n;
+  double scan, table;
+
+  /* same glyphs and same frames with and without the table */
+  init(&u8g_scan, 0);
+  init(&u8g_table, 1);
+  for( f = 0; f < sizeof(fonts)/sizeof(*fonts); f++ )
+  {
+    u8g_SetFont(&u8g_scan, fonts[f].font);
+    u8g_SetFont(&u8g_table, fonts[f].font);
+    for( c = 0; c < 256; c++ )
+    {
+      if ( u8g_GetGlyph(&u8g_scan, c) != u8g_GetGlyph(&u8g_table, c) ||
+           u8g_scan.glyph_dx != u8g_table.glyph_dx || u8g_scan.glyph_width != u8g_table.glyph_width )
+      {
+        printf("%s, encoding %u: glyph table differs from search\n", fonts[f].name, c);
+        return 1;
+      }
+    }
+    for( n = 0; n < 8; n++ )
+    {
+      draw(&u8g_scan, fonts[f].font, n, frame_scan);
+      draw(&u8g_table, fonts[f].font, n, frame_table);
+      if ( memcmp(frame_scan, frame_table, FRAME_SIZE) != 0 )
+      {
+        printf("%s, frame %u: glyph table differs from search\n", fonts[f].name, n);
+        return 1;
+      }
+    }
+  }
+  printf("all fonts: same frames with and without glyph table\n\n");
+
+  printf("%u frames, 6 lines of text 128x64 (gprof)\n\n", frames);
+  printf("%-10s %10s %10s          %12s %12s\n", "font", "us/frame", "table", "glyphs/s", "table");
+  for( f = 0; f < sizeof(fonts)/sizeof(*fonts); f++ )
+  {
+    scan = measure_frame(fonts[f].font, 0, frames);
+    table = measure_frame(fonts[f].font, 1, frames);
+    printf("%-10s %10.2f %10.2f  %5.2fx", fonts[f].name, scan, table, scan / table);
+    scan = measure_lookup(fonts[f].font, 0, frames / 5);
+    table = measure_lookup(fonts[f].font, 1, frames / 5);
+    printf(" %12.0f %12.0f  %5.1fx\n", scan, table, table / scan);
+  }
+  return 0;
+}
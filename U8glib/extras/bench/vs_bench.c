@@ -0,0 +1,219 @@
+/*
+
+  vs_bench.c
+
+  virtual screen (u8g_virtual_screen.c) with four 128x32 panels, stacked
+  to a 128x128 screen. Each panel is a pb8v1 device, which sends its pages
+  with page address commands and page data like the SSD1306, through the
+  Linux com procedures to the mock /dev of com_bench (mock/mock_dev.c).
+  The bus time is spent with nanosleep() in the write() and ioctl() calls
+  of the mock, like a blocking i2c-dev or spidev transfer.
+
+  - sequential:    U8G_VS_MODE_SEQUENTIAL, panels at /dev/i2c-1..4,
+                   16 passes of the picture loop
+  - parallel i2c:  U8G_VS_MODE_PARALLEL, panels at /dev/i2c-1..4, 4 passes,
+                   4 busses (one for each i2c-dev bus), the pages are sent
+                   by 4 threads at the same time
+  - parallel mix:  U8G_VS_MODE_PARALLEL, two panels at /dev/i2c-1..2, two
+                   panels at /dev/spidev0.0 and 0.1, also 4 busses
+
+  First the emulated RAM of all panels must be the same in all modes.
+
+  make vs_bench && ./vs_bench [frames]
+
+*/
+
+#include "bench.h"
+#include "mock_dev.h"
+
+#define PANEL_CNT 4
+#define WIDTH 128
+#define HEIGHT 32
+#define CHECK_FRAMES 64
+
+uint8_t u8g_com_linux_ssd_i2c_fn(u8g_t *u8g, uint8_t msg, uint8_t arg_val, void *arg_ptr);
+uint8_t u8g_com_raspberrypi_hw_spi_fn(u8g_t *u8g, uint8_t msg, uint8_t arg_val, void *arg_ptr);
+
+/* bus time per byte of all mock devices */
+struct bus
+{
+  const char *name;
+  long ns_per_byte;
+};
+
+static const struct bus busses[] = {
+  { "none", 0 },
+  { "spi 8MHz", 1000 },
+  { "i2c 400kHz", 22500 },		/* 9 clocks per byte */
+};
+
+static u8g_t panel[PANEL_CNT];
+static uint8_t ram[PANEL_CNT][HEIGHT/8][WIDTH];
+static uint8_t ram_ref[CHECK_FRAMES][PANEL_CNT][HEIGHT/8][WIDTH];
+
+/*========================================================================*/
+/* panel device, sends each page like the SSD1306 in page mode */
+
+static uint8_t panel_dev_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
+{
+  static const uint8_t col0[2] = { 0x000, 0x010 };
+  u8g_pb_t *pb = (u8g_pb_t *)(dev->dev_mem);
+  switch(msg)
+  {
+    case U8G_DEV_MSG_INIT:
+      u8g_InitCom(u8g, dev, U8G_SPI_CLK_CYCLE_NONE);
+      break;
+    case U8G_DEV_MSG_PAGE_NEXT:
+      u8g_SetChipSelect(u8g, dev, 1);
+      u8g_SetAddress(u8g, dev, 0);
+      u8g_WriteByte(u8g, dev, 0x0b0 | pb->p.page);
+      u8g_WriteSequence(u8g, dev, 2, (uint8_t *)col0);
+      u8g_SetAddress(u8g, dev, 1);
+      u8g_WriteSequence(u8g, dev, WIDTH, pb->buf);
+      u8g_SetChipSelect(u8g, dev, 0);
+      break;
+  }
+  return u8g_dev_pb8v1_base_fn(u8g, dev, msg, arg);
+}
+
+U8G_PB_DEV(panel_dev_0, WIDTH, HEIGHT, 8, panel_dev_fn, u8g_com_linux_ssd_i2c_fn);
+U8G_PB_DEV(panel_dev_1, WIDTH, HEIGHT, 8, panel_dev_fn, u8g_com_linux_ssd_i2c_fn);
+U8G_PB_DEV(panel_dev_2, WIDTH, HEIGHT, 8, panel_dev_fn, u8g_com_linux_ssd_i2c_fn);
+U8G_PB_DEV(panel_dev_3, WIDTH, HEIGHT, 8, panel_dev_fn, u8g_com_linux_ssd_i2c_fn);
+
+static u8g_dev_t *panel_dev[PANEL_CNT] = { &panel_dev_0, &panel_dev_1, &panel_dev_2, &panel_dev_3 };
+
+U8G_VS_DEV(vs_dev);
+
+/*========================================================================*/
+
+struct mode
+{
+  const char *name;
+  uint8_t vs_mode;
+  uint8_t spi_cnt;		/* the last panels are at the SPI channels */
+};
+
+static const struct mode modes[] = {
+  { "sequential", U8G_VS_MODE_SEQUENTIAL, 0 },
+  { "parallel i2c", U8G_VS_MODE_PARALLEL, 0 },
+  { "parallel mix", U8G_VS_MODE_PARALLEL, 2 },
+};
+
+#define MODE_CNT (sizeof(modes)/sizeof(*modes))
+
+/* i2c-dev bus or SPI channel of the panel */
+static struct mock_dev *panel_mock(const struct mode *m, uint8_t i)
+{
+  if ( i + m->spi_cnt >= PANEL_CNT )
+    return mock_spi(i + m->spi_cnt - PANEL_CNT);
+  return mock_i2c(i + 1);
+}
+
+static void init(u8g_t *vs, const struct mode *m)
+{
+  uint8_t i, channel;
+  if ( vs->dev == &vs_dev )
+    u8g_SetVirtualScreenMode(vs, U8G_VS_MODE_SEQUENTIAL);	/* stops the threads */
+  memset(&vs_dev_vs, 0, sizeof(vs_dev_vs));
+  u8g_Init(vs, &vs_dev);
+  u8g_SetVirtualScreenDimension(vs, WIDTH, HEIGHT * PANEL_CNT);
+  for( i = 0; i < PANEL_CNT; i++ )
+  {
+    if ( i + m->spi_cnt >= PANEL_CNT )
+    {
+      channel = i + m->spi_cnt - PANEL_CNT;
+      panel_dev[i]->com_fn = u8g_com_raspberrypi_hw_spi_fn;
+      u8g_InitHWSPI(panel + i, panel_dev[i], channel, MOCK_SPI_A0(channel), 25 + channel);
+    }
+    else
+    {
+      panel_dev[i]->com_fn = u8g_com_linux_ssd_i2c_fn;
+      u8g_InitI2C(panel + i, panel_dev[i], i + 1);
+    }
+    u8g_AddToVirtualScreen(vs, 0, i * HEIGHT, panel + i);
+  }
+  u8g_SetVirtualScreenMode(vs, m->vs_mode);
+}
+
+static void get_ram(const struct mode *m)
+{
+  uint8_t i;
+  for( i = 0; i < PANEL_CNT; i++ )
+    memcpy(ram[i], panel_mock(m, i)->ram, sizeof(ram[i]));
+}
+
+/* dashboard in the upper half, text, lines and a disc across the panel borders */
+static void draw(u8g_t *u8g, uint16_t n)
+{
+  bench_dashboard(u8g, n);
+  u8g_SetFont(u8g, u8g_font_6x10);
+  u8g_DrawStr(u8g, 4 + n % 8, 68, "Line 1 above border");
+  u8g_DrawStr90(u8g, 120, 60 + n % 16, "down");
+  u8g_DrawLine(u8g, 0, 64, 127, 127 - n % 32);
+  u8g_DrawDisc(u8g, 40, 96, 10 + n % 6, U8G_DRAW_ALL);
+  u8g_DrawFrame(u8g, 70, 90, 50, 20 + n % 8);
+  u8g_DrawStr(u8g, 2, 127, "bottom");
+}
+
+static void render(u8g_t *vs, uint16_t n)
+{
+  u8g_FirstPage(vs);
+  do
+  {
+    draw(vs, n);
+  } while( u8g_NextPage(vs) );
+}
+
+int main(int argc, char **argv)
+{
+  unsigned frames = argc > 1 ? (unsigned)atoi(argv[1]) : 20;
+  double t[MODE_CNT], start;
+  u8g_t vs;
+  unsigned b, m, i;
+  uint16_t n;
+
+  memset(&vs, 0, sizeof(vs));
+  for( m = 0; m < MODE_CNT; m++ )
+  {
+    init(&vs, modes + m);
+    printf("%-12s %u busses\n", modes[m].name, vs_dev_vs.bus_cnt);
+    for( n = 0; n < CHECK_FRAMES; n++ )
+    {
+      render(&vs, n);
+      get_ram(modes + m);
+      if ( m == 0 )
+        memcpy(ram_ref[n], ram, sizeof(ram));
+      else if ( memcmp(ram, ram_ref[n], sizeof(ram)) != 0 )
+      {
+        printf("frame %u: %s differs from sequential\n", n, modes[m].name);
+        return 1;
+      }
+    }
+  }
+  printf("all modes: same panel RAM\n\n");
+
+  printf("%u frames, 4 panels 128x32, ms per frame\n\n", frames);
+  printf("%-11s", "bus");
+  for( m = 0; m < MODE_CNT; m++ )
+    printf(" %12s", modes[m].name);
+  printf("\n");
+  for( b = 0; b < sizeof(busses)/sizeof(*busses); b++ )
+  {
+    mock_ns_per_byte = busses[b].ns_per_byte;
+    for( m = 0; m < MODE_CNT; m++ )
+    {
+      init(&vs, modes + m);
+      start = bench_now_us();
+      for( i = 0; i < frames; i++ )
+        render(&vs, i);
+      t[m] = (bench_now_us() - start) / frames / 1000.0;
+    }
+    printf("%-11s", busses[b].name);
+    for( m = 0; m < MODE_CNT; m++ )
+      printf(" %12.3f", t[m]);
+    printf("  %5.2fx\n", t[0] / t[1]);
+  }
+  u8g_SetVirtualScreenMode(&vs, U8G_VS_MODE_SEQUENTIAL);
+  return 0;
+}
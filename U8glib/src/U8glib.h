@@ -107,6 +107,15 @@ class U8GLIB : public Print
     void firstPage(void) { cbegin(); u8g_FirstPage(&u8g); }
     uint8_t nextPage(void) { return u8g_NextPage(&u8g); }
     
+     /* full frame devices (..._F) can be used without picture loop */
+    void clearBuffer(void) { cbegin(); u8g_ClearBuffer(&u8g); }
+    void sendBuffer(void) { u8g_SendBuffer(&u8g); }
+    
+#if defined(U8G_WITH_DAMAGE)
+     /* send only the changed parts, mem: U8G_DAMAGE_SIZE(width, height/8) bytes */
+    void setDamageTracking(uint8_t *mem) { cbegin(); u8g_SetDamageTracking(&u8g, mem); }
+#endif
+    
     /* system commands */
     uint8_t setContrast(uint8_t contrast) { cbegin(); return u8g_SetContrast(&u8g, contrast); }
     void sleepOn(void) { u8g_SleepOn(&u8g); }
@@ -164,6 +173,9 @@ class U8GLIB : public Print
       
     /* font handling */
     void setFont(const u8g_fntpgm_uint8_t *font) {u8g_SetFont(&u8g, font); }
+#if defined(U8G_WITH_GLYPH_TABLE)
+    void setFontGlyphTable(uint16_t *table, uint16_t cnt) {u8g_SetFontGlyphTable(&u8g, table, cnt); }
+#endif
     int8_t getFontAscent(void) { return u8g_GetFontAscent(&u8g); }
     int8_t getFontDescent(void) { return u8g_GetFontDescent(&u8g); }
     int8_t getFontLineSpacing(void) { return u8g_GetFontLineSpacing(&u8g); }
@@ -220,6 +232,7 @@ class U8GLIB : public Print
     
     void setVirtualScreenDimension(u8g_uint_t width, u8g_uint_t height) { u8g_SetVirtualScreenDimension(&u8g, width, height); }
     uint8_t addToVirtualScreen(u8g_uint_t x, u8g_uint_t y, U8GLIB &child_u8g) { return u8g_AddToVirtualScreen(&u8g, x, y, &child_u8g.u8g); }
+    void setVirtualScreenMode(uint8_t mode) { u8g_SetVirtualScreenMode(&u8g, mode); }
 
 };
 
@@ -898,6 +911,20 @@ class U8GLIB_SSD1306_128X64_2X : public U8GLIB
       { }
 };
 
+class U8GLIB_SSD1306_128X64_F : public U8GLIB 
+{
+  public:
+    U8GLIB_SSD1306_128X64_F(uint8_t sck, uint8_t mosi, uint8_t cs, uint8_t a0, uint8_t reset = U8G_PIN_NONE) 
+      : U8GLIB(&u8g_dev_ssd1306_128x64_f_sw_spi, sck, mosi, cs, a0, reset)
+      { }
+    U8GLIB_SSD1306_128X64_F(uint8_t cs, uint8_t a0, uint8_t reset = U8G_PIN_NONE) 
+      : U8GLIB(&u8g_dev_ssd1306_128x64_f_hw_spi, cs, a0, reset)
+      { }
+    U8GLIB_SSD1306_128X64_F(uint8_t options = U8G_I2C_OPT_NONE) 
+      : U8GLIB(&u8g_dev_ssd1306_128x64_f_i2c, options)
+      { }
+};
+
 class U8GLIB_SH1106_128X64 : public U8GLIB 
 {
   public:
@@ -926,6 +953,20 @@ class U8GLIB_SH1106_128X64_2X : public U8GLIB
       { }
 };
 
+class U8GLIB_SH1106_128X64_F : public U8GLIB 
+{
+  public:
+    U8GLIB_SH1106_128X64_F(uint8_t sck, uint8_t mosi, uint8_t cs, uint8_t a0, uint8_t reset = U8G_PIN_NONE) 
+      : U8GLIB(&u8g_dev_sh1106_128x64_f_sw_spi, sck, mosi, cs, a0, reset)
+      { }
+    U8GLIB_SH1106_128X64_F(uint8_t cs, uint8_t a0, uint8_t reset = U8G_PIN_NONE) 
+      : U8GLIB(&u8g_dev_sh1106_128x64_f_hw_spi, cs, a0, reset)
+      { }
+    U8GLIB_SH1106_128X64_F(uint8_t options = U8G_I2C_OPT_NONE) 
+      : U8GLIB(&u8g_dev_sh1106_128x64_f_i2c, options)
+      { }
+};
+
 class U8GLIB_SSD1309_128X64 : public U8GLIB 
 {
   public:
@@ -968,6 +1009,20 @@ class U8GLIB_SSD1306_128X32_2X : public U8GLIB
       { }
 };
 
+class U8GLIB_SSD1306_128X32_F : public U8GLIB 
+{
+  public:
+    U8GLIB_SSD1306_128X32_F(uint8_t sck, uint8_t mosi, uint8_t cs, uint8_t a0, uint8_t reset = U8G_PIN_NONE) 
+      : U8GLIB(&u8g_dev_ssd1306_128x32_f_sw_spi, sck, mosi, cs, a0, reset)
+      { }
+    U8GLIB_SSD1306_128X32_F(uint8_t cs, uint8_t a0, uint8_t reset = U8G_PIN_NONE) 
+      : U8GLIB(&u8g_dev_ssd1306_128x32_f_hw_spi, cs, a0, reset)
+      { }
+    U8GLIB_SSD1306_128X32_F(uint8_t options = U8G_I2C_OPT_NONE) 
+      : U8GLIB(&u8g_dev_ssd1306_128x32_f_i2c, options)
+      { }
+};
+
 class U8GLIB_SSD1306_64X48 : public U8GLIB 
 {
   public:
@@ -42,6 +42,18 @@
 /* comment the following line to generate more compact but interrupt unsafe code */
 #define U8G_INTERRUPT_SAFE 1
 
+/* uncomment the following line to send only the changed columns of SSD1306/SH1106 displays, see u8g_SetDamageTracking() */
+//#define U8G_WITH_DAMAGE 1
+
+/* uncomment the following line to fill lines and boxes of page buffer devices with U8G_DEV_MSG_SET_BOX */
+//#define U8G_WITH_SET_BOX 1
+
+/* uncomment the following line to look up glyphs in a table in RAM, see u8g_SetFontGlyphTable() */
+//#define U8G_WITH_GLYPH_TABLE 1
+
+/* uncomment the following line to store the spans of filled polygons, discs and ellipses, see u8g_SetEdgeTable() */
+//#define U8G_WITH_EDGE_TABLE 1
+
 
 #include <stddef.h>
 
@@ -65,6 +77,21 @@ typedef signed short int16_t;
 #define U8G_WITH_PINLIST
 #endif
 
+/*
+  define U8G_WITH_THREADS to send the pages of the virtual screen children
+  with POSIX threads (u8g_virtual_screen.c, link with -pthread)
+*/
+#if defined(U8G_WITH_THREADS)
+#include <pthread.h>
+#endif
+
+/*
+  host systems with a complete C library (stdio), see u8g_dev_mem.c
+*/
+#if !defined(__AVR__) && !defined(ARDUINO) && !defined(__MSP430__) && !defined(__18CXX) && !defined(__XC8) && !defined(U8G_CYPRESS_PSOC5)
+#define U8G_HOST
+#endif
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -242,13 +269,24 @@ int u8g_sdl_get_key(void);
 /* Size: 70x30 monochrom, stdout */
 extern u8g_dev_t u8g_dev_stdout;
 
-/* Size: monochrom, writes "u8g.pbm" */
+/* Size: 128x64 monochrom, writes "u8g.pbm" after each picture loop, u8g_dev_mem.c */
 extern u8g_dev_t u8g_dev_pbm;
 extern u8g_dev_t u8g_dev_pbm_8h1;
 extern u8g_dev_t u8g_dev_pbm_8h2;	/* grayscale simulation */
 
+/* Size: 128x64, no output, the picture is collected in memory, u8g_dev_mem.c */
+extern u8g_dev_t u8g_dev_mem_8v1;
+extern u8g_dev_t u8g_dev_mem_8h1;
+extern u8g_dev_t u8g_dev_mem_8v2;	/* 2 bit gray */
+extern u8g_dev_t u8g_dev_mem_16h2;	/* 2 bit gray */
+extern u8g_dev_t u8g_dev_mem_xh16;	/* 16 bit hicolor */
+extern u8g_dev_t u8g_dev_mem_xh24;	/* 24 bit truecolor */
+uint8_t *u8g_dev_mem_GetFrame(u8g_dev_t *dev);	/* one byte (color index) or three bytes (r, g, b) per pixel */
+uint8_t u8g_dev_mem_WritePNM(u8g_dev_t *dev, const char *filename);
+
 /* Size: 128x64 monochrom, no output, used for performance measure */
 extern u8g_dev_t u8g_dev_gprof;
+extern u8g_dev_t u8g_dev_gprof_f;	/* full frame, picture loop runs only once */
 
 /* Display: EA DOGS102, Size: 102x64 monochrom */
 extern u8g_dev_t u8g_dev_uc1701_dogs102_sw_spi;
@@ -458,6 +496,11 @@ extern u8g_dev_t u8g_dev_ssd1306_128x64_2x_sw_spi;
 extern u8g_dev_t u8g_dev_ssd1306_128x64_2x_hw_spi;
 extern u8g_dev_t u8g_dev_ssd1306_128x64_2x_i2c;
 
+/* full frame buffer, 128x64/8 byte */
+extern u8g_dev_t u8g_dev_ssd1306_128x64_f_sw_spi;
+extern u8g_dev_t u8g_dev_ssd1306_128x64_f_hw_spi;
+extern u8g_dev_t u8g_dev_ssd1306_128x64_f_i2c;
+
 /* OLED 128x64 Display with SH1106 Controller */
 extern u8g_dev_t u8g_dev_sh1106_128x64_sw_spi;
 extern u8g_dev_t u8g_dev_sh1106_128x64_hw_spi;
@@ -467,6 +510,11 @@ extern u8g_dev_t u8g_dev_sh1106_128x64_2x_sw_spi;
 extern u8g_dev_t u8g_dev_sh1106_128x64_2x_hw_spi;
 extern u8g_dev_t u8g_dev_sh1106_128x64_2x_i2c;
 
+/* full frame buffer, 128x64/8 byte */
+extern u8g_dev_t u8g_dev_sh1106_128x64_f_sw_spi;
+extern u8g_dev_t u8g_dev_sh1106_128x64_f_hw_spi;
+extern u8g_dev_t u8g_dev_sh1106_128x64_f_i2c;
+
 /* OLED 128x64 Display with SSD1309 Controller */
 extern u8g_dev_t u8g_dev_ssd1309_128x64_sw_spi;
 extern u8g_dev_t u8g_dev_ssd1309_128x64_hw_spi;
@@ -481,6 +529,11 @@ extern u8g_dev_t u8g_dev_ssd1306_128x32_2x_sw_spi;
 extern u8g_dev_t u8g_dev_ssd1306_128x32_2x_hw_spi;
 extern u8g_dev_t u8g_dev_ssd1306_128x32_2x_i2c;
 
+/* full frame buffer, 128x32/8 byte */
+extern u8g_dev_t u8g_dev_ssd1306_128x32_f_sw_spi;
+extern u8g_dev_t u8g_dev_ssd1306_128x32_f_hw_spi;
+extern u8g_dev_t u8g_dev_ssd1306_128x32_f_i2c;
+
 /* OLED 64x48 Display with SSD1306 Controller */
 extern u8g_dev_t u8g_dev_ssd1306_64x48_sw_spi;
 extern u8g_dev_t u8g_dev_ssd1306_64x48_hw_spi;
@@ -561,6 +614,9 @@ struct _u8g_dev_arg_pixel_t
   uint8_t color;			/* color or index value, red value for true color mode */
   uint8_t hi_color;		/* high byte for 64K color mode, low byte is in "color", green value for true color mode */
   uint8_t blue;			/* blue value in true color mode */
+#if defined(U8G_WITH_SET_BOX)
+  u8g_uint_t w, h;		/* box size for U8G_DEV_MSG_SET_BOX */
+#endif
 };
 /* typedef struct _u8g_dev_arg_pixel_t u8g_dev_arg_pixel_t; */ /* forward decl */
 
@@ -606,6 +662,9 @@ struct _u8g_dev_arg_irgb_t
 /* arg: u8g_box_t *, fill structure with current page properties */
 #define U8G_DEV_MSG_GET_PAGE_BOX 23
 
+/* arg: uint8_t *, memory for the damage tracking or NULL, see u8g_SetDamageTracking() */
+#define U8G_DEV_MSG_SET_DAMAGE 24
+
 /*
 #define U8G_DEV_MSG_PRIMITIVE_START             30
 #define U8G_DEV_MSG_PRIMITIVE_END               31
@@ -616,6 +675,8 @@ struct _u8g_dev_arg_irgb_t
 #define U8G_DEV_MSG_SET_4TPIXEL			45
 
 #define U8G_DEV_MSG_SET_PIXEL                           50
+/* fill the box x, y, w, h (w > 0, h > 0) with the color of arg, only sent if U8G_DEV_MSG_IS_SET_BOX is supported */
+#define U8G_DEV_MSG_SET_BOX                           52
 #define U8G_DEV_MSG_SET_8PIXEL                          59
 
 #define U8G_DEV_MSG_SET_COLOR_ENTRY                60
@@ -626,6 +687,9 @@ struct _u8g_dev_arg_irgb_t
 #define U8G_DEV_MSG_GET_HEIGHT                           71
 #define U8G_DEV_MSG_GET_MODE                  72
 
+/* arg: uint8_t *, devices which can fill a box with U8G_DEV_MSG_SET_BOX set this to 1 */
+#define U8G_DEV_MSG_IS_SET_BOX                  73
+
 /*===============================================================*/
 /* device modes */
 #define U8G_MODE(is_index_mode, is_color, bits_per_pixel) (((is_index_mode)<<6) | ((is_color)<<5)|(bits_per_pixel))
@@ -979,9 +1043,19 @@ struct _u8g_pb_t
   u8g_page_t p;
   u8g_uint_t width;		/* pixel width */
   void *buf;
+#if defined(U8G_WITH_DAMAGE)
+  uint8_t *damage;		/* checksums of the transferred rows, NULL: damage tracking disabled */
+#endif
 };
 typedef struct _u8g_pb_t u8g_pb_t;
 
+/*
+  damage tracking: two checksum bytes for each block of U8G_DAMAGE_BLOCK_WIDTH bytes
+  of a row (width bytes, e.g. 8 pixel lines of a vertical 1 bit buffer)
+*/
+#define U8G_DAMAGE_BLOCK_WIDTH 16
+#define U8G_DAMAGE_SIZE(width, rows) ((rows)*(((width)+U8G_DAMAGE_BLOCK_WIDTH-1)/U8G_DAMAGE_BLOCK_WIDTH)*2)
+
 
 /* u8g_pb.c */
 void u8g_pb_Clear(u8g_pb_t *b);
@@ -991,6 +1065,16 @@ uint8_t u8g_pb_IsIntersection(u8g_pb_t *pb, u8g_dev_arg_bbx_t *bbx);
 void u8g_pb_GetPageBox(u8g_pb_t *pb, u8g_box_t *box);
 uint8_t u8g_pb_Is8PixelVisible(u8g_pb_t *b, u8g_dev_arg_pixel_t *arg_pixel);
 uint8_t u8g_pb_WriteBuffer(u8g_pb_t *b, u8g_t *u8g, u8g_dev_t *dev);
+#if defined(U8G_WITH_DAMAGE)
+void u8g_pb_SetDamage(u8g_pb_t *b, uint8_t *damage);
+void u8g_pb_ResetDamage(u8g_pb_t *b);
+#endif
+uint8_t u8g_pb_GetDamage(u8g_pb_t *b, uint8_t row, const uint8_t *ptr, u8g_uint_t *x0, u8g_uint_t *x1);
+#if defined(U8G_WITH_SET_BOX)
+uint8_t u8g_pb_ClipBox(u8g_pb_t *b, const u8g_dev_arg_pixel_t *arg, u8g_box_t *box);
+void u8g_pb_SetBoxV1(u8g_pb_t *b, const u8g_dev_arg_pixel_t *arg);		/* pb8v1, pb16v1, pbxv1 */
+void u8g_pb_SetBoxH1(u8g_pb_t *b, const u8g_dev_arg_pixel_t *arg);		/* pb8h1, pb16h1 */
+#endif
 
 /*
   note on __attribute__ ((nocommon))
@@ -1020,6 +1104,10 @@ uint8_t u8g_pb8v1_WriteBuffer(u8g_pb_t *b, u8g_t *u8g, u8g_dev_t *dev);
 
 uint8_t u8g_dev_pb8v1_base_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg);
 
+/* u8g_pbxv1.c, x lines per page, full frame if page_height is the display height */
+void u8g_pbxv1_Clear(u8g_pb_t *b);
+uint8_t u8g_dev_pbxv1_base_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg);
+
 /* u8g_pb16v1.c */
 uint8_t u8g_dev_pb16v1_base_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg);
 
@@ -1142,6 +1230,9 @@ struct _u8g_t
   uint8_t cursor_fg_color, cursor_bg_color;
   uint8_t cursor_encoding;
   uint8_t mode;                         /* display mode, one of U8G_MODE_xxx */
+#if defined(U8G_WITH_SET_BOX)
+  uint8_t is_set_box;                   /* device supports U8G_DEV_MSG_SET_BOX */
+#endif
   u8g_uint_t cursor_x;
   u8g_uint_t cursor_y;
   u8g_draw_cursor_fn cursor_fn;
@@ -1159,12 +1250,28 @@ struct _u8g_t
   uint8_t font_line_spacing_factor;     /* line_spacing = factor * (ascent - descent) / 64 */
   uint8_t line_spacing;
   
+#if defined(U8G_WITH_GLYPH_TABLE)
+  uint16_t *glyph_table;     /* optional: offset of each glyph in the font, see u8g_SetFontGlyphTable() */
+  uint16_t glyph_table_cnt;     /* number of entries in glyph_table */
+  const u8g_pgm_uint8_t *glyph_table_font;     /* font for which the glyph_table has been filled */
+#endif
+  
+#if defined(U8G_WITH_EDGE_TABLE)
+  uint16_t *edge_table;     /* optional: spans of filled polygons, discs and ellipses, see u8g_SetEdgeTable() */
+  uint16_t edge_table_cnt;     /* size of edge_table in words */
+  uint16_t edge_table_end;     /* end of the valid entries */
+  uint16_t edge_table_pos;     /* next expected entry, 0 at the start of each page */
+#endif
+  
   u8g_dev_arg_pixel_t arg_pixel;
   /* uint8_t color_index; */
 
 #ifdef U8G_WITH_PINLIST
   uint8_t pin_list[U8G_PIN_LIST_LEN];
 #endif
+#if defined(U8G_WITH_PINLIST) && defined(U8G_HOST)
+  void *com_data;		/* state of the com procedure: Linux I2C and Raspberry Pi SPI */
+#endif
   
   u8g_state_cb state_cb;
   
@@ -1184,6 +1291,9 @@ uint8_t u8g_NextPageLL(u8g_t *u8g, u8g_dev_t *dev);
 uint8_t u8g_SetContrastLL(u8g_t *u8g, u8g_dev_t *dev, uint8_t contrast);
 void u8g_DrawPixelLL(u8g_t *u8g, u8g_dev_t *dev, u8g_uint_t x, u8g_uint_t y);
 void u8g_Draw8PixelLL(u8g_t *u8g, u8g_dev_t *dev, u8g_uint_t x, u8g_uint_t y, uint8_t dir, uint8_t pixel);
+#if defined(U8G_WITH_SET_BOX)
+void u8g_DrawBoxLL(u8g_t *u8g, u8g_dev_t *dev, u8g_uint_t x, u8g_uint_t y, u8g_uint_t w, u8g_uint_t h);	/* only if u8g->is_set_box is not 0 */
+#endif
 void u8g_Draw4TPixelLL(u8g_t *u8g, u8g_dev_t *dev, u8g_uint_t x, u8g_uint_t y, uint8_t dir, uint8_t pixel);
 uint8_t u8g_IsBBXIntersectionLL(u8g_t *u8g, u8g_dev_t *dev, u8g_uint_t x, u8g_uint_t y, u8g_uint_t w, u8g_uint_t h);	/* obsolete */
 u8g_uint_t u8g_GetWidthLL(u8g_t *u8g, u8g_dev_t *dev);
@@ -1207,6 +1317,11 @@ uint8_t u8g_InitRW8Bit(u8g_t *u8g, u8g_dev_t *dev, uint8_t d0, uint8_t d1, uint8
 
 void u8g_FirstPage(u8g_t *u8g);
 uint8_t u8g_NextPage(u8g_t *u8g);
+void u8g_ClearBuffer(u8g_t *u8g);		/* full frame devices only, replaces the picture loop */
+void u8g_SendBuffer(u8g_t *u8g);
+#if defined(U8G_WITH_DAMAGE)
+void u8g_SetDamageTracking(u8g_t *u8g, uint8_t *mem);	/* mem: U8G_DAMAGE_SIZE(width, height/8) bytes or NULL */
+#endif
 uint8_t u8g_SetContrast(u8g_t *u8g, uint8_t contrast);
 void u8g_SleepOn(u8g_t *u8g);
 void u8g_SleepOff(u8g_t *u8g);
@@ -1289,6 +1404,9 @@ uint8_t u8g_font_GetFontStartEncoding(const void *font) U8G_NOINLINE;
 uint8_t u8g_font_GetFontEndEncoding(const void *font) U8G_NOINLINE;
 
 void u8g_SetFont(u8g_t *u8g, const u8g_fntpgm_uint8_t *font);
+#if defined(U8G_WITH_GLYPH_TABLE)
+void u8g_SetFontGlyphTable(u8g_t *u8g, uint16_t *table, uint16_t cnt);
+#endif
 
 uint8_t u8g_GetFontBBXWidth(u8g_t *u8g);
 uint8_t u8g_GetFontBBXHeight(u8g_t *u8g);
@@ -1435,6 +1553,7 @@ struct pg_point_struct
 };
 
 typedef struct _pg_struct pg_struct;	/* forward declaration */
+typedef struct _u8g_edge_t u8g_edge_t;	/* forward declaration, u8g_edge.c */
 
 struct pg_edge_struct
 {
@@ -1470,6 +1589,9 @@ struct _pg_struct
   uint8_t is_min_y_not_flat;
   pg_word_t total_scan_line_cnt;
   struct pg_edge_struct pge[2];	/* left and right line draw structures */
+#if defined(U8G_WITH_EDGE_TABLE)
+  u8g_edge_t *edge;		/* if not NULL, the scan lines are stored here instead of drawn */
+#endif
 };
 
 void pg_ClearPolygonXY(pg_struct *pg);
@@ -1480,11 +1602,112 @@ void u8g_AddPolygonXY(u8g_t *u8g, int16_t x, int16_t y);
 void u8g_DrawPolygon(u8g_t *u8g);
 void u8g_DrawTriangle(u8g_t *u8g, int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2);
 
+/*===============================================================*/
+/* u8g_edge.c */
+
+/*
+  Filled polygons, discs and filled ellipses can store their horizontal
+  spans in a table, which is provided by u8g_SetEdgeTable(). The spans are
+  calculated once and all pages draw only their own rows. An entry is reused
+  as long as the same primitive with the same arguments is drawn at the same
+  position of the picture loop.
+*/
+
+#if defined(U8G_WITH_EDGE_TABLE)
+
+#define U8G_EDGE_POLYGON 1
+#define U8G_EDGE_DISC 2
+#define U8G_EDGE_FILLED_ELLIPSE 3
+
+/* polygon: all points, width and height of the display */
+#define U8G_EDGE_KEY_LEN (2*PG_MAX_POINTS+2)
+
+struct _u8g_edge_t
+{
+  uint8_t type;
+  uint8_t key_len;
+  uint16_t size;		/* words (uint16_t) of this entry, including the spans */
+  pg_word_t key[U8G_EDGE_KEY_LEN];	/* arguments of the draw procedure */
+  pg_word_t y;			/* first row */
+  pg_word_t h;			/* number of rows, -1: the spans can not describe the primitive */
+  /* followed by h pairs of u8g_uint_t: x and width of the span, width 0: empty row */
+};
+
+#define U8G_EDGE_SPANS(e) ((u8g_uint_t *)((e)+1))
+
+void u8g_SetEdgeTable(u8g_t *u8g, uint16_t *table, uint16_t cnt);
+u8g_edge_t *u8g_edge_Find(u8g_t *u8g, uint8_t type, const pg_word_t *key, uint8_t key_len);
+u8g_edge_t *u8g_edge_New(u8g_t *u8g, uint8_t type, const pg_word_t *key, uint8_t key_len, pg_word_t y, pg_word_t h);
+void u8g_edge_Discard(u8g_t *u8g, u8g_edge_t *e);
+void u8g_edge_SetExtent(u8g_edge_t *e, u8g_uint_t dy, u8g_uint_t dx);
+void u8g_edge_SetQuadrants(u8g_edge_t *e, u8g_uint_t x0, uint8_t option);
+void u8g_edge_Draw(u8g_t *u8g, u8g_edge_t *e);
+
+#endif /* U8G_WITH_EDGE_TABLE */
+
 
 /*===============================================================*/
 /* u8g_virtual_screen.c */
+
+#define U8G_VS_MAX 4
+
+/* picture loop for each child one after the other, or for all children at the same time */
+#define U8G_VS_MODE_SEQUENTIAL 0
+#define U8G_VS_MODE_PARALLEL 1
+
+struct _u8g_vs_child_t
+{
+  u8g_uint_t x;
+  u8g_uint_t y;
+  u8g_t *u8g;
+  u8g_box_t box;		/* parallel mode: current page of the child */
+  uint8_t is_active;		/* parallel mode: the child has more pages */
+  uint8_t r;			/* parallel mode: result of U8G_DEV_MSG_PAGE_NEXT */
+  uint8_t bus;			/* children with the same com procedure, I2C option and chip select have the same bus */
+};
+
+#if defined(U8G_WITH_THREADS)
+struct _u8g_vs_thread_t
+{
+  struct _u8g_vs_t *vs;
+  pthread_t thread;
+  uint16_t generation;		/* last page sent by this thread */
+  uint8_t bus;
+};
+#endif
+
+struct _u8g_vs_t
+{
+  struct _u8g_vs_child_t list[U8G_VS_MAX];
+  uint8_t cnt;
+  uint8_t current;		/* sequential mode: child of the current page */
+  uint8_t mode;
+  uint8_t bus_cnt;
+  u8g_uint_t width;
+  u8g_uint_t height;
+#if defined(U8G_WITH_THREADS)
+  struct _u8g_vs_thread_t thread[U8G_VS_MAX];
+  uint8_t is_thread;		/* threads are started */
+  uint8_t thread_cnt;
+  uint8_t is_stop;
+  uint8_t busy;			/* threads, which have not sent their page */
+  uint16_t generation;		/* incremented for each page */
+  pthread_mutex_t mutex;
+  pthread_cond_t cond_start;
+  pthread_cond_t cond_done;
+#endif
+};
+typedef struct _u8g_vs_t u8g_vs_t;
+
+/* virtual screen device with its own list of children */
+#define U8G_VS_DEV(name) \
+u8g_vs_t name##_vs; \
+u8g_dev_t name = { u8g_dev_vs_fn, &name##_vs, NULL }
+
+uint8_t u8g_dev_vs_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg);
 void u8g_SetVirtualScreenDimension(u8g_t *vs_u8g, u8g_uint_t width, u8g_uint_t height);
 uint8_t u8g_AddToVirtualScreen(u8g_t *vs_u8g, u8g_uint_t x, u8g_uint_t y, u8g_t *child_u8g);
+void u8g_SetVirtualScreenMode(u8g_t *vs_u8g, uint8_t mode);
 
 /*===============================================================*/
 void st_Draw(uint8_t fps);
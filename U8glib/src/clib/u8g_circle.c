@@ -290,10 +290,20 @@ void u8g_DrawCircle(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rad, ui
   u8g_draw_circle(u8g, x0, y0, rad, option);
 }
 
-static void u8g_draw_disc_section(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t x0, u8g_uint_t y0, uint8_t option) U8G_NOINLINE;
+static void u8g_draw_disc_section(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t x0, u8g_uint_t y0, uint8_t option, u8g_edge_t *e) U8G_NOINLINE;
 
-static void u8g_draw_disc_section(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t x0, u8g_uint_t y0, uint8_t option)
+static void u8g_draw_disc_section(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t x0, u8g_uint_t y0, uint8_t option, u8g_edge_t *e)
 {
+#if defined(U8G_WITH_EDGE_TABLE)
+    /* edge table: the vertical lines below are converted into rows later */
+    if ( e != NULL )
+    {
+      u8g_edge_SetExtent(e, y, x);
+      u8g_edge_SetExtent(e, x, y);
+      return;
+    }
+#endif
+    
     /* upper right */
     if ( option & U8G_DRAW_UPPER_RIGHT )
     {
@@ -323,7 +333,7 @@ static void u8g_draw_disc_section(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_ui
     }
 }
 
-void u8g_draw_disc(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rad, uint8_t option)
+static void u8g_disc(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rad, uint8_t option, u8g_edge_t *e)
 {
   u8g_int_t f;
   u8g_int_t ddF_x;
@@ -340,7 +350,7 @@ void u8g_draw_disc(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rad, uin
   x = 0;
   y = rad;
 
-  u8g_draw_disc_section(u8g, x, y, x0, y0, option);
+  u8g_draw_disc_section(u8g, x, y, x0, y0, option, e);
   
   while ( x < y )
   {
@@ -354,12 +364,54 @@ void u8g_draw_disc(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rad, uin
     ddF_x += 2;
     f += ddF_x;
 
-    u8g_draw_disc_section(u8g, x, y, x0, y0, option);    
+    u8g_draw_disc_section(u8g, x, y, x0, y0, option, e);    
+  }
+}
+
+void u8g_draw_disc(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rad, uint8_t option)
+{
+  u8g_disc(u8g, x0, y0, rad, option, NULL);
+}
+
+#if defined(U8G_WITH_EDGE_TABLE)
+/* draw with the edge table (u8g_edge.c), returns 0 if the table can not be used */
+static uint8_t u8g_draw_disc_edge(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rad, uint8_t option)
+{
+  pg_word_t key[4];
+  u8g_edge_t *e;
+  
+  /* the rows of the table can not wrap around */
+  if ( x0 < rad || y0 < rad )
+    return 0;
+  if ( (u8g_uint_t)(x0 + rad) < x0 || (u8g_uint_t)(y0 + rad) < y0 )
+    return 0;
+  
+  key[0] = x0;
+  key[1] = y0;
+  key[2] = rad;
+  key[3] = option;
+  e = u8g_edge_Find(u8g, U8G_EDGE_DISC, key, 4);
+  if ( e == NULL )
+  {
+    e = u8g_edge_New(u8g, U8G_EDGE_DISC, key, 4, y0 - rad, 2 * rad + 1);
+    if ( e == NULL )
+      return 0;
+    u8g_disc(u8g, x0, y0, rad, option, e);
+    u8g_edge_SetQuadrants(e, x0, option);
   }
+  u8g_edge_Draw(u8g, e);
+  return 1;
 }
+#endif
 
 void u8g_DrawDisc(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rad, uint8_t option)
 {
+#if defined(U8G_WITH_EDGE_TABLE)
+  if ( u8g->edge_table != NULL )
+    if ( u8g_draw_disc_edge(u8g, x0, y0, rad, option) != 0 )
+      return;
+#endif
+  
   /* check for bounding box */
   {
     u8g_uint_t radp, radp2;
@@ -54,18 +54,41 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 
+/*
+  All bytes between two chip select messages are collected in one buffer
+  (usually the commands and the data of one page). Each change between
+  command and data mode starts a new I2C message with its own control byte.
+  The collected messages are sent with one I2C_RDWR ioctl (combined
+  transfer), or with one write() per message, if the adapter does not
+  support I2C_RDWR.
+  The file descriptor and the buffer belong to the u8g_t (u8g->com_data,
+  allocated by U8G_COM_MSG_INIT), so that several displays can be used
+  at the same time, each on its own bus (U8G_PI_I2C_OPTION).
+*/
 
 #define I2C_SLA		0x3c
-#define I2C_CMD_MODE	0x80
+#define I2C_CMD_MODE	0x00	/* Co = 0: all following bytes are commands */
 #define I2C_DATA_MODE	0x40
-#define MAX_PACKET      64
+#define MAX_MSGS	8
+#define MAX_BUF		1024
 
 #ifndef U8G_WITH_PINLIST
 #error U8G_WITH_PINLIST is mandatory for this driver
 #endif
 
+struct i2c_state
+{
+  int fd;
+  bool is_rdwr;
+  uint8_t buf[MAX_BUF];
+  size_t len;
+  struct i2c_msg msgs[MAX_MSGS];
+  int msgcnt;
+};
+
 static void set_cmd_mode(u8g_t *u8g, bool cmd_mode)
 {
   u8g->pin_list[U8G_PI_A0_STATE] = cmd_mode;
@@ -76,62 +99,121 @@ static bool get_cmd_mode(u8g_t *u8g)
   return u8g->pin_list[U8G_PI_A0_STATE];
 }
 
-static uint8_t send_data_burst(u8g_t *u8g, int fd, uint8_t *buf, size_t buflen)
+static uint8_t flush_msgs(struct i2c_state *s)
 {
-  uint8_t i2cbuf[2*MAX_PACKET];
-  uint8_t i2clen;
-  int res;
+  struct i2c_rdwr_ioctl_data rdwr;
+  int i, res;
+  uint8_t ok = 1;
 
-  /* ignore bursts when there is no file open */
-  if (fd < 0)
-	  return 0;
+  if (s == NULL || s->msgcnt == 0)
+    return 1;
 
-  if (get_cmd_mode(u8g)) {
-    i2clen = 0;
-    while (buflen > 0) {
-      i2cbuf[i2clen++] = I2C_CMD_MODE;
-      i2cbuf[i2clen++] = *buf++;
-      buflen--;
+  /* ignore bursts when there is no file open */
+  if (s->fd < 0) {
+    ok = 0;
+  } else if (s->is_rdwr) {
+    rdwr.msgs = s->msgs;
+    rdwr.nmsgs = s->msgcnt;
+    res = ioctl(s->fd, I2C_RDWR, &rdwr);
+    if (res < 0) {
+      fprintf(stderr, "I2C transfer failed (%s)\n", strerror(errno));
+      ok = 0;
     }
   } else {
-    i2cbuf[0] = I2C_DATA_MODE;
-    memcpy(i2cbuf+1, buf, buflen);
-    i2clen = buflen + 1;
+    for (i = 0; i < s->msgcnt; i++) {
+      res = write(s->fd, s->msgs[i].buf, s->msgs[i].len);
+      if (res < 0) {
+	fprintf(stderr, "I2C write failed (%s)\n", strerror(errno));
+	ok = 0;
+      } else if (res != s->msgs[i].len) {
+	fprintf(stderr, "Incomplete I2C write (%d of %d packet)\n", res, s->msgs[i].len);
+	ok = 0;
+      }
+    }
   }
 
-  res = write(fd, i2cbuf, i2clen);
-  if (res < 0)
-    fprintf(stderr, "I2C write failed (%s)\n", strerror(errno));
-  else if (res != i2clen)
-    fprintf(stderr, "Incomplete I2C write (%d of %d packet)\n", res, i2clen);
+  s->msgcnt = 0;
+  s->len = 0;
+  return ok;
+}
 
-  return res == i2clen;
+static uint8_t send_data_burst(u8g_t *u8g, uint8_t *buf, size_t buflen)
+{
+  struct i2c_state *s = u8g->com_data;
+  uint8_t mode = get_cmd_mode(u8g) ? I2C_CMD_MODE : I2C_DATA_MODE;
+  struct i2c_msg *msg;
+  size_t len;
+  uint8_t ok = 1;
+
+  /* not initialized */
+  if (s == NULL)
+    return 0;
+
+  while (buflen > 0) {
+    if (s->msgcnt == 0 || s->msgs[s->msgcnt-1].buf[0] != mode || s->len == MAX_BUF) {
+      /* start a new message with the control byte */
+      if (s->msgcnt == MAX_MSGS || s->len + 2 > MAX_BUF)
+	ok &= flush_msgs(s);
+      msg = s->msgs + s->msgcnt++;
+      msg->addr = I2C_SLA;
+      msg->flags = 0;
+      msg->buf = s->buf + s->len;
+      msg->len = 1;
+      s->buf[s->len++] = mode;
+    }
+    msg = s->msgs + s->msgcnt - 1;
+    len = MAX_BUF - s->len;
+    if (len > buflen)
+      len = buflen;
+    memcpy(s->buf + s->len, buf, len);
+    s->len += len;
+    msg->len += len;
+    buf += len;
+    buflen -= len;
+  }
+  return ok;
 }
 
 uint8_t u8g_com_linux_ssd_i2c_fn(u8g_t *u8g, uint8_t msg, uint8_t arg_val, void *arg_ptr)
 {
-  static int fd = -1;
+  struct i2c_state *s = u8g->com_data;
   char dev[24];
+  unsigned long funcs;
 
   switch(msg)
   {
     case U8G_COM_MSG_INIT:
+      if (s == NULL) {
+	s = malloc(sizeof(struct i2c_state));
+	if (s == NULL) {
+	  fprintf(stderr, "out of memory\n");
+	  return 0;
+	}
+	s->fd = -1;
+	u8g->com_data = s;
+      }
+      if (s->fd >= 0)
+	close(s->fd);
+      s->msgcnt = 0;
+      s->len = 0;
       sprintf(dev, "/dev/i2c-%d", u8g->pin_list[U8G_PI_I2C_OPTION]);
-      fd = open(dev, O_RDWR);
-      if (fd < 0) {
+      s->fd = open(dev, O_RDWR);
+      if (s->fd < 0) {
 	fprintf(stderr, "cannot open %s (%s)\n", dev, strerror(errno));
 	return 0;
       }
 
-      if (ioctl(fd, I2C_SLAVE, I2C_SLA) < 0) {
+      if (ioctl(s->fd, I2C_SLAVE, I2C_SLA) < 0) {
 	fprintf(stderr, "cannot set slave address (%s)\n", strerror(errno));
 	return 0;
       }
 
+      /* combined transfers need plain I2C messages */
+      s->is_rdwr = ioctl(s->fd, I2C_FUNCS, &funcs) >= 0 && (funcs & I2C_FUNC_I2C) != 0;
       break;
 
     case U8G_COM_MSG_STOP:
-      /* ignored - i2c-dev will automatically stop between writes */
+      flush_msgs(s);
       break;
 
     case U8G_COM_MSG_RESET:
@@ -139,22 +221,18 @@ uint8_t u8g_com_linux_ssd_i2c_fn(u8g_t *u8g, uint8_t msg, uint8_t arg_val, void
       break;
 
     case U8G_COM_MSG_CHIP_SELECT:
+      /* send everything from the previous chip select */
+      flush_msgs(s);
       set_cmd_mode(u8g, true);
       break;
 
     case U8G_COM_MSG_WRITE_BYTE:
-      send_data_burst(u8g, fd, &arg_val, 1);
+      send_data_burst(u8g, &arg_val, 1);
       break;
 
     case U8G_COM_MSG_WRITE_SEQ:
     case U8G_COM_MSG_WRITE_SEQ_P:	/* no progmem in Linux */
-      while (arg_val > MAX_PACKET) {
-	send_data_burst(u8g, fd, arg_ptr, MAX_PACKET);
-	arg_ptr += MAX_PACKET;
-	arg_val -= MAX_PACKET;
-      }
-      send_data_burst(u8g, fd, arg_ptr, arg_val);
-      break;
+      return send_data_burst(u8g, arg_ptr, arg_val);
 
     case U8G_COM_MSG_ADDRESS:
       /* choose cmd (arg_val = 0) or data mode (arg_val = 1) */
@@ -57,16 +57,101 @@
 #include <wiringPi.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+
+/*
+  Bytes are collected until A0, reset or chip select change, then they are
+  sent with one spidev transfer (usually all commands of a page in one 
+  transfer and the complete page data in a second transfer).
+  The transfer is transmit only, the page buffer is not overwritten by 
+  the received bytes.
+  The SPI channel is the chip select pin of u8g_InitHWSPI() (0 or 1 for 
+  CE0 or CE1, channel 0 for any other value). Channel, file descriptor 
+  and buffer belong to the u8g_t (u8g->com_data, allocated by 
+  U8G_COM_MSG_INIT), so that both channels can be used at the same time.
+*/
+
+#define SPI_BUF_SIZE 1024
+
+#ifndef U8G_WITH_PINLIST
+#error U8G_WITH_PINLIST is mandatory for this driver
+#endif
+
+struct u8g_com_raspberrypi_hw_spi_state
+{
+  int channel;
+  int fd;
+  uint8_t buf[SPI_BUF_SIZE];
+  uint16_t len;
+};
+
+static uint8_t u8g_com_raspberrypi_hw_spi_flush(struct u8g_com_raspberrypi_hw_spi_state *s)
+{
+  struct spi_ioc_transfer tr;
+  
+  if ( s == NULL || s->len == 0 )
+    return 1;
+  memset(&tr, 0, sizeof(tr));
+  tr.tx_buf = (unsigned long)s->buf;
+  tr.len = s->len;
+  tr.bits_per_word = 8;
+  s->len = 0;
+  if ( ioctl(s->fd, SPI_IOC_MESSAGE(1), &tr) < 0 )
+  {
+    printf("SPI transfer failed: %s\n", strerror(errno));
+    return 0;
+  }
+  return 1;
+}
+
+static uint8_t u8g_com_raspberrypi_hw_spi_write(struct u8g_com_raspberrypi_hw_spi_state *s, uint8_t *ptr, uint8_t cnt)
+{
+  uint8_t ok = 1;
+  uint16_t len;
+  /* not initialized */
+  if ( s == NULL )
+    return 0;
+  while( cnt > 0 )
+  {
+    if ( s->len == SPI_BUF_SIZE )
+      ok &= u8g_com_raspberrypi_hw_spi_flush(s);
+    len = SPI_BUF_SIZE - s->len;
+    if ( len > cnt )
+      len = cnt;
+    memcpy(s->buf + s->len, ptr, len);
+    s->len += len;
+    ptr += len;
+    cnt -= len;
+  }
+  return ok;
+}
 
 uint8_t u8g_com_raspberrypi_hw_spi_fn(u8g_t *u8g, uint8_t msg, uint8_t arg_val, void *arg_ptr)
 {
+  struct u8g_com_raspberrypi_hw_spi_state *s = u8g->com_data;
+  
   switch(msg)
   {
     case U8G_COM_MSG_STOP:
+      u8g_com_raspberrypi_hw_spi_flush(s);
       break;
     
     case U8G_COM_MSG_INIT:
+		if ( s == NULL )
+		{
+			s = malloc(sizeof(struct u8g_com_raspberrypi_hw_spi_state));
+			if ( s == NULL )
+			{
+				printf("out of memory\n");
+				exit(1);
+			}
+			u8g->com_data = s;
+		}
+		s->channel = u8g->pin_list[U8G_PI_CS] == 1 ? 1 : 0;
+		
 		// check wiringPi setup
 		if (wiringPiSetup() == -1)
 		{
@@ -74,11 +159,13 @@ uint8_t u8g_com_raspberrypi_hw_spi_fn(u8g_t *u8g, uint8_t msg, uint8_t arg_val,
 			exit(1);
 		}
 
-		if (wiringPiSPISetup (0, 100000) < 0)
+		if (wiringPiSPISetup (s->channel, 100000) < 0)
 		{
-			printf ("Unable to open SPI device 0: %s\n", strerror (errno)) ;
+			printf ("Unable to open SPI device %d: %s\n", s->channel, strerror (errno)) ;
 			exit (1) ;
 		}
+		s->fd = wiringPiSPIGetFd(s->channel);
+		s->len = 0;
 		
 		u8g_SetPIOutput(u8g, U8G_PI_RESET);
 		u8g_SetPIOutput(u8g, U8G_PI_A0);
@@ -86,28 +173,26 @@ uint8_t u8g_com_raspberrypi_hw_spi_fn(u8g_t *u8g, uint8_t msg, uint8_t arg_val,
       break;
     
     case U8G_COM_MSG_ADDRESS:                     /* define cmd (arg_val = 0) or data mode (arg_val = 1) */
+	  u8g_com_raspberrypi_hw_spi_flush(s);	/* A0 must not change during the transfer */
 	  u8g_SetPILevel(u8g, U8G_PI_A0, arg_val);
       break;
 
     case U8G_COM_MSG_CHIP_SELECT:
-		/* Done by the SPI hardware */
+		/* Done by the SPI hardware, end of the transfer */
+		u8g_com_raspberrypi_hw_spi_flush(s);
       break;
       
     case U8G_COM_MSG_RESET:
+      u8g_com_raspberrypi_hw_spi_flush(s);
       u8g_SetPILevel(u8g, U8G_PI_RESET, arg_val);
       break;
     
     case U8G_COM_MSG_WRITE_BYTE:
-		wiringPiSPIDataRW (0, &arg_val, 1) ;
-      break;
+		return u8g_com_raspberrypi_hw_spi_write(s, &arg_val, 1);
     
     case U8G_COM_MSG_WRITE_SEQ:
-		wiringPiSPIDataRW (0, arg_ptr, arg_val);
-      break;
-
-	case U8G_COM_MSG_WRITE_SEQ_P:
-		wiringPiSPIDataRW (0, arg_ptr, arg_val);		
-      break;
+    case U8G_COM_MSG_WRITE_SEQ_P:
+		return u8g_com_raspberrypi_hw_spi_write(s, arg_ptr, arg_val);
   }
   return 1;
 }
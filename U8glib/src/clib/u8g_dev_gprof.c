@@ -94,7 +94,7 @@ uint8_t u8g_dev_gprof_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
         return 0;
       }
       u8g_pb_Clear(pb);
-      break;
+      return 1;       /* do not let u8g_dev_pb8v1_base_fn() advance the page a second time */
 #ifdef U8G_DEV_MSG_IS_BBX_INTERSECTION
     case U8G_DEV_MSG_IS_BBX_INTERSECTION:
        {
@@ -128,3 +128,17 @@ uint8_t u8g_dev_gprof_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
   }
   return u8g_dev_pb8v1_base_fn(u8g, dev, msg, arg);
 }
+
+/* same as u8g_dev_gprof, but with a full frame buffer: the picture loop is executed only once */
+
+uint8_t u8g_dev_gprof_f_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg);
+
+uint8_t u8g_pb_dev_gprof_f_buf[WIDTH*HEIGHT/8];
+u8g_pb_t u8g_pb_dev_gprof_f = { {HEIGHT, HEIGHT, 0, 0, 0},  WIDTH, u8g_pb_dev_gprof_f_buf };
+
+u8g_dev_t u8g_dev_gprof_f = { u8g_dev_gprof_f_fn, &u8g_pb_dev_gprof_f, NULL };
+
+uint8_t u8g_dev_gprof_f_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
+{
+  return u8g_dev_pbxv1_base_fn(u8g, dev, msg, arg);
+}
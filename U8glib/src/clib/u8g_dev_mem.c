@@ -0,0 +1,248 @@
+/*
+
+  u8g_dev_mem.c
+
+  Devices for tests and benchmarks on the host: Each page is copied into a
+  frame memory after it has been drawn. The frame can be read with
+  u8g_dev_mem_GetFrame() or written as PBM, PGM or PPM file with
+  u8g_dev_mem_WritePNM().
+  
+  There is one device for each common page buffer layout:
+    u8g_dev_mem_8v1		u8g_pb8v1.c		monochrom
+    u8g_dev_mem_8h1		u8g_pb8h1.c		monochrom
+    u8g_dev_mem_8v2		u8g_pb8v2.c		2 bit gray
+    u8g_dev_mem_16h2		u8g_pb16h2.c		2 bit gray
+    u8g_dev_mem_xh16		u8g_pbxh16.c		16 bit hicolor
+    u8g_dev_mem_xh24		u8g_pbxh24.c		24 bit truecolor
+  
+  u8g_dev_pbm, u8g_dev_pbm_8h1 and u8g_dev_pbm_8h2 write "u8g.pbm" at the
+  end of each picture loop.
+
+  Universal 8bit Graphics Library
+  
+  Copyright (c) 2013, olikraus@gmail.com
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification, 
+  are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this list 
+    of conditions and the following disclaimer.
+    
+  * Redistributions in binary form must reproduce the above copyright notice, this 
+    list of conditions and the following disclaimer in the documentation and/or other 
+    materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND 
+  CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF 
+  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  
+  
+  
+
+*/
+
+
+#include "u8g.h"
+
+#if defined(U8G_HOST)
+
+#include <stdio.h>
+
+#define WIDTH 128
+#define HEIGHT 64
+
+typedef struct _u8g_mem_t u8g_mem_t;
+typedef void (*u8g_mem_copy_fnptr)(u8g_pb_t *pb, uint8_t *dest);
+
+struct _u8g_mem_t
+{
+  u8g_pb_t pb;			/* first member, the page buffer procedures use dev_mem as u8g_pb_t */
+  uint8_t *frame;
+  uint8_t mode;
+  u8g_mem_copy_fnptr copy_page;
+  u8g_dev_fnptr base_fn;
+  const char *filename;	/* written after the last page, NULL: memory only */
+};
+
+uint8_t u8g_dev_mem_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg);
+
+/*
+  copy procedures: one byte per pixel (color index) for monochrom and gray,
+  r, g and b for hicolor and truecolor
+*/
+
+static void u8g_mem_copy_8v1(u8g_pb_t *pb, uint8_t *dest)
+{
+  uint8_t *src = pb->buf;
+  uint8_t y, h = pb->p.page_y1 - pb->p.page_y0 + 1;
+  u8g_uint_t x;
+  for( y = 0; y < h; y++ )
+    for( x = 0; x < pb->width; x++ )
+      *dest++ = (src[x] >> y) & 1;
+}
+
+static void u8g_mem_copy_8h1(u8g_pb_t *pb, uint8_t *dest)
+{
+  uint8_t *src = pb->buf;
+  uint8_t y, h = pb->p.page_y1 - pb->p.page_y0 + 1;
+  u8g_uint_t x;
+  for( y = 0; y < h; y++, src += pb->width / 8 )
+    for( x = 0; x < pb->width; x++ )
+      *dest++ = (src[x >> 3] >> (7 - (x & 7))) & 1;
+}
+
+static void u8g_mem_copy_8v2(u8g_pb_t *pb, uint8_t *dest)
+{
+  uint8_t *src = pb->buf;
+  uint8_t y, h = pb->p.page_y1 - pb->p.page_y0 + 1;
+  u8g_uint_t x;
+  for( y = 0; y < h; y++ )
+    for( x = 0; x < pb->width; x++ )
+      *dest++ = (src[x] >> (y * 2)) & 3;
+}
+
+/* u8g_pb8h2.c and u8g_pb16h2.c */
+static void u8g_mem_copy_h2(u8g_pb_t *pb, uint8_t *dest)
+{
+  uint8_t *src = pb->buf;
+  uint8_t y, h = pb->p.page_y1 - pb->p.page_y0 + 1;
+  u8g_uint_t x;
+  for( y = 0; y < h; y++, src += pb->width / 4 )
+    for( x = 0; x < pb->width; x++ )
+      *dest++ = (src[x >> 2] >> ((x & 3) * 2)) & 3;
+}
+
+/* low byte: ggg bbbbb, high byte: rrrrr ggg, see u8g_SetHiColorByRGB() */
+static void u8g_mem_copy_xh16(u8g_pb_t *pb, uint8_t *dest)
+{
+  uint8_t *src = pb->buf;
+  uint16_t i, cnt = pb->width * (pb->p.page_y1 - pb->p.page_y0 + 1);
+  uint8_t r, g, b;
+  for( i = 0; i < cnt; i++, src += 2 )
+  {
+    r = src[1] & 0x0f8;
+    g = ((src[1] & 7) << 5) | ((src[0] >> 3) & 0x01c);
+    b = src[0] << 3;
+    *dest++ = r | (r >> 5);
+    *dest++ = g | (g >> 6);
+    *dest++ = b | (b >> 5);
+  }
+}
+
+static void u8g_mem_copy_xh24(u8g_pb_t *pb, uint8_t *dest)
+{
+  uint8_t *src = pb->buf;
+  uint16_t i, cnt = pb->width * (pb->p.page_y1 - pb->p.page_y0 + 1) * 3;
+  for( i = 0; i < cnt; i++ )
+    *dest++ = *src++;
+}
+
+static uint8_t u8g_mem_get_bytes_per_pixel(u8g_mem_t *mem)
+{
+  if ( U8G_MODE_IS_COLOR(mem->mode) )
+    return 3;
+  return 1;
+}
+
+/*
+  PBM (monochrom), PGM (gray) or PPM (hicolor, truecolor), binary format.
+  Pixel with color index 1 (monochrom) or 3 (gray) are black.
+  Returns 0 if the file could not be written.
+*/
+uint8_t u8g_dev_mem_WritePNM(u8g_dev_t *dev, const char *filename)
+{
+  u8g_mem_t *mem = (u8g_mem_t *)(dev->dev_mem);
+  uint8_t *p = mem->frame;
+  u8g_uint_t x, y;
+  uint8_t bits;
+  FILE *fp;
+  
+  fp = fopen(filename, "wb");
+  if ( fp == NULL )
+    return 0;
+  
+  if ( mem->mode == U8G_MODE_BW )
+  {
+    fprintf(fp, "P4\n%d %d\n", WIDTH, HEIGHT);
+    for( y = 0; y < HEIGHT; y++ )
+    {
+      bits = 0;
+      for( x = 0; x < WIDTH; x++ )
+      {
+        bits <<= 1;
+        bits |= *p++;
+        if ( (x & 7) == 7 )
+        {
+          putc(bits, fp);
+          bits = 0;
+        }
+      }
+    }
+  }
+  else if ( mem->mode == U8G_MODE_GRAY2BIT )
+  {
+    fprintf(fp, "P5\n%d %d\n3\n", WIDTH, HEIGHT);
+    for( y = 0; y < HEIGHT; y++ )
+      for( x = 0; x < WIDTH; x++ )
+        putc(3 - *p++, fp);
+  }
+  else
+  {
+    fprintf(fp, "P6\n%d %d\n255\n", WIDTH, HEIGHT);
+    fwrite(p, 3, WIDTH*HEIGHT, fp);
+  }
+  
+  if ( fclose(fp) != 0 )
+    return 0;
+  return 1;
+}
+
+uint8_t *u8g_dev_mem_GetFrame(u8g_dev_t *dev)
+{
+  return ((u8g_mem_t *)(dev->dev_mem))->frame;
+}
+
+uint8_t u8g_dev_mem_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
+{
+  u8g_mem_t *mem = (u8g_mem_t *)(dev->dev_mem);
+  u8g_pb_t *pb = &(mem->pb);
+  
+  switch(msg)
+  {
+    case U8G_DEV_MSG_PAGE_NEXT:
+      mem->copy_page(pb, mem->frame + (uint16_t)pb->p.page_y0 * WIDTH * u8g_mem_get_bytes_per_pixel(mem));
+      if ( mem->filename != NULL && pb->p.page_y1 + 1 >= pb->p.total_height )
+        u8g_dev_mem_WritePNM(dev, mem->filename);
+      break;
+  }
+  return mem->base_fn(u8g, dev, msg, arg);
+}
+
+#define U8G_MEM_DEV(name, page_height, buf_size, mode, copy_fn, base_fn, filename) \
+uint8_t name##_buf[buf_size]; \
+uint8_t name##_frame[WIDTH*HEIGHT*(U8G_MODE_IS_COLOR(mode) ? 3 : 1)]; \
+u8g_mem_t name##_mem = { { {page_height, HEIGHT, 0, 0, 0}, WIDTH, name##_buf }, name##_frame, mode, copy_fn, base_fn, filename }; \
+u8g_dev_t name = { u8g_dev_mem_fn, &name##_mem, NULL }
+
+U8G_MEM_DEV(u8g_dev_mem_8v1, 8, WIDTH, U8G_MODE_BW, u8g_mem_copy_8v1, u8g_dev_pb8v1_base_fn, NULL);
+U8G_MEM_DEV(u8g_dev_mem_8h1, 8, WIDTH, U8G_MODE_BW, u8g_mem_copy_8h1, u8g_dev_pb8h1_base_fn, NULL);
+U8G_MEM_DEV(u8g_dev_mem_8v2, 4, WIDTH, U8G_MODE_GRAY2BIT, u8g_mem_copy_8v2, u8g_dev_pb8v2_base_fn, NULL);
+U8G_MEM_DEV(u8g_dev_mem_16h2, 8, WIDTH*2, U8G_MODE_GRAY2BIT, u8g_mem_copy_h2, u8g_dev_pb16h2_base_fn, NULL);
+U8G_MEM_DEV(u8g_dev_mem_xh16, 8, WIDTH*8*2, U8G_MODE_HICOLOR, u8g_mem_copy_xh16, u8g_dev_pbxh16_base_fn, NULL);
+U8G_MEM_DEV(u8g_dev_mem_xh24, 8, WIDTH*8*3, U8G_MODE_TRUECOLOR, u8g_mem_copy_xh24, u8g_dev_pbxh24_base_fn, NULL);
+
+U8G_MEM_DEV(u8g_dev_pbm, 8, WIDTH, U8G_MODE_BW, u8g_mem_copy_8v1, u8g_dev_pb8v1_base_fn, "u8g.pbm");
+U8G_MEM_DEV(u8g_dev_pbm_8h1, 8, WIDTH, U8G_MODE_BW, u8g_mem_copy_8h1, u8g_dev_pb8h1_base_fn, "u8g.pbm");
+U8G_MEM_DEV(u8g_dev_pbm_8h2, 4, WIDTH, U8G_MODE_GRAY2BIT, u8g_mem_copy_h2, u8g_dev_pb8h2_base_fn, "u8g.pbm");
+
+#endif /* U8G_HOST */
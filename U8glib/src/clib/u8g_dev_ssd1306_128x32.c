@@ -184,13 +184,28 @@ static const uint8_t u8g_dev_ssd1306_128x32_univision_init_seq[] PROGMEM = {
 #define u8g_dev_ssd1306_128x32_init_seq u8g_dev_ssd1306_128x32_adafruit3_init_seq
 
 
-static const uint8_t u8g_dev_ssd1306_128x32_data_start[] PROGMEM = {
-  U8G_ESC_ADR(0),       /* instruction mode */
-  U8G_ESC_CS(1),        /* enable chip */
-  0x010,				/* set upper 4 bit of the col adr. to 0 */
-  0x000,				/* set lower 4 bit of the col adr. to 4  */
-  U8G_ESC_END           /* end of sequence */
-};
+/*
+  send one row (8 pixel lines) of the buffer to the display RAM
+  with damage tracking (u8g_SetDamageTracking()) only the changed columns are sent
+*/
+static uint8_t u8g_dev_ssd1306_128x32_write_row(u8g_t *u8g, u8g_dev_t *dev, uint8_t row, uint8_t *ptr)
+{
+  u8g_pb_t *pb = (u8g_pb_t *)(dev->dev_mem);
+  u8g_uint_t x0, x1;
+
+  if ( u8g_pb_GetDamage(pb, row, ptr, &x0, &x1) == 0 )
+    return 1;				/* nothing has changed */
+  u8g_SetAddress(u8g, dev, 0);           /* instruction mode */
+  u8g_SetChipSelect(u8g, dev, 1);
+  u8g_WriteByte(u8g, dev, 0x010 | (x0 >> 4));	/* set upper 4 bit of the col adr */
+  u8g_WriteByte(u8g, dev, x0 & 0x0f);		/* set lower 4 bit of the col adr */
+  u8g_WriteByte(u8g, dev, 0x0b0 | row); /* select current page (SSD1306) */
+  u8g_SetAddress(u8g, dev, 1);           /* data mode */
+  if ( u8g_WriteSequence(u8g, dev, x1-x0+1, ptr+x0) == 0 )
+    return 0;
+  u8g_SetChipSelect(u8g, dev, 0);
+  return 1;
+}
 
 static const uint8_t u8g_dev_ssd13xx_sleep_on[] PROGMEM = {
   U8G_ESC_ADR(0),           /* instruction mode */
@@ -222,12 +237,8 @@ uint8_t u8g_dev_ssd1306_128x32_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void
     case U8G_DEV_MSG_PAGE_NEXT:
       {
         u8g_pb_t *pb = (u8g_pb_t *)(dev->dev_mem);
-        u8g_WriteEscSeqP(u8g, dev, u8g_dev_ssd1306_128x32_data_start);    
-        u8g_WriteByte(u8g, dev, 0x0b0 | pb->p.page);	/* select current page (SSD1306) */
-        u8g_SetAddress(u8g, dev, 1);					/* data mode */
-        if ( u8g_pb_WriteBuffer(pb, u8g, dev) == 0 )
+        if ( u8g_dev_ssd1306_128x32_write_row(u8g, dev, pb->p.page, pb->buf) == 0 )
           return 0;
-        u8g_SetChipSelect(u8g, dev, 0);
       }
       break;
     case U8G_DEV_MSG_CONTRAST:
@@ -261,18 +272,10 @@ uint8_t u8g_dev_ssd1306_128x32_2x_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, vo
     case U8G_DEV_MSG_PAGE_NEXT:
       {
         u8g_pb_t *pb = (u8g_pb_t *)(dev->dev_mem);
-	
-        u8g_WriteEscSeqP(u8g, dev, u8g_dev_ssd1306_128x32_data_start);    
-        u8g_WriteByte(u8g, dev, 0x0b0 | (pb->p.page*2));	/* select current page (SSD1306) */
-        u8g_SetAddress(u8g, dev, 1);					/* data mode */
-	u8g_WriteSequence(u8g, dev, pb->width, pb->buf); 
-        u8g_SetChipSelect(u8g, dev, 0);
-	
-        u8g_WriteEscSeqP(u8g, dev, u8g_dev_ssd1306_128x32_data_start);    
-        u8g_WriteByte(u8g, dev, 0x0b0 | (pb->p.page*2+1));	/* select current page (SSD1306) */
-        u8g_SetAddress(u8g, dev, 1);					/* data mode */
-	u8g_WriteSequence(u8g, dev, pb->width, (uint8_t *)(pb->buf)+pb->width); 
-        u8g_SetChipSelect(u8g, dev, 0);
+        if ( u8g_dev_ssd1306_128x32_write_row(u8g, dev, pb->p.page*2, pb->buf) == 0 )
+          return 0;
+        if ( u8g_dev_ssd1306_128x32_write_row(u8g, dev, pb->p.page*2+1, (uint8_t *)(pb->buf)+pb->width) == 0 )
+          return 0;
       }
       break;
     case U8G_DEV_MSG_CONTRAST:
@@ -292,6 +295,48 @@ uint8_t u8g_dev_ssd1306_128x32_2x_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, vo
   return u8g_dev_pb16v1_base_fn(u8g, dev, msg, arg);
 }
 
+uint8_t u8g_dev_ssd1306_128x32_f_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
+{
+  switch(msg)
+  {
+    case U8G_DEV_MSG_INIT:
+      u8g_InitCom(u8g, dev, U8G_SPI_CLK_CYCLE_300NS);
+      u8g_WriteEscSeqP(u8g, dev, u8g_dev_ssd1306_128x32_init_seq);
+      break;
+    case U8G_DEV_MSG_STOP:
+      break;
+    case U8G_DEV_MSG_PAGE_NEXT:
+      {
+        u8g_pb_t *pb = (u8g_pb_t *)(dev->dev_mem);
+        uint8_t *ptr = (uint8_t *)(pb->buf);
+        uint8_t page;
+
+        /* full frame: send all pages of the controller at once */
+        for( page = 0; page < HEIGHT/8; page++ )
+        {
+          if ( u8g_dev_ssd1306_128x32_write_row(u8g, dev, page, ptr) == 0 )
+            return 0;
+          ptr += pb->width;
+        }
+      }
+      break;
+    case U8G_DEV_MSG_SLEEP_ON:
+      u8g_WriteEscSeqP(u8g, dev, u8g_dev_ssd13xx_sleep_on);    
+      return 1;
+    case U8G_DEV_MSG_SLEEP_OFF:
+      u8g_WriteEscSeqP(u8g, dev, u8g_dev_ssd13xx_sleep_off);    
+      return 1;
+    case U8G_DEV_MSG_CONTRAST:
+      u8g_SetChipSelect(u8g, dev, 1);
+      u8g_SetAddress(u8g, dev, 0);          /* instruction mode */
+      u8g_WriteByte(u8g, dev, 0x081);
+      u8g_WriteByte(u8g, dev, (*(uint8_t *)arg) );
+      u8g_SetChipSelect(u8g, dev, 0);      
+      return 1; 
+  }
+  return u8g_dev_pbxv1_base_fn(u8g, dev, msg, arg);
+}
+
 U8G_PB_DEV(u8g_dev_ssd1306_128x32_sw_spi, WIDTH, HEIGHT, PAGE_HEIGHT, u8g_dev_ssd1306_128x32_fn, U8G_COM_SW_SPI);
 U8G_PB_DEV(u8g_dev_ssd1306_128x32_hw_spi, WIDTH, HEIGHT, PAGE_HEIGHT, u8g_dev_ssd1306_128x32_fn, U8G_COM_HW_SPI);
 U8G_PB_DEV(u8g_dev_ssd1306_128x32_i2c, WIDTH, HEIGHT, PAGE_HEIGHT, u8g_dev_ssd1306_128x32_fn, U8G_COM_SSD_I2C);
@@ -301,3 +346,10 @@ u8g_pb_t u8g_dev_ssd1306_128x32_2x_pb = { {16, HEIGHT, 0, 0, 0},  WIDTH, u8g_dev
 u8g_dev_t u8g_dev_ssd1306_128x32_2x_sw_spi = { u8g_dev_ssd1306_128x32_2x_fn, &u8g_dev_ssd1306_128x32_2x_pb, U8G_COM_SW_SPI };
 u8g_dev_t u8g_dev_ssd1306_128x32_2x_hw_spi = { u8g_dev_ssd1306_128x32_2x_fn, &u8g_dev_ssd1306_128x32_2x_pb, U8G_COM_HW_SPI };
 u8g_dev_t u8g_dev_ssd1306_128x32_2x_i2c = { u8g_dev_ssd1306_128x32_2x_fn, &u8g_dev_ssd1306_128x32_2x_pb, U8G_COM_SSD_I2C };
+
+/* full frame, picture loop is executed only once */
+uint8_t u8g_dev_ssd1306_128x32_f_buf[WIDTH*HEIGHT/8] U8G_NOCOMMON ; 
+u8g_pb_t u8g_dev_ssd1306_128x32_f_pb = { {HEIGHT, HEIGHT, 0, 0, 0},  WIDTH, u8g_dev_ssd1306_128x32_f_buf}; 
+u8g_dev_t u8g_dev_ssd1306_128x32_f_sw_spi = { u8g_dev_ssd1306_128x32_f_fn, &u8g_dev_ssd1306_128x32_f_pb, U8G_COM_SW_SPI };
+u8g_dev_t u8g_dev_ssd1306_128x32_f_hw_spi = { u8g_dev_ssd1306_128x32_f_fn, &u8g_dev_ssd1306_128x32_f_pb, U8G_COM_HW_SPI };
+u8g_dev_t u8g_dev_ssd1306_128x32_f_i2c = { u8g_dev_ssd1306_128x32_f_fn, &u8g_dev_ssd1306_128x32_f_pb, U8G_COM_SSD_I2C };
@@ -0,0 +1,254 @@
+/*
+
+  u8g_edge.c
+
+  Table with the horizontal spans of filled polygons, discs and filled
+  ellipses. Without table, each page calculates the complete primitive
+  again and most of the lines are clipped. With table, the spans are
+  calculated on the first page and the other pages draw only the rows
+  between page_y0 and page_y1.
+
+  The table is a list of entries. Each page starts again at the first
+  entry (u8g_FirstPageLL(), u8g_NextPageLL()). The entry at the current
+  position is used, if type and arguments of the primitive are the same,
+  otherwise a new entry is created at this position and all following
+  entries are discarded. If the table is full, the primitive is drawn
+  without table.
+
+  Universal 8bit Graphics Library
+  
+  Copyright (c) 2013, olikraus@gmail.com
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification, 
+  are permitted provided that the following conditions are met:
+
+  * Redistributions of source code must retain the above copyright notice, this list 
+    of conditions and the following disclaimer.
+    
+  * Redistributions in binary form must reproduce the above copyright notice, this 
+    list of conditions and the following disclaimer in the documentation and/or other 
+    materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND 
+  CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, 
+  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF 
+  MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE 
+  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR 
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, 
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT 
+  NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; 
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER 
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, 
+  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.  
+  
+*/
+
+#include "u8g.h"
+
+#if defined(U8G_WITH_EDGE_TABLE)
+
+/*
+  table:	memory for the entries, NULL disables the table
+  cnt:		number of words (uint16_t) in table
+  An entry needs 18 words and one word (8 bit) or two words (16 bit mode)
+  for each row of the primitive.
+*/
+void u8g_SetEdgeTable(u8g_t *u8g, uint16_t *table, uint16_t cnt)
+{
+  u8g->edge_table = table;
+  u8g->edge_table_cnt = table == NULL ? 0 : cnt;
+  u8g->edge_table_end = 0;
+  u8g->edge_table_pos = 0;
+}
+
+/* returns the entry at the current position, if it has been created for the same primitive */
+u8g_edge_t *u8g_edge_Find(u8g_t *u8g, uint8_t type, const pg_word_t *key, uint8_t key_len)
+{
+  u8g_edge_t *e;
+  uint8_t i;
+  
+  if ( u8g->edge_table_pos >= u8g->edge_table_end )
+    return NULL;
+  e = (u8g_edge_t *)(u8g->edge_table + u8g->edge_table_pos);
+  if ( e->type != type || e->key_len != key_len )
+    return NULL;
+  for( i = 0; i < key_len; i++ )
+    if ( e->key[i] != key[i] )
+      return NULL;
+  u8g->edge_table_pos += e->size;
+  return e;
+}
+
+/* new entry with h empty rows at the current position, NULL if the table is too small */
+u8g_edge_t *u8g_edge_New(u8g_t *u8g, uint8_t type, const pg_word_t *key, uint8_t key_len, pg_word_t y, pg_word_t h)
+{
+  u8g_edge_t *e;
+  u8g_uint_t *span;
+  uint16_t size;
+  uint8_t i;
+  
+  /* all following entries are invalid */
+  u8g->edge_table_end = u8g->edge_table_pos;
+  
+  if ( u8g->edge_table == NULL || h < 0 )
+    return NULL;
+  size = sizeof(u8g_edge_t);
+  size += (uint16_t)h * 2 * sizeof(u8g_uint_t);
+  size++;
+  size /= 2;
+  if ( size > u8g->edge_table_cnt - u8g->edge_table_pos )
+    return NULL;
+  
+  e = (u8g_edge_t *)(u8g->edge_table + u8g->edge_table_pos);
+  e->type = type;
+  e->key_len = key_len;
+  e->size = size;
+  for( i = 0; i < key_len; i++ )
+    e->key[i] = key[i];
+  e->y = y;
+  e->h = h;
+  span = U8G_EDGE_SPANS(e);
+  while( h > 0 )
+  {
+    *span++ = 0;
+    *span++ = 0;
+    h--;
+  }
+  
+  u8g->edge_table_pos += size;
+  u8g->edge_table_end = u8g->edge_table_pos;
+  return e;
+}
+
+/* 
+  removes the spans of the last new entry, the key remains: the primitive 
+  is found again on the next pages, but has to be drawn without table 
+*/
+void u8g_edge_Discard(u8g_t *u8g, u8g_edge_t *e)
+{
+  e->h = -1;
+  e->size = (sizeof(u8g_edge_t) + 1) / 2;
+  u8g->edge_table_pos = (uint16_t *)e - u8g->edge_table + e->size;
+  u8g->edge_table_end = u8g->edge_table_pos;
+}
+
+/*
+  Discs and ellipses: the entry has 2*r+1 rows, the center is row r.
+  Before u8g_edge_SetQuadrants() is called, the width of the rows r..2*r
+  collects the extent of the primitive: dx is the largest distance from 
+  the center which is set dy rows above or below the center.
+*/
+void u8g_edge_SetExtent(u8g_edge_t *e, u8g_uint_t dy, u8g_uint_t dx)
+{
+  u8g_uint_t *w;
+  if ( dy > e->h / 2 )
+    return;
+  w = U8G_EDGE_SPANS(e) + (e->h / 2 + dy) * 2 + 1;
+  if ( *w < dx )
+    *w = dx;
+}
+
+/* converts the extent into spans for the quadrants of option (U8G_DRAW_UPPER_RIGHT, ...) */
+void u8g_edge_SetQuadrants(u8g_edge_t *e, u8g_uint_t x0, uint8_t option)
+{
+  u8g_uint_t *span = U8G_EDGE_SPANS(e);
+  u8g_uint_t r = e->h / 2;
+  u8g_uint_t dy, dx, ext;
+  u8g_uint_t *upper, *lower;
+  uint8_t left, right;
+  
+  /* a row is also set, if a row further away from the center is set */
+  ext = 0;
+  dy = r;
+  for(;;)
+  {
+    lower = span + (r + dy) * 2 + 1;
+    if ( ext < *lower )
+      ext = *lower;
+    *lower = ext;
+    if ( dy == 0 )
+      break;
+    dy--;
+  }
+  
+  for( dy = 0; dy <= r; dy++ )
+  {
+    upper = span + (r - dy) * 2;
+    lower = span + (r + dy) * 2;
+    dx = lower[1];
+    
+    /* upper rows, dy == 0 is the center row, which belongs to all quadrants */
+    left = option & U8G_DRAW_UPPER_LEFT;
+    right = option & U8G_DRAW_UPPER_RIGHT;
+    if ( dy == 0 )
+    {
+      left |= option & U8G_DRAW_LOWER_LEFT;
+      right |= option & U8G_DRAW_LOWER_RIGHT;
+    }
+    upper[0] = x0;
+    upper[1] = 0;
+    if ( left || right )
+    {
+      upper[1] = 1;
+      if ( left )
+      {
+        upper[0] -= dx;
+        upper[1] += dx;
+      }
+      if ( right )
+        upper[1] += dx;
+    }
+    
+    if ( dy == 0 )
+      continue;
+    
+    /* lower rows */
+    left = option & U8G_DRAW_LOWER_LEFT;
+    right = option & U8G_DRAW_LOWER_RIGHT;
+    lower[0] = x0;
+    lower[1] = 0;
+    if ( left || right )
+    {
+      lower[1] = 1;
+      if ( left )
+      {
+        lower[0] -= dx;
+        lower[1] += dx;
+      }
+      if ( right )
+        lower[1] += dx;
+    }
+  }
+}
+
+/* draws the rows of the entry which are inside the current page */
+void u8g_edge_Draw(u8g_t *u8g, u8g_edge_t *e)
+{
+  u8g_uint_t *span = U8G_EDGE_SPANS(e);
+  pg_word_t y, y_end;
+  
+  if ( e->h < 0 )
+    return;
+  y = u8g->current_page.y0;
+  y_end = u8g->current_page.y1;
+  if ( y < e->y )
+    y = e->y;
+  if ( y_end > e->y + e->h - 1 )
+    y_end = e->y + e->h - 1;
+  if ( y > y_end )
+    return;
+  
+  span += (y - e->y) * 2;
+  while( y <= y_end )
+  {
+    if ( span[1] != 0 )
+      u8g_DrawHLine(u8g, span[0], y, span[1]);
+    span += 2;
+    y++;
+  }
+}
+
+#endif /* U8G_WITH_EDGE_TABLE */
@@ -251,9 +251,18 @@ void u8g_DrawEllipse(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rx, u8
   u8g_draw_ellipse(u8g, x0, y0, rx, ry, option);
 }
 
-static void u8g_draw_filled_ellipse_section(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t x0, u8g_uint_t y0, uint8_t option) U8G_NOINLINE;
-static void u8g_draw_filled_ellipse_section(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t x0, u8g_uint_t y0, uint8_t option)
+static void u8g_draw_filled_ellipse_section(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t x0, u8g_uint_t y0, uint8_t option, u8g_edge_t *e) U8G_NOINLINE;
+static void u8g_draw_filled_ellipse_section(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t x0, u8g_uint_t y0, uint8_t option, u8g_edge_t *e)
 {
+#if defined(U8G_WITH_EDGE_TABLE)
+    /* edge table: the vertical lines below are converted into rows later */
+    if ( e != NULL )
+    {
+      u8g_edge_SetExtent(e, y, x);
+      return;
+    }
+#endif
+    
     /* upper right */
     if ( option & U8G_DRAW_UPPER_RIGHT )
     {
@@ -279,9 +288,16 @@ static void u8g_draw_filled_ellipse_section(u8g_t *u8g, u8g_uint_t x, u8g_uint_t
     }
 }
 
-void u8g_draw_filled_ellipse(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rx, u8g_uint_t ry, uint8_t option)
+/*
+  returns 0 if the vertical lines of the quadrant can not be described by rows:
+  the first loop sets the columns rx down to x1, the second loop the columns
+  0 up to x2. For small radii, these may leave a gap or the column x1-1 may
+  be lower than the column x1.
+*/
+static uint8_t u8g_filled_ellipse(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rx, u8g_uint_t ry, uint8_t option, u8g_edge_t *e)
 {
   u8g_uint_t x, y;
+  u8g_uint_t x1, y1, x2, y2;
   u8g_long_t xchg, ychg;
   u8g_long_t err;
   u8g_long_t rxrx2;
@@ -314,9 +330,13 @@ void u8g_draw_filled_ellipse(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_
   stopx *= rx;
   stopy = 0;
   
+  x1 = x;
+  y1 = y;
   while( stopx >= stopy )
   {
-    u8g_draw_filled_ellipse_section(u8g, x, y, x0, y0, option);
+    u8g_draw_filled_ellipse_section(u8g, x, y, x0, y0, option, e);
+    x1 = x;
+    y1 = y;
     y++;
     stopy += rxrx2;
     err += ychg;
@@ -350,9 +370,14 @@ void u8g_draw_filled_ellipse(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_
   stopy *= ry;
   
 
+  x2 = 0;
+  y2 = y;
   while( stopx <= stopy )
   {
-    u8g_draw_filled_ellipse_section(u8g, x, y, x0, y0, option);
+    u8g_draw_filled_ellipse_section(u8g, x, y, x0, y0, option, e);
+    x2 = x;
+    if ( (u8g_uint_t)(x+1) == x1 )
+      y2 = y;
     x++;
     stopx += ryry2;
     err += xchg;
@@ -366,10 +391,62 @@ void u8g_draw_filled_ellipse(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_
     }
   }
   
+  if ( x1 == 0 )
+    return 1;
+  if ( (u8g_uint_t)(x2+1) < x1 )
+    return 0;
+  return y2 >= y1;
 }
 
+void u8g_draw_filled_ellipse(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rx, u8g_uint_t ry, uint8_t option)
+{
+  u8g_filled_ellipse(u8g, x0, y0, rx, ry, option, NULL);
+}
+
+#if defined(U8G_WITH_EDGE_TABLE)
+/* draw with the edge table (u8g_edge.c), returns 0 if the table can not be used */
+static uint8_t u8g_draw_filled_ellipse_edge(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rx, u8g_uint_t ry, uint8_t option)
+{
+  pg_word_t key[5];
+  u8g_edge_t *e;
+  
+  /* the rows of the table can not wrap around */
+  if ( x0 < rx || y0 < ry )
+    return 0;
+  if ( (u8g_uint_t)(x0 + rx) < x0 || (u8g_uint_t)(y0 + ry) < y0 )
+    return 0;
+  
+  key[0] = x0;
+  key[1] = y0;
+  key[2] = rx;
+  key[3] = ry;
+  key[4] = option;
+  e = u8g_edge_Find(u8g, U8G_EDGE_FILLED_ELLIPSE, key, 5);
+  if ( e == NULL )
+  {
+    e = u8g_edge_New(u8g, U8G_EDGE_FILLED_ELLIPSE, key, 5, y0 - ry, 2 * ry + 1);
+    if ( e == NULL )
+      return 0;
+    if ( u8g_filled_ellipse(u8g, x0, y0, rx, ry, option, e) != 0 )
+      u8g_edge_SetQuadrants(e, x0, option);
+    else
+      u8g_edge_Discard(u8g, e);
+  }
+  if ( e->h < 0 )
+    return 0;
+  u8g_edge_Draw(u8g, e);
+  return 1;
+}
+#endif
+
 void u8g_DrawFilledEllipse(u8g_t *u8g, u8g_uint_t x0, u8g_uint_t y0, u8g_uint_t rx, u8g_uint_t ry, uint8_t option)
 {
+#if defined(U8G_WITH_EDGE_TABLE)
+  if ( u8g->edge_table != NULL )
+    if ( u8g_draw_filled_ellipse_edge(u8g, x0, y0, rx, ry, option) != 0 )
+      return;
+#endif
+  
   /* check for bounding box */
   {
     u8g_uint_t rxp, rxp2;
@@ -120,6 +120,7 @@ static uint8_t u8g_font_GetFontGlyphStructureSize(const u8g_fntpgm_uint8_t *font
     case 0: return 6;
     case 1: return 3;
     case 2: return 6;
+    case 3: return 7;
   }
   return 3;
 }
@@ -282,6 +283,7 @@ static void u8g_CopyGlyphDataToCache(u8g_t *u8g, u8g_glyph_t g)
   {
     case 0:
     case 2:
+    case 3:
   /*
     format 0
     glyph information 
@@ -293,6 +295,11 @@ static void u8g_CopyGlyphDataToCache(u8g_t *u8g, u8g_glyph_t g)
     4             BBX xoffset                                    signed
     5             BBX yoffset                                    signed
   byte 0 == 255 indicates empty glyph
+  
+    format 3 (run length encoded bitmap, see u8g_draw_rle_glyph)
+    offset 0..5 as format 0, but data size is the size of the run length data
+    6             bits per 0-run                          unsigned --> upper 4 Bit
+    6             bits per 1-run                          unsigned --> lower 4 Bit
   */
       u8g->glyph_width =  u8g_pgm_read( ((u8g_pgm_uint8_t *)g) + 0 );
       u8g->glyph_height =  u8g_pgm_read( ((u8g_pgm_uint8_t *)g) + 1 );
@@ -343,6 +350,74 @@ static void u8g_FillEmptyGlyphCache(u8g_t *u8g)
   u8g->glyph_y = 0;
 }
 
+#if defined(U8G_WITH_GLYPH_TABLE)
+/*
+  Walk through all glyphs of the current font once and store the offset of each glyph
+  (relative to the start of the font) in u8g->glyph_table. Entry 0 belongs to the
+  start encoding of the font. An offset of 0 marks an empty glyph.
+*/
+static void u8g_FillGlyphTable(u8g_t *u8g)
+{
+  const u8g_pgm_uint8_t *font = u8g->font;
+  uint8_t *p = (uint8_t *)font;
+  uint8_t data_structure_size;
+  uint8_t mask = 255;
+  uint8_t start, end;
+  uint16_t i, cnt;
+
+  u8g->glyph_table_font = NULL;
+  if ( u8g->glyph_table == NULL || font == NULL )
+    return;
+    
+  if ( u8g_font_GetFormat(font) == 1 )
+    mask = 15;
+  data_structure_size = u8g_font_GetFontGlyphStructureSize(font);
+  start = u8g_font_GetFontStartEncoding(font);
+  end = u8g_font_GetFontEndEncoding(font);
+  
+  cnt = 0;
+  if ( start <= end )
+    cnt = (uint16_t)(end - start) + 1;
+  if ( cnt > u8g->glyph_table_cnt )
+    cnt = u8g->glyph_table_cnt;
+  
+  p += U8G_FONT_DATA_STRUCT_SIZE;       /* skip font general information */  
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( u8g_pgm_read((u8g_pgm_uint8_t *)(p)) == 255 )
+    {
+      u8g->glyph_table[i] = 0;
+      p += 1;
+    }
+    else
+    {
+      u8g->glyph_table[i] = (uint16_t)(p - (uint8_t *)font);
+      p += u8g_pgm_read( ((u8g_pgm_uint8_t *)(p)) + 2 ) & mask;
+      p += data_structure_size;
+    }
+  }
+  for( ; i < u8g->glyph_table_cnt; i++ )
+    u8g->glyph_table[i] = 0;
+  
+  u8g->glyph_table_font = font;
+}
+
+/*
+  Provide RAM for a glyph lookup table: u8g_GetGlyph() becomes a direct access
+  instead of a linear search through the font.
+  table must have cnt entries, cnt should be end encoding - start encoding + 1
+  of the largest font (at most 256). Glyphs behind the table are searched as before.
+  The table is filled again with each u8g_SetFont() for a different font.
+  Use table = NULL to remove the table.
+*/
+void u8g_SetFontGlyphTable(u8g_t *u8g, uint16_t *table, uint16_t cnt)
+{
+  u8g->glyph_table = table;
+  u8g->glyph_table_cnt = table == NULL ? 0 : cnt;
+  u8g_FillGlyphTable(u8g);
+}
+#endif
+
 /*
   Find (with some speed optimization) and return a pointer to the glyph data structure
   Also uncompress (format 1) and copy the content of the data structure to the u8g structure
@@ -363,6 +438,26 @@ u8g_glyph_t u8g_GetGlyph(u8g_t *u8g, uint8_t requested_encoding)
   start = u8g_font_GetFontStartEncoding(u8g->font);
   end = u8g_font_GetFontEndEncoding(u8g->font);
 
+#if defined(U8G_WITH_GLYPH_TABLE)
+  /* direct access, if the table has been filled for this font */
+  if ( u8g->glyph_table_font == u8g->font && requested_encoding >= start )
+  {
+    pos = requested_encoding - start;
+    if ( pos < u8g->glyph_table_cnt )
+    {
+      pos = u8g->glyph_table[pos];
+      if ( pos == 0 )
+      {
+        u8g_FillEmptyGlyphCache(u8g);
+        return NULL;
+      }
+      p += pos;
+      u8g_CopyGlyphDataToCache(u8g, p);
+      return p;
+    }
+  }
+#endif
+
   pos = u8g_font_GetEncoding97Pos(u8g->font);
   if ( requested_encoding >= 97 && pos > 0 )
   {
@@ -561,19 +656,166 @@ int8_t u8g_DrawGlyphDir(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t dir, uin
 }
 #endif
 
+/*
+  format 3: run length encoded glyph bitmap
+  
+  The glyph bitmap (rows from top to bottom, pixels from left to right) is 
+  a sequence of alternating runs of 0 and 1 pixels. Runs may continue 
+  into the next row. The data is a bit stream (LSB of the first byte first)
+  of run pairs:
+    m0 bits     number of 0 pixels
+    m1 bits     number of 1 pixels
+    1 bit       1: draw the same pair again, followed by another repeat bit
+                0: next pair
+  m0 and m1 (1..8) are stored per glyph. Trailing 0 pixels are not stored,
+  the remaining bits of the last byte are 0 (pairs without pixels).
+  
+  Each run of 1 pixels is drawn as a line, which the page buffer fills with 
+  U8G_DEV_MSG_SET_BOX (see u8g_draw_hline, U8G_WITH_SET_BOX) instead of 8 pixel
+  blocks.
+  Runs outside of the current page are skipped, decoding stops after the
+  last row inside the current page.
+*/
+
+struct _u8g_font_rle_t
+{
+  const u8g_pgm_uint8_t *data;
+  uint8_t byte;
+  uint8_t bit_pos;            /* 0..8, number of used bits in byte */
+};
+typedef struct _u8g_font_rle_t u8g_font_rle_t;
+
+static uint8_t u8g_font_rle_get_bits(u8g_font_rle_t *rle, uint8_t cnt)
+{
+  uint8_t val;
+  uint8_t bit_pos = rle->bit_pos;
+  
+  val = rle->byte >> bit_pos;
+  bit_pos += cnt;
+  if ( bit_pos > 8 )
+  {
+    rle->data++;
+    rle->byte = u8g_pgm_read(rle->data);
+    val |= rle->byte << (8 - rle->bit_pos);
+    bit_pos -= 8;
+  }
+  rle->bit_pos = bit_pos;
+  return val & ((1 << cnt) - 1);
+}
+
+/* draw a run of 1 pixels, x/y is the position of the upper left pixel of the (unrotated) glyph */
+static void u8g_font_rle_draw_run(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t dir, uint8_t col, uint8_t row, uint8_t len)
+{
+  switch(dir)
+  {
+    case 0:
+      u8g_DrawHLine(u8g, x+col, y+row, len);
+      break;
+    case 1:
+      u8g_DrawVLine(u8g, x-row, y+col, len);
+      break;
+    case 2:
+      x -= col;
+      x -= len;
+      x++;
+      u8g_DrawHLine(u8g, x, y-row, len);
+      break;
+    default:
+      y -= col;
+      y -= len;
+      y++;
+      u8g_DrawVLine(u8g, x+row, y, len);
+      break;
+  }
+}
+
+static void u8g_draw_rle_glyph(u8g_t *u8g, u8g_glyph_t g, u8g_uint_t x, u8g_uint_t y, uint8_t dir)
+{
+  u8g_font_rle_t rle;
+  uint8_t w = u8g->glyph_width;
+  uint8_t h = u8g->glyph_height;
+  uint8_t m0, m1;
+  uint16_t bits;
+  uint16_t col;
+  uint8_t row, row_end;
+  u8g_uint_t tmp;
+  uint8_t a, b, n, len;
+  
+  if ( w == 0 )
+    return;
+  a = u8g_pgm_read( ((u8g_pgm_uint8_t *)g) + 6 );
+  m0 = a >> 4;
+  m1 = a & 15;
+  bits = u8g_pgm_read( ((u8g_pgm_uint8_t *)g) + 2 );
+  bits *= 8;
+  
+  rle.data = u8g_font_GetGlyphDataStart(u8g->font, g);
+  rle.byte = u8g_pgm_read(rle.data);
+  rle.bit_pos = 0;
+  
+  /* rows behind the current page are not decoded */
+  switch(dir)
+  {
+    case 0: tmp = u8g->current_page.y1 - y; break;
+    case 1: tmp = x - u8g->current_page.x0; break;
+    case 2: tmp = y - u8g->current_page.y0; break;
+    default: tmp = u8g->current_page.x1 - x; break;
+  }
+  row_end = h;
+  if ( tmp < h )
+    row_end = tmp + 1;
+  
+  col = 0;
+  row = 0;
+  while( bits > m0 + m1 && row < row_end )
+  {
+    a = u8g_font_rle_get_bits(&rle, m0);
+    b = u8g_font_rle_get_bits(&rle, m1);
+    bits -= m0 + m1;
+    for(;;)
+    {
+      col += a;
+      while( col >= w )
+      {
+        col -= w;
+        row++;
+      }
+      len = b;
+      while( len > 0 && row < row_end )
+      {
+        n = w - col;
+        if ( n > len )
+          n = len;
+        u8g_font_rle_draw_run(u8g, x, y, dir, col, row, n);
+        len -= n;
+        col += n;
+        if ( col >= w )
+        {
+          col = 0;
+          row++;
+        }
+      }
+      bits--;
+      if ( u8g_font_rle_get_bits(&rle, 1) == 0 )
+        break;
+      if ( bits == 0 )
+        return;
+    }
+  }
+}
+
 int8_t u8g_draw_glyph(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t encoding)
 {
   const u8g_pgm_uint8_t *data;
+  u8g_glyph_t g;
   uint8_t w, h;
   uint8_t i, j;
   u8g_uint_t ix, iy;
 
-  {
-    u8g_glyph_t g = u8g_GetGlyph(u8g, encoding);
-    if ( g == NULL  )
-      return 0;
-    data = u8g_font_GetGlyphDataStart(u8g->font, g);
-  }
+  g = u8g_GetGlyph(u8g, encoding);
+  if ( g == NULL  )
+    return 0;
+  data = u8g_font_GetGlyphDataStart(u8g->font, g);
   
   w = u8g->glyph_width;
   h = u8g->glyph_height;
@@ -585,6 +827,12 @@ int8_t u8g_draw_glyph(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t encoding)
   if ( u8g_IsBBXIntersection(u8g, x, y-h+1, w, h) == 0 )
     return u8g->glyph_dx;
 
+  if ( u8g_font_GetFormat(u8g->font) == 3 )
+  {
+    u8g_draw_rle_glyph(u8g, g, x, y-h+1, 0);
+    return u8g->glyph_dx;
+  }
+
   /* now, w is reused as bytes per line */
   w += 7;
   w /= 8;
@@ -616,16 +864,15 @@ int8_t u8g_DrawGlyph(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t encoding)
 int8_t u8g_draw_glyph90(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t encoding)
 {
   const u8g_pgm_uint8_t *data;
+  u8g_glyph_t g;
   uint8_t w, h;
   uint8_t i, j;
   u8g_uint_t ix, iy;
 
-  {
-    u8g_glyph_t g = u8g_GetGlyph(u8g, encoding);
-    if ( g == NULL  )
-      return 0;
-    data = u8g_font_GetGlyphDataStart(u8g->font, g);
-  }
+  g = u8g_GetGlyph(u8g, encoding);
+  if ( g == NULL  )
+    return 0;
+  data = u8g_font_GetGlyphDataStart(u8g->font, g);
   
   w = u8g->glyph_width;
   h = u8g->glyph_height;
@@ -637,6 +884,12 @@ int8_t u8g_draw_glyph90(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t encoding
   if ( u8g_IsBBXIntersection(u8g, x, y, h, w) == 0 )
     return u8g->glyph_dx;
 
+  if ( u8g_font_GetFormat(u8g->font) == 3 )
+  {
+    u8g_draw_rle_glyph(u8g, g, x+h-1, y, 1);
+    return u8g->glyph_dx;
+  }
+
   /* now, w is reused as bytes per line */
   w += 7;
   w /= 8;
@@ -668,16 +921,15 @@ int8_t u8g_DrawGlyph90(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t encoding)
 int8_t u8g_draw_glyph180(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t encoding)
 {
   const u8g_pgm_uint8_t *data;
+  u8g_glyph_t g;
   uint8_t w, h;
   uint8_t i, j;
   u8g_uint_t ix, iy;
 
-  {
-    u8g_glyph_t g = u8g_GetGlyph(u8g, encoding);
-    if ( g == NULL  )
-      return 0;
-    data = u8g_font_GetGlyphDataStart(u8g->font, g);
-  }
+  g = u8g_GetGlyph(u8g, encoding);
+  if ( g == NULL  )
+    return 0;
+  data = u8g_font_GetGlyphDataStart(u8g->font, g);
   
   w = u8g->glyph_width;
   h = u8g->glyph_height;
@@ -689,6 +941,12 @@ int8_t u8g_draw_glyph180(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t encodin
   if ( u8g_IsBBXIntersection(u8g, x-(w-1), y, w, h) == 0 )
     return u8g->glyph_dx;
 
+  if ( u8g_font_GetFormat(u8g->font) == 3 )
+  {
+    u8g_draw_rle_glyph(u8g, g, x, y+h-1, 2);
+    return u8g->glyph_dx;
+  }
+
   /* now, w is reused as bytes per line */
   w += 7;
   w /= 8;
@@ -720,16 +978,15 @@ int8_t u8g_DrawGlyph180(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t encoding
 int8_t u8g_draw_glyph270(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t encoding)
 {
   const u8g_pgm_uint8_t *data;
+  u8g_glyph_t g;
   uint8_t w, h;
   uint8_t i, j;
   u8g_uint_t ix, iy;
 
-  {
-    u8g_glyph_t g = u8g_GetGlyph(u8g, encoding);
-    if ( g == NULL  )
-      return 0;
-    data = u8g_font_GetGlyphDataStart(u8g->font, g);
-  }
+  g = u8g_GetGlyph(u8g, encoding);
+  if ( g == NULL  )
+    return 0;
+  data = u8g_font_GetGlyphDataStart(u8g->font, g);
   
   w = u8g->glyph_width;
   h = u8g->glyph_height;
@@ -742,6 +999,12 @@ int8_t u8g_draw_glyph270(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, uint8_t encodin
     return u8g->glyph_dx;
   
 
+  if ( u8g_font_GetFormat(u8g->font) == 3 )
+  {
+    u8g_draw_rle_glyph(u8g, g, x-h+1, y, 3);
+    return u8g->glyph_dx;
+  }
+
   /* now, w is reused as bytes per line */
   w += 7;
   w /= 8;  
@@ -1429,6 +1692,10 @@ void u8g_SetFont(u8g_t *u8g, const u8g_fntpgm_uint8_t  *font)
   if ( u8g->font != font )
   {
     u8g->font = font;
+#if defined(U8G_WITH_GLYPH_TABLE)
+    if ( u8g->glyph_table != NULL )
+      u8g_FillGlyphTable(u8g);
+#endif
     u8g_UpdateRefHeight(u8g);
     u8g_SetFontPosBaseline(u8g);
   }
@@ -62,6 +62,9 @@ void u8g_FirstPageLL(u8g_t *u8g, u8g_dev_t *dev)
   u8g->state_cb(U8G_STATE_MSG_RESTORE_U8G);
   u8g_call_dev_fn(u8g, dev, U8G_DEV_MSG_PAGE_FIRST, NULL);
   u8g_call_dev_fn(u8g, dev, U8G_DEV_MSG_GET_PAGE_BOX, &(u8g->current_page));
+#if defined(U8G_WITH_EDGE_TABLE)
+  u8g->edge_table_pos = 0;
+#endif
   u8g->state_cb(U8G_STATE_MSG_RESTORE_ENV);
 }
 
@@ -74,6 +77,9 @@ uint8_t u8g_NextPageLL(u8g_t *u8g, u8g_dev_t *dev)
   if ( r != 0 )
   {
     u8g_call_dev_fn(u8g, dev, U8G_DEV_MSG_GET_PAGE_BOX, &(u8g->current_page));
+#if defined(U8G_WITH_EDGE_TABLE)
+    u8g->edge_table_pos = 0;
+#endif
   }
   u8g->state_cb(U8G_STATE_MSG_RESTORE_ENV);
   return r;
@@ -102,6 +108,19 @@ void u8g_Draw8PixelLL(u8g_t *u8g, u8g_dev_t *dev, u8g_uint_t x, u8g_uint_t y, ui
   u8g_call_dev_fn(u8g, dev, U8G_DEV_MSG_SET_8PIXEL, arg);
 }
 
+#if defined(U8G_WITH_SET_BOX)
+/* w > 0, h > 0, the device must support U8G_DEV_MSG_SET_BOX (u8g->is_set_box) */
+void u8g_DrawBoxLL(u8g_t *u8g, u8g_dev_t *dev, u8g_uint_t x, u8g_uint_t y, u8g_uint_t w, u8g_uint_t h)
+{
+  u8g_dev_arg_pixel_t *arg = &(u8g->arg_pixel);
+  arg->x = x;
+  arg->y = y;
+  arg->w = w;
+  arg->h = h;
+  u8g_call_dev_fn(u8g, dev, U8G_DEV_MSG_SET_BOX, arg);
+}
+#endif
+
 void u8g_Draw4TPixelLL(u8g_t *u8g, u8g_dev_t *dev, u8g_uint_t x, u8g_uint_t y, uint8_t dir, uint8_t pixel)
 {
   u8g_dev_arg_pixel_t *arg = &(u8g->arg_pixel);
@@ -150,6 +169,11 @@ void u8g_UpdateDimension(u8g_t *u8g)
   u8g->width = u8g_GetWidthLL(u8g, u8g->dev);
   u8g->height = u8g_GetHeightLL(u8g, u8g->dev);
   u8g->mode = u8g_GetModeLL(u8g, u8g->dev);
+#if defined(U8G_WITH_SET_BOX)
+  /* devices which do not know the message leave is_set_box at 0 */
+  u8g->is_set_box = 0;
+  u8g_call_dev_fn(u8g, u8g->dev, U8G_DEV_MSG_IS_SET_BOX, &(u8g->is_set_box));
+#endif
   /* 9 Dec 2012: u8g_scale.c requires update of current page */
   u8g_call_dev_fn(u8g, u8g->dev, U8G_DEV_MSG_GET_PAGE_BOX, &(u8g->current_page));
 }
@@ -170,6 +194,9 @@ static void u8g_init_data(u8g_t *u8g)
       u8g->pin_list[i] = U8G_PIN_NONE;
   }
 #endif
+#if defined(U8G_WITH_PINLIST) && defined(U8G_HOST)
+  u8g->com_data = NULL;
+#endif
   
   u8g_SetColorIndex(u8g, 1);
 
@@ -179,6 +206,18 @@ static void u8g_init_data(u8g_t *u8g)
   u8g->font_ref_ascent = 0;
   u8g->font_ref_descent = 0;
   u8g->font_line_spacing_factor = 64;           /* 64 = 1.0, 77 = 1.2 line spacing factor */
+  
+#if defined(U8G_WITH_GLYPH_TABLE)
+  u8g->glyph_table = NULL;
+  u8g->glyph_table_cnt = 0;
+  u8g->glyph_table_font = NULL;
+#endif
+#if defined(U8G_WITH_EDGE_TABLE)
+  u8g->edge_table = NULL;
+  u8g->edge_table_cnt = 0;
+  u8g->edge_table_end = 0;
+  u8g->edge_table_pos = 0;
+#endif
   u8g->line_spacing = 0;
   
   u8g->state_cb = u8g_state_dummy_cb;
@@ -394,6 +433,44 @@ uint8_t u8g_NextPage(u8g_t *u8g)
   return u8g_NextPageLL(u8g, u8g->dev);
 }
 
+/*
+  full frame devices (page height = display height, e.g. u8g_dev_ssd1306_128x64_f_i2c)
+  can be used without picture loop:
+    u8g_ClearBuffer(u8g);
+    ... draw procedures ...
+    u8g_SendBuffer(u8g);
+  The buffer is kept after u8g_SendBuffer(), so it is also possible to draw
+  only the changed parts and call u8g_SendBuffer() again.
+  With a paged device, u8g_SendBuffer() will only send the first page.
+*/
+void u8g_ClearBuffer(u8g_t *u8g)
+{
+  u8g_FirstPageLL(u8g, u8g->dev);
+}
+
+void u8g_SendBuffer(u8g_t *u8g)
+{
+  if  ( u8g->cursor_fn != (u8g_draw_cursor_fn)0 )
+  {
+    u8g->cursor_fn(u8g);
+  }
+  u8g_NextPageLL(u8g, u8g->dev);
+}
+
+/*
+  damage tracking: only the changed parts of the display are transfered
+  mem must provide U8G_DAMAGE_SIZE(width, height/8) bytes, e.g. 128 bytes for 128x64
+  NULL disables damage tracking. Each call will force a complete update with the next frame.
+  Only devices which support this will use it (SSD1306 and SH1106 128x64 and 128x32)
+  Requires U8G_WITH_DAMAGE in u8g.h
+*/
+#if defined(U8G_WITH_DAMAGE)
+void u8g_SetDamageTracking(u8g_t *u8g, uint8_t *mem)
+{
+  u8g_call_dev_fn(u8g, u8g->dev, U8G_DEV_MSG_SET_DAMAGE, mem);
+}
+#endif
+
 uint8_t u8g_SetContrast(u8g_t *u8g, uint8_t contrast)
 {
   return u8g_SetContrastLL(u8g, u8g->dev, contrast);
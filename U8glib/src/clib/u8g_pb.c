@@ -189,3 +189,264 @@ uint8_t u8g_pb_WriteBuffer(u8g_pb_t *b, u8g_t *u8g, u8g_dev_t *dev)
   return u8g_WriteSequence(u8g, dev, b->width, b->buf);  
 }
 
+
+/*
+  damage tracking
+  
+  The damage memory holds a 16 bit checksum (CRC-CCITT) for each block of
+  U8G_DAMAGE_BLOCK_WIDTH bytes of each row. A row are the width bytes which
+  are sent together to the display, for vertical 1 bit buffers this is a
+  line of 8 pixel height.
+  0xffff never is stored as checksum, so a reset will force the transfer of all rows.
+  
+  Fletcher checksums do not work here: 0x00 and 0xff (8 pixel off or on)
+  have the same value. The CRC detects all changes of up to three bits 
+  in a block, but as with all checksums, different content might still have
+  the same checksum. u8g_SetDamageTracking() can be called again to force 
+  a complete update.
+  
+  Without U8G_WITH_DAMAGE, u8g_pb_GetDamage() always returns the complete row.
+*/
+
+#if defined(U8G_WITH_DAMAGE)
+void u8g_pb_SetDamage(u8g_pb_t *b, uint8_t *damage)
+{
+  b->damage = damage;
+  u8g_pb_ResetDamage(b);
+}
+
+void u8g_pb_ResetDamage(u8g_pb_t *b)
+{
+  uint16_t cnt;
+  uint8_t *ptr = b->damage;
+  if ( ptr == NULL )
+    return;
+  cnt = U8G_DAMAGE_SIZE(b->width, (b->p.total_height+7)>>3);
+  do
+  {
+    *ptr++ = 0x0ff;
+    cnt--;
+  } while( cnt != 0 );
+}
+#endif
+
+/*
+  row: row number on the display (0 for pixel lines 0..7 of a vertical 1 bit buffer)
+  ptr: the width bytes of this row
+  returns 0 if the row is unchanged since the last call, otherwise the first
+  and last byte of the changed part are stored in x0 and x1.
+  Without damage memory, this returns the complete row.
+*/
+uint8_t u8g_pb_GetDamage(u8g_pb_t *b, uint8_t row, const uint8_t *ptr, u8g_uint_t *x0, u8g_uint_t *x1)
+{
+#if defined(U8G_WITH_DAMAGE)
+  uint8_t *sum;
+  u8g_uint_t start, x, end;
+  uint16_t crc;
+  uint8_t t;
+  uint8_t is_changed = 0;
+#endif
+  
+  *x0 = 0;
+  *x1 = b->width;
+  (*x1)--;
+  
+#if defined(U8G_WITH_DAMAGE)
+  if ( b->damage == NULL )
+    return 1;
+  
+  sum = b->damage;
+  sum += U8G_DAMAGE_SIZE(b->width, row);
+  
+  for( start = 0; start < b->width; start = end )
+  {
+    x = start;
+    end = b->width;
+    if ( end - start > U8G_DAMAGE_BLOCK_WIDTH )	/* no overflow with 8 bit u8g_uint_t */
+      end = start + U8G_DAMAGE_BLOCK_WIDTH;
+    crc = 0x0ffff;
+    do
+    {
+      /* CRC-CCITT (0x1021) without table */
+      t = (crc >> 8) ^ ptr[x];
+      t ^= t >> 4;
+      crc = (crc << 8) ^ ((uint16_t)t << 12) ^ ((uint16_t)t << 5) ^ t;
+      x++;
+    } while( x != end );
+    if ( crc == 0x0ffff )
+      crc--;
+    
+    if ( sum[0] != (uint8_t)crc || sum[1] != (uint8_t)(crc >> 8) )
+    {
+      sum[0] = crc;
+      sum[1] = crc >> 8;
+      if ( is_changed == 0 )
+        *x0 = start;
+      *x1 = end-1;
+      is_changed = 1;
+    }
+    sum += 2;
+  }
+  return is_changed;
+#else
+  return 1;
+#endif
+}
+
+#if defined(U8G_WITH_SET_BOX)
+
+/*
+  U8G_DEV_MSG_SET_BOX
+  
+  u8g_pb_ClipBox() clips the box of arg (x, y, w, h) to the current page
+  and stores the visible part (including x1 and y1) in box.
+  returns 0 if nothing is visible.
+  Like with single pixels, a box which wraps around at the end of the
+  u8g_uint_t range continues at 0.
+*/
+uint8_t u8g_pb_ClipBox(u8g_pb_t *b, const u8g_dev_arg_pixel_t *arg, u8g_box_t *box)
+{
+  box->x0 = arg->x;
+  box->x1 = arg->x;
+  box->x1 += arg->w;
+  box->x1--;
+  if ( box->x1 < box->x0 )
+    box->x0 = 0;
+  if ( box->x0 >= b->width )
+    return 0;
+  if ( box->x1 >= b->width )
+  {
+    box->x1 = b->width;
+    box->x1--;
+  }
+  
+  box->y0 = arg->y;
+  box->y1 = arg->y;
+  box->y1 += arg->h;
+  box->y1--;
+  if ( box->y1 < box->y0 )
+    box->y0 = 0;
+  if ( box->y0 > b->p.page_y1 )
+    return 0;
+  if ( box->y1 < b->p.page_y0 )
+    return 0;
+  if ( box->y0 < b->p.page_y0 )
+    box->y0 = b->p.page_y0;
+  if ( box->y1 > b->p.page_y1 )
+    box->y1 = b->p.page_y1;
+  return 1;
+}
+
+/* 
+  vertical 1 bit buffers: rows of width bytes, bit 0 is the upper pixel
+  one masked write for each byte of the box
+*/
+void u8g_pb_SetBoxV1(u8g_pb_t *b, const u8g_dev_arg_pixel_t *arg)
+{
+  u8g_box_t box;
+  uint8_t *ptr;
+  uint8_t *p;
+  uint8_t row, row_last;
+  uint8_t mask;
+  u8g_uint_t cnt;
+  
+  if ( u8g_pb_ClipBox(b, arg, &box) == 0 )
+    return;
+  box.y0 -= b->p.page_y0;
+  box.y1 -= b->p.page_y0;
+  row = box.y0 >> 3;
+  row_last = box.y1 >> 3;
+  ptr = (uint8_t *)b->buf;
+  ptr += (uint16_t)row * b->width;
+  ptr += box.x0;
+  
+  for(;;)
+  {
+    mask = 0x0ff;
+    if ( row == (box.y0 >> 3) )
+      mask <<= box.y0 & 7;
+    if ( row == row_last )
+      mask &= 0x0ff >> (7 - (box.y1 & 7));
+    
+    p = ptr;
+    cnt = box.x1 - box.x0;
+    cnt++;
+    if ( arg->color )
+    {
+      do
+      {
+        *p++ |= mask;
+        cnt--;
+      } while( cnt != 0 );
+    }
+    else
+    {
+      mask ^= 0x0ff;
+      do
+      {
+        *p++ &= mask;
+        cnt--;
+      } while( cnt != 0 );
+    }
+    
+    if ( row == row_last )
+      break;
+    row++;
+    ptr += b->width;
+  }
+}
+
+/* 
+  horizontal 1 bit buffers: lines of width/8 bytes, bit 7 is the left pixel
+  masked writes for the first and last byte of a line, full bytes in between
+*/
+void u8g_pb_SetBoxH1(u8g_pb_t *b, const u8g_dev_arg_pixel_t *arg)
+{
+  u8g_box_t box;
+  uint8_t *ptr;
+  uint8_t *p;
+  uint8_t left, right, fill;
+  uint8_t cnt, i;
+  uint8_t line_len;
+  u8g_uint_t y;
+  
+  if ( u8g_pb_ClipBox(b, arg, &box) == 0 )
+    return;
+    
+  line_len = b->width >> 3;
+  left = 0x0ff >> (box.x0 & 7);
+  right = 0x0ff << (7 - (box.x1 & 7));
+  cnt = (box.x1 >> 3) - (box.x0 >> 3);		/* number of bytes after the first byte */
+  if ( cnt == 0 )
+    left &= right;
+  fill = 0;
+  if ( arg->color )
+    fill = 0x0ff;
+    
+  ptr = (uint8_t *)b->buf;
+  ptr += (uint16_t)(box.y0 - b->p.page_y0) * line_len;
+  ptr += box.x0 >> 3;
+  y = box.y0;
+  for(;;)
+  {
+    p = ptr;
+    *p = (*p & ~left) | (fill & left);
+    if ( cnt != 0 )
+    {
+      i = cnt;
+      p++;
+      while( i > 1 )
+      {
+        *p++ = fill;
+        i--;
+      }
+      *p = (*p & ~right) | (fill & right);
+    }
+    if ( y == box.y1 )
+      break;
+    y++;
+    ptr += line_len;
+  }
+}
+
+#endif /* U8G_WITH_SET_BOX */
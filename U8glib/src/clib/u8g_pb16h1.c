@@ -174,6 +174,11 @@ uint8_t u8g_dev_pb16h1_base_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *ar
     case U8G_DEV_MSG_SET_PIXEL:
       u8g_pb16h1_SetPixel(pb, (u8g_dev_arg_pixel_t *)arg);
       break;
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_SET_BOX:
+      u8g_pb_SetBoxH1(pb, (u8g_dev_arg_pixel_t *)arg);
+      break;
+#endif
     case U8G_DEV_MSG_INIT:
       break;
     case U8G_DEV_MSG_STOP:
@@ -204,6 +209,11 @@ uint8_t u8g_dev_pb16h1_base_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *ar
       break;
     case U8G_DEV_MSG_SET_XY_CB:
       break;
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_IS_SET_BOX:
+      *((uint8_t *)arg) = 1;
+      break;
+#endif
     case U8G_DEV_MSG_GET_MODE:
       return U8G_MODE_BW;
   }
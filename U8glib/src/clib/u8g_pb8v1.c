@@ -145,8 +145,21 @@ uint8_t u8g_dev_pb8v1_base_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg
     case U8G_DEV_MSG_SET_PIXEL:
         u8g_pb8v1_SetPixel(pb, (u8g_dev_arg_pixel_t *)arg);
       break;
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_SET_BOX:
+      u8g_pb_SetBoxV1(pb, (u8g_dev_arg_pixel_t *)arg);
+      break;
+#endif
     case U8G_DEV_MSG_INIT:
+#if defined(U8G_WITH_DAMAGE)
+      u8g_pb_ResetDamage(pb);		/* content of the display is unknown */
+#endif
+      break;
+#if defined(U8G_WITH_DAMAGE)
+    case U8G_DEV_MSG_SET_DAMAGE:
+      u8g_pb_SetDamage(pb, (uint8_t *)arg);
       break;
+#endif
     case U8G_DEV_MSG_STOP:
       break;
     case U8G_DEV_MSG_PAGE_FIRST:
@@ -175,6 +188,11 @@ uint8_t u8g_dev_pb8v1_base_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg
       break;
     case U8G_DEV_MSG_SET_XY_CB:
       break;
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_IS_SET_BOX:
+      *((uint8_t *)arg) = 1;
+      break;
+#endif
     case U8G_DEV_MSG_GET_MODE:
       return U8G_MODE_BW;
   }
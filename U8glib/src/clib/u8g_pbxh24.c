@@ -231,6 +231,40 @@ void u8g_pbxh24_Set4TPixel(u8g_pb_t *b, u8g_dev_arg_pixel_t *arg_pixel)
 }
 
 
+#if defined(U8G_WITH_SET_BOX)
+void u8g_pbxh24_SetBox(u8g_pb_t *b, const u8g_dev_arg_pixel_t *arg)
+{
+  u8g_box_t box;
+  uint8_t *ptr;
+  uint8_t *p;
+  u8g_uint_t cnt;
+  u8g_uint_t y;
+  
+  if ( u8g_pb_ClipBox(b, arg, &box) == 0 )
+    return;
+  ptr = b->buf;
+  ptr += ((uint16_t)(box.y0 - b->p.page_y0) * b->width + box.x0) * 3;
+  y = box.y0;
+  for(;;)
+  {
+    p = ptr;
+    cnt = box.x1 - box.x0;
+    cnt++;
+    do
+    {
+      *p++ = arg->color;
+      *p++ = arg->hi_color;
+      *p++ = arg->blue;
+      cnt--;
+    } while( cnt != 0 );
+    if ( y == box.y1 )
+      break;
+    y++;
+    ptr += b->width*3;
+  }
+}
+#endif
+
 uint8_t u8g_dev_pbxh24_base_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
 {
   u8g_pb_t *pb = (u8g_pb_t *)(dev->dev_mem);
@@ -243,6 +277,11 @@ uint8_t u8g_dev_pbxh24_base_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *ar
     case U8G_DEV_MSG_SET_PIXEL:
       u8g_pbxh24_SetTPixel(pb, (u8g_dev_arg_pixel_t *)arg, 4);
       break;
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_SET_BOX:
+      u8g_pbxh24_SetBox(pb, (u8g_dev_arg_pixel_t *)arg);
+      break;
+#endif
     case U8G_DEV_MSG_SET_4TPIXEL:
       u8g_pbxh24_Set4TPixel(pb, (u8g_dev_arg_pixel_t *)arg);
       break;
@@ -279,6 +318,11 @@ uint8_t u8g_dev_pbxh24_base_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *ar
       break;
     case U8G_DEV_MSG_SET_XY_CB:
       break;
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_IS_SET_BOX:
+      *((uint8_t *)arg) = 1;
+      break;
+#endif
     case U8G_DEV_MSG_GET_MODE:
       return U8G_MODE_TRUECOLOR;
   }
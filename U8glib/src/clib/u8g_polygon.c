@@ -195,6 +195,26 @@ static uint8_t pg_prepare(pg_struct *pg)
   return 1;
 }
 
+static void pg_span(pg_struct *pg, u8g_t *u8g, pg_word_t x, pg_word_t y, pg_word_t w)
+{
+#if defined(U8G_WITH_EDGE_TABLE)
+  u8g_uint_t *span;
+  if ( pg->edge == NULL )
+  {
+    u8g_DrawHLine(u8g, x, y, w);
+    return;
+  }
+  y -= pg->edge->y;
+  if ( y < 0 || y >= pg->edge->h )
+    return;
+  span = U8G_EDGE_SPANS(pg->edge) + y * 2;
+  span[0] = x;
+  span[1] = w;
+#else
+  u8g_DrawHLine(u8g, x, y, w);
+#endif
+}
+
 static void pg_hline(pg_struct *pg, u8g_t *u8g)
 {
   pg_word_t x1, x2, y;
@@ -216,7 +236,7 @@ static void pg_hline(pg_struct *pg, u8g_t *u8g)
       x1 = 0;
     if ( x2 >= u8g_GetWidth(u8g) )
       x2 = u8g_GetWidth(u8g);
-    u8g_DrawHLine(u8g, x1, y, x2 - x1);
+    pg_span(pg, u8g, x1, y, x2 - x1);
   }
   else
   {
@@ -228,7 +248,7 @@ static void pg_hline(pg_struct *pg, u8g_t *u8g)
       x1 = 0;
     if ( x1 >= u8g_GetWidth(u8g) )
       x1 = u8g_GetWidth(u8g);
-    u8g_DrawHLine(u8g, x2, y, x1 - x2);
+    pg_span(pg, u8g, x2, y, x1 - x2);
   }
 }
 
@@ -299,10 +319,59 @@ void pg_AddPolygonXY(pg_struct *pg, u8g_t *u8g, int16_t x, int16_t y)
   }
 }
 
+#if defined(U8G_WITH_EDGE_TABLE)
+/* draw with the edge table (u8g_edge.c), returns 0 if the table can not be used */
+static uint8_t pg_draw_edge(pg_struct *pg, u8g_t *u8g)
+{
+  pg_word_t key[U8G_EDGE_KEY_LEN];
+  pg_word_t y, y_end;
+  uint8_t i, len;
+  u8g_edge_t *e;
+  
+  len = 0;
+  for( i = 0; i < pg->cnt; i++ )
+  {
+    key[len++] = pg->list[i].x;
+    key[len++] = pg->list[i].y;
+  }
+  key[len++] = u8g_GetWidth(u8g);
+  key[len++] = u8g_GetHeight(u8g);
+  
+  e = u8g_edge_Find(u8g, U8G_EDGE_POLYGON, key, len);
+  if ( e == NULL )
+  {
+    /* scan lines of pg_exec(), limited to the display */
+    y = pg->list[pg->pge[PG_LEFT].curr_idx].y;
+    y += pg->is_min_y_not_flat;
+    y_end = y + pg->total_scan_line_cnt;
+    if ( y < 0 )
+      y = 0;
+    if ( y_end > u8g_GetHeight(u8g) )
+      y_end = u8g_GetHeight(u8g);
+    if ( y_end < y )
+      y_end = y;
+    e = u8g_edge_New(u8g, U8G_EDGE_POLYGON, key, len, y, y_end - y);
+    if ( e == NULL )
+      return 0;
+    pg->edge = e;
+    pg_exec(pg, u8g);
+    pg->edge = NULL;
+  }
+  u8g_edge_Draw(u8g, e);
+  return 1;
+}
+#endif
+
 void pg_DrawPolygon(pg_struct *pg, u8g_t *u8g)
 {
   if ( pg_prepare(pg) == 0 )
     return;
+#if defined(U8G_WITH_EDGE_TABLE)
+  pg->edge = NULL;
+  if ( u8g->edge_table != NULL )
+    if ( pg_draw_edge(pg, u8g) != 0 )
+      return;
+#endif
   pg_exec(pg, u8g);
 }
 
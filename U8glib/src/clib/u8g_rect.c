@@ -41,6 +41,15 @@
 void u8g_draw_hline(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t w)
 {
   uint8_t pixel = 0x0ff;
+#if defined(U8G_WITH_SET_BOX)
+  if ( u8g->is_set_box )
+  {
+    /* the page buffer fills the line with masked byte writes */
+    if ( w != 0 )
+      u8g_DrawBoxLL(u8g, u8g->dev, x, y, w, 1);
+    return;
+  }
+#endif
   while( w >= 8 )
   {
     u8g_Draw8Pixel(u8g, x, y, 0, pixel);
@@ -59,6 +68,14 @@ void u8g_draw_hline(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t w)
 void u8g_draw_vline(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t h)
 {
   uint8_t pixel = 0x0ff;
+#if defined(U8G_WITH_SET_BOX)
+  if ( u8g->is_set_box )
+  {
+    if ( h != 0 )
+      u8g_DrawBoxLL(u8g, u8g->dev, x, y, 1, h);
+    return;
+  }
+#endif
   while( h >= 8 )
   {
     u8g_Draw8Pixel(u8g, x, y, 1, pixel);
@@ -109,6 +126,17 @@ void u8g_DrawFrame(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t w, u8g_uin
 
 void u8g_draw_box(u8g_t *u8g, u8g_uint_t x, u8g_uint_t y, u8g_uint_t w, u8g_uint_t h)
 {
+  /* h = 0 happens with u8g_DrawRBox() if h = 2*r+2, the loop below would wrap around */
+  if ( h == 0 )
+    return;
+#if defined(U8G_WITH_SET_BOX)
+  if ( u8g->is_set_box )
+  {
+    if ( w != 0 )
+      u8g_DrawBoxLL(u8g, u8g->dev, x, y, w, h);
+    return;
+  }
+#endif
   do
   { 
     u8g_draw_hline(u8g, x, y, w);
@@ -47,6 +47,19 @@ uint8_t u8g_dev_rot_dummy_fn(u8g_t *u8g, u8g_dev_t*dev, uint8_t msg, void *arg)
 
 u8g_dev_t u8g_dev_rot = { u8g_dev_rot_dummy_fn, NULL, NULL };
 
+/* 
+  size of the device below the rotation, updated with each page, 
+  so that pixel and boxes do not need to ask the device
+*/
+static u8g_uint_t u8g_rot_width;
+static u8g_uint_t u8g_rot_height;
+
+static void u8g_rot_update_size(u8g_t *u8g, u8g_dev_t *rotation_chain)
+{
+  u8g_rot_width = u8g_GetWidthLL(u8g, rotation_chain);
+  u8g_rot_height = u8g_GetHeightLL(u8g, rotation_chain);
+}
+
 
 void u8g_UndoRotation(u8g_t *u8g)
 {
@@ -64,6 +77,7 @@ void u8g_SetRot90(u8g_t *u8g)
     u8g->dev = &u8g_dev_rot;
   }
   u8g_dev_rot.dev_fn = u8g_dev_rot90_fn;
+  u8g_rot_update_size(u8g, u8g_dev_rot.dev_mem);
   u8g_UpdateDimension(u8g);
 }
 
@@ -75,6 +89,7 @@ void u8g_SetRot180(u8g_t *u8g)
     u8g->dev = &u8g_dev_rot;
   }
   u8g_dev_rot.dev_fn = u8g_dev_rot180_fn;
+  u8g_rot_update_size(u8g, u8g_dev_rot.dev_mem);
   u8g_UpdateDimension(u8g);
 }
 
@@ -86,6 +101,7 @@ void u8g_SetRot270(u8g_t *u8g)
     u8g->dev = &u8g_dev_rot;
   }
   u8g_dev_rot.dev_fn = u8g_dev_rot270_fn;
+  u8g_rot_update_size(u8g, u8g_dev_rot.dev_mem);
   u8g_UpdateDimension(u8g);
 }
 
@@ -132,8 +148,13 @@ uint8_t u8g_dev_rot90_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
       }
       return u8g_call_dev_fn(u8g, rotation_chain, msg, arg);
 #endif /* U8G_DEV_MSG_IS_BBX_INTERSECTION */
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_IS_SET_BOX:
+      return u8g_call_dev_fn(u8g, rotation_chain, msg, arg);	/* boxes are rotated, see U8G_DEV_MSG_SET_BOX */
+#endif
     case U8G_DEV_MSG_GET_PAGE_BOX:
       /* get page size from next device in the chain */
+      u8g_rot_update_size(u8g, rotation_chain);
       u8g_call_dev_fn(u8g, rotation_chain, msg, arg);
       //printf("pre x: %3d..%3d y: %3d..%3d   ", ((u8g_box_t *)arg)->x0, ((u8g_box_t *)arg)->x1, ((u8g_box_t *)arg)->y0, ((u8g_box_t *)arg)->y1);
       {
@@ -155,12 +176,31 @@ uint8_t u8g_dev_rot90_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
     case U8G_DEV_MSG_GET_HEIGHT:
       *((u8g_uint_t *)arg) = u8g_GetWidthLL(u8g, rotation_chain);
       break;
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_SET_BOX:
+      {
+        u8g_uint_t x, y, tmp;
+        y = ((u8g_dev_arg_pixel_t *)arg)->x;
+        x = u8g_rot_width;
+        x -= ((u8g_dev_arg_pixel_t *)arg)->y; 
+        x -= ((u8g_dev_arg_pixel_t *)arg)->h; 
+        ((u8g_dev_arg_pixel_t *)arg)->x = x;
+        ((u8g_dev_arg_pixel_t *)arg)->y = y;
+        
+        /* swap box dimensions */        
+        tmp = ((u8g_dev_arg_pixel_t *)arg)->w;
+        ((u8g_dev_arg_pixel_t *)arg)->w = ((u8g_dev_arg_pixel_t *)arg)->h;
+        ((u8g_dev_arg_pixel_t *)arg)->h = tmp;
+      }
+      u8g_call_dev_fn(u8g, rotation_chain, msg, arg);
+      break;
+#endif
     case U8G_DEV_MSG_SET_PIXEL:
     case U8G_DEV_MSG_SET_TPIXEL:
       {
         u8g_uint_t x, y;
         y = ((u8g_dev_arg_pixel_t *)arg)->x;
-        x = u8g_GetWidthLL(u8g, rotation_chain);
+        x = u8g_rot_width;
         x -= ((u8g_dev_arg_pixel_t *)arg)->y; 
         x--;
         ((u8g_dev_arg_pixel_t *)arg)->x = x;
@@ -174,7 +214,7 @@ uint8_t u8g_dev_rot90_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
         u8g_uint_t x, y;
 	//uint16_t x,y;
         y = ((u8g_dev_arg_pixel_t *)arg)->x;
-        x = u8g_GetWidthLL(u8g, rotation_chain);
+        x = u8g_rot_width;
         x -= ((u8g_dev_arg_pixel_t *)arg)->y; 
         x--;
         ((u8g_dev_arg_pixel_t *)arg)->x = x;
@@ -233,8 +273,13 @@ uint8_t u8g_dev_rot180_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
       }
       return u8g_call_dev_fn(u8g, rotation_chain, msg, arg);
 #endif /* U8G_DEV_MSG_IS_BBX_INTERSECTION */
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_IS_SET_BOX:
+      return u8g_call_dev_fn(u8g, rotation_chain, msg, arg);	/* boxes are rotated, see U8G_DEV_MSG_SET_BOX */
+#endif
     case U8G_DEV_MSG_GET_PAGE_BOX:
       /* get page size from next device in the chain */
+      u8g_rot_update_size(u8g, rotation_chain);
       u8g_call_dev_fn(u8g, rotation_chain, msg, arg);
       //printf("pre x: %3d..%3d y: %3d..%3d   ", ((u8g_box_t *)arg)->x0, ((u8g_box_t *)arg)->x1, ((u8g_box_t *)arg)->y0, ((u8g_box_t *)arg)->y1);
       {
@@ -254,16 +299,35 @@ uint8_t u8g_dev_rot180_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
     case U8G_DEV_MSG_GET_HEIGHT:
       *((u8g_uint_t *)arg) = u8g_GetHeightLL(u8g, rotation_chain);
       break;
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_SET_BOX:
+      {
+        u8g_uint_t x, y;
+        
+        y = u8g_rot_height;
+        y -= ((u8g_dev_arg_pixel_t *)arg)->y; 
+        y -= ((u8g_dev_arg_pixel_t *)arg)->h; 
+        
+        x = u8g_rot_width;
+        x -= ((u8g_dev_arg_pixel_t *)arg)->x; 
+        x -= ((u8g_dev_arg_pixel_t *)arg)->w; 
+        
+        ((u8g_dev_arg_pixel_t *)arg)->x = x;
+        ((u8g_dev_arg_pixel_t *)arg)->y = y;
+      }
+      u8g_call_dev_fn(u8g, rotation_chain, msg, arg);
+      break;
+#endif
     case U8G_DEV_MSG_SET_PIXEL:
     case U8G_DEV_MSG_SET_TPIXEL:
       {
         u8g_uint_t x, y;
 
-        y = u8g_GetHeightLL(u8g, rotation_chain);
+        y = u8g_rot_height;
         y -= ((u8g_dev_arg_pixel_t *)arg)->y; 
         y--;
         
-        x = u8g_GetWidthLL(u8g, rotation_chain);
+        x = u8g_rot_width;
         x -= ((u8g_dev_arg_pixel_t *)arg)->x; 
         x--;
         
@@ -277,11 +341,11 @@ uint8_t u8g_dev_rot180_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
       {
         u8g_uint_t x, y;
         
-        y = u8g_GetHeightLL(u8g, rotation_chain);
+        y = u8g_rot_height;
         y -= ((u8g_dev_arg_pixel_t *)arg)->y; 
         y--;
         
-        x = u8g_GetWidthLL(u8g, rotation_chain);
+        x = u8g_rot_width;
         x -= ((u8g_dev_arg_pixel_t *)arg)->x; 
         x--;
         
@@ -340,8 +404,13 @@ uint8_t u8g_dev_rot270_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
       }
       return u8g_call_dev_fn(u8g, rotation_chain, msg, arg);
 #endif /* U8G_DEV_MSG_IS_BBX_INTERSECTION */
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_IS_SET_BOX:
+      return u8g_call_dev_fn(u8g, rotation_chain, msg, arg);	/* boxes are rotated, see U8G_DEV_MSG_SET_BOX */
+#endif
     case U8G_DEV_MSG_GET_PAGE_BOX:
       /* get page size from next device in the chain */
+      u8g_rot_update_size(u8g, rotation_chain);
       u8g_call_dev_fn(u8g, rotation_chain, msg, arg);
       //printf("pre x: %3d..%3d y: %3d..%3d   ", ((u8g_box_t *)arg)->x0, ((u8g_box_t *)arg)->x1, ((u8g_box_t *)arg)->y0, ((u8g_box_t *)arg)->y1);
       {
@@ -361,13 +430,34 @@ uint8_t u8g_dev_rot270_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
     case U8G_DEV_MSG_GET_HEIGHT:
       *((u8g_uint_t *)arg) = u8g_GetWidthLL(u8g, rotation_chain);
       break;
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_SET_BOX:
+      {
+        u8g_uint_t x, y, tmp;
+        x = ((u8g_dev_arg_pixel_t *)arg)->y;
+        
+        y = u8g_rot_height;
+        y -= ((u8g_dev_arg_pixel_t *)arg)->x; 
+        y -= ((u8g_dev_arg_pixel_t *)arg)->w; 
+        
+        ((u8g_dev_arg_pixel_t *)arg)->x = x;
+        ((u8g_dev_arg_pixel_t *)arg)->y = y;
+        
+        /* swap box dimensions */        
+        tmp = ((u8g_dev_arg_pixel_t *)arg)->w;
+        ((u8g_dev_arg_pixel_t *)arg)->w = ((u8g_dev_arg_pixel_t *)arg)->h;
+        ((u8g_dev_arg_pixel_t *)arg)->h = tmp;
+      }
+      u8g_call_dev_fn(u8g, rotation_chain, msg, arg);
+      break;
+#endif
     case U8G_DEV_MSG_SET_PIXEL:
     case U8G_DEV_MSG_SET_TPIXEL:
       {
         u8g_uint_t x, y;
         x = ((u8g_dev_arg_pixel_t *)arg)->y;
         
-        y = u8g_GetHeightLL(u8g, rotation_chain);
+        y = u8g_rot_height;
         y -= ((u8g_dev_arg_pixel_t *)arg)->x; 
         y--;
           
@@ -387,7 +477,7 @@ uint8_t u8g_dev_rot270_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
         u8g_uint_t x, y;
         x = ((u8g_dev_arg_pixel_t *)arg)->y;
         
-        y = u8g_GetHeightLL(u8g, rotation_chain);
+        y = u8g_rot_height;
         y -= ((u8g_dev_arg_pixel_t *)arg)->x; 
         y--;
           
@@ -43,6 +43,11 @@ uint8_t u8g_dev_scale_2x2_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
 
 u8g_dev_t u8g_dev_scale = { u8g_dev_scale_2x2_fn, NULL, NULL };
 
+#if defined(U8G_WITH_SET_BOX)
+/* the device below the scaling supports U8G_DEV_MSG_SET_BOX, a pixel is set as 2x2 box */
+static uint8_t u8g_scale_is_set_box;
+#endif
+
 void u8g_UndoScale(u8g_t *u8g)
 {
   if ( u8g->dev != &u8g_dev_scale )
@@ -82,6 +87,18 @@ uint8_t u8g_dev_scale_2x2_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
     case U8G_DEV_MSG_GET_HEIGHT:
       *((u8g_uint_t *)arg) = u8g_GetHeightLL(u8g, chain) / 2;
       break;
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_IS_SET_BOX:
+      u8g_call_dev_fn(u8g, chain, msg, arg);
+      u8g_scale_is_set_box = *((uint8_t *)arg);
+      return 1;
+    case U8G_DEV_MSG_SET_BOX:
+      ((u8g_dev_arg_pixel_t *)arg)->x *= 2;
+      ((u8g_dev_arg_pixel_t *)arg)->y *= 2;
+      ((u8g_dev_arg_pixel_t *)arg)->w *= 2;
+      ((u8g_dev_arg_pixel_t *)arg)->h *= 2;
+      return u8g_call_dev_fn(u8g, chain, msg, arg);
+#endif
     case U8G_DEV_MSG_GET_PAGE_BOX:
       /* get page size from next device in the chain */
       u8g_call_dev_fn(u8g, chain, msg, arg);
@@ -95,6 +112,16 @@ uint8_t u8g_dev_scale_2x2_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
       x *= 2;
       y = ((u8g_dev_arg_pixel_t *)arg)->y;
       y *= 2;
+#if defined(U8G_WITH_SET_BOX)
+      if ( u8g_scale_is_set_box )
+      {
+        ((u8g_dev_arg_pixel_t *)arg)->x = x;
+        ((u8g_dev_arg_pixel_t *)arg)->y = y;
+        ((u8g_dev_arg_pixel_t *)arg)->w = 2;
+        ((u8g_dev_arg_pixel_t *)arg)->h = 2;
+        return u8g_call_dev_fn(u8g, chain, U8G_DEV_MSG_SET_BOX, arg);
+      }
+#endif
       ((u8g_dev_arg_pixel_t *)arg)->x = x;
       ((u8g_dev_arg_pixel_t *)arg)->y = y;
       u8g_call_dev_fn(u8g, chain, msg, arg);
@@ -34,67 +34,319 @@
   
 */
 
+
 #include "u8g.h"
 
-struct _u8g_vs_t
+/*
+  The virtual screen combines up to U8G_VS_MAX child devices into one
+  larger display. Each virtual screen device (U8G_VS_DEV) has its own 
+  u8g_vs_t in dev_mem, u8g_dev_vs is a predefined virtual screen.
+  
+  U8G_VS_MODE_SEQUENTIAL (default): The picture loop runs for all pages 
+  of the first child, then for all pages of the next child.
+  
+  U8G_VS_MODE_PARALLEL: All children are at the same page index, one pass
+  of the picture loop draws into the page buffers of all children. The 
+  page box of the virtual screen includes the current pages of all children.
+  The children send their pages with U8G_DEV_MSG_PAGE_NEXT. With 
+  U8G_WITH_THREADS, this is done by one thread for each bus. A bus is a 
+  com procedure and, with U8G_WITH_PINLIST, its I2C option and chip select
+  pin (the i2c-dev bus and the spidev channel of the Linux com procedures,
+  which keep their state in the u8g_t of the child). Children on the same
+  bus are sent one after the other.
+*/
+
+U8G_VS_DEV(u8g_dev_vs);
+
+static uint8_t u8g_vs_child_fn(u8g_vs_t *vs, uint8_t i, uint8_t msg, void *arg)
+{
+  return u8g_call_dev_fn(vs->list[i].u8g, vs->list[i].u8g->dev, msg, arg);
+}
+
+static uint8_t u8g_vs_is_same_bus(u8g_t *a, u8g_t *b)
+{
+  if ( a->dev->com_fn != b->dev->com_fn )
+    return 0;
+#if defined(U8G_WITH_PINLIST)
+  if ( a->pin_list[U8G_PI_I2C_OPTION] != b->pin_list[U8G_PI_I2C_OPTION] )
+    return 0;
+  if ( a->pin_list[U8G_PI_CS] != b->pin_list[U8G_PI_CS] )
+    return 0;
+#endif
+  return 1;
+}
+
+/*========================================================================*/
+/* parallel mode */
+
+/* send the current page of all active children on the bus */
+static void u8g_vs_next_bus(u8g_vs_t *vs, uint8_t bus)
+{
+  uint8_t i;
+  for( i = 0; i < vs->cnt; i++ )
+    if ( vs->list[i].bus == bus && vs->list[i].is_active != 0 )
+      vs->list[i].r = u8g_vs_child_fn(vs, i, U8G_DEV_MSG_PAGE_NEXT, NULL);
+}
+
+#if defined(U8G_WITH_THREADS)
+
+static void *u8g_vs_thread(void *arg)
+{
+  struct _u8g_vs_thread_t *t = (struct _u8g_vs_thread_t *)arg;
+  u8g_vs_t *vs = t->vs;
+  
+  for(;;)
+  {
+    pthread_mutex_lock(&(vs->mutex));
+    while( vs->is_stop == 0 && vs->generation == t->generation )
+      pthread_cond_wait(&(vs->cond_start), &(vs->mutex));
+    if ( vs->is_stop != 0 )
+    {
+      pthread_mutex_unlock(&(vs->mutex));
+      return NULL;
+    }
+    t->generation = vs->generation;
+    pthread_mutex_unlock(&(vs->mutex));
+    
+    u8g_vs_next_bus(vs, t->bus);
+    
+    pthread_mutex_lock(&(vs->mutex));
+    vs->busy--;
+    if ( vs->busy == 0 )
+      pthread_cond_signal(&(vs->cond_done));
+    pthread_mutex_unlock(&(vs->mutex));
+  }
+}
+
+/* bus 0 is sent by the calling thread, all other busses get their own thread */
+static void u8g_vs_start_threads(u8g_vs_t *vs)
+{
+  uint8_t i;
+  
+  pthread_mutex_init(&(vs->mutex), NULL);
+  pthread_cond_init(&(vs->cond_start), NULL);
+  pthread_cond_init(&(vs->cond_done), NULL);
+  vs->is_stop = 0;
+  vs->busy = 0;
+  for( i = 0; i+1 < vs->bus_cnt; i++ )
+  {
+    vs->thread[i].vs = vs;
+    vs->thread[i].bus = i+1;
+    vs->thread[i].generation = vs->generation;
+    if ( pthread_create(&(vs->thread[i].thread), NULL, u8g_vs_thread, vs->thread+i) != 0 )
+      break;
+  }
+  vs->thread_cnt = i;
+  vs->is_thread = 1;
+}
+
+static void u8g_vs_stop_threads(u8g_vs_t *vs)
+{
+  uint8_t i;
+  
+  if ( vs->is_thread == 0 )
+    return;
+  pthread_mutex_lock(&(vs->mutex));
+  vs->is_stop = 1;
+  pthread_cond_broadcast(&(vs->cond_start));
+  pthread_mutex_unlock(&(vs->mutex));
+  for( i = 0; i < vs->thread_cnt; i++ )
+    pthread_join(vs->thread[i].thread, NULL);
+  pthread_cond_destroy(&(vs->cond_done));
+  pthread_cond_destroy(&(vs->cond_start));
+  pthread_mutex_destroy(&(vs->mutex));
+  vs->thread_cnt = 0;
+  vs->is_thread = 0;
+}
+
+#endif /* U8G_WITH_THREADS */
+
+static void u8g_vs_next_all(u8g_vs_t *vs)
+{
+  uint8_t bus = 0;
+  
+#if defined(U8G_WITH_THREADS)
+  if ( vs->is_thread == 0 && vs->bus_cnt > 1 )
+    u8g_vs_start_threads(vs);
+  if ( vs->thread_cnt > 0 )
+  {
+    pthread_mutex_lock(&(vs->mutex));
+    vs->busy = vs->thread_cnt;
+    vs->generation++;
+    pthread_cond_broadcast(&(vs->cond_start));
+    pthread_mutex_unlock(&(vs->mutex));
+    
+    /* bus 0 and the busses without thread */
+    u8g_vs_next_bus(vs, 0);
+    for( bus = vs->thread_cnt+1; bus < vs->bus_cnt; bus++ )
+      u8g_vs_next_bus(vs, bus);
+    
+    pthread_mutex_lock(&(vs->mutex));
+    while( vs->busy != 0 )
+      pthread_cond_wait(&(vs->cond_done), &(vs->mutex));
+    pthread_mutex_unlock(&(vs->mutex));
+    return;
+  }
+#endif
+  
+  for( bus = 0; bus < vs->bus_cnt; bus++ )
+    u8g_vs_next_bus(vs, bus);
+}
+
+/* returns 0 if all children have finished their last page */
+static uint8_t u8g_vs_update_active(u8g_vs_t *vs)
+{
+  uint8_t i, r = 0;
+  for( i = 0; i < vs->cnt; i++ )
+  {
+    if ( vs->list[i].is_active != 0 && vs->list[i].r == 0 )
+      vs->list[i].is_active = 0;
+    if ( vs->list[i].is_active != 0 )
+    {
+      u8g_vs_child_fn(vs, i, U8G_DEV_MSG_GET_PAGE_BOX, &(vs->list[i].box));
+      r = 1;
+    }
+  }
+  return r;
+}
+
+/* union of the current pages of all active children */
+static void u8g_vs_get_page_box(u8g_vs_t *vs, u8g_box_t *box)
 {
-  u8g_uint_t x;
-  u8g_uint_t y;
-  u8g_t *u8g;
-};
-typedef struct _u8g_vs_t u8g_vs_t;
-
-#define U8g_VS_MAX 4
-uint8_t u8g_vs_cnt = 0;
-u8g_vs_t u8g_vs_list[U8g_VS_MAX]; 
-uint8_t u8g_vs_current;
-u8g_uint_t u8g_vs_width;
-u8g_uint_t u8g_vs_height;
+  struct _u8g_vs_child_t *c;
+  uint8_t i, is_first = 1;
+  
+  box->x0 = 0;
+  box->x1 = 0;
+  box->y0 = 0;
+  box->y1 = 0;
+  for( i = 0; i < vs->cnt; i++ )
+  {
+    c = vs->list+i;
+    if ( c->is_active == 0 )
+      continue;
+    if ( is_first != 0 || box->x0 > c->box.x0 + c->x )
+      box->x0 = c->box.x0 + c->x;
+    if ( is_first != 0 || box->x1 < c->box.x1 + c->x )
+      box->x1 = c->box.x1 + c->x;
+    if ( is_first != 0 || box->y0 > c->box.y0 + c->y )
+      box->y0 = c->box.y0 + c->y;
+    if ( is_first != 0 || box->y1 < c->box.y1 + c->y )
+      box->y1 = c->box.y1 + c->y;
+    is_first = 0;
+  }
+}
+
+/* 
+  set the pixel (SET_PIXEL, d = 0) or the 8 pixel (SET_8PIXEL, d = 7) of arg
+  in all children, whose current page is at most d pixel away 
+*/
+static void u8g_vs_set_pixel(u8g_vs_t *vs, uint8_t msg, u8g_dev_arg_pixel_t *arg, uint8_t d)
+{
+  struct _u8g_vs_child_t *c;
+  u8g_uint_t x = arg->x;
+  u8g_uint_t y = arg->y;
+  uint8_t i;
+  
+  for( i = 0; i < vs->cnt; i++ )
+  {
+    c = vs->list+i;
+    if ( c->is_active == 0 )
+      continue;
+    arg->x = x - c->x;
+    arg->y = y - c->y;
+    if ( (u8g_uint_t)(arg->x - c->box.x0 + d) > c->box.x1 - c->box.x0 + 2*d )
+      continue;
+    if ( (u8g_uint_t)(arg->y - c->box.y0 + d) > c->box.y1 - c->box.y0 + 2*d )
+      continue;
+    u8g_vs_child_fn(vs, i, msg, arg);
+  }
+  arg->x = x;
+  arg->y = y;
+}
+
+/*========================================================================*/
 
 uint8_t u8g_dev_vs_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
 {
+  u8g_vs_t *vs = (u8g_vs_t *)(dev->dev_mem);
+  
   switch(msg)
   {
     default:
       {
 	uint8_t i;
-	for( i = 0; i < u8g_vs_cnt; i++ )
+	for( i = 0; i < vs->cnt; i++ )
 	{
-	  u8g_call_dev_fn(u8g_vs_list[i].u8g, u8g_vs_list[i].u8g->dev, msg, arg);
+	  u8g_vs_child_fn(vs, i, msg, arg);
 	}
       }
       return 1;
+    case U8G_DEV_MSG_STOP:
+#if defined(U8G_WITH_THREADS)
+      u8g_vs_stop_threads(vs);
+#endif
+      {
+	uint8_t i;
+	for( i = 0; i < vs->cnt; i++ )
+	  u8g_vs_child_fn(vs, i, msg, arg);
+      }
+      return 1;
     case U8G_DEV_MSG_PAGE_FIRST:
-      u8g_vs_current = 0;
-      if ( u8g_vs_cnt != 0 )
-	return u8g_call_dev_fn(u8g_vs_list[u8g_vs_current].u8g, u8g_vs_list[u8g_vs_current].u8g->dev, msg, arg);
+      if ( vs->mode == U8G_VS_MODE_PARALLEL )
+      {
+	uint8_t i;
+	for( i = 0; i < vs->cnt; i++ )
+	{
+	  u8g_vs_child_fn(vs, i, msg, arg);
+	  vs->list[i].is_active = 1;
+	  vs->list[i].r = 1;
+	}
+	return u8g_vs_update_active(vs);
+      }
+      vs->current = 0;
+      if ( vs->cnt != 0 )
+	return u8g_vs_child_fn(vs, vs->current, msg, arg);
       return 0;
     case U8G_DEV_MSG_PAGE_NEXT:
+      if ( vs->mode == U8G_VS_MODE_PARALLEL )
+      {
+	u8g_vs_next_all(vs);
+	return u8g_vs_update_active(vs);
+      }
       {	
 	uint8_t ret = 0;
-	if ( u8g_vs_cnt != 0 )
-	  ret = u8g_call_dev_fn(u8g_vs_list[u8g_vs_current].u8g, u8g_vs_list[u8g_vs_current].u8g->dev, msg, arg);
+	if ( vs->cnt != 0 )
+	  ret = u8g_vs_child_fn(vs, vs->current, msg, arg);
 	if ( ret != 0 )
 	  return ret;
-	u8g_vs_current++;	/* next device */
-	if ( u8g_vs_current >= u8g_vs_cnt )  /* reached end? */
+	vs->current++;	/* next device */
+	if ( vs->current >= vs->cnt )  /* reached end? */
 	  return 0;
-	return u8g_call_dev_fn(u8g_vs_list[u8g_vs_current].u8g, u8g_vs_list[u8g_vs_current].u8g->dev, U8G_DEV_MSG_PAGE_FIRST, arg);	
+	return u8g_vs_child_fn(vs, vs->current, U8G_DEV_MSG_PAGE_FIRST, arg);	
       }
     case U8G_DEV_MSG_GET_WIDTH:
-      *((u8g_uint_t *)arg) = u8g_vs_width;
+      *((u8g_uint_t *)arg) = vs->width;
       break;
     case U8G_DEV_MSG_GET_HEIGHT:
-      *((u8g_uint_t *)arg) = u8g_vs_height;
+      *((u8g_uint_t *)arg) = vs->height;
       break;
+#if defined(U8G_WITH_SET_BOX)
+    case U8G_DEV_MSG_IS_SET_BOX:
+      return 1;		/* boxes are not moved to the child screens, keep the pixel based procedures */
+#endif
     case U8G_DEV_MSG_GET_PAGE_BOX:
-      if ( u8g_vs_current < u8g_vs_cnt )
+      if ( vs->mode == U8G_VS_MODE_PARALLEL )
+      {
+	u8g_vs_get_page_box(vs, (u8g_box_t *)arg);
+      }
+      else if ( vs->current < vs->cnt )
       {
-	u8g_call_dev_fn(u8g_vs_list[u8g_vs_current].u8g, u8g_vs_list[u8g_vs_current].u8g->dev, msg, arg);
-	((u8g_box_t *)arg)->x0 += u8g_vs_list[u8g_vs_current].x;
-	((u8g_box_t *)arg)->x1 += u8g_vs_list[u8g_vs_current].x;
-	((u8g_box_t *)arg)->y0 += u8g_vs_list[u8g_vs_current].y;
-	((u8g_box_t *)arg)->y1 += u8g_vs_list[u8g_vs_current].y;
+	u8g_vs_child_fn(vs, vs->current, msg, arg);
+	((u8g_box_t *)arg)->x0 += vs->list[vs->current].x;
+	((u8g_box_t *)arg)->x1 += vs->list[vs->current].x;
+	((u8g_box_t *)arg)->y0 += vs->list[vs->current].y;
+	((u8g_box_t *)arg)->y1 += vs->list[vs->current].y;
       }
       else
       {
@@ -106,39 +358,73 @@ uint8_t u8g_dev_vs_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg)
       return 1;
     case U8G_DEV_MSG_SET_PIXEL:
     case U8G_DEV_MSG_SET_8PIXEL:
-      if ( u8g_vs_current < u8g_vs_cnt )
+      if ( vs->mode == U8G_VS_MODE_PARALLEL )
+      {
+	u8g_vs_set_pixel(vs, msg, (u8g_dev_arg_pixel_t *)arg, msg == U8G_DEV_MSG_SET_8PIXEL ? 7 : 0);
+      }
+      else if ( vs->current < vs->cnt )
       {
-        ((u8g_dev_arg_pixel_t *)arg)->x -= u8g_vs_list[u8g_vs_current].x;
-        ((u8g_dev_arg_pixel_t *)arg)->y -= u8g_vs_list[u8g_vs_current].y;
-	return u8g_call_dev_fn(u8g_vs_list[u8g_vs_current].u8g, u8g_vs_list[u8g_vs_current].u8g->dev, msg, arg);
+        ((u8g_dev_arg_pixel_t *)arg)->x -= vs->list[vs->current].x;
+        ((u8g_dev_arg_pixel_t *)arg)->y -= vs->list[vs->current].y;
+	return u8g_vs_child_fn(vs, vs->current, msg, arg);
       }
       break;
   }
   return 1;
 }
 
-
-
-u8g_dev_t u8g_dev_vs = { u8g_dev_vs_fn, NULL, NULL };
-
 void u8g_SetVirtualScreenDimension(u8g_t *vs_u8g, u8g_uint_t width, u8g_uint_t height)
 {
-  if ( vs_u8g->dev != &u8g_dev_vs )
+  u8g_vs_t *vs;
+  if ( vs_u8g->dev->dev_fn != u8g_dev_vs_fn )
     return; 	/* abort if there is no a virtual screen device */
-  u8g_vs_width = width;
-  u8g_vs_height = height;  
+  vs = (u8g_vs_t *)(vs_u8g->dev->dev_mem);
+  vs->width = width;
+  vs->height = height;  
 }
 
 uint8_t u8g_AddToVirtualScreen(u8g_t *vs_u8g, u8g_uint_t x, u8g_uint_t y, u8g_t *child_u8g)
 {
-  if ( vs_u8g->dev != &u8g_dev_vs )
+  u8g_vs_t *vs;
+  uint8_t i;
+  if ( vs_u8g->dev->dev_fn != u8g_dev_vs_fn )
     return 0; 	/* abort if there is no a virtual screen device */
-  if ( u8g_vs_cnt >= U8g_VS_MAX )
+  vs = (u8g_vs_t *)(vs_u8g->dev->dev_mem);
+  if ( vs->cnt >= U8G_VS_MAX )
     return 0;  	/* maximum number of  child u8g's reached */
-  u8g_vs_list[u8g_vs_cnt].u8g = child_u8g;
-  u8g_vs_list[u8g_vs_cnt].x = x;
-  u8g_vs_list[u8g_vs_cnt].y = y;
-  u8g_vs_cnt++;
+#if defined(U8G_WITH_THREADS)
+  u8g_vs_stop_threads(vs);	/* the busses are assigned again */
+#endif
+  vs->list[vs->cnt].u8g = child_u8g;
+  vs->list[vs->cnt].x = x;
+  vs->list[vs->cnt].y = y;
+  
+  vs->list[vs->cnt].bus = vs->bus_cnt;
+  for( i = 0; i < vs->cnt; i++ )
+    if ( u8g_vs_is_same_bus(vs->list[i].u8g, child_u8g) )
+    {
+      vs->list[vs->cnt].bus = vs->list[i].bus;
+      break;
+    }
+  if ( vs->list[vs->cnt].bus == vs->bus_cnt )
+    vs->bus_cnt++;
+  vs->cnt++;
   return 1;
 }
 
+/*
+  mode: U8G_VS_MODE_SEQUENTIAL or U8G_VS_MODE_PARALLEL, do not call this inside the picture loop.
+  U8G_VS_MODE_SEQUENTIAL also stops the threads of the parallel mode.
+*/
+void u8g_SetVirtualScreenMode(u8g_t *vs_u8g, uint8_t mode)
+{
+  u8g_vs_t *vs;
+  if ( vs_u8g->dev->dev_fn != u8g_dev_vs_fn )
+    return; 	/* abort if there is no a virtual screen device */
+  vs = (u8g_vs_t *)(vs_u8g->dev->dev_mem);
+#if defined(U8G_WITH_THREADS)
+  u8g_vs_stop_threads(vs);
+#endif
+  vs->mode = mode;
+}
+
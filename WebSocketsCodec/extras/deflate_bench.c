@@ -0,0 +1,178 @@
+/**
+ * @file deflate_bench.c
+ * @date 16.10.2026
+ *
+ * host benchmark for wsdeflate, compresses and inflates a stream of JSON
+ * telemetry messages (the kind a sensor node pushes every few seconds) and
+ * reports per window size, with and without context takeover:
+ *  - compression ratio (raw bytes / bytes on the wire)
+ *  - CPU time per message for ws_deflate_message and ws_inflate_message
+ *  - heap of one connection, idle (both windows) and peak (while a message is compressed or inflated)
+ *
+ * build and run from this directory:
+ *   cc -O2 -I.. deflate_bench.c -o deflate_bench && ./deflate_bench [messages]
+ *
+ * the codec is included below with malloc/calloc/realloc/free counted, so the peak
+ * is exactly what one connection asks for
+ *
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+static size_t heapNow;
+static size_t heapPeak;
+
+void * bench_malloc(size_t size);
+void * bench_calloc(size_t count, size_t size);
+void * bench_realloc(void * ptr, size_t size);
+void bench_free(void * ptr);
+
+void * bench_malloc(size_t size) {
+    size_t * p = (size_t *) malloc(sizeof(size_t) + size);
+    if(!p) {
+        return NULL;
+    }
+    *p = size;
+    heapNow += size;
+    if(heapNow > heapPeak) {
+        heapPeak = heapNow;
+    }
+    return (p + 1);
+}
+
+void * bench_calloc(size_t count, size_t size) {
+    void * p = bench_malloc(count * size);
+    if(p) {
+        memset(p, 0, (count * size));
+    }
+    return p;
+}
+
+void bench_free(void * ptr) {
+    if(ptr) {
+        size_t * p = ((size_t *) ptr - 1);
+        heapNow -= *p;
+        free(p);
+    }
+}
+
+void * bench_realloc(void * ptr, size_t size) {
+    void * n = bench_malloc(size);
+    if(n && ptr) {
+        size_t old = *((size_t *) ptr - 1);
+        memcpy(n, ptr, (old < size) ? old : size);
+    }
+    if(n || !size) {
+        bench_free(ptr);
+    }
+    return n;
+}
+
+#define malloc bench_malloc
+#define calloc bench_calloc
+#define realloc bench_realloc
+#define free bench_free
+#include "../wsdeflate.c"
+#undef malloc
+#undef calloc
+#undef realloc
+#undef free
+
+#define BENCH_MAX_MESSAGE   (512)
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3);
+}
+
+static size_t telemetry(char * out, unsigned int i) {
+    static const char * rooms[] = { "kitchen", "living", "bedroom", "garage" };
+    return (size_t) snprintf(out, BENCH_MAX_MESSAGE,
+            "{\"device\":\"esp-%02u\",\"room\":\"%s\",\"ts\":%u,\"temperature\":%d.%u,\"humidity\":%u,"
+            "\"pressure\":%u,\"rssi\":-%u,\"heap\":%u,\"uptime\":%u,\"status\":\"ok\"}",
+            (i % 4), rooms[i % 4], (1700000000u + i * 5), (18 + (int) ((i * 7) % 9)), ((i * 3) % 10), (35 + (i * 11) % 30),
+            (1000 + (i * 13) % 25), (55 + (i * 5) % 30), (30000 + (i * 97) % 4000), (i * 5));
+}
+
+static int run(unsigned int messages, uint8_t bits, uint8_t noContextTakeover) {
+    ws_deflate_params_t params = { bits, bits, noContextTakeover, noContextTakeover };
+    char message[BENCH_MAX_MESSAGE];
+    size_t raw = 0, wire = 0;
+    double deflateTime = 0, inflateTime = 0;
+    size_t extra = 0;
+
+    // one side compresses, the other one inflates, like the two ends of a connection
+    heapNow = 0;
+    ws_deflate_t * tx = ws_deflate_new(&params);
+    size_t connection = heapNow;
+    ws_deflate_t * rx = ws_deflate_new(&params);
+    if(!tx || !rx) {
+        printf("out of memory\n");
+        return 0;
+    }
+
+    for(unsigned int i = 0; i < messages; i++) {
+        size_t length = telemetry(message, i);
+        size_t outLength = 0, inLength = 0;
+
+        size_t before = heapPeak = heapNow;
+        double start = now_us();
+        uint8_t * deflated = ws_deflate_message(tx, (const uint8_t *) message, length, 14, &outLength);
+        deflateTime += (now_us() - start);
+        if((heapPeak - before) > extra) {
+            extra = (heapPeak - before);
+        }
+
+        raw += length;
+        if(!deflated) {
+            // sent as it is
+            wire += length;
+            continue;
+        }
+        wire += outLength;
+
+        before = heapPeak = heapNow;
+        start = now_us();
+        uint8_t * inflated = ws_inflate_message(rx, (deflated + 14), outLength, BENCH_MAX_MESSAGE, &inLength);
+        inflateTime += (now_us() - start);
+        if((heapPeak - before) > extra) {
+            extra = (heapPeak - before);
+        }
+
+        if(!inflated || inLength != length || memcmp(inflated, message, length) != 0) {
+            printf("round trip FAILED at message %u\n", i);
+            return 0;
+        }
+        bench_free(inflated);
+        bench_free(deflated);
+    }
+
+    ws_deflate_free(tx);
+    ws_deflate_free(rx);
+
+    // state kept by one connection between messages, plus the most a single deflate or inflate call allocated on top
+    printf("%4u %-5s %7.2fx %10.2f %10.2f %9u %9u\n", bits, (noContextTakeover ? "no" : "yes"), ((double) raw / wire),
+            (deflateTime / messages), (inflateTime / messages), (unsigned int) connection, (unsigned int) (connection + extra));
+    return 1;
+}
+
+int main(int argc, char ** argv) {
+    unsigned int messages = (argc > 1) ? (unsigned int) atoi(argv[1]) : 10000;
+    char message[BENCH_MAX_MESSAGE];
+    uint8_t bits[] = { 8, 10, 12, 15 };
+    int ok = 1;
+
+    printf("%u JSON messages, %u byte each\n\n", messages, (unsigned int) telemetry(message, 0));
+    printf("bits ctx     ratio deflate us inflate us  idle RAM  peak RAM\n");
+    for(size_t i = 0; i < sizeof(bits); i++) {
+        ok &= run(messages, bits[i], 0);
+        ok &= run(messages, bits[i], 1);
+    }
+    return ok ? 0 : 1;
+}
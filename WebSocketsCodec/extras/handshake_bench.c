@@ -0,0 +1,127 @@
+/**
+ * @file handshake_bench.c
+ * @date 16.10.2026
+ *
+ * host benchmark for the Sec-WebSocket-Accept computation, reports handshakes
+ * per second for:
+ *  - libsha1 + libb64 the way the libraries did it (key and GUID copied into a
+ *    heap buffer, base64 into a second heap buffer)
+ *  - ws_accept_key
+ * and checks both give the same result for random keys and the RFC 6455 sample
+ *
+ * build and run from this directory:
+ *   cc -O2 -I.. handshake_bench.c -o handshake_bench && ./handshake_bench [handshakes]
+ *
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "../wshandshake.c"
+
+/* the implementations arduinoWebSockets used before wshandshake.c, kept here as reference */
+#include "libsha1/libsha1.c"
+#include "libb64/cencode.c"
+
+#define BENCH_KEY_SIZE  (24)
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3);
+}
+
+static void reference_accept_key(const char * key, size_t length, char * accept) {
+    size_t size = length + sizeof(WS_HANDSHAKE_GUID) - 1;
+    uint8_t hash[20];
+    SHA1_CTX ctx;
+
+    char * buffer = (char *) malloc(size);
+    memcpy(buffer, key, length);
+    memcpy((buffer + length), WS_HANDSHAKE_GUID, (sizeof(WS_HANDSHAKE_GUID) - 1));
+    SHA1Init(&ctx);
+    SHA1Update(&ctx, (const unsigned char *) buffer, size);
+    SHA1Final(hash, &ctx);
+    free(buffer);
+
+    char * base64 = (char *) malloc(33);
+    base64_encodestate state;
+    base64_init_encodestate(&state);
+    int len = base64_encode_block((const char *) hash, 20, base64, &state);
+    base64_encode_blockend((base64 + len), &state);
+    memcpy(accept, base64, strlen(base64) + 1);
+    free(base64);
+}
+
+static void random_key(char * key, unsigned int seed) {
+    uint8_t nonce[16];
+    srand(seed);
+    for(size_t i = 0; i < sizeof(nonce); i++) {
+        nonce[i] = (uint8_t) rand();
+    }
+    ws_base64_encode(nonce, sizeof(nonce), key);
+}
+
+int main(int argc, char ** argv) {
+    unsigned int handshakes = (argc > 1) ? (unsigned int) atoi(argv[1]) : 1000000;
+    char keys[256][BENCH_KEY_SIZE + 1];
+    char accept[WS_ACCEPT_KEY_SIZE];
+    char expected[WS_ACCEPT_KEY_SIZE];
+    unsigned int sum = 0;
+
+    ws_accept_key("dGhlIHNhbXBsZSBub25jZQ==", BENCH_KEY_SIZE, accept);
+    if(strcmp(accept, "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") != 0) {
+        printf("RFC 6455 sample FAILED: %s\n", accept);
+        return 1;
+    }
+
+    for(unsigned int i = 0; i < 256; i++) {
+        random_key(keys[i], i);
+        ws_accept_key(keys[i], BENCH_KEY_SIZE, accept);
+        reference_accept_key(keys[i], BENCH_KEY_SIZE, expected);
+        if(strcmp(accept, expected) != 0) {
+            printf("key %s FAILED: %s != %s\n", keys[i], accept, expected);
+            return 1;
+        }
+    }
+
+    // any length, the message schedule has to handle partial words and a second padding block
+    for(size_t length = 0; length < 200; length++) {
+        char data[200];
+        for(size_t i = 0; i < length; i++) {
+            data[i] = (char) ('a' + (i % 26));
+        }
+        ws_accept_key(data, length, accept);
+        reference_accept_key(data, length, expected);
+        if(strcmp(accept, expected) != 0) {
+            printf("length %u FAILED\n", (unsigned int) length);
+            return 1;
+        }
+    }
+
+    printf("%u handshakes\n\n", handshakes);
+    printf("                  us each  handshakes/s\n");
+
+    double start = now_us();
+    for(unsigned int i = 0; i < handshakes; i++) {
+        reference_accept_key(keys[i & 255], BENCH_KEY_SIZE, accept);
+        sum += (uint8_t) accept[i % 28];
+    }
+    double time = (now_us() - start);
+    printf("libsha1 + libb64 %9.3f %13.0f\n", (time / handshakes), (handshakes / (time / 1e6)));
+
+    start = now_us();
+    for(unsigned int i = 0; i < handshakes; i++) {
+        ws_accept_key(keys[i & 255], BENCH_KEY_SIZE, accept);
+        sum += (uint8_t) accept[i % 28];
+    }
+    time = (now_us() - start);
+    printf("ws_accept_key    %9.3f %13.0f\n", (time / handshakes), (handshakes / (time / 1e6)));
+
+    // keeps the loops from being optimized away
+    return (sum == 0);
+}
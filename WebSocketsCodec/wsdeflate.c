@@ -0,0 +1,894 @@
+/**
+ * @file wsdeflate.c
+ * @date 16.10.2026
+ *
+ * permessage-deflate (RFC 7692) for the WebSocket libraries
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+
+#include "wsdeflate.h"
+
+#define WS_DEFLATE_MIN_MATCH    (3)
+#define WS_DEFLATE_MAX_MATCH    (258)
+#define WS_DEFLATE_HASH_SIZE    (1 << WS_DEFLATE_HASH_BITS)
+
+// tail of a sync flush, removed by the sender and added again by the receiver
+static const uint8_t ws_deflate_tail[4] = { 0x00, 0x00, 0xFF, 0xFF };
+
+static const uint16_t ws_length_base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t ws_length_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t ws_dist_base[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const uint8_t ws_dist_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+/*
+ * negotiation
+ */
+
+/**
+ * find the next "name[=value]" parameter in one extension of a Sec-WebSocket-Extensions value
+ * @return pointer behind the parameter, NULL at the end of the extension (',' or end of string)
+ */
+static const char * ws_deflate_param(const char * p, char * name, size_t nameSize, int * value) {
+    size_t n = 0;
+
+    while(*p == ' ' || *p == '\t' || *p == ';') {
+        p++;
+    }
+    if(*p == 0x00 || *p == ',') {
+        return NULL;
+    }
+
+    while(*p && *p != '=' && *p != ';' && *p != ',' && *p != ' ' && *p != '\t') {
+        if(n < (nameSize - 1)) {
+            name[n++] = *p;
+        }
+        p++;
+    }
+    name[n] = 0x00;
+
+    *value = -1;
+    while(*p == ' ' || *p == '\t') {
+        p++;
+    }
+    if(*p == '=') {
+        p++;
+        while(*p == ' ' || *p == '\t' || *p == '"') {
+            p++;
+        }
+        *value = 0;
+        while(*p >= '0' && *p <= '9') {
+            if(*value < 100) {
+                *value = (*value * 10) + (*p - '0');
+            }
+            p++;
+        }
+        while(*p && *p != ';' && *p != ',') {
+            if(*p != '"' && *p != ' ' && *p != '\t') {
+                // not a number
+                *value = -2;
+            }
+            p++;
+        }
+    }
+    return p;
+}
+
+/**
+ * move to the next extension of a Sec-WebSocket-Extensions value
+ * @return pointer to the extension name, NULL at the end
+ */
+static const char * ws_deflate_next(const char * p) {
+    while(*p && *p != ',') {
+        p++;
+    }
+    if(*p == ',') {
+        p++;
+    }
+    while(*p == ' ' || *p == '\t') {
+        p++;
+    }
+    return (*p ? p : NULL);
+}
+
+/**
+ * check the extension name at p
+ * @return pointer behind the name if it is permessage-deflate
+ */
+static const char * ws_deflate_name(const char * p) {
+    size_t len = strlen(WS_DEFLATE_EXTENSION);
+    if(strncasecmp(p, WS_DEFLATE_EXTENSION, len) != 0) {
+        return NULL;
+    }
+    p += len;
+    while(*p == ' ' || *p == '\t') {
+        p++;
+    }
+    if(*p && *p != ';' && *p != ',') {
+        return NULL;
+    }
+    return p;
+}
+
+static uint8_t ws_deflate_bits(const ws_deflate_config_t * config) {
+    uint8_t bits = config->windowBits;
+    if(bits < WS_DEFLATE_MIN_WINDOW_BITS) {
+        bits = WS_DEFLATE_MIN_WINDOW_BITS;
+    }
+    if(bits > WS_DEFLATE_MAX_WINDOW_BITS) {
+        bits = WS_DEFLATE_MAX_WINDOW_BITS;
+    }
+    return bits;
+}
+
+int ws_deflate_accept(const char * offer, const ws_deflate_config_t * config, ws_deflate_params_t * params, char * response) {
+    uint8_t bits = ws_deflate_bits(config);
+    const char * ext = offer;
+
+    while(ext && *ext == ' ') {
+        ext++;
+    }
+
+    for(; ext && *ext; ext = ws_deflate_next(ext)) {
+        const char * p = ws_deflate_name(ext);
+        if(!p) {
+            continue;
+        }
+
+        int serverBits = WS_DEFLATE_MAX_WINDOW_BITS;
+        int clientBits = -1; ///< -1 client can not limit its window
+        int clientOffered = 0;
+        int serverNoContextTakeover = config->noContextTakeover;
+        int clientNoContextTakeover = config->noContextTakeover;
+        int valid = 1;
+
+        char name[32];
+        int value;
+        while((p = ws_deflate_param(p, name, sizeof(name), &value))) {
+            if(strcasecmp(name, "server_no_context_takeover") == 0 && value == -1) {
+                serverNoContextTakeover = 1;
+            } else if(strcasecmp(name, "client_no_context_takeover") == 0 && value == -1) {
+                clientNoContextTakeover = 1;
+            } else if(strcasecmp(name, "server_max_window_bits") == 0 && value >= WS_DEFLATE_MIN_WINDOW_BITS && value <= WS_DEFLATE_MAX_WINDOW_BITS) {
+                serverBits = value;
+            } else if(strcasecmp(name, "client_max_window_bits") == 0 && (value == -1 || (value >= WS_DEFLATE_MIN_WINDOW_BITS && value <= WS_DEFLATE_MAX_WINDOW_BITS))) {
+                clientBits = ((value == -1) ? WS_DEFLATE_MAX_WINDOW_BITS : value);
+                clientOffered = 1;
+            } else {
+                valid = 0;
+            }
+        }
+
+        if(!valid) {
+            // try the next offer
+            continue;
+        }
+
+        if(serverBits > bits) {
+            serverBits = bits;
+        }
+
+        if(clientBits == -1) {
+            // the client compresses with up to 32KB window, only affordable without context takeover
+            clientBits = WS_DEFLATE_MAX_WINDOW_BITS;
+            if(bits < WS_DEFLATE_MAX_WINDOW_BITS) {
+                clientNoContextTakeover = 1;
+            }
+        } else {
+            if(clientBits > bits) {
+                clientBits = bits;
+            }
+        }
+
+        params->txBits = serverBits;
+        params->rxBits = clientBits;
+        params->txNoContextTakeover = serverNoContextTakeover;
+        params->rxNoContextTakeover = clientNoContextTakeover;
+
+        if(response) {
+            int len = snprintf(response, WS_DEFLATE_HEADER_SIZE, "%s", WS_DEFLATE_EXTENSION);
+            if(serverNoContextTakeover) {
+                len += snprintf(response + len, WS_DEFLATE_HEADER_SIZE - len, "; server_no_context_takeover");
+            }
+            if(clientNoContextTakeover) {
+                len += snprintf(response + len, WS_DEFLATE_HEADER_SIZE - len, "; client_no_context_takeover");
+            }
+            if(serverBits < WS_DEFLATE_MAX_WINDOW_BITS) {
+                len += snprintf(response + len, WS_DEFLATE_HEADER_SIZE - len, "; server_max_window_bits=%d", serverBits);
+            }
+            if(clientOffered && clientBits < WS_DEFLATE_MAX_WINDOW_BITS) {
+                snprintf(response + len, WS_DEFLATE_HEADER_SIZE - len, "; client_max_window_bits=%d", clientBits);
+            }
+        }
+        return 1;
+    }
+    return 0;
+}
+
+void ws_deflate_offer(const ws_deflate_config_t * config, char * offer) {
+    uint8_t bits = ws_deflate_bits(config);
+    int len = snprintf(offer, WS_DEFLATE_HEADER_SIZE, "%s", WS_DEFLATE_EXTENSION);
+    if(config->noContextTakeover) {
+        len += snprintf(offer + len, WS_DEFLATE_HEADER_SIZE - len, "; server_no_context_takeover; client_no_context_takeover");
+    }
+    if(bits < WS_DEFLATE_MAX_WINDOW_BITS) {
+        len += snprintf(offer + len, WS_DEFLATE_HEADER_SIZE - len, "; server_max_window_bits=%d", bits);
+    }
+    snprintf(offer + len, WS_DEFLATE_HEADER_SIZE - len, "; client_max_window_bits=%d", bits);
+}
+
+int ws_deflate_response(const char * response, const ws_deflate_config_t * config, ws_deflate_params_t * params) {
+    uint8_t bits = ws_deflate_bits(config);
+    const char * p = response;
+
+    while(p && *p == ' ') {
+        p++;
+    }
+    if(!p || !*p) {
+        return 0;
+    }
+
+    p = ws_deflate_name(p);
+    if(!p) {
+        // we only offered permessage-deflate
+        return -1;
+    }
+
+    params->txBits = bits;
+    params->rxBits = bits;
+    params->txNoContextTakeover = config->noContextTakeover;
+    params->rxNoContextTakeover = config->noContextTakeover;
+
+    char name[32];
+    int value;
+    while((p = ws_deflate_param(p, name, sizeof(name), &value))) {
+        if(strcasecmp(name, "server_no_context_takeover") == 0 && value == -1) {
+            params->rxNoContextTakeover = 1;
+        } else if(strcasecmp(name, "client_no_context_takeover") == 0 && value == -1) {
+            params->txNoContextTakeover = 1;
+        } else if(strcasecmp(name, "server_max_window_bits") == 0 && value >= WS_DEFLATE_MIN_WINDOW_BITS && value <= bits) {
+            params->rxBits = value;
+        } else if(strcasecmp(name, "client_max_window_bits") == 0 && value >= WS_DEFLATE_MIN_WINDOW_BITS && value <= bits) {
+            params->txBits = value;
+        } else {
+            return -1;
+        }
+    }
+    return 1;
+}
+
+/*
+ * state
+ */
+
+static int ws_deflate_stream_init(ws_deflate_stream_t * stream, uint8_t bits, uint8_t noContextTakeover) {
+    stream->bits = bits;
+    stream->noContextTakeover = noContextTakeover;
+    stream->windowLen = 0;
+    stream->window = NULL;
+    if(!noContextTakeover) {
+        stream->window = (uint8_t *) malloc((size_t) 1 << bits);
+        if(!stream->window) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * keep the last (1 << bits) bytes of history + message for the next message
+ */
+static void ws_deflate_stream_update(ws_deflate_stream_t * stream, const uint8_t * data, size_t length) {
+    size_t size = ((size_t) 1 << stream->bits);
+    if(!stream->window) {
+        return;
+    }
+    if(length >= size) {
+        memcpy(stream->window, (data + length - size), size);
+        stream->windowLen = size;
+    } else {
+        size_t keep = (size - length);
+        if(keep > stream->windowLen) {
+            keep = stream->windowLen;
+        }
+        memmove(stream->window, (stream->window + stream->windowLen - keep), keep);
+        memcpy((stream->window + keep), data, length);
+        stream->windowLen = (keep + length);
+    }
+}
+
+ws_deflate_t * ws_deflate_new(const ws_deflate_params_t * params) {
+    ws_deflate_t * deflate = (ws_deflate_t *) calloc(1, sizeof(ws_deflate_t));
+    if(!deflate) {
+        return NULL;
+    }
+    if(!ws_deflate_stream_init(&deflate->tx, params->txBits, params->txNoContextTakeover) || !ws_deflate_stream_init(&deflate->rx, params->rxBits, params->rxNoContextTakeover)) {
+        ws_deflate_free(deflate);
+        return NULL;
+    }
+    return deflate;
+}
+
+void ws_deflate_free(ws_deflate_t * deflate) {
+    if(!deflate) {
+        return;
+    }
+    free(deflate->tx.window);
+    free(deflate->rx.window);
+    free(deflate);
+}
+
+/*
+ * compressor
+ */
+
+typedef struct {
+        uint8_t * out;
+        size_t pos;
+        size_t size;
+        uint32_t bits;
+        uint8_t count;
+        uint8_t overflow;
+} ws_bit_writer_t;
+
+static void ws_put_bits(ws_bit_writer_t * w, uint32_t value, uint8_t count) {
+    w->bits |= (value << w->count);
+    w->count += count;
+    while(w->count >= 8) {
+        if(w->pos < w->size) {
+            w->out[w->pos++] = (w->bits & 0xFF);
+        } else {
+            w->overflow = 1;
+        }
+        w->bits >>= 8;
+        w->count -= 8;
+    }
+}
+
+/**
+ * huffman codes are stored MSB first
+ */
+static void ws_put_code(ws_bit_writer_t * w, uint16_t code, uint8_t count) {
+    uint16_t reversed = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        reversed = (reversed << 1) | (code & 0x01);
+        code >>= 1;
+    }
+    ws_put_bits(w, reversed, count);
+}
+
+static void ws_put_literal(ws_bit_writer_t * w, uint16_t symbol) {
+    if(symbol < 144) {
+        ws_put_code(w, (0x30 + symbol), 8);
+    } else if(symbol < 256) {
+        ws_put_code(w, (0x190 + symbol - 144), 9);
+    } else if(symbol < 280) {
+        ws_put_code(w, (symbol - 256), 7);
+    } else {
+        ws_put_code(w, (0xC0 + symbol - 280), 8);
+    }
+}
+
+static void ws_put_match(ws_bit_writer_t * w, uint16_t length, uint16_t distance) {
+    uint8_t code = 28;
+    while(ws_length_base[code] > length) {
+        code--;
+    }
+    ws_put_literal(w, (257 + code));
+    if(ws_length_extra[code]) {
+        ws_put_bits(w, (length - ws_length_base[code]), ws_length_extra[code]);
+    }
+
+    code = 29;
+    while(ws_dist_base[code] > distance) {
+        code--;
+    }
+    ws_put_code(w, code, 5);
+    if(ws_dist_extra[code]) {
+        ws_put_bits(w, (distance - ws_dist_base[code]), ws_dist_extra[code]);
+    }
+}
+
+static inline uint16_t ws_deflate_hash(const uint8_t * p) {
+    return ((((uint16_t) p[0] << 10) ^ ((uint16_t) p[1] << 5) ^ p[2]) & (WS_DEFLATE_HASH_SIZE - 1));
+}
+
+uint8_t * ws_deflate_message(ws_deflate_t * deflate, const uint8_t * data, size_t length, size_t headroom, size_t * outLength) {
+    ws_deflate_stream_t * stream = &deflate->tx;
+    size_t windowSize = ((size_t) 1 << stream->bits);
+    size_t start = stream->windowLen;
+    size_t end = (start + length);
+
+    if(length < WS_DEFLATE_MIN_SIZE) {
+        return NULL;
+    }
+
+    // chain links are only needed for the positions in the buffer
+    size_t prevSize = 64;
+    while(prevSize < end && prevSize < windowSize) {
+        prevSize <<= 1;
+    }
+
+    // history and message in one buffer, positions in the hash chains are only 16 bit
+    // and every candidate is checked, so an outdated entry costs time but never output
+    uint8_t * buffer = (uint8_t *) malloc(end);
+    uint16_t * head = (uint16_t *) calloc(WS_DEFLATE_HASH_SIZE, sizeof(uint16_t));
+    uint16_t * prev = (uint16_t *) malloc(prevSize * sizeof(uint16_t));
+    uint8_t * result = (uint8_t *) malloc(headroom + length);
+
+    if(!buffer || !head || !prev || !result) {
+        free(buffer);
+        free(head);
+        free(prev);
+        free(result);
+        return NULL;
+    }
+
+    if(start) {
+        memcpy(buffer, stream->window, start);
+    }
+    memcpy((buffer + start), data, length);
+
+    // anything not smaller than the message is useless
+    ws_bit_writer_t w = { (result + headroom), 0, (length - 1), 0, 0, 0 };
+
+    // block header: not final, fixed huffman
+    ws_put_bits(&w, 0x02, 3);
+
+    size_t pos = 0;
+    while(pos < end && !w.overflow) {
+        size_t bestLength = 0;
+        size_t bestDistance = 0;
+
+        if((pos + WS_DEFLATE_MIN_MATCH) <= end) {
+            uint16_t hash = ws_deflate_hash(&buffer[pos]);
+
+            if(pos >= start) {
+                size_t maxLength = (end - pos);
+                if(maxLength > WS_DEFLATE_MAX_MATCH) {
+                    maxLength = WS_DEFLATE_MAX_MATCH;
+                }
+
+                uint16_t candidate = head[hash];
+                size_t lastDistance = 0;
+                for(uint8_t chain = 0; chain < WS_DEFLATE_MAX_CHAIN; chain++) {
+                    size_t distance = (uint16_t) (pos - candidate);
+                    if(distance <= lastDistance || distance > windowSize || distance > pos) {
+                        break;
+                    }
+                    lastDistance = distance;
+
+                    const uint8_t * a = &buffer[pos];
+                    const uint8_t * b = &buffer[pos - distance];
+                    if(b[bestLength] == a[bestLength]) {
+                        size_t len = 0;
+                        while(len < maxLength && a[len] == b[len]) {
+                            len++;
+                        }
+                        if(len > bestLength) {
+                            bestLength = len;
+                            bestDistance = distance;
+                            if(len == maxLength) {
+                                break;
+                            }
+                        }
+                    }
+                    candidate = prev[candidate & (prevSize - 1)];
+                }
+            }
+
+            prev[pos & (prevSize - 1)] = head[hash];
+            head[hash] = pos;
+        }
+
+        if(pos < start) {
+            // history is only indexed
+            pos++;
+        } else if(bestLength >= WS_DEFLATE_MIN_MATCH) {
+            ws_put_match(&w, bestLength, bestDistance);
+            // index the rest of the match
+            size_t matchEnd = (pos + bestLength);
+            for(pos++; pos < matchEnd; pos++) {
+                if((pos + WS_DEFLATE_MIN_MATCH) <= end) {
+                    uint16_t hash = ws_deflate_hash(&buffer[pos]);
+                    prev[pos & (prevSize - 1)] = head[hash];
+                    head[hash] = pos;
+                }
+            }
+        } else {
+            ws_put_literal(&w, buffer[pos]);
+            pos++;
+        }
+    }
+
+    // end of block, then the header of an empty stored block (sync flush without the 0x00 0x00 0xFF 0xFF)
+    ws_put_literal(&w, 256);
+    ws_put_bits(&w, 0x00, 3);
+    if(w.count) {
+        ws_put_bits(&w, 0x00, (8 - w.count));
+    }
+
+    free(head);
+    free(prev);
+
+    if(w.overflow) {
+        // not smaller, send it as it is
+        free(buffer);
+        free(result);
+        return NULL;
+    }
+
+    if(!stream->noContextTakeover) {
+        ws_deflate_stream_update(stream, data, length);
+    }
+    free(buffer);
+
+    *outLength = w.pos;
+    return result;
+}
+
+/*
+ * decompressor
+ */
+
+typedef struct {
+        uint16_t count[16];     ///< number of codes of each length
+        uint16_t symbol[288];   ///< symbols ordered by code
+} ws_huffman_t;
+
+typedef struct {
+        const uint8_t * in;
+        size_t inPos;
+        size_t inSize;
+        uint32_t bits;
+        uint8_t count;
+        uint8_t * out;          ///< history followed by the message
+        size_t outPos;
+        size_t outSize;
+        size_t outStart;        ///< start of the message in out
+        size_t outMax;          ///< limit for outPos
+} ws_inflate_state_t;
+
+static inline int ws_get_byte(ws_inflate_state_t * s) {
+    if(s->inPos < s->inSize) {
+        return s->in[s->inPos++];
+    }
+    // the flush tail removed by the sender
+    size_t tail = (s->inPos++ - s->inSize);
+    if(tail < sizeof(ws_deflate_tail)) {
+        return ws_deflate_tail[tail];
+    }
+    return -1;
+}
+
+static int ws_get_bits(ws_inflate_state_t * s, uint8_t need, uint32_t * value) {
+    while(s->count < need) {
+        int c = ws_get_byte(s);
+        if(c < 0) {
+            return 0;
+        }
+        s->bits |= ((uint32_t) c << s->count);
+        s->count += 8;
+    }
+    *value = (s->bits & ((1UL << need) - 1));
+    s->bits >>= need;
+    s->count -= need;
+    return 1;
+}
+
+static int ws_huffman_build(ws_huffman_t * h, const uint8_t * lengths, uint16_t n) {
+    uint16_t offsets[16];
+    memset(h->count, 0, sizeof(h->count));
+    for(uint16_t i = 0; i < n; i++) {
+        h->count[lengths[i]]++;
+    }
+    if(h->count[0] == n) {
+        // no codes, only valid for an unused distance tree
+        return 1;
+    }
+    int left = 1;
+    for(uint8_t len = 1; len < 16; len++) {
+        left <<= 1;
+        left -= h->count[len];
+        if(left < 0) {
+            // over subscribed
+            return 0;
+        }
+    }
+    offsets[1] = 0;
+    for(uint8_t len = 1; len < 15; len++) {
+        offsets[len + 1] = (offsets[len] + h->count[len]);
+    }
+    for(uint16_t i = 0; i < n; i++) {
+        if(lengths[i]) {
+            h->symbol[offsets[lengths[i]]++] = i;
+        }
+    }
+    return 1;
+}
+
+static int ws_huffman_decode(ws_inflate_state_t * s, const ws_huffman_t * h) {
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for(uint8_t len = 1; len < 16; len++) {
+        uint32_t bit;
+        if(!ws_get_bits(s, 1, &bit)) {
+            return -1;
+        }
+        code |= bit;
+        int count = h->count[len];
+        if((code - count) < first) {
+            return h->symbol[index + (code - first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+static int ws_inflate_put(ws_inflate_state_t * s, uint8_t c) {
+    if(s->outPos >= s->outSize) {
+        if(s->outPos >= s->outMax) {
+            return 0;
+        }
+        size_t size = ((s->outSize * 2) + 64);
+        if(size > s->outMax) {
+            size = s->outMax;
+        }
+        // one more for the 0x00 at the end
+        uint8_t * out = (uint8_t *) realloc(s->out, size + 1);
+        if(!out) {
+            return 0;
+        }
+        s->out = out;
+        s->outSize = size;
+    }
+    s->out[s->outPos++] = c;
+    return 1;
+}
+
+static int ws_inflate_codes(ws_inflate_state_t * s, const ws_huffman_t * lencode, const ws_huffman_t * distcode) {
+    for(;;) {
+        int symbol = ws_huffman_decode(s, lencode);
+        if(symbol < 0) {
+            return 0;
+        }
+        if(symbol < 256) {
+            if(!ws_inflate_put(s, symbol)) {
+                return 0;
+            }
+        } else if(symbol == 256) {
+            return 1;
+        } else {
+            uint32_t extra;
+            symbol -= 257;
+            if(symbol >= 29) {
+                return 0;
+            }
+            if(!ws_get_bits(s, ws_length_extra[symbol], &extra)) {
+                return 0;
+            }
+            size_t length = (ws_length_base[symbol] + extra);
+
+            symbol = ws_huffman_decode(s, distcode);
+            if(symbol < 0 || symbol >= 30) {
+                return 0;
+            }
+            if(!ws_get_bits(s, ws_dist_extra[symbol], &extra)) {
+                return 0;
+            }
+            size_t distance = (ws_dist_base[symbol] + extra);
+            if(distance > s->outPos) {
+                return 0;
+            }
+            while(length--) {
+                if(!ws_inflate_put(s, s->out[s->outPos - distance])) {
+                    return 0;
+                }
+            }
+        }
+    }
+}
+
+static int ws_inflate_stored(ws_inflate_state_t * s) {
+    uint32_t len, nlen;
+    // go to the byte boundary
+    s->bits = 0;
+    s->count = 0;
+    if(!ws_get_bits(s, 16, &len) || !ws_get_bits(s, 16, &nlen) || len != (~nlen & 0xFFFF)) {
+        return 0;
+    }
+    while(len--) {
+        int c = ws_get_byte(s);
+        if(c < 0 || !ws_inflate_put(s, c)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int ws_inflate_fixed(ws_inflate_state_t * s) {
+    ws_huffman_t lencode, distcode;
+    uint8_t lengths[288];
+    uint16_t i;
+    for(i = 0; i < 144; i++) {
+        lengths[i] = 8;
+    }
+    for(; i < 256; i++) {
+        lengths[i] = 9;
+    }
+    for(; i < 280; i++) {
+        lengths[i] = 7;
+    }
+    for(; i < 288; i++) {
+        lengths[i] = 8;
+    }
+    ws_huffman_build(&lencode, lengths, 288);
+    memset(lengths, 5, 30);
+    ws_huffman_build(&distcode, lengths, 30);
+    return ws_inflate_codes(s, &lencode, &distcode);
+}
+
+static int ws_inflate_dynamic(ws_inflate_state_t * s) {
+    static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+    ws_huffman_t lencode, distcode;
+    uint8_t lengths[320];
+    uint32_t nlen, ndist, ncode, value;
+    uint16_t i;
+
+    if(!ws_get_bits(s, 5, &nlen) || !ws_get_bits(s, 5, &ndist) || !ws_get_bits(s, 4, &ncode)) {
+        return 0;
+    }
+    nlen += 257;
+    ndist += 1;
+    ncode += 4;
+    if(nlen > 286 || ndist > 30) {
+        return 0;
+    }
+
+    memset(lengths, 0, 19);
+    for(i = 0; i < ncode; i++) {
+        if(!ws_get_bits(s, 3, &value)) {
+            return 0;
+        }
+        lengths[order[i]] = value;
+    }
+    if(!ws_huffman_build(&lencode, lengths, 19)) {
+        return 0;
+    }
+
+    for(i = 0; i < (nlen + ndist);) {
+        int symbol = ws_huffman_decode(s, &lencode);
+        if(symbol < 0) {
+            return 0;
+        }
+        if(symbol < 16) {
+            lengths[i++] = symbol;
+        } else {
+            uint8_t len = 0;
+            uint32_t repeat;
+            if(symbol == 16) {
+                if(i == 0) {
+                    return 0;
+                }
+                len = lengths[i - 1];
+                if(!ws_get_bits(s, 2, &repeat)) {
+                    return 0;
+                }
+                repeat += 3;
+            } else if(symbol == 17) {
+                if(!ws_get_bits(s, 3, &repeat)) {
+                    return 0;
+                }
+                repeat += 3;
+            } else {
+                if(!ws_get_bits(s, 7, &repeat)) {
+                    return 0;
+                }
+                repeat += 11;
+            }
+            if((i + repeat) > (nlen + ndist)) {
+                return 0;
+            }
+            while(repeat--) {
+                lengths[i++] = len;
+            }
+        }
+    }
+
+    if(lengths[256] == 0) {
+        // no end of block code
+        return 0;
+    }
+    if(!ws_huffman_build(&lencode, lengths, nlen) || !ws_huffman_build(&distcode, (lengths + nlen), ndist)) {
+        return 0;
+    }
+    return ws_inflate_codes(s, &lencode, &distcode);
+}
+
+uint8_t * ws_inflate_message(ws_deflate_t * deflate, const uint8_t * data, size_t length, size_t maxLength, size_t * outLength) {
+    ws_deflate_stream_t * stream = &deflate->rx;
+    ws_inflate_state_t s;
+
+    s.in = data;
+    s.inPos = 0;
+    s.inSize = length;
+    s.bits = 0;
+    s.count = 0;
+    s.outStart = stream->windowLen;
+    s.outPos = s.outStart;
+    s.outMax = (s.outStart + maxLength);
+    s.outSize = (s.outStart + (length * 4) + 64);
+    if(s.outSize > s.outMax) {
+        s.outSize = s.outMax;
+    }
+
+    s.out = (uint8_t *) malloc(s.outSize + 1);
+    if(!s.out) {
+        return NULL;
+    }
+    if(s.outStart) {
+        memcpy(s.out, stream->window, s.outStart);
+    }
+
+    // until the appended flush tail is used up
+    int ok = 1;
+    while(ok && s.inPos < (s.inSize + sizeof(ws_deflate_tail))) {
+        uint32_t last, type;
+        if(!ws_get_bits(&s, 1, &last) || !ws_get_bits(&s, 2, &type)) {
+            ok = 0;
+            break;
+        }
+        switch(type) {
+            case 0:
+                ok = ws_inflate_stored(&s);
+                break;
+            case 1:
+                ok = ws_inflate_fixed(&s);
+                break;
+            case 2:
+                ok = ws_inflate_dynamic(&s);
+                break;
+            default:
+                ok = 0;
+                break;
+        }
+        if(last) {
+            break;
+        }
+    }
+
+    if(!ok) {
+        free(s.out);
+        return NULL;
+    }
+
+    size_t len = (s.outPos - s.outStart);
+    if(!stream->noContextTakeover) {
+        ws_deflate_stream_update(stream, (s.out + s.outStart), len);
+    }
+    if(s.outStart) {
+        memmove(s.out, (s.out + s.outStart), len);
+    }
+    s.out[len] = 0x00;
+
+    *outLength = len;
+    return s.out;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file wsdeflate.h
+ * @date 16.10.2026
+ *
+ * permessage-deflate (RFC 7692) for the WebSocket libraries
+ *
+ * raw deflate (RFC 1951) sized for small devices:
+ *  - the compressor does LZ77 with a hash chain and writes fixed huffman blocks
+ *  - the decompressor reads stored, fixed and dynamic blocks
+ *  - the LZ77 window is bounded by the negotiated window bits and is only
+ *    kept between messages without no_context_takeover
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef WSDEFLATE_H_
+#define WSDEFLATE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WS_DEFLATE_EXTENSION        "permessage-deflate"
+
+#define WS_DEFLATE_MIN_WINDOW_BITS  (8)
+#define WS_DEFLATE_MAX_WINDOW_BITS  (15)
+
+// max length of the Sec-WebSocket-Extensions value created by ws_deflate_offer / ws_deflate_accept
+#define WS_DEFLATE_HEADER_SIZE      (128)
+
+// messages shorter than this are not worth compressing
+#ifndef WS_DEFLATE_MIN_SIZE
+#define WS_DEFLATE_MIN_SIZE         (32)
+#endif
+
+// hash chain entries checked for each match, more gives better compression for more CPU
+#ifndef WS_DEFLATE_MAX_CHAIN
+#define WS_DEFLATE_MAX_CHAIN        (16)
+#endif
+
+#ifndef WS_DEFLATE_HASH_BITS
+#define WS_DEFLATE_HASH_BITS        (11)
+#endif
+
+/**
+ * local settings, what we are willing to spend on memory
+ */
+typedef struct {
+        uint8_t windowBits;         ///< max LZ77 window in both directions (WS_DEFLATE_MIN_WINDOW_BITS - WS_DEFLATE_MAX_WINDOW_BITS)
+        uint8_t noContextTakeover;  ///< forget the window after every message in both directions
+} ws_deflate_config_t;
+
+/**
+ * result of the negotiation
+ */
+typedef struct {
+        uint8_t txBits;             ///< window we compress with
+        uint8_t rxBits;             ///< window the peer compresses with
+        uint8_t txNoContextTakeover;
+        uint8_t rxNoContextTakeover;
+} ws_deflate_params_t;
+
+/**
+ * one direction of a connection
+ */
+typedef struct {
+        uint8_t bits;
+        uint8_t noContextTakeover;
+        uint16_t windowLen;         ///< valid bytes in window
+        uint8_t * window;           ///< last (1 << bits) bytes of the previous messages (NULL with noContextTakeover)
+} ws_deflate_stream_t;
+
+typedef struct {
+        ws_deflate_stream_t tx;
+        ws_deflate_stream_t rx;
+} ws_deflate_t;
+
+/**
+ * server side, pick the first permessage-deflate offer we can accept
+ * @param offer const char *            value of the Sec-WebSocket-Extensions request header
+ * @param config const ws_deflate_config_t *
+ * @param params ws_deflate_params_t *  negotiated parameters
+ * @param response char *               Sec-WebSocket-Extensions response value (WS_DEFLATE_HEADER_SIZE byte)
+ * @return 1 if accepted
+ */
+int ws_deflate_accept(const char * offer, const ws_deflate_config_t * config, ws_deflate_params_t * params, char * response);
+
+/**
+ * client side, create the offer for the handshake request
+ * @param config const ws_deflate_config_t *
+ * @param offer char *  Sec-WebSocket-Extensions request value (WS_DEFLATE_HEADER_SIZE byte)
+ */
+void ws_deflate_offer(const ws_deflate_config_t * config, char * offer);
+
+/**
+ * client side, check the response of the server to our offer
+ * @param response const char *         value of the Sec-WebSocket-Extensions response header
+ * @param config const ws_deflate_config_t *  the config the offer was made with
+ * @param params ws_deflate_params_t *  negotiated parameters
+ * @return 1 if permessage-deflate is in use, 0 if not, -1 if the response is invalid
+ */
+int ws_deflate_response(const char * response, const ws_deflate_config_t * config, ws_deflate_params_t * params);
+
+/**
+ * allocate the state for a connection
+ * @param params const ws_deflate_params_t *
+ * @return ws_deflate_t * or NULL
+ */
+ws_deflate_t * ws_deflate_new(const ws_deflate_params_t * params);
+void ws_deflate_free(ws_deflate_t * deflate);
+
+/**
+ * compress one message
+ * @param deflate ws_deflate_t *
+ * @param data const uint8_t *
+ * @param length size_t
+ * @param headroom size_t   free bytes in front of the result (for the frame header)
+ * @param outLength size_t *    compressed length (without headroom)
+ * @return malloced buffer or NULL if the message does not get smaller (send it uncompressed)
+ */
+uint8_t * ws_deflate_message(ws_deflate_t * deflate, const uint8_t * data, size_t length, size_t headroom, size_t * outLength);
+
+/**
+ * decompress one message
+ * @param deflate ws_deflate_t *
+ * @param data const uint8_t *  payload of all frames of the message
+ * @param length size_t
+ * @param maxLength size_t  limit for the decompressed message
+ * @param outLength size_t *
+ * @return malloced buffer (0x00 terminated) or NULL if the data is invalid or too big
+ */
+uint8_t * ws_inflate_message(ws_deflate_t * deflate, const uint8_t * data, size_t length, size_t maxLength, size_t * outLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WSDEFLATE_H_ */
@@ -0,0 +1,197 @@
+/**
+ * @file wshandshake.c
+ * @date 16.10.2026
+ *
+ * Sec-WebSocket-Accept (RFC 6455 4.2.2) for the WebSocket libraries
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <string.h>
+
+#include "wshandshake.h"
+
+#define WS_ROL(x, n)    (((x) << (n)) | ((x) >> (32 - (n))))
+
+// message schedule in place, w[i & 15] becomes w[i] for the rounds 16 - 79
+#define WS_SHA1_W(i)    (w[(i) & 15] = WS_ROL(w[((i) + 13) & 15] ^ w[((i) + 8) & 15] ^ w[((i) + 2) & 15] ^ w[(i) & 15], 1))
+
+// one round without moving the working variables around, the caller rotates the names
+#define WS_SHA1_ROUND(a, b, c, d, e, f, k, wi) { \
+        e += WS_ROL(a, 5) + (f) + (k) + (wi); \
+        b = WS_ROL(b, 30); \
+    }
+
+#define WS_SHA1_F1(b, c, d)     (d ^ (b & (c ^ d)))
+#define WS_SHA1_F2(b, c, d)     (b ^ c ^ d)
+#define WS_SHA1_F3(b, c, d)     ((b & c) | (d & (b | c)))
+
+// five rounds, after them a - e are back in their places
+#define WS_SHA1_ROUND5(F, k, W, i) { \
+        WS_SHA1_ROUND(a, b, c, d, e, F(b, c, d), k, W(i)); \
+        WS_SHA1_ROUND(e, a, b, c, d, F(a, b, c), k, W(i + 1)); \
+        WS_SHA1_ROUND(d, e, a, b, c, F(e, a, b), k, W(i + 2)); \
+        WS_SHA1_ROUND(c, d, e, a, b, F(d, e, a), k, W(i + 3)); \
+        WS_SHA1_ROUND(b, c, d, e, a, F(c, d, e), k, W(i + 4)); \
+    }
+
+#define WS_SHA1_W0(i)   w[i]
+
+static const char ws_base64_table[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ * one 64 byte block, w is used up
+ */
+static void ws_sha1_block(uint32_t * h, uint32_t * w) {
+    uint32_t a = h[0];
+    uint32_t b = h[1];
+    uint32_t c = h[2];
+    uint32_t d = h[3];
+    uint32_t e = h[4];
+    uint8_t i;
+
+    for(i = 0; i < 15; i += 5) {
+        WS_SHA1_ROUND5(WS_SHA1_F1, 0x5A827999, WS_SHA1_W0, i);
+    }
+    // round 15 still uses the block as it is
+    WS_SHA1_ROUND(a, b, c, d, e, WS_SHA1_F1(b, c, d), 0x5A827999, w[15]);
+    WS_SHA1_ROUND(e, a, b, c, d, WS_SHA1_F1(a, b, c), 0x5A827999, WS_SHA1_W(16));
+    WS_SHA1_ROUND(d, e, a, b, c, WS_SHA1_F1(e, a, b), 0x5A827999, WS_SHA1_W(17));
+    WS_SHA1_ROUND(c, d, e, a, b, WS_SHA1_F1(d, e, a), 0x5A827999, WS_SHA1_W(18));
+    WS_SHA1_ROUND(b, c, d, e, a, WS_SHA1_F1(c, d, e), 0x5A827999, WS_SHA1_W(19));
+    for(i = 20; i < 40; i += 5) {
+        WS_SHA1_ROUND5(WS_SHA1_F2, 0x6ED9EBA1, WS_SHA1_W, i);
+    }
+    for(; i < 60; i += 5) {
+        WS_SHA1_ROUND5(WS_SHA1_F3, 0x8F1BBCDC, WS_SHA1_W, i);
+    }
+    for(; i < 80; i += 5) {
+        WS_SHA1_ROUND5(WS_SHA1_F2, 0xCA62C1D6, WS_SHA1_W, i);
+    }
+
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+}
+
+void ws_sha1_init(ws_sha1_t * ctx) {
+    ctx->h[0] = 0x67452301;
+    ctx->h[1] = 0xEFCDAB89;
+    ctx->h[2] = 0x98BADCFE;
+    ctx->h[3] = 0x10325476;
+    ctx->h[4] = 0xC3D2E1F0;
+    ctx->length = 0;
+}
+
+void ws_sha1_update(ws_sha1_t * ctx, const uint8_t * data, size_t length) {
+    uint32_t * w = ctx->w;
+    uint8_t n = (ctx->length & 63);
+
+    ctx->length += length;
+
+    while(length > 0) {
+        if((n & 3) == 0 && length >= 4) {
+            // whole word, this is the usual case
+            w[n >> 2] = ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | data[3];
+            data += 4;
+            length -= 4;
+            n += 4;
+        } else {
+            if((n & 3) == 0) {
+                w[n >> 2] = 0;
+            }
+            w[n >> 2] |= ((uint32_t) *data << (24 - ((n & 3) << 3)));
+            data++;
+            length--;
+            n++;
+        }
+
+        if(n == 64) {
+            ws_sha1_block(ctx->h, w);
+            n = 0;
+        }
+    }
+}
+
+void ws_sha1_final(ws_sha1_t * ctx, uint8_t * digest) {
+    static const uint8_t pad[64] = { 0x80 };
+    uint32_t bits = (ctx->length << 3);
+    uint32_t bitsHigh = (ctx->length >> 29);
+    uint8_t n = (ctx->length & 63);
+    uint8_t i;
+
+    // 0x80, zeros up to 56 mod 64, then the bit count
+    ws_sha1_update(ctx, pad, ((n < 56) ? (56 - n) : (120 - n)));
+    ctx->w[14] = bitsHigh;
+    ctx->w[15] = bits;
+    ws_sha1_block(ctx->h, ctx->w);
+
+    for(i = 0; i < 5; i++) {
+        digest[(i << 2) + 0] = (uint8_t) (ctx->h[i] >> 24);
+        digest[(i << 2) + 1] = (uint8_t) (ctx->h[i] >> 16);
+        digest[(i << 2) + 2] = (uint8_t) (ctx->h[i] >> 8);
+        digest[(i << 2) + 3] = (uint8_t) (ctx->h[i]);
+    }
+}
+
+void ws_sha1(const uint8_t * data, size_t length, uint8_t * digest) {
+    ws_sha1_t ctx;
+    ws_sha1_init(&ctx);
+    ws_sha1_update(&ctx, data, length);
+    ws_sha1_final(&ctx, digest);
+}
+
+size_t ws_base64_encode(const uint8_t * data, size_t length, char * out) {
+    char * p = out;
+    uint32_t v;
+
+    while(length >= 3) {
+        v = ((uint32_t) data[0] << 16) | ((uint32_t) data[1] << 8) | data[2];
+        p[0] = ws_base64_table[(v >> 18) & 0x3F];
+        p[1] = ws_base64_table[(v >> 12) & 0x3F];
+        p[2] = ws_base64_table[(v >> 6) & 0x3F];
+        p[3] = ws_base64_table[v & 0x3F];
+        data += 3;
+        length -= 3;
+        p += 4;
+    }
+
+    if(length > 0) {
+        v = ((uint32_t) data[0] << 16);
+        if(length > 1) {
+            v |= ((uint32_t) data[1] << 8);
+        }
+        p[0] = ws_base64_table[(v >> 18) & 0x3F];
+        p[1] = ws_base64_table[(v >> 12) & 0x3F];
+        p[2] = ((length > 1) ? ws_base64_table[(v >> 6) & 0x3F] : '=');
+        p[3] = '=';
+        p += 4;
+    }
+
+    *p = 0x00;
+    return (size_t) (p - out);
+}
+
+void ws_accept_key(const char * key, size_t length, char * accept) {
+    uint8_t digest[WS_SHA1_SIZE];
+    ws_sha1_t ctx;
+
+    // hashed in two parts, no need to put key and GUID together first
+    ws_sha1_init(&ctx);
+    ws_sha1_update(&ctx, (const uint8_t *) key, length);
+    ws_sha1_update(&ctx, (const uint8_t *) WS_HANDSHAKE_GUID, (sizeof(WS_HANDSHAKE_GUID) - 1));
+    ws_sha1_final(&ctx, digest);
+
+    ws_base64_encode(digest, WS_SHA1_SIZE, accept);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file wshandshake.h
+ * @date 16.10.2026
+ *
+ * Sec-WebSocket-Accept (RFC 6455 4.2.2) for the WebSocket libraries
+ *
+ * SHA-1 and base64 without heap, the whole state of a hash is 88 byte on
+ * the stack, input is loaded and expanded a 32 bit word at a time
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef WSHANDSHAKE_H_
+#define WSHANDSHAKE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WS_HANDSHAKE_GUID   "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+#define WS_SHA1_SIZE        (20)
+
+// base64 of n byte, with 0x00
+#define WS_BASE64_SIZE(n)   ((((n) + 2) / 3) * 4 + 1)
+
+// Sec-WebSocket-Accept value, with 0x00
+#define WS_ACCEPT_KEY_SIZE  WS_BASE64_SIZE(WS_SHA1_SIZE)
+
+typedef struct {
+        uint32_t h[5];      ///< hash so far
+        uint32_t w[16];     ///< block in progress, big endian words
+        uint32_t length;    ///< byte count so far
+} ws_sha1_t;
+
+void ws_sha1_init(ws_sha1_t * ctx);
+void ws_sha1_update(ws_sha1_t * ctx, const uint8_t * data, size_t length);
+void ws_sha1_final(ws_sha1_t * ctx, uint8_t * digest);
+
+/**
+ * SHA-1 of a buffer
+ * @param data const uint8_t *
+ * @param length size_t
+ * @param digest uint8_t *  WS_SHA1_SIZE byte
+ */
+void ws_sha1(const uint8_t * data, size_t length, uint8_t * digest);
+
+/**
+ * base64 (RFC 4648) without line breaks
+ * @param data const uint8_t *
+ * @param length size_t
+ * @param out char *    WS_BASE64_SIZE(length) byte
+ * @return length of out without the 0x00
+ */
+size_t ws_base64_encode(const uint8_t * data, size_t length, char * out);
+
+/**
+ * Sec-WebSocket-Accept for a Sec-WebSocket-Key
+ * @param key const char *  Sec-WebSocket-Key (not 0x00 terminated)
+ * @param length size_t
+ * @param accept char *     WS_ACCEPT_KEY_SIZE byte
+ */
+void ws_accept_key(const char * key, size_t length, char * accept);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WSHANDSHAKE_H_ */
@@ -24,28 +24,6 @@
 
 #include "WebSockets.h"
 
-#ifdef ESP8266
-#include <core_esp8266_features.h>
-#endif
-
-extern "C" {
-#ifdef CORE_HAS_LIBB64
-#include <libb64/cencode.h>
-#else
-#include "libb64/cencode_inc.h"
-#endif
-}
-
-#ifdef ESP8266
-#include <Hash.h>
-#else
-
-extern "C" {
-#include "libsha1/libsha1.h"
-}
-
-#endif
-
 /**
  *
  * @param client WSclient_t *  ptr to the client struct
@@ -68,6 +46,56 @@ void WebSockets::clientDisconnect(WSclient_t * client, uint16_t code, char * rea
     clientDisconnect(client);
 }
 
+/**
+ * XOR data with the mask key, masking and unmasking is the same operation
+ * works a word at a time on 32bit cpus
+ * @param data uint8_t *        data to (un)mask in place
+ * @param length size_t
+ * @param maskKey uint8_t *     4 byte mask key
+ * @param offset size_t         position of data[0] in the frame payload (to mask a payload in pieces)
+ */
+void WebSockets::maskPayload(uint8_t * data, size_t length, const uint8_t * maskKey, size_t offset) {
+    uint8_t k = (offset & 0x03);
+#ifndef __AVR__
+    typedef uint32_t __attribute__((__may_alias__)) word_t;
+
+    // bytes until data is word aligned
+    while(length && ((uintptr_t) data & 0x03)) {
+        *data++ ^= maskKey[k];
+        k = ((k + 1) & 0x03);
+        length--;
+    }
+
+    if(length >= 4) {
+        // key rotated to the current position, built in memory order so the byte order does not matter
+        uint8_t rotated[4] = { maskKey[k], maskKey[(k + 1) & 0x03], maskKey[(k + 2) & 0x03], maskKey[(k + 3) & 0x03] };
+        word_t key = *((word_t *) &rotated[0]);
+        word_t * data32 = (word_t *) data;
+
+        while(length >= 16) {
+            data32[0] ^= key;
+            data32[1] ^= key;
+            data32[2] ^= key;
+            data32[3] ^= key;
+            data32 += 4;
+            length -= 16;
+        }
+
+        while(length >= 4) {
+            *data32++ ^= key;
+            length -= 4;
+        }
+        // whole words do not change the key position
+        data = (uint8_t *) data32;
+    }
+#endif
+
+    while(length--) {
+        *data++ ^= maskKey[k];
+        k = ((k + 1) & 0x03);
+    }
+}
+
 /**
  *
  * @param client WSclient_t *   ptr to the client struct
@@ -77,9 +105,10 @@ void WebSockets::clientDisconnect(WSclient_t * client, uint16_t code, char * rea
  * @param mask bool             add dummy mask to the frame (needed for web browser)
  * @param fin bool              can be used to send data in more then one frame (set fin on the last frame)
  * @param headerToPayload bool  set true if the payload has reserved 14 Byte at the beginning to dynamically add the Header (payload neet to be in RAM!)
+ * @param compressed bool       payload is already compressed (set RSV1), otherwise text and binary messages are compressed if permessage-deflate is in use
  * @return true if ok
  */
-bool WebSockets::sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length, bool mask, bool fin, bool headerToPayload) {
+bool WebSockets::sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length, bool mask, bool fin, bool headerToPayload, bool compressed) {
 
     if(client->tcp && !client->tcp->connected()) {
         DEBUG_WEBSOCKETS("[WS][%d][sendFrame] not Connected!?\n", client->num);
@@ -94,40 +123,51 @@ bool WebSockets::sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * pay
     DEBUG_WEBSOCKETS("[WS][%d][sendFrame] ------- send massage frame -------\n", client->num);
     DEBUG_WEBSOCKETS("[WS][%d][sendFrame] fin: %u opCode: %u mask: %u length: %u headerToPayload: %u\n", client->num, fin, opcode, mask, length, headerToPayload);
 
-    if(opcode == WSop_text) {
+    if(opcode == WSop_text && !compressed) {
         DEBUG_WEBSOCKETS("[WS][%d][sendFrame] text: %s\n", client->num, (payload + (headerToPayload ? 14 : 0)));
     }
 
+#ifdef WEBSOCKETS_USE_DEFLATE
+    if(client->cDeflate && !compressed && fin && (opcode == WSop_text || opcode == WSop_binary)) {
+        size_t deflateLength;
+        uint8_t * deflated = ws_deflate_message(client->cDeflate, (headerToPayload ? (payload + WEBSOCKETS_MAX_HEADER_SIZE) : payload), length, WEBSOCKETS_MAX_HEADER_SIZE, &deflateLength);
+        if(deflated) {
+            DEBUG_WEBSOCKETS("[WS][%d][sendFrame] deflate %u -> %u\n", client->num, length, deflateLength);
+            bool ret = sendFrame(client, opcode, deflated, deflateLength, mask, fin, true, true);
+            free(deflated);
+            return ret;
+        }
+        // not smaller, send it uncompressed
+    }
+#endif
+
     uint8_t maskKey[4] = { 0x00, 0x00, 0x00, 0x00 };
     uint8_t buffer[WEBSOCKETS_MAX_HEADER_SIZE] = { 0 };
 
     uint8_t headerSize;
-    uint8_t * headerPtr;
     uint8_t * payloadPtr = payload;
     bool useInternBuffer = false;
     bool ret = true;
 
-    // calculate header Size
-    if(length < 126) {
-        headerSize = 2;
-    } else if(length < 0xFFFF) {
-        headerSize = 4;
-    } else {
-        headerSize = 10;
-    }
-
     if(mask) {
-        headerSize += 4;
+        // new random key for every frame
+#ifdef ESP8266
+        uint32_t r = RANDOM_REG32;
+#else
+        uint32_t r = (((uint32_t) random(0x10000) << 16) | (uint32_t) random(0x10000));
+#endif
+        memcpy(&maskKey[0], &r, sizeof(maskKey));
     }
 
 #ifdef WEBSOCKETS_USE_BIG_MEM
     // only for ESP since AVR has less HEAP
     // try to send data in one TCP package (only if some free Heap is there)
-    if(!headerToPayload && ((length > 0) && (length < 1400)) && (ESP.getFreeHeap() > 6000)) {
+    // a masked frame is copied too so the payload of the caller is not modified
+    if((!headerToPayload || mask) && ((length > 0) && (length < 1400)) && (ESP.getFreeHeap() > 6000)) {
         DEBUG_WEBSOCKETS("[WS][%d][sendFrame] pack to one TCP package...\n", client->num);
         uint8_t * dataPtr = (uint8_t *) malloc(length + WEBSOCKETS_MAX_HEADER_SIZE);
         if(dataPtr) {
-            memcpy((dataPtr + WEBSOCKETS_MAX_HEADER_SIZE), payload, length);
+            memcpy((dataPtr + WEBSOCKETS_MAX_HEADER_SIZE), (headerToPayload ? (payload + WEBSOCKETS_MAX_HEADER_SIZE) : payload), length);
             headerToPayload = true;
             useInternBuffer = true;
             payloadPtr = dataPtr;
@@ -135,21 +175,111 @@ bool WebSockets::sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * pay
     }
 #endif
 
-    // set Header Pointer
+    // payload is not ours to modify, it gets masked on the way out
+    if(mask && !useInternBuffer && headerToPayload) {
+        payloadPtr += WEBSOCKETS_MAX_HEADER_SIZE;
+        headerToPayload = false;
+    }
+
+    // create header in front of the payload or in the stack buffer
+    headerSize = createHeader((headerToPayload ? payloadPtr : &buffer[0]), opcode, length, mask, maskKey, fin, compressed);
+
+    if(mask && useInternBuffer) {
+        // if we use a Intern Buffer we can modify the data
+        // by this fact its possible the do the masking in place
+        maskPayload((payloadPtr + WEBSOCKETS_MAX_HEADER_SIZE), length, &maskKey[0]);
+    }
+
+#ifndef NODEBUG_WEBSOCKETS
+    unsigned long start = micros();
+#endif
+
     if(headerToPayload) {
-        // calculate offset in payload
-        headerPtr = (payloadPtr + (WEBSOCKETS_MAX_HEADER_SIZE - headerSize));
+        // header has be added to payload
+        // payload is forced to reserved 14 Byte but we may not need all based on the length and mask settings
+        // offset in payload is calculatetd 14 - headerSize
+        if(client->tcp->write(&payloadPtr[(WEBSOCKETS_MAX_HEADER_SIZE - headerSize)], (length + headerSize)) != (length + headerSize)) {
+            ret = false;
+        }
+    } else {
+        // send header
+        if(client->tcp->write(&buffer[(WEBSOCKETS_MAX_HEADER_SIZE - headerSize)], headerSize) != headerSize) {
+            ret = false;
+        }
+
+        if(payloadPtr && length > 0 && mask) {
+            // send payload masked in pieces
+            uint8_t maskBuffer[WEBSOCKETS_MASK_BUFFER_SIZE];
+            size_t offset = 0;
+            while(offset < length) {
+                size_t chunk = (length - offset);
+                if(chunk > sizeof(maskBuffer)) {
+                    chunk = sizeof(maskBuffer);
+                }
+                memcpy(&maskBuffer[0], &payloadPtr[offset], chunk);
+                maskPayload(&maskBuffer[0], chunk, &maskKey[0], offset);
+                if(client->tcp->write(&maskBuffer[0], chunk) != chunk) {
+                    ret = false;
+                    break;
+                }
+                offset += chunk;
+            }
+        } else if(payloadPtr && length > 0) {
+            // send payload
+            if(client->tcp->write(&payloadPtr[0], length) != length) {
+                ret = false;
+            }
+        }
+    }
+
+    DEBUG_WEBSOCKETS("[WS][%d][sendFrame] sending Frame Done (%uus).\n", client->num, (micros() - start));
+
+#ifdef WEBSOCKETS_USE_BIG_MEM
+    if(useInternBuffer && payloadPtr) {
+        free(payloadPtr);
+    }
+#endif
+
+    return ret;
+}
+
+/**
+ * write the frame header to the end of a WEBSOCKETS_MAX_HEADER_SIZE Byte area
+ * @param buffer uint8_t *      area of WEBSOCKETS_MAX_HEADER_SIZE Byte (the header starts at buffer + WEBSOCKETS_MAX_HEADER_SIZE - headerSize)
+ * @param opcode WSopcode_t
+ * @param length size_t         payload length
+ * @param mask bool             add maskKey to the header
+ * @param maskKey uint8_t *     4 Byte mask key (only used with mask)
+ * @param fin bool
+ * @param compressed bool       set RSV1 (permessage-deflate)
+ * @return uint8_t headerSize
+ */
+uint8_t WebSockets::createHeader(uint8_t * buffer, WSopcode_t opcode, size_t length, bool mask, uint8_t * maskKey, bool fin, bool compressed) {
+    uint8_t headerSize;
+
+    // calculate header Size
+    if(length < 126) {
+        headerSize = 2;
+    } else if(length < 0xFFFF) {
+        headerSize = 4;
     } else {
-        headerPtr = &buffer[0];
+        headerSize = 10;
     }
 
-    // create header
+    if(mask) {
+        headerSize += 4;
+    }
+
+    uint8_t * headerPtr = (buffer + (WEBSOCKETS_MAX_HEADER_SIZE - headerSize));
 
     // byte 0
     *headerPtr = 0x00;
     if(fin) {
         *headerPtr |= bit(7);    ///< set Fin
     }
+    if(compressed) {
+        *headerPtr |= bit(6);    ///< set RSV1
+    }
     *headerPtr |= opcode;        ///< set opcode
     headerPtr++;
 
@@ -192,73 +322,17 @@ bool WebSockets::sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * pay
     }
 
     if(mask) {
-        if(useInternBuffer) {
-            // if we use a Intern Buffer we can modify the data
-            // by this fact its possible the do the masking
-            for(uint8_t x = 0; x < sizeof(maskKey); x++) {
-                maskKey[x] = random(0xFF);
-                *headerPtr = maskKey[x];
-                headerPtr++;
-            }
-
-            uint8_t * dataMaskPtr;
-
-            if(headerToPayload) {
-                dataMaskPtr = (payloadPtr + WEBSOCKETS_MAX_HEADER_SIZE);
-            } else {
-                dataMaskPtr = payloadPtr;
-            }
-
-            for(size_t x = 0; x < length; x++) {
-                dataMaskPtr[x] = (dataMaskPtr[x] ^ maskKey[x % 4]);
-            }
-
-        } else {
-            *headerPtr = maskKey[0];
-            headerPtr++;
-            *headerPtr = maskKey[1];
-            headerPtr++;
-            *headerPtr = maskKey[2];
-            headerPtr++;
-            *headerPtr = maskKey[3];
-            headerPtr++;
-        }
-    }
-
-#ifndef NODEBUG_WEBSOCKETS
-    unsigned long start = micros();
-#endif
-
-    if(headerToPayload) {
-        // header has be added to payload
-        // payload is forced to reserved 14 Byte but we may not need all based on the length and mask settings
-        // offset in payload is calculatetd 14 - headerSize
-        if(client->tcp->write(&payloadPtr[(WEBSOCKETS_MAX_HEADER_SIZE - headerSize)], (length + headerSize)) != (length + headerSize)) {
-            ret = false;
-        }
-    } else {
-        // send header
-        if(client->tcp->write(&buffer[0], headerSize) != headerSize) {
-            ret = false;
-        }
-
-        if(payloadPtr && length > 0) {
-            // send payload
-            if(client->tcp->write(&payloadPtr[0], length) != length) {
-                ret = false;
-            }
-        }
-    }
-
-    DEBUG_WEBSOCKETS("[WS][%d][sendFrame] sending Frame Done (%uus).\n", client->num, (micros() - start));
-
-#ifdef WEBSOCKETS_USE_BIG_MEM
-    if(useInternBuffer && payloadPtr) {
-        free(payloadPtr);
+        *headerPtr = maskKey[0];
+        headerPtr++;
+        *headerPtr = maskKey[1];
+        headerPtr++;
+        *headerPtr = maskKey[2];
+        headerPtr++;
+        *headerPtr = maskKey[3];
+        headerPtr++;
     }
-#endif
 
-    return ret;
+    return headerSize;
 }
 
 /**
@@ -269,8 +343,8 @@ void WebSockets::headerDone(WSclient_t * client) {
     client->status = WSC_CONNECTED;
     client->cWsRXsize = 0;
     DEBUG_WEBSOCKETS("[WS][%d][headerDone] Header Handling Done (%uus).\n", client->num);
-#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
     client->cHttpLine = "";
+#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
     handleWebsocket(client);
 #endif
 }
@@ -280,9 +354,20 @@ void WebSockets::headerDone(WSclient_t * client) {
  * @param client WSclient_t *  ptr to the client struct
  */
 void WebSockets::handleWebsocket(WSclient_t * client) {
+#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
     if(client->cWsRXsize == 0) {
         handleWebsocketCb(client);
     }
+#else
+    // never waits, a frame that is not complete yet is continued by the next call
+    do {
+        if(client->cWsPayload) {
+            handleWebsocketPayloadRead(client, client->cWsPayload);
+        } else {
+            handleWebsocketCb(client);
+        }
+    } while(client->cWsPayload && client->tcp && client->tcp->available() > 0);
+#endif
 }
 
 /**
@@ -305,6 +390,7 @@ bool WebSockets::handleWebsocketWaitFor(WSclient_t * client, size_t size) {
     }
 
     DEBUG_WEBSOCKETS("[WS][%d][handleWebsocketWaitFor] size: %d cWsRXsize: %d\n", client->num, size, client->cWsRXsize);
+#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
     readCb(client, &client->cWsHeader[client->cWsRXsize], (size - client->cWsRXsize), std::bind([](WebSockets * server, size_t size, WSclient_t * client, bool ok) {
         DEBUG_WEBSOCKETS("[WS][%d][handleWebsocketWaitFor][readCb] size: %d ok: %d\n", client->num, size, ok);
         if(ok) {
@@ -318,6 +404,11 @@ bool WebSockets::handleWebsocketWaitFor(WSclient_t * client, size_t size) {
         }
     }, this, size, std::placeholders::_1, std::placeholders::_2));
     return false;
+#else
+    // take what is there, handleWebsocketCb is called again for the rest
+    client->cWsRXsize += readAvailable(client, &client->cWsHeader[client->cWsRXsize], (size - client->cWsRXsize));
+    return (client->cWsRXsize >= size);
+#endif
 }
 
 void WebSockets::handleWebsocketCb(WSclient_t * client) {
@@ -376,12 +467,50 @@ void WebSockets::handleWebsocketCb(WSclient_t * client) {
     DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] fin: %u rsv1: %u rsv2: %u rsv3 %u  opCode: %u\n", client->num, header->fin, header->rsv1, header->rsv2, header->rsv3, header->opCode);
     DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] mask: %u payloadLen: %u\n", client->num, header->mask, header->payloadLen);
 
-    if(header->payloadLen > WEBSOCKETS_MAX_DATA_SIZE) {
-        DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] payload to big! (%u)\n", client->num, header->payloadLen);
-        clientDisconnect(client, 1009);
+    // text, binary and continuation frames carry (parts of) a message
+    bool dataFrame = (header->opCode == WSop_text || header->opCode == WSop_binary || header->opCode == WSop_continuation);
+
+    if(dataFrame) {
+        if((header->opCode == WSop_continuation) != (client->cWsMessageOpcode != WSop_continuation)) {
+            DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] unexpected frame in fragmented message!\n", client->num);
+            clientDisconnect(client, 1002);
+            return;
+        }
+    } else if(!header->fin) {
+        DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] fragmented control frame!\n", client->num);
+        clientDisconnect(client, 1002);
+        return;
+    }
+
+    // RSV1 marks a compressed message (permessage-deflate), it is only allowed on the first frame
+#ifdef WEBSOCKETS_USE_DEFLATE
+    bool deflate = (client->cDeflate != NULL);
+#else
+    bool deflate = false;
+#endif
+    if(header->rsv2 || header->rsv3 || (header->rsv1 && (!deflate || !dataFrame || header->opCode == WSop_continuation))) {
+        DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] reserved bits set!\n", client->num);
+        clientDisconnect(client, 1002);
         return;
     }
 
+    if(dataFrame && header->opCode != WSop_continuation) {
+        client->cWsCompressed = header->rsv1;
+    }
+
+    // with fragment events data frames are passed on piece by piece and can have any size,
+    // compressed messages are always put together first
+    bool streamed = (_fragmentEvents && dataFrame && !client->cWsCompressed);
+
+    if(!streamed) {
+        size_t received = ((header->opCode == WSop_continuation) ? client->cWsMessageLen : 0);
+        if(header->payloadLen > (WEBSOCKETS_MAX_DATA_SIZE - received)) {
+            DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] payload to big! (%u)\n", client->num, header->payloadLen);
+            clientDisconnect(client, 1009);
+            return;
+        }
+    }
+
     if(header->mask) {
         headerLen += 4;
         if(!handleWebsocketWaitFor(client, headerLen)) {
@@ -391,72 +520,187 @@ void WebSockets::handleWebsocketCb(WSclient_t * client) {
         buffer += 4;
     }
 
+    client->cWsPayloadIndex = 0;
+
     if(header->payloadLen > 0) {
-        // if text data we need one more
-        payload = (uint8_t *) malloc(header->payloadLen + 1);
+        if(!streamed && header->opCode == WSop_continuation) {
+            // read the fragment directly behind the ones received so far
+            uint8_t * message = (uint8_t *) realloc(client->cWsMessage, client->cWsMessageLen + header->payloadLen + 1);
+            if(!message) {
+                DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] to less memory to handle payload %d!\n", client->num, header->payloadLen);
+                clientDisconnect(client, 1011);
+                return;
+            }
+            client->cWsMessage = message;
+            payload = (message + client->cWsMessageLen);
+        } else {
+            size_t size = header->payloadLen;
+            if(streamed && size > WEBSOCKETS_FRAGMENT_CHUNK_SIZE) {
+                size = WEBSOCKETS_FRAGMENT_CHUNK_SIZE;
+            }
 
-        if(!payload) {
-            DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] to less memory to handle payload %d!\n", client->num, header->payloadLen);
-            clientDisconnect(client, 1011);
-            return;
+            // if text data we need one more
+            payload = (uint8_t *) malloc(size + 1);
+
+            if(!payload) {
+                DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] to less memory to handle payload %d!\n", client->num, header->payloadLen);
+                clientDisconnect(client, 1011);
+                return;
+            }
         }
-        readCb(client, payload, header->payloadLen, std::bind(&WebSockets::handleWebsocketPayloadCb, this, std::placeholders::_1, std::placeholders::_2, payload));
+
+        handleWebsocketPayloadRead(client, payload);
     } else {
         handleWebsocketPayloadCb(client, true, NULL);
     }
 }
 
+/**
+ * read the next piece of the frame payload
+ * @param client WSclient_t *  ptr to the client struct
+ * @param payload uint8_t *    buffer for the piece
+ */
+void WebSockets::handleWebsocketPayloadRead(WSclient_t * client, uint8_t * payload) {
+    WSMessageHeader_t * header = &client->cWsHeaderDecode;
+    size_t len = (header->payloadLen - client->cWsPayloadIndex);
+    if(_fragmentEvents && header->opCode <= WSop_binary && !client->cWsCompressed && len > WEBSOCKETS_FRAGMENT_CHUNK_SIZE) {
+        len = WEBSOCKETS_FRAGMENT_CHUNK_SIZE;
+    }
+#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
+    readCb(client, payload, len, std::bind(&WebSockets::handleWebsocketPayloadCb, this, std::placeholders::_1, std::placeholders::_2, payload));
+#else
+    client->cWsPayloadRXsize += readAvailable(client, (payload + client->cWsPayloadRXsize), (len - client->cWsPayloadRXsize));
+    if(client->cWsPayloadRXsize < len) {
+        // keep the buffer, handleWebsocket goes on with it when more data is there
+        client->cWsPayload = payload;
+        return;
+    }
+    client->cWsPayload = NULL;
+    client->cWsPayloadRXsize = 0;
+    handleWebsocketPayloadCb(client, true, payload);
+#endif
+}
+
 void WebSockets::handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t * payload) {
 
     WSMessageHeader_t * header = &client->cWsHeaderDecode;
+    bool dataFrame = (header->opCode <= WSop_binary);
+    bool streamed = (_fragmentEvents && dataFrame && !client->cWsCompressed);
+    bool appended = (!streamed && header->opCode == WSop_continuation);
+
+    size_t len = (header->payloadLen - client->cWsPayloadIndex);
+    if(streamed && len > WEBSOCKETS_FRAGMENT_CHUNK_SIZE) {
+        len = WEBSOCKETS_FRAGMENT_CHUNK_SIZE;
+    }
+
     if(ok) {
-        if(header->payloadLen > 0) {
-            payload[header->payloadLen] = 0x00;
+        if(len > 0) {
+            payload[len] = 0x00;
 
             if(header->mask) {
                 //decode XOR
-                for(size_t i = 0; i < header->payloadLen; i++) {
-                    payload[i] = (payload[i] ^ header->maskKey[i % 4]);
-                }
+                maskPayload(payload, len, header->maskKey, client->cWsPayloadIndex);
             }
         }
 
-        switch(header->opCode) {
-            case WSop_text:
+        if(streamed) {
+            bool first = (header->opCode != WSop_continuation && client->cWsPayloadIndex == 0);
+            client->cWsPayloadIndex += len;
+            bool more = (client->cWsPayloadIndex < header->payloadLen);
+            bool last = (header->fin && !more);
+
+            if(header->opCode == WSop_text) {
                 DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] text: %s\n", client->num, payload);
-                // no break here!
-            case WSop_binary:
-                messageReceived(client, header->opCode, payload, header->payloadLen);
-                break;
-            case WSop_ping:
-                // send pong back
-                sendFrame(client, WSop_pong, payload, header->payloadLen);
-                break;
-            case WSop_pong:
-                DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] get pong  (%s)\n", client->num, payload);
-                break;
-            case WSop_close: {
-                uint16_t reasonCode = 1000;
-                if(header->payloadLen >= 2) {
-                    reasonCode = payload[0] << 8 | payload[1];
+            }
+
+            if(first && last) {
+                // complete message
+                messageReceived(client, header->opCode, payload, len, true);
+            } else if(first) {
+                client->cWsMessageOpcode = header->opCode;
+                messageReceived(client, header->opCode, payload, len, false);
+            } else {
+                if(last) {
+                    client->cWsMessageOpcode = WSop_continuation;
                 }
+                messageReceived(client, WSop_continuation, payload, len, last);
+            }
+
+            if(more && client->status == WSC_CONNECTED) {
+#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
+                handleWebsocketPayloadRead(client, payload);
+#else
+                // handleWebsocket reads the next piece into the same buffer
+                client->cWsPayload = payload;
+#endif
+                return;
+            }
+        } else if(dataFrame && header->opCode != WSop_continuation) {
+            if(header->opCode == WSop_text && !client->cWsCompressed) {
+                DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] text: %s\n", client->num, payload);
+            }
 
-                DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] get ask for close. Code: %d", client->num, reasonCode);
-                if(header->payloadLen > 2) {
-                    DEBUG_WEBSOCKETS(" (%s)\n", (payload + 2));
-                } else {
-                    DEBUG_WEBSOCKETS("\n");
+            if(header->fin) {
+                messageDeliver(client, header->opCode, payload, len, client->cWsCompressed);
+            } else {
+                // first fragment, the others are appended to it
+                client->cWsMessageOpcode = header->opCode;
+                client->cWsMessage = payload;
+                client->cWsMessageLen = len;
+                payload = NULL;
+            }
+        } else if(dataFrame) {
+            // fragment was read into cWsMessage
+            client->cWsMessageLen += len;
+            payload = NULL;
+
+            if(header->fin) {
+                uint8_t * message = client->cWsMessage;
+                size_t length = client->cWsMessageLen;
+                WSopcode_t opcode = client->cWsMessageOpcode;
+                bool compressed = client->cWsCompressed;
+                messageInit(client);
+
+                if(message) {
+                    message[length] = 0x00;
+                }
+                if(opcode == WSop_text && !compressed) {
+                    DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] text: %s\n", client->num, message);
+                }
+                messageDeliver(client, opcode, message, length, compressed);
+
+                if(message) {
+                    free(message);
                 }
-                clientDisconnect(client, 1000);
             }
-                break;
-            case WSop_continuation:
-                // continuation is not supported
-                clientDisconnect(client, 1003);
-                break;
-            default:
-                clientDisconnect(client, 1002);
-                break;
+        } else {
+            switch(header->opCode) {
+                case WSop_ping:
+                    // send pong back
+                    sendFrame(client, WSop_pong, payload, header->payloadLen);
+                    break;
+                case WSop_pong:
+                    DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] get pong  (%s)\n", client->num, payload);
+                    break;
+                case WSop_close: {
+                    uint16_t reasonCode = 1000;
+                    if(header->payloadLen >= 2) {
+                        reasonCode = payload[0] << 8 | payload[1];
+                    }
+
+                    DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] get ask for close. Code: %d", client->num, reasonCode);
+                    if(header->payloadLen > 2) {
+                        DEBUG_WEBSOCKETS(" (%s)\n", (payload + 2));
+                    } else {
+                        DEBUG_WEBSOCKETS("\n");
+                    }
+                    clientDisconnect(client, 1000);
+                }
+                    break;
+                default:
+                    clientDisconnect(client, 1002);
+                    break;
+            }
         }
 
         if(payload) {
@@ -464,6 +708,7 @@ void WebSockets::handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t
         }
 
         // reset input
+        client->cWsPayloadIndex = 0;
         client->cWsRXsize = 0;
 #if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
         //register callback for next message
@@ -472,32 +717,113 @@ void WebSockets::handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t
 
     } else {
         DEBUG_WEBSOCKETS("[WS][%d][handleWebsocket] missing data!\n", client->num);
-        free(payload);
+        if(!appended) {
+            free(payload);
+        }
+        client->cWsPayloadIndex = 0;
         clientDisconnect(client, 1002);
     }
 }
 
+/**
+ * forget the fragmented message in progress
+ * @param client WSclient_t *  ptr to the client struct
+ */
+void WebSockets::messageInit(WSclient_t * client) {
+    client->cWsPayloadIndex = 0;
+#if (WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+    client->cWsPayload = NULL;
+    client->cWsPayloadRXsize = 0;
+#endif
+    client->cWsMessageOpcode = WSop_continuation;
+    client->cWsMessage = NULL;
+    client->cWsMessageLen = 0;
+    client->cWsCompressed = false;
+}
+
+/**
+ * free the fragmented message in progress
+ * @param client WSclient_t *  ptr to the client struct
+ */
+void WebSockets::messageReset(WSclient_t * client) {
+#if (WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+    if(client->cWsPayload) {
+        // a fragment that is read straight behind the others goes with cWsMessage
+        bool appended = (client->cWsHeaderDecode.opCode == WSop_continuation && (!_fragmentEvents || client->cWsCompressed));
+        if(!appended) {
+            free(client->cWsPayload);
+        }
+    }
+#endif
+    if(client->cWsMessage) {
+        free(client->cWsMessage);
+    }
+    messageInit(client);
+}
+
+/**
+ * pass a complete message on, inflate it first if it is compressed
+ * @param client WSclient_t *  ptr to the client struct
+ * @param opcode WSopcode_t
+ * @param payload uint8_t *
+ * @param length size_t
+ * @param compressed bool   RSV1 was set on the first frame
+ */
+void WebSockets::messageDeliver(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length, bool compressed) {
+#ifdef WEBSOCKETS_USE_DEFLATE
+    if(compressed) {
+        size_t inflateLength;
+        uint8_t * inflated = ws_inflate_message(client->cDeflate, payload, length, WEBSOCKETS_MAX_DATA_SIZE, &inflateLength);
+        if(!inflated) {
+            DEBUG_WEBSOCKETS("[WS][%d][messageDeliver] inflate failed!\n", client->num);
+            clientDisconnect(client, 1007);
+            return;
+        }
+        DEBUG_WEBSOCKETS("[WS][%d][messageDeliver] inflate %u -> %u\n", client->num, length, inflateLength);
+        if(opcode == WSop_text) {
+            DEBUG_WEBSOCKETS("[WS][%d][messageDeliver] text: %s\n", client->num, inflated);
+        }
+        messageReceived(client, opcode, inflated, inflateLength, true);
+        free(inflated);
+        return;
+    }
+#endif
+    messageReceived(client, opcode, payload, length, true);
+}
+
+/**
+ * no permessage-deflate for a new connection
+ * @param client WSclient_t *  ptr to the client struct
+ */
+void WebSockets::deflateInit(WSclient_t * client) {
+    client->cWsCompressed = false;
+#ifdef WEBSOCKETS_USE_DEFLATE
+    client->cDeflate = NULL;
+#endif
+}
+
+/**
+ * free the permessage-deflate state of a connection
+ * @param client WSclient_t *  ptr to the client struct
+ */
+void WebSockets::deflateReset(WSclient_t * client) {
+#ifdef WEBSOCKETS_USE_DEFLATE
+    if(client->cDeflate) {
+        ws_deflate_free(client->cDeflate);
+    }
+#endif
+    deflateInit(client);
+}
+
 /**
  * generate the key for Sec-WebSocket-Accept
  * @param clientKey String
  * @return String Accept Key
  */
 String WebSockets::acceptKey(String & clientKey) {
-    uint8_t sha1HashBin[20] = { 0 };
-#ifdef ESP8266
-    sha1(clientKey + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11", &sha1HashBin[0]);
-#else
-    clientKey += "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
-    SHA1_CTX ctx;
-    SHA1Init(&ctx);
-    SHA1Update(&ctx, (const unsigned char*)clientKey.c_str(), clientKey.length());
-    SHA1Final(&sha1HashBin[0], &ctx);
-#endif
-
-    String key = base64_encode(sha1HashBin, 20);
-    key.trim();
-
-    return key;
+    char accept[WS_ACCEPT_KEY_SIZE];
+    ws_accept_key(clientKey.c_str(), clientKey.length(), accept);
+    return String(accept);
 }
 
 /**
@@ -507,14 +833,9 @@ String WebSockets::acceptKey(String & clientKey) {
  * @return base64 encoded String
  */
 String WebSockets::base64_encode(uint8_t * data, size_t length) {
-    size_t size = ((length * 1.6f) + 1);
-    char * buffer = (char *) malloc(size);
+    char * buffer = (char *) malloc(WS_BASE64_SIZE(length));
     if(buffer) {
-        base64_encodestate _state;
-        base64_init_encodestate(&_state);
-        int len = base64_encode_block((const char *) &data[0], length, &buffer[0], &_state);
-        len = base64_encode_blockend((buffer + len), &_state);
-
+        ws_base64_encode(data, length, buffer);
         String base64 = String(buffer);
         free(buffer);
         return base64;
@@ -522,15 +843,16 @@ String WebSockets::base64_encode(uint8_t * data, size_t length) {
     return String("-FAIL-");
 }
 
+#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
 /**
- * read x byte from tcp or get timeout
+ * read x byte from tcp
  * @param client WSclient_t *
  * @param out  uint8_t * data buffer
  * @param n size_t byte count
+ * @param cb WSreadWaitCb   called when the data is there or the connection is gone
  * @return true if ok
  */
 bool WebSockets::readCb(WSclient_t * client, uint8_t * out, size_t n, WSreadWaitCb cb) {
-#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
     if(!client->tcp || !client->tcp->connected()) {
         return false;
     }
@@ -540,60 +862,75 @@ bool WebSockets::readCb(WSclient_t * client, uint8_t * out, size_t n, WSreadWait
             cb(client, ok);
         }
     }, client, std::placeholders::_1, cb));
-
+    return true;
+}
 #else
-    unsigned long t = millis();
-    size_t len;
-    DEBUG_WEBSOCKETS("[readCb] n: %d t: %d\n", n, t);
-    while(n > 0) {
-        if(client->tcp == NULL) {
-            DEBUG_WEBSOCKETS("[readCb] tcp is null!\n");
-            if(cb) {
-                cb(client, false);
-            }
-            return false;
-        }
+/**
+ * read up to x byte that are already received, never waits for more
+ * @param client WSclient_t *
+ * @param out  uint8_t * data buffer
+ * @param n size_t max byte count
+ * @return byte count read
+ */
+size_t WebSockets::readAvailable(WSclient_t * client, uint8_t * out, size_t n) {
+    if(!client->tcp || n == 0) {
+        return 0;
+    }
 
-        if(!client->tcp->connected()) {
-            DEBUG_WEBSOCKETS("[readCb] not connected!\n");
-            if(cb) {
-                cb(client, false);
-            }
-            return false;
-        }
+    int len = client->tcp->available();
+    if(len <= 0) {
+        return 0;
+    }
 
-        if((millis() - t) > WEBSOCKETS_TCP_TIMEOUT) {
-            DEBUG_WEBSOCKETS("[readCb] receive TIMEOUT! %d\n", (millis() - t));
-            if(cb) {
-                cb(client, false);
-            }
-            return false;
-        }
+    if((size_t) len < n) {
+        n = len;
+    }
 
-        if(!client->tcp->available()) {
-#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266)
-            delay(0);
-#endif
-            continue;
-        }
+    len = client->tcp->read(out, n);
+    if(len <= 0) {
+        return 0;
+    }
+    client->cRxTime = millis();
+    return len;
+}
 
-        len = client->tcp->read((uint8_t*) out, n);
-        if(len) {
-            t = millis();
-            out += len;
-            n -= len;
-            //DEBUG_WEBSOCKETS("Receive %d left %d!\n", len, n);
-        } else {
-            //DEBUG_WEBSOCKETS("Receive %d left %d!\n", len, n);
+/**
+ * collect a HTTP header line in cHttpLine without waiting for the rest of it
+ * a line longer than WEBSOCKETS_MAX_HEADER_LINE disconnects the client
+ * @param client WSclient_t *
+ * @return true if cHttpLine holds a complete line (without the \n)
+ */
+bool WebSockets::readHeaderLine(WSclient_t * client) {
+    while(client->tcp && client->tcp->available() > 0) {
+        int c = client->tcp->read();
+        if(c < 0) {
+            break;
         }
-#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266)
-        delay(0);
-#endif
+        client->cRxTime = millis();
+        if(c == '\n') {
+            return true;
+        }
+        if(client->cHttpLine.length() >= WEBSOCKETS_MAX_HEADER_LINE) {
+            DEBUG_WEBSOCKETS("[WS][%d][readHeaderLine] header line too long!\n", client->num);
+            clientDisconnect(client);
+            return false;
+        }
+        client->cHttpLine += (char) c;
     }
-    if(cb) {
-        cb(client, true);
+    return false;
+}
+
+/**
+ * disconnect a client that stopped in the middle of the handshake or of a frame
+ * for more than WEBSOCKETS_TCP_TIMEOUT, an idle connection is left alone
+ * @param client WSclient_t *
+ */
+void WebSockets::handleRxTimeout(WSclient_t * client) {
+    bool pending = (client->status == WSC_HEADER || client->cWsRXsize > 0 || client->cWsPayload);
+    if(pending && (millis() - client->cRxTime) > WEBSOCKETS_TCP_TIMEOUT) {
+        DEBUG_WEBSOCKETS("[WS][%d][handleRxTimeout] receive TIMEOUT! %lu\n", client->num, (millis() - client->cRxTime));
+        clientDisconnect(client, 1002);
     }
-#endif
-    return true;
 }
+#endif
 
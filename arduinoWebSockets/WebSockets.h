@@ -6,6 +6,10 @@
  * Copyright (c) 2015 Markus Sattler. All rights reserved.
  * This file is part of the WebSockets for Arduino.
  *
+ * Needs the WebSocketsCodec library (wshandshake.c, wsdeflate.c) installed
+ * next to this one, on every platform including AVR: the Sec-WebSocket-Accept
+ * key and base64 come from there. The bundled libsha1 and libb64 are gone.
+ *
  * This library is free software; you can redistribute it and/or
  * modify it under the terms of the GNU Lesser General Public
  * License as published by the Free Software Foundation; either
@@ -37,6 +41,8 @@
 #ifdef ESP8266
 #define WEBSOCKETS_MAX_DATA_SIZE  (15*1024)
 #define WEBSOCKETS_USE_BIG_MEM
+// permessage-deflate, needs the WebSocketsCodec library
+#define WEBSOCKETS_USE_DEFLATE
 #else
 //atmega328p has only 2KB ram!
 #define WEBSOCKETS_MAX_DATA_SIZE  (1024)
@@ -44,6 +50,45 @@
 
 #define WEBSOCKETS_TCP_TIMEOUT    (2000)
 
+// longest HTTP header line, a peer that sends a longer one is disconnected
+#ifndef WEBSOCKETS_MAX_HEADER_LINE
+#ifdef __AVR__
+#define WEBSOCKETS_MAX_HEADER_LINE  (256)
+#else
+#define WEBSOCKETS_MAX_HEADER_LINE  (1024)
+#endif
+#endif
+
+// piece size when a frame is passed on with fragment events
+#ifndef WEBSOCKETS_FRAGMENT_CHUNK_SIZE
+#ifdef __AVR__
+#define WEBSOCKETS_FRAGMENT_CHUNK_SIZE  (128)
+#else
+#define WEBSOCKETS_FRAGMENT_CHUNK_SIZE  (1024)
+#endif
+#endif
+
+// default LZ77 window for permessage-deflate, each connection keeps up to 2 windows
+#ifndef WEBSOCKETS_DEFLATE_WINDOW_BITS
+#define WEBSOCKETS_DEFLATE_WINDOW_BITS  (10)
+#endif
+
+// Sec-WebSocket-Accept and base64, needs the WebSocketsCodec library (see above)
+#include <wshandshake.h>
+
+#ifdef WEBSOCKETS_USE_DEFLATE
+#include <wsdeflate.h>
+#endif
+
+// stack buffer used to mask frames that can not be masked in place
+#ifndef WEBSOCKETS_MASK_BUFFER_SIZE
+#ifdef __AVR__
+#define WEBSOCKETS_MASK_BUFFER_SIZE  (64)
+#else
+#define WEBSOCKETS_MASK_BUFFER_SIZE  (512)
+#endif
+#endif
+
 #define NETWORK_ESP8266_ASYNC   (0)
 #define NETWORK_ESP8266         (1)
 #define NETWORK_W5100           (2)
@@ -123,7 +168,11 @@ typedef enum {
     WStype_DISCONNECTED,
     WStype_CONNECTED,
     WStype_TEXT,
-    WStype_BIN
+    WStype_BIN,
+    WStype_FRAGMENT_TEXT_START,
+    WStype_FRAGMENT_BIN_START,
+    WStype_FRAGMENT,
+    WStype_FRAGMENT_FIN
 } WStype_t;
 
 typedef enum {
@@ -179,6 +228,21 @@ typedef struct {
         uint8_t cWsRXsize;  ///< State of the RX
         uint8_t cWsHeader[WEBSOCKETS_MAX_HEADER_SIZE]; ///< RX WS Message buffer
         WSMessageHeader_t cWsHeaderDecode;
+        size_t cWsPayloadIndex;     ///< bytes of the frame payload already passed on (fragment events)
+#if (WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+        uint8_t * cWsPayload;       ///< buffer of the payload (piece) that is not complete yet, NULL if none
+        size_t cWsPayloadRXsize;    ///< bytes of that payload (piece) received so far
+        unsigned long cRxTime;      ///< millis() of the last progress of the handshake or of a frame that is not complete yet
+#endif
+
+        WSopcode_t cWsMessageOpcode; ///< opcode of the fragmented message in progress, WSop_continuation if none
+        uint8_t * cWsMessage;       ///< fragments received so far
+        size_t cWsMessageLen;       ///< length of the fragments received so far
+        bool cWsCompressed;         ///< message in progress has RSV1 set (permessage-deflate)
+
+#ifdef WEBSOCKETS_USE_DEFLATE
+        ws_deflate_t * cDeflate;    ///< permessage-deflate state, NULL if not negotiated
+#endif
 
         String base64Authorization; ///< Base64 encoded Auth request
         String plainAuthorization; ///< Base64 encoded Auth request
@@ -186,16 +250,25 @@ typedef struct {
         bool cHttpHeadersValid; ///< non-websocket http header validity indicator
         size_t cMandatoryHeadersCount; ///< non-websocket mandatory http headers present count
 
-#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
-        String cHttpLine;   ///< HTTP header lines
-#endif
+        String cHttpLine;   ///< HTTP header line received so far
 
 } WSclient_t;
 
 
 
 class WebSockets {
+    public:
+        static void maskPayload(uint8_t * data, size_t length, const uint8_t * maskKey, size_t offset = 0);
+
     protected:
+        WebSockets() : _fragmentEvents(false), _deflate(false) {}
+
+        bool _fragmentEvents; ///< pass fragmented and large messages on piece by piece instead of reassembling them
+        bool _deflate;        ///< negotiate permessage-deflate
+#ifdef WEBSOCKETS_USE_DEFLATE
+        ws_deflate_config_t _deflateConfig;
+#endif
+
 #ifdef __AVR__
         typedef void (*WSreadWaitCb)(WSclient_t * client, bool ok);
 #else
@@ -205,10 +278,11 @@ class WebSockets {
         virtual void clientDisconnect(WSclient_t * client);
         virtual bool clientIsConnected(WSclient_t * client);
 
-        virtual void messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length);
+        virtual void messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length, bool fin);
 
         void clientDisconnect(WSclient_t * client, uint16_t code, char * reason = NULL, size_t reasonLen = 0);
-        bool sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * payload = NULL, size_t length = 0, bool mask = false, bool fin = true, bool headerToPayload = false);
+        bool sendFrame(WSclient_t * client, WSopcode_t opcode, uint8_t * payload = NULL, size_t length = 0, bool mask = false, bool fin = true, bool headerToPayload = false, bool compressed = false);
+        uint8_t createHeader(uint8_t * buffer, WSopcode_t opcode, size_t length, bool mask, uint8_t * maskKey, bool fin, bool compressed = false);
 
         void headerDone(WSclient_t * client);
 
@@ -216,12 +290,26 @@ class WebSockets {
 
         bool handleWebsocketWaitFor(WSclient_t * client, size_t size);
         void handleWebsocketCb(WSclient_t * client);
+        void handleWebsocketPayloadRead(WSclient_t * client, uint8_t * payload);
         void handleWebsocketPayloadCb(WSclient_t * client, bool ok, uint8_t * payload);
 
+        void messageDeliver(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length, bool compressed);
+        void messageInit(WSclient_t * client);
+        void messageReset(WSclient_t * client);
+
+        void deflateInit(WSclient_t * client);
+        void deflateReset(WSclient_t * client);
+
         String acceptKey(String & clientKey);
         String base64_encode(uint8_t * data, size_t length);
 
+#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
         bool readCb(WSclient_t * client, uint8_t *out, size_t n, WSreadWaitCb cb);
+#else
+        size_t readAvailable(WSclient_t * client, uint8_t * out, size_t n);
+        bool readHeaderLine(WSclient_t * client);
+        void handleRxTimeout(WSclient_t * client);
+#endif
 
 
 };
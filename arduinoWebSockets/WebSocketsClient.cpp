@@ -29,6 +29,9 @@
 WebSocketsClient::WebSocketsClient() {
     _cbEvent = NULL;
     _client.num = 0;
+    _client.cWsRXsize = 0;
+    messageInit(&_client);
+    deflateInit(&_client);
 }
 
 WebSocketsClient::~WebSocketsClient() {
@@ -234,6 +237,33 @@ void WebSocketsClient::setAuthorization(const char * auth) {
     }
 }
 
+/**
+ * pass fragmented messages and messages larger than WEBSOCKETS_MAX_DATA_SIZE on piece by piece
+ * (WStype_FRAGMENT_TEXT_START / WStype_FRAGMENT_BIN_START, WStype_FRAGMENT..., WStype_FRAGMENT_FIN)
+ * instead of reassembling them, a message that arrives in one piece is still passed as WStype_TEXT / WStype_BIN
+ * @param enable bool
+ */
+void WebSocketsClient::setFragmentEvents(bool enable) {
+    _fragmentEvents = enable;
+}
+
+/**
+ * offer permessage-deflate (RFC 7692) to the server, if it is accepted text and binary messages
+ * are compressed when that makes them smaller. The connection keeps up to 2 windows of (1 << windowBits) byte
+ * between messages, with noContextTakeover none are kept (less RAM, less compression).
+ * Only has an effect if WEBSOCKETS_USE_DEFLATE is defined, used from the next connect on.
+ * @param enable bool
+ * @param windowBits uint8_t    8 - 15
+ * @param noContextTakeover bool
+ */
+void WebSocketsClient::setDeflate(bool enable, uint8_t windowBits, bool noContextTakeover) {
+#ifdef WEBSOCKETS_USE_DEFLATE
+    _deflate = enable;
+    _deflateConfig.windowBits = windowBits;
+    _deflateConfig.noContextTakeover = noContextTakeover;
+#endif
+}
+
 //#################################################################################
 //#################################################################################
 //#################################################################################
@@ -244,16 +274,20 @@ void WebSocketsClient::setAuthorization(const char * auth) {
  * @param opcode WSopcode_t
  * @param payload  uint8_t *
  * @param lenght size_t
+ * @param fin bool  false for all but the last piece of a fragmented message
  */
-void WebSocketsClient::messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t lenght) {
+void WebSocketsClient::messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t lenght, bool fin) {
     WStype_t type = WStype_ERROR;
 
     switch(opcode) {
         case WSop_text:
-            type = WStype_TEXT;
+            type = fin ? WStype_TEXT : WStype_FRAGMENT_TEXT_START;
             break;
         case WSop_binary:
-            type = WStype_BIN;
+            type = fin ? WStype_BIN : WStype_FRAGMENT_BIN_START;
+            break;
+        case WSop_continuation:
+            type = fin ? WStype_FRAGMENT_FIN : WStype_FRAGMENT;
             break;
     }
 
@@ -302,9 +336,14 @@ void WebSocketsClient::clientDisconnect(WSclient_t * client) {
     client->cKey = "";
     client->cAccept = "";
     client->cProtocol = "";
+    client->cExtensions = "";
     client->cVersion = 0;
     client->cIsUpgrade = false;
     client->cIsWebsocket = false;
+    client->cWsRXsize = 0;
+    messageReset(client);
+    deflateReset(client);
+    client->cHttpLine = "";
 
     client->status = WSC_NOT_CONNECTED;
 
@@ -354,10 +393,10 @@ void WebSocketsClient::handleClientData(void) {
     if(len > 0) {
         switch(_client.status) {
             case WSC_HEADER:
-            {
-                String headerLine = _client.tcp->readStringUntil('\n');
-                handleHeader(&_client, &headerLine);
-            }
+                // complete lines only, the rest of a line stays in cHttpLine
+                while(_client.status == WSC_HEADER && readHeaderLine(&_client)) {
+                    handleHeader(&_client, &_client.cHttpLine);
+                }
                 break;
             case WSC_CONNECTED:
                 WebSockets::handleWebsocket(&_client);
@@ -366,6 +405,9 @@ void WebSocketsClient::handleClientData(void) {
                 WebSockets::clientDisconnect(&_client, 1002);
                 break;
         }
+    } else {
+        // nothing new, the handshake or frame in progress may have timed out
+        handleRxTimeout(&_client);
     }
 #if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266)
     delay(0);
@@ -393,6 +435,14 @@ void WebSocketsClient::sendHeader(WSclient_t * client) {
     unsigned long start = micros();
 #endif
 
+#ifdef WEBSOCKETS_USE_DEFLATE
+    if(_deflate) {
+        char offer[WS_DEFLATE_HEADER_SIZE];
+        ws_deflate_offer(&_deflateConfig, offer);
+        client->cExtensions = offer;
+    }
+#endif
+
     String handshake =  "GET " + client->cUrl + " HTTP/1.1\r\n"
                         "Host: " + _host + ":" + _port + "\r\n"
                         "Connection: Upgrade\r\n"
@@ -420,6 +470,9 @@ void WebSocketsClient::sendHeader(WSclient_t * client) {
 
     handshake += "\r\n";
 
+    // from now on holds the answer of the server
+    client->cExtensions = "";
+
     client->tcp->write(handshake.c_str(), handshake.length());
 
 #if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
@@ -522,6 +575,26 @@ void WebSocketsClient::handleHeader(WSclient_t * client, String * headerLine) {
             }
         }
 
+#ifdef WEBSOCKETS_USE_DEFLATE
+        if(ok && _deflate && client->cExtensions.length() > 0) {
+            ws_deflate_params_t params;
+            switch(ws_deflate_response(client->cExtensions.c_str(), &_deflateConfig, &params)) {
+                case 1:
+                    client->cDeflate = ws_deflate_new(&params);
+                    if(!client->cDeflate) {
+                        ok = false;
+                    }
+                    break;
+                case 0:
+                    break;
+                default:
+                    DEBUG_WEBSOCKETS("[WS-Client][handleHeader] Sec-WebSocket-Extensions is wrong\n");
+                    ok = false;
+                    break;
+            }
+        }
+#endif
+
         if(ok) {
 
             DEBUG_WEBSOCKETS("[WS-Client][handleHeader] Websocket connection init done.\n");
@@ -560,6 +633,7 @@ void WebSocketsClient::connectedCb() {
 #if (WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
     // set Timeout for readBytesUntil and readStringUntil
     _client.tcp->setTimeout(WEBSOCKETS_TCP_TIMEOUT);
+    _client.cRxTime = millis();
 #endif
 
 #if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266)
@@ -71,6 +71,9 @@ class WebSocketsClient: private WebSockets {
         void setAuthorization(const char * user, const char * password);
         void setAuthorization(const char * auth);
 
+        void setFragmentEvents(bool enable);
+        void setDeflate(bool enable, uint8_t windowBits = WEBSOCKETS_DEFLATE_WINDOW_BITS, bool noContextTakeover = false);
+
     protected:
         String _host;
         uint16_t _port;
@@ -82,7 +85,7 @@ class WebSocketsClient: private WebSockets {
 
         WebSocketClientEvent _cbEvent;
 
-        void messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length);
+        void messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length, bool fin);
 
         void clientDisconnect(WSclient_t * client);
         bool clientIsConnected(WSclient_t * client);
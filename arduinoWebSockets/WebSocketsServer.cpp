@@ -83,6 +83,7 @@ void WebSocketsServer::begin(void) {
         client->cCode = 0;
         client->cKey = "";
         client->cProtocol = "";
+        client->cExtensions = "";
         client->cVersion = 0;
         client->cIsUpgrade = false;
         client->cIsWebsocket = false;
@@ -90,10 +91,10 @@ void WebSocketsServer::begin(void) {
         client->base64Authorization = "";
 
         client->cWsRXsize = 0;
+        messageInit(client);
+        deflateInit(client);
 
-#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
         client->cHttpLine = "";
-#endif
     }
 
 #ifdef ESP8266
@@ -103,6 +104,10 @@ void WebSocketsServer::begin(void) {
     randomSeed(millis());
 #endif
 
+#if (WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+    _clientsActive = 0;
+#endif
+
     _server->begin();
 
     DEBUG_WEBSOCKETS("[WS-Server] Server Started.\n");
@@ -196,24 +201,10 @@ bool WebSocketsServer::sendTXT(uint8_t num, String & payload) {
  * @return true if ok
  */
 bool WebSocketsServer::broadcastTXT(uint8_t * payload, size_t length, bool headerToPayload) {
-    WSclient_t * client;
-    bool ret = true;
     if(length == 0) {
-        length = strlen((const char *) payload);
-    }
-
-    for(uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
-        client = &_clients[i];
-        if(clientIsConnected(client)) {
-            if(!sendFrame(client, WSop_text, payload, length, false, true, headerToPayload)) {
-                ret = false;
-            }
-        }
-#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266)
-        delay(0);
-#endif
+        length = strlen((const char *) (payload + (headerToPayload ? WEBSOCKETS_MAX_HEADER_SIZE : 0)));
     }
-    return ret;
+    return broadcastFrame(WSop_text, payload, length, headerToPayload);
 }
 
 bool WebSocketsServer::broadcastTXT(const uint8_t * payload, size_t length) {
@@ -263,24 +254,93 @@ bool WebSocketsServer::sendBIN(uint8_t num, const uint8_t * payload, size_t leng
  * @return true if ok
  */
 bool WebSocketsServer::broadcastBIN(uint8_t * payload, size_t length, bool headerToPayload) {
+    return broadcastFrame(WSop_binary, payload, length, headerToPayload);
+}
+
+bool WebSocketsServer::broadcastBIN(const uint8_t * payload, size_t length) {
+    return broadcastBIN((uint8_t *) payload, length);
+}
+
+/**
+ * send one frame to all connected clients
+ * the frame is encoded once and the same bytes are written to every client,
+ * clients with permessage-deflate get their own compressed frame
+ * @param opcode WSopcode_t
+ * @param payload uint8_t *
+ * @param length size_t
+ * @param headerToPayload bool  (see sendFrame for more details)
+ * @return true if all clients got the frame
+ */
+bool WebSocketsServer::broadcastFrame(WSopcode_t opcode, uint8_t * payload, size_t length, bool headerToPayload) {
     WSclient_t * client;
     bool ret = true;
+
+    uint8_t buffer[WEBSOCKETS_MAX_HEADER_SIZE];
+    uint8_t * frame = NULL;
+    uint8_t * payloadPtr = (headerToPayload ? (payload + WEBSOCKETS_MAX_HEADER_SIZE) : payload);
+    bool useInternBuffer = false;
+
+    if(headerToPayload) {
+        frame = payload;
+    }
+#ifdef WEBSOCKETS_USE_BIG_MEM
+    else if((length > 0) && (ESP.getFreeHeap() > (length + 6000))) {
+        // one copy for all clients, header and payload go out in one write
+        frame = (uint8_t *) malloc(length + WEBSOCKETS_MAX_HEADER_SIZE);
+        if(frame) {
+            memcpy((frame + WEBSOCKETS_MAX_HEADER_SIZE), payload, length);
+            payloadPtr = (frame + WEBSOCKETS_MAX_HEADER_SIZE);
+            useInternBuffer = true;
+        }
+    }
+#endif
+
+    uint8_t headerSize = createHeader((frame ? frame : &buffer[0]), opcode, length, false, NULL, true);
+    uint8_t * headerPtr = ((frame ? frame : &buffer[0]) + (WEBSOCKETS_MAX_HEADER_SIZE - headerSize));
+
     for(uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
         client = &_clients[i];
-        if(clientIsConnected(client)) {
-            if(!sendFrame(client, WSop_binary, payload, length, false, true, headerToPayload)) {
+        if(clientIsConnected(client) && client->status == WSC_CONNECTED) {
+#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
+            // do not pile up more data for a client that does not read
+            size_t buffered = client->tcp->txBuffered();
+            if(buffered > 0 && (buffered + headerSize + length) > WEBSOCKETS_SERVER_BROADCAST_TX_LIMIT) {
+                DEBUG_WEBSOCKETS("[WS-Server][%d][broadcast] TX buffer full (%d), skip frame\n", client->num, buffered);
                 ret = false;
+                continue;
+            }
+#endif
+#ifdef WEBSOCKETS_USE_DEFLATE
+            if(client->cDeflate) {
+                // the compressed frame depends on the window of the client
+                if(!sendFrame(client, opcode, payloadPtr, length)) {
+                    ret = false;
+                }
+                continue;
+            }
+#endif
+            if(frame) {
+                if(client->tcp->write(headerPtr, (headerSize + length)) != (headerSize + length)) {
+                    ret = false;
+                }
+            } else {
+                if(client->tcp->write(headerPtr, headerSize) != headerSize) {
+                    ret = false;
+                } else if(length > 0 && client->tcp->write(payloadPtr, length) != length) {
+                    ret = false;
+                }
             }
         }
 #if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266)
         delay(0);
 #endif
     }
-    return ret;
-}
 
-bool WebSocketsServer::broadcastBIN(const uint8_t * payload, size_t length) {
-    return broadcastBIN((uint8_t *) payload, length);
+    if(useInternBuffer) {
+        free(frame);
+    }
+
+    return ret;
 }
 
 /**
@@ -335,6 +395,33 @@ void WebSocketsServer::setAuthorization(const char * auth) {
     }
 }
 
+/**
+ * pass fragmented messages and messages larger than WEBSOCKETS_MAX_DATA_SIZE on piece by piece
+ * (WStype_FRAGMENT_TEXT_START / WStype_FRAGMENT_BIN_START, WStype_FRAGMENT..., WStype_FRAGMENT_FIN)
+ * instead of reassembling them, a message that arrives in one piece is still passed as WStype_TEXT / WStype_BIN
+ * @param enable bool
+ */
+void WebSocketsServer::setFragmentEvents(bool enable) {
+    _fragmentEvents = enable;
+}
+
+/**
+ * accept permessage-deflate (RFC 7692) when a client offers it, text and binary messages are then compressed
+ * if that makes them smaller. Each connection keeps up to 2 windows of (1 << windowBits) byte between messages,
+ * with noContextTakeover none are kept (less RAM, less compression).
+ * Only has an effect if WEBSOCKETS_USE_DEFLATE is defined, set it before clients connect.
+ * @param enable bool
+ * @param windowBits uint8_t    8 - 15
+ * @param noContextTakeover bool
+ */
+void WebSocketsServer::setDeflate(bool enable, uint8_t windowBits, bool noContextTakeover) {
+#ifdef WEBSOCKETS_USE_DEFLATE
+    _deflate = enable;
+    _deflateConfig.windowBits = windowBits;
+    _deflateConfig.noContextTakeover = noContextTakeover;
+#endif
+}
+
 #if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266) || (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
 /**
  * get an IP for a client
@@ -379,6 +466,8 @@ bool WebSocketsServer::newClient(WEBSOCKETS_NETWORK_CLASS * TCPclient) {
 #if (WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
             // set Timeout for readBytesUntil and readStringUntil
             client->tcp->setTimeout(WEBSOCKETS_TCP_TIMEOUT);
+            client->cRxTime = millis();
+            _clientsActive |= (1UL << i);
 #endif
             client->status = WSC_HEADER;
 #if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266) || (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
@@ -418,16 +507,20 @@ bool WebSocketsServer::newClient(WEBSOCKETS_NETWORK_CLASS * TCPclient) {
  * @param opcode WSopcode_t
  * @param payload  uint8_t *
  * @param lenght size_t
+ * @param fin bool  false for all but the last piece of a fragmented message
  */
-void WebSocketsServer::messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t lenght) {
+void WebSocketsServer::messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t lenght, bool fin) {
     WStype_t type = WStype_ERROR;
 
     switch(opcode) {
         case WSop_text:
-            type = WStype_TEXT;
+            type = fin ? WStype_TEXT : WStype_FRAGMENT_TEXT_START;
             break;
         case WSop_binary:
-            type = WStype_BIN;
+            type = fin ? WStype_BIN : WStype_FRAGMENT_BIN_START;
+            break;
+        case WSop_continuation:
+            type = fin ? WStype_FRAGMENT_FIN : WStype_FRAGMENT;
             break;
     }
 
@@ -472,17 +565,21 @@ void WebSocketsServer::clientDisconnect(WSclient_t * client) {
     client->cUrl = "";
     client->cKey = "";
     client->cProtocol = "";
+    client->cExtensions = "";
     client->cVersion = 0;
     client->cIsUpgrade = false;
     client->cIsWebsocket = false;
 
     client->cWsRXsize = 0;
+    messageReset(client);
+    deflateReset(client);
 
-#if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
     client->cHttpLine = "";
-#endif
 
     client->status = WSC_NOT_CONNECTED;
+#if (WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+    _clientsActive &= ~(1UL << client->num);
+#endif
 
     DEBUG_WEBSOCKETS("[WS-Server][%d] client disconnected.\n", client->num);
 
@@ -572,7 +669,12 @@ void WebSocketsServer::handleNewClients(void) {
 void WebSocketsServer::handleClientData(void) {
 
     WSclient_t * client;
-    for(uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    // free slots are skipped, nothing here waits for data that is not there yet
+    uint32_t active = _clientsActive;
+    for(uint8_t i = 0; active; i++, active >>= 1) {
+        if(!(active & 1)) {
+            continue;
+        }
         client = &_clients[i];
         if(clientIsConnected(client)) {
             int len = client->tcp->available();
@@ -580,10 +682,10 @@ void WebSocketsServer::handleClientData(void) {
                 //DEBUG_WEBSOCKETS("[WS-Server][%d][handleClientData] len: %d\n", client->num, len);
                 switch(client->status) {
                     case WSC_HEADER:
-                    {
-                        String headerLine = client->tcp->readStringUntil('\n');
-                        handleHeader(client, &headerLine);
-                    }
+                        // complete lines only, the rest of a line stays in cHttpLine
+                        while(client->status == WSC_HEADER && readHeaderLine(client)) {
+                            handleHeader(client, &client->cHttpLine);
+                        }
                         break;
                     case WSC_CONNECTED:
                         WebSockets::handleWebsocket(client);
@@ -592,6 +694,9 @@ void WebSocketsServer::handleClientData(void) {
                         WebSockets::clientDisconnect(client, 1002);
                         break;
                 }
+            } else {
+                // nothing new, the handshake or frame in progress may have timed out
+                handleRxTimeout(client);
             }
         }
 #if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266)
@@ -727,9 +832,10 @@ void WebSocketsServer::handleHeader(WSclient_t * client, String * headerLine) {
             DEBUG_WEBSOCKETS("[WS-Server][%d][handleHeader] Websocket connection incoming.\n", client->num);
 
             // generate Sec-WebSocket-Accept key
-            String sKey = acceptKey(client->cKey);
+            char sKey[WS_ACCEPT_KEY_SIZE];
+            ws_accept_key(client->cKey.c_str(), client->cKey.length(), sKey);
 
-            DEBUG_WEBSOCKETS("[WS-Server][%d][handleHeader]  - sKey: %s\n", client->num, sKey.c_str());
+            DEBUG_WEBSOCKETS("[WS-Server][%d][handleHeader]  - sKey: %s\n", client->num, sKey);
 
             client->status = WSC_CONNECTED;
 
@@ -739,7 +845,7 @@ void WebSocketsServer::handleHeader(WSclient_t * client, String * headerLine) {
                     "Connection: Upgrade\r\n"
                     "Sec-WebSocket-Version: 13\r\n"
                     "Sec-WebSocket-Accept: ");
-            client->tcp->write(sKey.c_str(), sKey.length());
+            client->tcp->write(sKey, (WS_ACCEPT_KEY_SIZE - 1));
 
             if(_origin.length() > 0) {
                 String origin = "\r\nAccess-Control-Allow-Origin: ";
@@ -757,6 +863,23 @@ void WebSocketsServer::handleHeader(WSclient_t * client, String * headerLine) {
                 client->tcp->write("\r\n");
             }
 
+#ifdef WEBSOCKETS_USE_DEFLATE
+            if(_deflate && client->cExtensions.length() > 0) {
+                ws_deflate_params_t params;
+                char response[WS_DEFLATE_HEADER_SIZE];
+                if(ws_deflate_accept(client->cExtensions.c_str(), &_deflateConfig, &params, response)) {
+                    client->cDeflate = ws_deflate_new(&params);
+                }
+                if(client->cDeflate) {
+                    DEBUG_WEBSOCKETS("[WS-Server][%d][handleHeader]  - deflate: %s\n", client->num, response);
+                    String extensions = "Sec-WebSocket-Extensions: ";
+                    extensions += response;
+                    extensions += "\r\n";
+                    client->tcp->write(extensions.c_str(), extensions.length());
+                }
+            }
+#endif
+
             // header end
             client->tcp->write("\r\n");
 
@@ -30,6 +30,15 @@
 
 #define WEBSOCKETS_SERVER_CLIENT_MAX  (5)
 
+#if (WEBSOCKETS_SERVER_CLIENT_MAX > 32)
+#error "WEBSOCKETS_SERVER_CLIENT_MAX has to fit in _clientsActive"
+#endif
+
+#ifndef WEBSOCKETS_SERVER_BROADCAST_TX_LIMIT
+// broadcasts skip clients that have more than this still waiting in their TX buffer (async only)
+#define WEBSOCKETS_SERVER_BROADCAST_TX_LIMIT  (8 * 1024)
+#endif
+
 
 
 
@@ -87,6 +96,9 @@ public:
         void setAuthorization(const char * user, const char * password);
         void setAuthorization(const char * auth);
 
+        void setFragmentEvents(bool enable);
+        void setDeflate(bool enable, uint8_t windowBits = WEBSOCKETS_DEFLATE_WINDOW_BITS, bool noContextTakeover = false);
+
 #if (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266) || (WEBSOCKETS_NETWORK_TYPE == NETWORK_ESP8266_ASYNC)
         IPAddress remoteIP(uint8_t num);
 #endif
@@ -102,17 +114,22 @@ protected:
         WEBSOCKETS_NETWORK_SERVER_CLASS * _server;
 
         WSclient_t _clients[WEBSOCKETS_SERVER_CLIENT_MAX];
+#if (WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
+        uint32_t _clientsActive; ///< bit per _clients slot that holds a connection, loop only looks at these
+#endif
 
         WebSocketServerEvent _cbEvent;
         WebSocketServerHttpHeaderValFunc _httpHeaderValidationFunc;
 
         bool newClient(WEBSOCKETS_NETWORK_CLASS * TCPclient);
 
-        void messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length);
+        void messageReceived(WSclient_t * client, WSopcode_t opcode, uint8_t * payload, size_t length, bool fin);
 
         void clientDisconnect(WSclient_t * client);
         bool clientIsConnected(WSclient_t * client);
 
+        bool broadcastFrame(WSopcode_t opcode, uint8_t * payload, size_t length, bool headerToPayload);
+
 #if (WEBSOCKETS_NETWORK_TYPE != NETWORK_ESP8266_ASYNC)
         void handleNewClients(void);
         void handleClientData(void);
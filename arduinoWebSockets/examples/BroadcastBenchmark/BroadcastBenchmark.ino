@@ -0,0 +1,94 @@
+/*
+ * BroadcastBenchmark.ino
+ *
+ *  Created on: 16.10.2026
+ *
+ * times broadcastBIN for a small and a large message every time the number
+ * of connected clients changes, connect 1 to WEBSOCKETS_SERVER_CLIENT_MAX
+ * browsers to see how the broadcast time grows with the client count
+ *
+ */
+
+#include <Arduino.h>
+
+#include <ESP8266WiFi.h>
+#include <ESP8266WiFiMulti.h>
+#include <WebSocketsServer.h>
+#include <Hash.h>
+
+ESP8266WiFiMulti WiFiMulti;
+
+WebSocketsServer webSocket = WebSocketsServer(81);
+
+#define USE_SERIAL Serial1
+
+#define BENCH_ROUNDS    (100)
+
+uint8_t message[1024];
+uint8_t clients = 0;
+bool changed = false;
+
+void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t lenght) {
+
+    switch(type) {
+        case WStype_DISCONNECTED:
+            clients--;
+            changed = true;
+            break;
+        case WStype_CONNECTED:
+            clients++;
+            changed = true;
+            break;
+    }
+
+}
+
+void bench(size_t lenght) {
+    uint32_t heap = ESP.getFreeHeap();
+    unsigned long start = micros();
+    for(uint16_t r = 0; r < BENCH_ROUNDS; r++) {
+        webSocket.broadcastBIN(message, lenght);
+    }
+    unsigned long time = (micros() - start);
+
+    USE_SERIAL.printf("clients: %u lenght: %u broadcast: %lu us heap: %u\n", clients, lenght, (time / BENCH_ROUNDS), heap);
+}
+
+void setup() {
+    USE_SERIAL.begin(115200);
+
+    USE_SERIAL.setDebugOutput(true);
+
+    USE_SERIAL.println();
+    USE_SERIAL.println();
+    USE_SERIAL.println();
+
+    for(uint8_t t = 4; t > 0; t--) {
+        USE_SERIAL.printf("[SETUP] BOOT WAIT %d...\n", t);
+        USE_SERIAL.flush();
+        delay(1000);
+    }
+
+    for(size_t i = 0; i < sizeof(message); i++) {
+        message[i] = i;
+    }
+
+    WiFiMulti.addAP("SSID", "passpasspass");
+
+    while(WiFiMulti.run() != WL_CONNECTED) {
+        delay(100);
+    }
+
+    webSocket.begin();
+    webSocket.onEvent(webSocketEvent);
+}
+
+void loop() {
+    webSocket.loop();
+
+    if(changed && clients > 0) {
+        changed = false;
+        bench(64);
+        bench(sizeof(message));
+    }
+}
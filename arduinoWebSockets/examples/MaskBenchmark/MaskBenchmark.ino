@@ -0,0 +1,87 @@
+/*
+ * MaskBenchmark.ino
+ *
+ *  Created on: 16.10.2026
+ *
+ * checks WebSockets::maskPayload against a byte by byte XOR for odd lengths,
+ * buffer alignments and stream offsets, then times both on a 1KB message
+ *
+ */
+
+#include <Arduino.h>
+
+#include <WebSockets.h>
+
+#define USE_SERIAL Serial
+
+#define BENCH_SIZE      (1024)
+#define BENCH_ROUNDS    (1000)
+
+uint8_t buffer[BENCH_SIZE + 8];
+uint8_t reference[BENCH_SIZE + 8];
+uint8_t maskKey[4] = { 0x37, 0xFA, 0x21, 0x3D };
+
+void maskBytewise(uint8_t * data, size_t length, const uint8_t * key, size_t offset) {
+    for(size_t i = 0; i < length; i++) {
+        data[i] = (data[i] ^ key[(i + offset) % 4]);
+    }
+}
+
+bool selfTest(void) {
+    for(size_t align = 0; align < 4; align++) {
+        for(size_t length = 0; length < 67; length++) {
+            for(size_t offset = 0; offset < 4; offset++) {
+                for(size_t i = 0; i < sizeof(buffer); i++) {
+                    buffer[i] = reference[i] = random(0x100);
+                }
+                WebSockets::maskPayload(&buffer[align], length, maskKey, offset);
+                maskBytewise(&reference[align], length, maskKey, offset);
+                bool ok = (memcmp(buffer, reference, sizeof(buffer)) == 0);
+
+                // unmask again in two pieces
+                size_t cut = (length / 3);
+                WebSockets::maskPayload(&buffer[align], cut, maskKey, offset);
+                WebSockets::maskPayload(&buffer[align + cut], (length - cut), maskKey, (offset + cut));
+                maskBytewise(&reference[align], length, maskKey, offset);
+                ok = ok && (memcmp(buffer, reference, sizeof(buffer)) == 0);
+
+                if(!ok) {
+                    USE_SERIAL.printf("FAIL align: %u length: %u offset: %u\n", align, length, offset);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void bench(size_t align) {
+    unsigned long start = micros();
+    for(uint16_t r = 0; r < BENCH_ROUNDS; r++) {
+        maskBytewise(&buffer[align], BENCH_SIZE, maskKey, 0);
+    }
+    unsigned long bytewise = (micros() - start);
+
+    start = micros();
+    for(uint16_t r = 0; r < BENCH_ROUNDS; r++) {
+        WebSockets::maskPayload(&buffer[align], BENCH_SIZE, maskKey);
+    }
+    unsigned long words = (micros() - start);
+
+    USE_SERIAL.printf("align %u: bytewise %lu us, maskPayload %lu us per %u byte message (x%lu)\n", align,
+            (bytewise / BENCH_ROUNDS), (words / BENCH_ROUNDS), BENCH_SIZE, (words ? (bytewise / words) : 0));
+}
+
+void setup() {
+    USE_SERIAL.begin(115200);
+    USE_SERIAL.println();
+
+    USE_SERIAL.println(selfTest() ? "self test ok" : "self test FAILED");
+
+    bench(0);
+    bench(1);
+    bench(3);
+}
+
+void loop() {
+}
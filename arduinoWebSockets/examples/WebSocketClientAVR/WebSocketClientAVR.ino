@@ -3,6 +3,8 @@
  *
  *  Created on: 10.12.2015
  *
+ *  needs the WebSocketsCodec library next to arduinoWebSockets
+ *
  */
 
 #include <Arduino.h>
@@ -0,0 +1,101 @@
+/*
+ * WebSocketServerFragmentation.ino
+ *
+ *  Created on: 16.10.2026
+ *
+ * receives messages of any size in pieces of WEBSOCKETS_FRAGMENT_CHUNK_SIZE
+ * and only keeps a running checksum, without buffering the whole message
+ *
+ */
+
+#include <Arduino.h>
+
+#include <ESP8266WiFi.h>
+#include <ESP8266WiFiMulti.h>
+#include <WebSocketsServer.h>
+#include <Hash.h>
+
+ESP8266WiFiMulti WiFiMulti;
+
+WebSocketsServer webSocket = WebSocketsServer(81);
+
+#define USE_SERIAL Serial1
+
+size_t messageLength[WEBSOCKETS_SERVER_CLIENT_MAX];
+uint32_t messageSum[WEBSOCKETS_SERVER_CLIENT_MAX];
+
+void messageUpdate(uint8_t num, uint8_t * payload, size_t lenght) {
+    for(size_t i = 0; i < lenght; i++) {
+        messageSum[num] += payload[i];
+    }
+    messageLength[num] += lenght;
+}
+
+void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t lenght) {
+
+    switch(type) {
+        case WStype_DISCONNECTED:
+            USE_SERIAL.printf("[%u] Disconnected!\n", num);
+            break;
+        case WStype_CONNECTED:
+            {
+                IPAddress ip = webSocket.remoteIP(num);
+                USE_SERIAL.printf("[%u] Connected from %d.%d.%d.%d url: %s\n", num, ip[0], ip[1], ip[2], ip[3], payload);
+            }
+            break;
+        case WStype_TEXT:
+        case WStype_BIN:
+            // message fit into one piece
+            messageLength[num] = 0;
+            messageSum[num] = 0;
+            messageUpdate(num, payload, lenght);
+            USE_SERIAL.printf("[%u] message lenght: %u sum: %08X\n", num, messageLength[num], messageSum[num]);
+            break;
+        case WStype_FRAGMENT_TEXT_START:
+        case WStype_FRAGMENT_BIN_START:
+            messageLength[num] = 0;
+            messageSum[num] = 0;
+            messageUpdate(num, payload, lenght);
+            break;
+        case WStype_FRAGMENT:
+            messageUpdate(num, payload, lenght);
+            break;
+        case WStype_FRAGMENT_FIN:
+            messageUpdate(num, payload, lenght);
+            USE_SERIAL.printf("[%u] fragmented message lenght: %u sum: %08X\n", num, messageLength[num], messageSum[num]);
+            webSocket.sendTXT(num, "done");
+            break;
+    }
+
+}
+
+void setup() {
+    USE_SERIAL.begin(115200);
+
+    USE_SERIAL.setDebugOutput(true);
+
+    USE_SERIAL.println();
+    USE_SERIAL.println();
+    USE_SERIAL.println();
+
+    for(uint8_t t = 4; t > 0; t--) {
+        USE_SERIAL.printf("[SETUP] BOOT WAIT %d...\n", t);
+        USE_SERIAL.flush();
+        delay(1000);
+    }
+
+    WiFiMulti.addAP("SSID", "passpasspass");
+
+    while(WiFiMulti.run() != WL_CONNECTED) {
+        delay(100);
+    }
+
+    webSocket.begin();
+    webSocket.onEvent(webSocketEvent);
+    // deliver text and binary messages in pieces instead of reassembling them
+    webSocket.setFragmentEvents(true);
+}
+
+void loop() {
+    webSocket.loop();
+}
@@ -0,0 +1,93 @@
+/*
+ * WebSocketServerStalledClient.ino
+ *
+ *  Created on: 16.10.2026
+ *
+ * echo server that prints the slowest webSocket.loop() call every 5 seconds,
+ * a client that stops in the middle of a frame or of the handshake must not
+ * hold up the others
+ *
+ * test it from a host with:
+ *   python stalled_client.py <ip> --clients 3
+ *
+ */
+
+#include <Arduino.h>
+
+#include <ESP8266WiFi.h>
+#include <ESP8266WiFiMulti.h>
+#include <WebSocketsServer.h>
+#include <Hash.h>
+
+ESP8266WiFiMulti WiFiMulti;
+
+WebSocketsServer webSocket = WebSocketsServer(81);
+
+#define USE_SERIAL Serial1
+
+uint32_t loopMax = 0;
+uint32_t lastReport = 0;
+
+void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t lenght) {
+
+    switch(type) {
+        case WStype_DISCONNECTED:
+            USE_SERIAL.printf("[%u] Disconnected!\n", num);
+            break;
+        case WStype_CONNECTED:
+            {
+                IPAddress ip = webSocket.remoteIP(num);
+                USE_SERIAL.printf("[%u] Connected from %d.%d.%d.%d url: %s\n", num, ip[0], ip[1], ip[2], ip[3], payload);
+            }
+            break;
+        case WStype_TEXT:
+            webSocket.sendTXT(num, payload, lenght);
+            break;
+        case WStype_BIN:
+            webSocket.sendBIN(num, payload, lenght);
+            break;
+    }
+
+}
+
+void setup() {
+    USE_SERIAL.begin(115200);
+
+    USE_SERIAL.setDebugOutput(true);
+
+    USE_SERIAL.println();
+    USE_SERIAL.println();
+    USE_SERIAL.println();
+
+    for(uint8_t t = 4; t > 0; t--) {
+        USE_SERIAL.printf("[SETUP] BOOT WAIT %d...\n", t);
+        USE_SERIAL.flush();
+        delay(1000);
+    }
+
+    WiFiMulti.addAP("SSID", "passpasspass");
+
+    while(WiFiMulti.run() != WL_CONNECTED) {
+        delay(100);
+    }
+
+    USE_SERIAL.printf("[SETUP] IP: %s\n", WiFi.localIP().toString().c_str());
+
+    webSocket.begin();
+    webSocket.onEvent(webSocketEvent);
+}
+
+void loop() {
+    uint32_t start = micros();
+    webSocket.loop();
+    uint32_t time = (micros() - start);
+    if(time > loopMax) {
+        loopMax = time;
+    }
+
+    if((millis() - lastReport) > 5000) {
+        lastReport = millis();
+        USE_SERIAL.printf("[LOOP] slowest: %uus heap: %u\n", loopMax, ESP.getFreeHeap());
+        loopMax = 0;
+    }
+}
@@ -0,0 +1,218 @@
+#!/usr/bin/env python
+#
+# Talks to WebSocketServerStalledClient.ino with a few clients that echo
+# messages as fast as they can, while one client stops in the middle of a
+# frame and another one in the middle of the handshake. Prints the echo
+# round trip times and fails if one of them waited for the stalled clients.
+# The stalled clients have to be disconnected after WEBSOCKETS_TCP_TIMEOUT,
+# a client that sends its frame slowly but keeps going has to get its echo,
+# and one that sends a header line that is too long has to be disconnected.
+#
+import argparse
+import base64
+import os
+import socket
+import struct
+import sys
+import threading
+import time
+
+
+def handshake_request(host, port):
+    key = base64.b64encode(os.urandom(16)).decode()
+    return ('GET / HTTP/1.1\r\nHost: %s:%d\r\nConnection: Upgrade\r\nUpgrade: websocket\r\n'
+            'Sec-WebSocket-Version: 13\r\nSec-WebSocket-Key: %s\r\n\r\n' % (host, port, key)).encode()
+
+
+def read_response(sock):
+    response = b''
+    while b'\r\n\r\n' not in response:
+        data = sock.recv(1024)
+        if not data:
+            raise IOError('closed during handshake')
+        response += data
+    if b' 101 ' not in response.split(b'\r\n', 1)[0]:
+        raise IOError('handshake failed: %r' % response.split(b'\r\n', 1)[0])
+    return response.split(b'\r\n\r\n', 1)[1]
+
+
+def connect(host, port, timeout):
+    sock = socket.create_connection((host, port), timeout=timeout)
+    sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    sock.sendall(handshake_request(host, port))
+    return sock, read_response(sock)
+
+
+def frame(opcode, payload):
+    header = bytearray([0x80 | opcode])
+    if len(payload) < 126:
+        header.append(0x80 | len(payload))
+    elif len(payload) < 0x10000:
+        header.append(0x80 | 126)
+        header += struct.pack('>H', len(payload))
+    else:
+        header.append(0x80 | 127)
+        header += struct.pack('>Q', len(payload))
+    mask = os.urandom(4)
+    return bytes(header) + mask + bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+
+
+def read_frame(sock, rest):
+    def need(n):
+        data = rest[0]
+        while len(data) < n:
+            more = sock.recv(4096)
+            if not more:
+                raise IOError('connection closed')
+            data += more
+        rest[0] = data[n:]
+        return data[:n]
+
+    while True:
+        head = need(2)
+        length = head[1] & 0x7F
+        if length == 126:
+            length = struct.unpack('>H', need(2))[0]
+        elif length == 127:
+            length = struct.unpack('>Q', need(8))[0]
+        payload = need(length)
+        # the server pings every new client once
+        if (head[0] & 0x0F) not in (0x9, 0xA):
+            return head[0] & 0x0F, payload
+
+
+def expect_closed(sock, rest):
+    try:
+        while True:
+            opcode, payload = read_frame(sock, rest)
+            if opcode == 0x8:
+                return
+            raise IOError('got a frame instead of a close')
+    except socket.timeout:
+        raise IOError('still connected')
+    except (IOError, OSError):
+        return
+
+
+def slow_client(host, port, timeout, results):
+    # every piece of the frame comes well within the timeout, the whole frame does not
+    try:
+        sock, rest = connect(host, port, 10)
+        message = os.urandom(1000)
+        data = frame(0x2, message)
+        pieces = 8
+        step = (len(data) + pieces - 1) // pieces
+        for i in range(0, len(data), step):
+            sock.sendall(data[i:i + step])
+            time.sleep(timeout / 3)
+        opcode, payload = read_frame(sock, [rest])
+        results.append('ok' if payload == message else 'FAILED (wrong echo)')
+        sock.close()
+    except (IOError, OSError) as e:
+        results.append('FAILED (%s)' % e)
+
+
+def echo_client(host, port, seconds, size, timeout, times, errors):
+    try:
+        sock, rest = connect(host, port, timeout)
+        rest = [rest]
+        end = time.time() + seconds
+        n = 0
+        while time.time() < end:
+            message = (b'%08d' % n) * (size // 8)
+            start = time.time()
+            sock.sendall(frame(0x2, message))
+            opcode, payload = read_frame(sock, rest)
+            times.append(time.time() - start)
+            if opcode != 0x2 or payload != message:
+                errors.append('wrong echo')
+                break
+            n += 1
+        sock.close()
+    except (IOError, OSError) as e:
+        errors.append(str(e))
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('host')
+    parser.add_argument('--port', type=int, default=81)
+    parser.add_argument('--clients', type=int, default=3)
+    parser.add_argument('--seconds', type=float, default=5)
+    parser.add_argument('--size', type=int, default=256)
+    parser.add_argument('--limit', type=float, default=0.5, help='max echo round trip in seconds')
+    parser.add_argument('--timeout', type=float, default=2, help='WEBSOCKETS_TCP_TIMEOUT in seconds')
+    args = parser.parse_args()
+    if args.seconds < 2 * args.timeout:
+        args.seconds = 2 * args.timeout
+
+    times = []
+    errors = []
+    threads = [threading.Thread(target=echo_client, args=(args.host, args.port, args.seconds, args.size, 10, times, errors))
+               for _ in range(args.clients)]
+    for t in threads:
+        t.start()
+    time.sleep(args.seconds / 4)
+
+    # stops after the first byte of the frame header and again in the middle of the payload
+    stalled, rest = connect(args.host, args.port, 10)
+    message = os.urandom(1000)
+    data = frame(0x2, message)
+    stalled.sendall(data[:1])
+    time.sleep(0.2)
+    stalled.sendall(data[1:500])
+
+    # stops in the middle of the request line
+    slow = socket.create_connection((args.host, args.port), timeout=10)
+    request = handshake_request(args.host, args.port)
+    slow.sendall(request[:7])
+
+    for t in threads:
+        t.join()
+
+    ok = True
+    if errors:
+        print('echo clients failed: %s' % ', '.join(errors))
+        ok = False
+    if times:
+        times.sort()
+        print('%d echos of %d byte, round trip avg %.1f ms, 99%% %.1f ms, max %.1f ms' % (
+            len(times), args.size, 1000 * sum(times) / len(times), 1000 * times[int(len(times) * 0.99)], 1000 * times[-1]))
+        if times[-1] > args.limit:
+            print('FAILED: an echo took longer than %.1f s' % args.limit)
+            ok = False
+
+    # the stalled clients waited longer than the timeout, the server dropped them
+    for name, sock, rest in (('stalled frame', stalled, [rest]), ('stalled handshake', slow, [b''])):
+        try:
+            sock.settimeout(args.timeout)
+            expect_closed(sock, rest)
+            print('%s: disconnected' % name)
+        except (IOError, OSError) as e:
+            print('%s: FAILED (%s)' % (name, e))
+            ok = False
+        sock.close()
+
+    # keeps sending its frame for longer than the timeout, needs a free slot
+    slow_results = []
+    slow_client(args.host, args.port, args.timeout, slow_results)
+    print('slow frame: %s' % slow_results[0])
+    if slow_results[0] != 'ok':
+        ok = False
+
+    # a header line longer than WEBSOCKETS_MAX_HEADER_LINE
+    long_line = socket.create_connection((args.host, args.port), timeout=args.timeout)
+    try:
+        long_line.sendall(b'GET /' + b'a' * 4096)
+        expect_closed(long_line, [b''])
+        print('long header line: disconnected')
+    except (IOError, OSError) as e:
+        print('long header line: FAILED (%s)' % e)
+        ok = False
+    long_line.close()
+
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == '__main__':
+    main()